@@ -85,12 +85,13 @@ namespace Tiny3D
         ID getGroupID() const;
 
         /**
-         * @fn  virtual bool Bound::test(BoundPtr bound) const;
+         * @fn  virtual bool Bound::test(Bound *bound) const;
          * @brief   相交检测
          * @param   bound   The bound.
          * @return  True if it succeeds, false if it fails.
+         * @remarks 每帧每个结点都会调用，只借用对象，不持有引用.
          */
-        virtual bool test(BoundPtr bound) const;
+        virtual bool test(Bound *bound) const;
 
         /**
          * @fn  void Bound::setCollisionSource(bool isSource);
@@ -127,6 +128,14 @@ namespace Tiny3D
          */
         virtual RenderablePtr getRenderable() = 0;
 
+        /**
+         * @fn  virtual bool Bound::getWorldAabb(Aabb &aabb) const;
+         * @brief   获取碰撞体在世界空间的轴对齐包围盒，用于场景剔除
+         * @param [out] aabb    : 返回的包围盒.
+         * @return  碰撞体没有有限大小的包围盒时返回 false.
+         */
+        virtual bool getWorldAabb(Aabb &aabb) const;
+
     protected:
         /**
          * @fn  Bound::Bound(SceneNode *node, ID uID = E_BID_AUTOMATIC);
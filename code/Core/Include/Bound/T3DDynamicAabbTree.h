@@ -0,0 +1,241 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#ifndef __T3D_DYNAMIC_AABB_TREE_H__
+#define __T3D_DYNAMIC_AABB_TREE_H__
+
+
+#include "T3DPrerequisites.h"
+#include "T3DTypedef.h"
+#include "Bound/T3DFrustumCuller.h"
+
+
+namespace Tiny3D
+{
+    /**
+     * @class   DynamicAabbTree
+     * @brief   动态 AABB 层次包围体树
+     * @remarks 叶子结点保存的是向外扩大过的 AABB（fat AABB），物体在扩大的
+     *          范围内移动时不需要修改树，只有超出范围才从树上删除再重新插入。
+     *          插入时按照面积增量选择兄弟结点，插入和删除之后沿着路径做旋转
+     *          保持平衡，所以单次插入、删除和移动都是 O(log n)。
+     *          每个结点还保存子树所有叶子的掩码的“或”，查询时掩码不匹配的
+     *          整棵子树直接跳过。
+     *          结点存放在连续数组里，用索引互相引用，空闲结点串成链表复用。
+     */
+    class T3D_ENGINE_API DynamicAabbTree
+    {
+    public:
+        /** 无效的代理ID */
+        static const int32_t NULL_NODE;
+
+        /** 默认叶子 AABB 向外扩大的比例，相对于 AABB 的尺寸 */
+        static const Real DEFAULT_FAT_RATIO;
+
+        /**
+         * @brief 构造函数
+         */
+        DynamicAabbTree();
+
+        /**
+         * @brief 析构函数
+         */
+        ~DynamicAabbTree();
+
+        /**
+         * @brief 创建代理，插入一个叶子结点
+         * @param [in] aabb : 物体的世界空间 AABB
+         * @param [in] mask : 查询使用的掩码
+         * @param [in] userData : 用户数据，查询时返回
+         * @return 返回代理ID
+         */
+        int32_t createProxy(const Aabb &aabb, uint32_t mask, void *userData);
+
+        /**
+         * @brief 删除代理
+         * @param [in] proxyID : 代理ID
+         */
+        void destroyProxy(int32_t proxyID);
+
+        /**
+         * @brief 物体移动之后更新代理的包围盒
+         * @param [in] proxyID : 代理ID
+         * @param [in] aabb : 物体新的世界空间 AABB
+         * @return 超出了原来扩大的范围，重新插入树中返回 true
+         */
+        bool moveProxy(int32_t proxyID, const Aabb &aabb);
+
+        /**
+         * @brief 修改代理的掩码，同时更新所有祖先结点的掩码
+         * @param [in] proxyID : 代理ID
+         * @param [in] mask : 新的掩码
+         */
+        void setProxyMask(int32_t proxyID, uint32_t mask);
+
+        /**
+         * @brief 获取代理的用户数据
+         */
+        void *getUserData(int32_t proxyID) const;
+
+        /**
+         * @brief 获取代理数量
+         */
+        size_t getProxyCount() const;
+
+        /**
+         * @brief 获取树的高度，只有一个叶子时高度为0
+         */
+        int32_t getHeight() const;
+
+        /**
+         * @brief 设置叶子 AABB 向外扩大的比例
+         * @remarks 只影响之后插入或者移动出范围的叶子
+         */
+        void setFatRatio(Real ratio);
+
+        /**
+         * @brief 视锥体查询
+         * @param [in] frustum : 视锥体，平面法线指向视锥体内部
+         * @param [in] mask : 查询掩码，跟叶子掩码的“与”不为0才返回
+         * @param [out] result : 追加和视锥体相交的代理的用户数据
+         * @remarks 结点完全在某个平面内侧时，子树不再检测这个平面；
+         *          完全在所有平面内侧时，整棵子树直接加入结果，不再检测。
+         *          还需要检测的叶子收集起来，最后用 FrustumCuller 批量检测，
+         *          并且记住每个叶子上一次被剔除的平面
+         */
+        void query(const Frustum &frustum, uint32_t mask, 
+            TArray<void*> &result) const;
+
+    protected:
+        /**
+         * @brief 树结点，叶子结点的 child1 为 NULL_NODE
+         */
+        struct TreeNode
+        {
+            Real        minimum[3];     /**< AABB 最小点 */
+            Real        maximum[3];     /**< AABB 最大点 */
+            void        *userData;      /**< 叶子结点用户数据 */
+            int32_t     parent;         /**< 父结点，空闲结点用作链表的 next */
+            int32_t     child1;         /**< 第一个子结点 */
+            int32_t     child2;         /**< 第二个子结点 */
+            int32_t     height;         /**< 叶子为0，空闲结点为 -1 */
+            uint32_t    mask;           /**< 子树所有叶子掩码的“或” */
+            mutable uint8_t lastPlane;  /**< 叶子上一次被剔除的平面 */
+
+            bool isLeaf() const { return child1 == NULL_NODE; }
+        };
+
+        typedef TArray<TreeNode>    TreeNodes;
+        typedef TArray<int32_t>     NodeStack;
+        typedef TArray<Real>        RealArray;
+        typedef TArray<uint8_t>     PlaneArray;
+        typedef TArray<uint32_t>    MaskArray;
+
+        /**
+         * @brief 查询时收集的待检测叶子，SoA 方式存放
+         */
+        struct PendingLeaves
+        {
+            RealArray   centerX;
+            RealArray   centerY;
+            RealArray   centerZ;
+            RealArray   extentX;
+            RealArray   extentY;
+            RealArray   extentZ;
+            PlaneArray  lastPlanes;
+            NodeStack   nodes;
+            MaskArray   visibility;
+
+            void clear();
+            void add(const TreeNode &node, int32_t nodeID);
+        };
+
+        /**
+         * @brief 分配一个结点，空闲链表为空时扩大结点数组
+         */
+        int32_t allocateNode();
+
+        /**
+         * @brief 释放结点到空闲链表
+         */
+        void freeNode(int32_t nodeID);
+
+        /**
+         * @brief 把叶子结点插入到树中
+         */
+        void insertLeaf(int32_t leaf);
+
+        /**
+         * @brief 把叶子结点从树中摘掉，但不释放
+         */
+        void removeLeaf(int32_t leaf);
+
+        /**
+         * @brief 以结点为根做一次旋转，返回旋转之后子树的根
+         */
+        int32_t balance(int32_t iA);
+
+        /**
+         * @brief 从结点开始向上更新包围盒、高度、掩码，并且保持平衡
+         */
+        void refit(int32_t nodeID);
+
+        /**
+         * @brief 把扩大后的 AABB 写入叶子结点
+         */
+        void setFatAabb(TreeNode &node, const Aabb &aabb) const;
+
+        /**
+         * @brief 结点包围盒是否完全包含指定 AABB
+         */
+        static bool contains(const TreeNode &node, const Aabb &aabb);
+
+        /**
+         * @brief 计算两个结点合并后的包围盒表面积的一半
+         */
+        static Real mergedPerimeter(const TreeNode &a, const TreeNode &b);
+
+        /**
+         * @brief 计算结点包围盒表面积的一半
+         */
+        static Real perimeter(const TreeNode &node);
+
+        /**
+         * @brief 用两个子结点更新父结点的包围盒和掩码
+         */
+        void combine(int32_t parent);
+
+    protected:
+        TreeNodes           mNodes;         /**< 结点数组 */
+        int32_t             mRoot;          /**< 根结点 */
+        int32_t             mFreeList;      /**< 空闲结点链表 */
+        size_t              mProxyCount;    /**< 代理数量 */
+        Real                mFatRatio;      /**< 叶子 AABB 扩大比例 */
+        mutable NodeStack   mStack;         /**< 查询使用的栈，避免每次分配 */
+        mutable FrustumCuller   mCuller;    /**< 叶子批量剔除 */
+        mutable PendingLeaves   mPending;   /**< 待批量检测的叶子 */
+    };
+}
+
+
+#include "T3DDynamicAabbTree.inl"
+
+
+#endif  /*__T3D_DYNAMIC_AABB_TREE_H__*/
@@ -0,0 +1,131 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#ifndef __T3D_FRUSTUM_CULLER_H__
+#define __T3D_FRUSTUM_CULLER_H__
+
+
+#include "T3DPrerequisites.h"
+
+
+namespace Tiny3D
+{
+    /**
+     * @class   FrustumCuller
+     * @brief   批量视锥体剔除
+     * @remarks 包围体以 SoA 方式传入（每个分量一个连续数组），单精度浮点数
+     *          且支持 SSE2 的平台一次检测 4 个包围体，其他情况逐个检测，两种
+     *          路径结果完全一致。
+     *          检测结果写入可见性位图，第 i 个包围体对应第 i / 32 个字的第
+     *          i % 32 位，可见为 1。
+     *          可以传入每个包围体上一次被剔除的平面索引，下一次先检测这个平面，
+     *          一组包围体都被它剔除时不再检测其他平面。连续帧之间相机变化不大，
+     *          视锥体外的物体大部分都会在第一个平面就被剔除。
+     */
+    class T3D_ENGINE_API FrustumCuller
+    {
+    public:
+        /**
+         * @brief 视锥体平面数量
+         */
+        static const uint32_t PLANE_COUNT;
+
+        /**
+         * @brief 构造函数
+         */
+        FrustumCuller();
+
+        /**
+         * @brief 构造函数
+         * @param [in] frustum : 视锥体，平面法线指向视锥体内部
+         */
+        FrustumCuller(const Frustum &frustum);
+
+        /**
+         * @brief 设置视锥体
+         * @param [in] frustum : 视锥体，平面法线指向视锥体内部
+         */
+        void setFrustum(const Frustum &frustum);
+
+        /**
+         * @brief 计算可见性位图需要的字数
+         * @param [in] count : 包围体数量
+         */
+        static size_t getMaskWords(size_t count);
+
+        /**
+         * @brief 批量剔除轴对齐包围盒
+         * @param [in] centerX : 包围盒中心 x 分量
+         * @param [in] centerY : 包围盒中心 y 分量
+         * @param [in] centerZ : 包围盒中心 z 分量
+         * @param [in] extentX : 包围盒 x 方向半长
+         * @param [in] extentY : 包围盒 y 方向半长
+         * @param [in] extentZ : 包围盒 z 方向半长
+         * @param [in] count : 包围盒数量
+         * @param [in,out] lastPlanes : 每个包围盒上一次被剔除的平面索引，
+         *      剔除时更新，可以为 nullptr
+         * @param [out] visibility : 可见性位图，至少 getMaskWords(count) 个字
+         * @return 返回可见的包围盒数量
+         */
+        size_t cullAabbs(const Real *centerX, const Real *centerY, 
+            const Real *centerZ, const Real *extentX, const Real *extentY,
+            const Real *extentZ, size_t count, uint8_t *lastPlanes, 
+            uint32_t *visibility) const;
+
+        /**
+         * @brief 批量剔除包围球
+         * @param [in] centerX : 球心 x 分量
+         * @param [in] centerY : 球心 y 分量
+         * @param [in] centerZ : 球心 z 分量
+         * @param [in] radius : 半径
+         * @param [in] count : 包围球数量
+         * @param [in,out] lastPlanes : 每个包围球上一次被剔除的平面索引，
+         *      剔除时更新，可以为 nullptr
+         * @param [out] visibility : 可见性位图，至少 getMaskWords(count) 个字
+         * @return 返回可见的包围球数量
+         */
+        size_t cullSpheres(const Real *centerX, const Real *centerY,
+            const Real *centerZ, const Real *radius, size_t count,
+            uint8_t *lastPlanes, uint32_t *visibility) const;
+
+    protected:
+        /**
+         * @brief 逐个剔除包围盒，用于没有 SIMD 的平台和批量剩下的尾部
+         */
+        size_t cullAabbsScalar(const Real *centerX, const Real *centerY,
+            const Real *centerZ, const Real *extentX, const Real *extentY,
+            const Real *extentZ, size_t first, size_t count, 
+            uint8_t *lastPlanes, uint32_t *visibility) const;
+
+        /**
+         * @brief 逐个剔除包围球，用于没有 SIMD 的平台和批量剩下的尾部
+         */
+        size_t cullSpheresScalar(const Real *centerX, const Real *centerY,
+            const Real *centerZ, const Real *radius, size_t first, 
+            size_t count, uint8_t *lastPlanes, uint32_t *visibility) const;
+
+    protected:
+        Real    mPlanes[6][4];      /**< 平面方程系数 (a, b, c, d) */
+        Real    mAbsNormals[6][3];  /**< 平面法线各分量的绝对值 */
+    };
+}
+
+
+#endif  /*__T3D_FRUSTUM_CULLER_H__*/
@@ -34,6 +34,7 @@ namespace Tiny3D
     class T3D_ENGINE_API ObbBound : public Bound
     {
         T3D_DECLARE_CLASS();
+        T3D_DECLARE_POOL(ObbBound);
 
     public:
         /**
@@ -123,6 +124,13 @@ namespace Tiny3D
          */
         virtual void update() override;
 
+        /**
+         * @fn  virtual bool ObbBound::getWorldAabb(Aabb &aabb) const override;
+         * @brief   实现基类接口
+         * @sa  bool Bound::getWorldAabb(Aabb &aabb) const
+         */
+        virtual bool getWorldAabb(Aabb &aabb) const override;
+
     protected:
         /**
          * @fn  ObbBound::ObbBound(SceneNode *node, ID uID = E_BID_AUTOMATIC);
@@ -34,6 +34,7 @@ namespace Tiny3D
     class T3D_ENGINE_API SphereBound : public Bound
     {
         T3D_DECLARE_CLASS();
+        T3D_DECLARE_POOL(SphereBound);
 
     public:
         /**
@@ -94,6 +95,13 @@ namespace Tiny3D
          */
         virtual void update() override;
 
+        /**
+         * @fn  virtual bool SphereBound::getWorldAabb(Aabb &aabb) const override;
+         * @brief   实现基类接口
+         * @sa  bool Bound::getWorldAabb(Aabb &aabb) const
+         */
+        virtual bool getWorldAabb(Aabb &aabb) const override;
+
     protected:
         /**
          * @fn  SphereBound::SphereBound(SceneNode *node, 
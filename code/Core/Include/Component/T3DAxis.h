@@ -34,6 +34,7 @@ namespace Tiny3D
     class T3D_ENGINE_API Axis : public Renderable
     {
         T3D_DECLARE_CLASS();
+        T3D_DECLARE_POOL(Axis);
 
     public:
         /**
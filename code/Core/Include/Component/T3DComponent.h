@@ -36,6 +36,7 @@ namespace Tiny3D
     class T3D_ENGINE_API Component : public Object
     {
         friend class SceneNode;
+        friend class ComponentStore;
 
         T3D_DISABLE_COPY(Component);
         T3D_DECLARE_CLASS();
@@ -64,6 +65,16 @@ namespace Tiny3D
          */
         virtual ComponentPtr clone() const = 0;
 
+        /**
+         * @fn  virtual ComponentPtr Component::instantiate() const;
+         * @brief   以本组件为预制体生成实例
+         * @return  返回新的组件实例.
+         * @remarks 实例和预制体共享不可变的数据（VAO、材质等），只复制实例自身
+         *          的状态。默认实现直接调用 clone().
+         * @sa  SceneNodePtr SceneNode::instantiate() const
+         */
+        virtual ComponentPtr instantiate() const;
+
         /**
          * @fn  ID Component::getID() const
          * @brief   Gets the identifier
@@ -124,6 +135,10 @@ namespace Tiny3D
     protected:
         ID          mID;            /**< The identifier */
         SceneNode   *mSceneNode;    /**< The scene node */
+
+    private:
+        uint32_t    mStoreBucket;   /**< 在 ComponentStore 里的类型位置加一，0 表示不在存储里 */
+        uint32_t    mStoreIndex;    /**< 在 ComponentStore 类型数组里的位置 */
     };
 }
 
@@ -62,8 +62,10 @@ namespace Tiny3D
          *      createObject(int32_t argc, ...) const override;
          * @brief   Creates an object
          * @param   argc    The argc.
-         * @param   ...     Variable arguments providing additional information.
+         * @param   ...     依次是组件类 const Class * 和指向组件构造参数的 
+         *                  va_list * .
          * @return  The new object.
+         * @remarks 直接转发给 ComponentRegistry，新代码请直接用注册表.
          */
         virtual ComponentPtr createObject(int32_t argc, ...) const override;
 
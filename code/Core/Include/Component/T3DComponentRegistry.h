@@ -0,0 +1,136 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#ifndef __T3D_COMPONENT_REGISTRY_H__
+#define __T3D_COMPONENT_REGISTRY_H__
+
+
+#include "T3DPrerequisites.h"
+#include "T3DTypedef.h"
+#include "Kernel/T3DCommon.h"
+#include <stdarg.h>
+
+
+namespace Tiny3D
+{
+    /**
+     * @class   ComponentRegistry
+     * @brief   组件类型注册表，按 Class 序号直接索引组件的创建函数和执行顺序
+     * @remarks 组件类在自己的源文件里用 T3D_REGISTER_COMPONENT 静态注册，
+     *          插件里的组件在插件加载时注册、卸载时注销。执行顺序由场景管理器
+     *          通过 setOrder 设置在基类上，派生类沿继承链取最近基类的顺序，
+     *          设置时一次算好，查询时只是一次数组访问。注册和设置顺序都不是
+     *          线程安全的，应该在启动或者加载插件时完成.
+     */
+    class T3D_ENGINE_API ComponentRegistry
+    {
+    public:
+        /**
+         * @brief   组件创建函数，args 是 SceneNode::addComponent 的变参
+         */
+        typedef ComponentPtr (*Creator)(va_list args);
+
+        /**
+         * @fn  template <typename T> static ComponentPtr 
+         *      ComponentRegistry::defaultCreator(va_list args);
+         * @brief   不带参数的组件创建函数，直接调用 T::create()
+         */
+        template <typename T>
+        static ComponentPtr defaultCreator(va_list args)
+        {
+            return T::create();
+        }
+
+        /**
+         * @fn  static TResult ComponentRegistry::registerComponent(
+         *      const Class *cls, Creator creator);
+         * @brief   注册组件创建函数
+         * @param [in]  cls     : 组件类.
+         * @param [in]  creator : 创建函数.
+         * @return  调用成功返回 T3D_OK.
+         */
+        static TResult registerComponent(const Class *cls, Creator creator);
+
+        /**
+         * @fn  static TResult ComponentRegistry::unregisterComponent(
+         *      const Class *cls);
+         * @brief   注销组件创建函数
+         * @param [in]  cls : 组件类.
+         * @return  调用成功返回 T3D_OK.
+         */
+        static TResult unregisterComponent(const Class *cls);
+
+        /**
+         * @fn  static Creator ComponentRegistry::getCreator(const Class *cls);
+         * @brief   获取组件创建函数
+         * @param [in]  cls : 组件类.
+         * @return  没有注册返回 nullptr.
+         */
+        static Creator getCreator(const Class *cls);
+
+        /**
+         * @fn  static ComponentPtr ComponentRegistry::createComponent(
+         *      const Class *cls, va_list args);
+         * @brief   创建组件对象
+         * @param [in]  cls     : 组件类.
+         * @param [in]  args    : 传给创建函数的参数.
+         * @return  组件类没有注册或者创建失败返回 nullptr.
+         */
+        static ComponentPtr createComponent(const Class *cls, va_list args);
+
+        /**
+         * @fn  static void ComponentRegistry::setOrder(const Class *cls, 
+         *      uint32_t order);
+         * @brief   设置组件类及其派生类的执行顺序
+         * @param [in]  cls     : 组件类，一般是功能基类，如 Bound.
+         * @param [in]  order   : 执行顺序，见 ComponentOrder.
+         */
+        static void setOrder(const Class *cls, uint32_t order);
+
+        /**
+         * @fn  static uint32_t ComponentRegistry::getOrder(const Class *cls);
+         * @brief   获取组件类的执行顺序
+         * @param [in]  cls : 组件类.
+         * @return  没有设置过顺序返回 ComponentOrder::INVALID.
+         */
+        static uint32_t getOrder(const Class *cls);
+
+    private:
+        static uint32_t resolveOrder(const Class *cls);
+    };
+
+    /**
+     * @brief   在组件类的源文件里静态注册组件，放在 T3D_IMPLEMENT_CLASS 之后
+     */
+    #define T3D_REGISTER_COMPONENT(cls) \
+        static const TResult s_##cls##Registered = \
+            ComponentRegistry::registerComponent(T3D_CLASS(cls), \
+                ComponentRegistry::defaultCreator<cls>);
+
+    /**
+     * @brief   用自定义创建函数静态注册组件，creator 从变参中取出构造参数
+     */
+    #define T3D_REGISTER_COMPONENT_CREATOR(cls, creator) \
+        static const TResult s_##cls##Registered = \
+            ComponentRegistry::registerComponent(T3D_CLASS(cls), creator);
+}
+
+
+#endif  /*__T3D_COMPONENT_REGISTRY_H__*/
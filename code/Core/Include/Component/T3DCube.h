@@ -34,6 +34,7 @@ namespace Tiny3D
     class T3D_ENGINE_API Cube : public Renderable
     {
         T3D_DECLARE_CLASS();
+        T3D_DECLARE_POOL(Cube);
 
     public:
         /**
@@ -62,6 +63,14 @@ namespace Tiny3D
          */
         virtual ComponentPtr clone() const override;
 
+        /**
+         * @fn  virtual ComponentPtr Cube::instantiate() const override;
+         * @brief   重写基类接口，实例和预制体共享 VAO 和材质
+         * @return  返回新的实例对象.
+         * @sa  ComponentPtr Component::instantiate() const
+         */
+        virtual ComponentPtr instantiate() const override;
+
         /**
          * @fn  const Vector3 Cube::&getCenter() const
          * @brief   获取长方体中心
@@ -76,6 +85,16 @@ namespace Tiny3D
          */
         const Vector3 &getExtent() const { return mExtent; }
 
+        /**
+         * @fn  virtual TResult Cube::readGeometry(TArray<uint8_t> &vertices, 
+         *      TArray<uint32_t> &indices) const override;
+         * @brief   重写基类接口，按中心和长度重新生成顶点和索引，不回读显存
+         * @sa  TResult Renderable::readGeometry(TArray<uint8_t> &vertices, 
+         *      TArray<uint32_t> &indices) const
+         */
+        virtual TResult readGeometry(TArray<uint8_t> &vertices, 
+            TArray<uint32_t> &indices) const override;
+
     protected:
         /**
          * @fn  Cube::Cube(ID uID = E_CID_AUTOMATIC);
@@ -121,6 +140,15 @@ namespace Tiny3D
          */
         virtual VertexArrayObjectPtr getVertexArrayObject() const override;
 
+        /**
+         * @fn  virtual TResult Cube::replaceMaterial(MaterialPtr material) override;
+         * @brief   重写基类接口，替换渲染材质
+         * @param [in]  material    : 新的材质对象.
+         * @return  成功返回 T3D_OK.
+         * @sa  TResult Renderable::replaceMaterial(MaterialPtr material)
+         */
+        virtual TResult replaceMaterial(MaterialPtr material) override;
+
     private:
         /**
          * @fn  void Cube::setupBox(void *vertices, size_t vertexCount, 
@@ -132,7 +160,7 @@ namespace Tiny3D
          * @param           indexCount  Number of indexes.
          */
         void setupBox(void *vertices, size_t vertexCount,  uint16_t *indices, 
-            size_t indexCount);
+            size_t indexCount) const;
 
     protected:
         Vector3                 mCenter;        /**< 长方体的中心 */
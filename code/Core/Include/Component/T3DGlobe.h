@@ -33,6 +33,7 @@ namespace Tiny3D
     class T3D_ENGINE_API Globe : public Renderable
     {
         T3D_DECLARE_CLASS();
+        T3D_DECLARE_POOL(Globe);
 
     public:
         /**
@@ -61,6 +62,14 @@ namespace Tiny3D
          */
         virtual ComponentPtr clone() const override;
 
+        /**
+         * @fn  virtual ComponentPtr Globe::instantiate() const override;
+         * @brief   重写基类接口，实例和预制体共享 VAO 和材质
+         * @return  返回新的实例对象.
+         * @sa  ComponentPtr Component::instantiate() const
+         */
+        virtual ComponentPtr instantiate() const override;
+
         /**
          * @fn  const Vector3 Globe::&getCenter() const
          * @brief   获取球心
@@ -118,6 +127,25 @@ namespace Tiny3D
          */
         virtual VertexArrayObjectPtr getVertexArrayObject() const override;
 
+        /**
+         * @fn  virtual TResult Globe::replaceMaterial(MaterialPtr material) override;
+         * @brief   重写基类接口，替换渲染材质
+         * @param [in]  material    : 新的材质对象.
+         * @return  成功返回 T3D_OK.
+         * @sa  TResult Renderable::replaceMaterial(MaterialPtr material)
+         */
+        virtual TResult replaceMaterial(MaterialPtr material) override;
+
+        /**
+         * @fn  virtual TResult Globe::readGeometry(TArray<uint8_t> &vertices, 
+         *      TArray<uint32_t> &indices) const override;
+         * @brief   重写基类接口，按球心和半径重新生成顶点和索引，不回读显存
+         * @sa  TResult Renderable::readGeometry(TArray<uint8_t> &vertices, 
+         *      TArray<uint32_t> &indices) const
+         */
+        virtual TResult readGeometry(TArray<uint8_t> &vertices, 
+            TArray<uint32_t> &indices) const override;
+
     private:
         /**
          * @fn  void Globe::setupSphere(void *vertices, size_t vertexCount, 
@@ -129,7 +157,7 @@ namespace Tiny3D
          * @param           indexCount  Number of indexes.
          */
         void setupSphere(void *vertices, size_t vertexCount, uint16_t *indices,
-            size_t indexCount);
+            size_t indexCount) const;
 
     protected:
         Vector3                 mCenter;    /**< 球心 */
@@ -34,6 +34,7 @@ namespace Tiny3D
     class T3D_ENGINE_API Mesh : public Renderable
     {
         T3D_DECLARE_CLASS();
+        T3D_DECLARE_POOL(Mesh);
 
     public:
         /**
@@ -67,6 +68,14 @@ namespace Tiny3D
          */
         virtual ComponentPtr clone() const override;
 
+        /**
+         * @fn  virtual ComponentPtr Mesh::instantiate() const override;
+         * @brief   重写基类接口，实例和预制体共享模型、VAO 和材质
+         * @return  返回新的实例对象.
+         * @remarks 实例调用 setModel() 只会替换自己的引用，不影响预制体.
+         */
+        virtual ComponentPtr instantiate() const override;
+
         /**
          * @fn  virtual TResult 
          *      Mesh::cloneProperties(ComponentPtr newObj) const override;
@@ -91,6 +100,14 @@ namespace Tiny3D
          */
         virtual VertexArrayObjectPtr getVertexArrayObject() const override;
 
+        /**
+         * @fn  virtual TResult Mesh::replaceMaterial(MaterialPtr material) override;
+         * @brief   重写基类接口，替换渲染材质
+         * @param [in]  material    : 新的材质对象.
+         * @return  成功返回 T3D_OK.
+         */
+        virtual TResult replaceMaterial(MaterialPtr material) override;
+
         TResult setupVAO();
 
         TResult setupMaterial();
@@ -54,6 +54,16 @@ namespace Tiny3D
          */
         virtual MaterialPtr getMaterial() const = 0;
 
+        /**
+         * @fn  MaterialPtr Renderable::getWritableMaterial();
+         * @brief   获取可以修改的材质
+         * @return  返回本对象独占的材质对象.
+         * @remarks 预制体实例和预制体共享同一个材质，无论是实例还是预制体，
+         *          第一次通过本接口获取时都会先克隆一份材质给自己使用（写时
+         *          复制），之后的修改不会影响共享这个材质的其他对象.
+         */
+        MaterialPtr getWritableMaterial();
+
         /**
          * @fn  virtual VertexArrayObjectPtr 
          *      Renderable::getVertexArrayObject() const = 0;
@@ -62,6 +72,30 @@ namespace Tiny3D
          */
         virtual VertexArrayObjectPtr getVertexArrayObject() const = 0;
 
+        /**
+         * @fn  virtual bool Renderable::frustumCulling(Bound *bound);
+         * @brief   结点通过剔除后，由可渲染对象做更细粒度的剔除
+         * @param [in]  bound   用于剔除的碰撞体，一般是视锥体.
+         * @return  还有需要渲染的部分返回 true，否则返回 false.
+         * @remarks 默认实现直接返回 true
+         */
+        virtual bool frustumCulling(Bound *bound);
+
+        /**
+         * @fn  virtual TResult Renderable::readGeometry(
+         *      TArray<uint8_t> &vertices, TArray<uint32_t> &indices) const;
+         * @brief   获取 CPU 端的顶点和索引数据，静态合批等需要在 CPU 上处理
+         *          几何数据的地方使用
+         * @param [out] vertices    : 顶点数据，格式跟 VAO 的顶点声明一致.
+         * @param [out] indices     : 索引数据，VAO 不用索引时为空.
+         * @return  调用成功返回 T3D_OK.
+         * @remarks 默认实现从 VAO 的第一个顶点缓冲区和索引缓冲区回读，缓冲区
+         *          创建时没有 CPU 读权限就会失败。自己生成几何数据的子类应该
+         *          重写本接口，直接提供 CPU 端的数据.
+         */
+        virtual TResult readGeometry(TArray<uint8_t> &vertices, 
+            TArray<uint32_t> &indices) const;
+
     protected:
         /**
          * @fn  Renderable::Renderable(ID uID = E_CID_AUTOMATIC);
@@ -78,6 +112,27 @@ namespace Tiny3D
          * @return  A TResult.
          */
         virtual TResult cloneProperties(ComponentPtr newObj) const;
+
+        /**
+         * @fn  TResult 
+         *      Renderable::instantiateProperties(ComponentPtr newObj) const;
+         * @brief   实例化时复制基类属性，并把实例和预制体都标记为共享材质
+         * @param   newObj  The new object.
+         * @return  A TResult.
+         */
+        TResult instantiateProperties(ComponentPtr newObj) const;
+
+        /**
+         * @fn  virtual TResult Renderable::replaceMaterial(MaterialPtr material);
+         * @brief   替换渲染使用的材质，写时复制时调用
+         * @param [in]  material    : 新的材质对象，引用计数已经由调用者持有.
+         * @return  成功返回 T3D_OK.
+         * @remarks 默认实现不支持替换，返回 T3D_ERR_FAIL.
+         */
+        virtual TResult replaceMaterial(MaterialPtr material);
+
+    protected:
+        mutable bool    mIsMaterialShared;  /**< 材质是否和预制体或者其他实例共享 */
     };
 }
 
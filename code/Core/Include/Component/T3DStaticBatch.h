@@ -0,0 +1,253 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#ifndef __T3D_STATIC_BATCH_H__
+#define __T3D_STATIC_BATCH_H__
+
+
+#include "Component/T3DRenderable.h"
+#include "Render/T3DHardwareIndexBuffer.h"
+#include "Bound/T3DFrustumCuller.h"
+
+
+namespace Tiny3D
+{
+    /**
+     * @class   StaticBatch
+     * @brief   静态合批渲染对象
+     * @remarks 把使用同一个材质、顶点格式相同的多个静态结点的顶点变换到世界
+     *          空间，合并到一个顶点缓冲区和一个索引缓冲区里，作为一个可渲染
+     *          对象渲染。被合并的结点不再单独渲染，直到合批对象销毁。
+     *          每个结点在索引缓冲区里占一段连续的索引，并且记录世界空间包围盒。
+     *          视锥体剔除时逐个检测这些包围盒，可见性变化时把可见结点的索引
+     *          紧凑地写到索引缓冲区前面，并设置 VAO 实际绘制的索引数量，
+     *          不可见的结点不会提交绘制。
+     *          顶点和索引通过 Renderable::readGeometry 从 CPU 端获取，不要求
+     *          被合并结点的缓冲区可以回读。
+     *          合批以后移动被合并的结点不会影响渲染结果，需要重新合批.
+     */
+    class T3D_ENGINE_API StaticBatch : public Renderable
+    {
+        T3D_DECLARE_CLASS();
+
+    public:
+        /**
+         * @brief 合批中的一个结点
+         */
+        struct SubMesh
+        {
+            SceneNode   *node;          /**< 被合并的结点，克隆出来的为 nullptr */
+            size_t      firstIndex;     /**< 在合并后的索引中的起始位置 */
+            size_t      indexCount;     /**< 索引数量 */
+            Aabb        bound;          /**< 世界空间包围盒 */
+        };
+
+        /**
+         * @fn  static StaticBatchPtr StaticBatch::create(Material *material, 
+         *      ID uID = E_CID_AUTOMATIC);
+         * @brief   创建静态合批对象
+         * @param [in]  material    : 所有被合并结点共用的材质.
+         * @param [in]  uID         (Optional) : 组件ID，默认自动生成.
+         * @return  返回新建的静态合批对象.
+         */
+        static StaticBatchPtr create(Material *material, 
+            ID uID = E_CID_AUTOMATIC);
+
+        /**
+         * @fn  virtual StaticBatch::~StaticBatch();
+         * @brief   析构函数
+         */
+        virtual ~StaticBatch();
+
+        /**
+         * @fn  static bool StaticBatch::canBatch(SceneNode *node);
+         * @brief   判断结点是否可以合批
+         * @param [in]  node    : 场景结点.
+         * @return  结点是静态的、还没有合批，并且可渲染对象是单个顶点流的
+         *          三角形列表，位置是3个浮点数时返回 true.
+         */
+        static bool canBatch(SceneNode *node);
+
+        /**
+         * @fn  bool StaticBatch::isCompatible(SceneNode *node) const;
+         * @brief   判断结点能否合并到本对象里
+         * @param [in]  node    : 可以合批的场景结点.
+         * @return  材质和顶点格式都相同时返回 true.
+         */
+        bool isCompatible(SceneNode *node) const;
+
+        /**
+         * @fn  TResult StaticBatch::addNode(SceneNode *node);
+         * @brief   把结点的顶点和索引变换后追加到合批数据里
+         * @param [in]  node    : 兼容的场景结点.
+         * @return  调用成功返回 T3D_OK，获取几何数据失败时结点不会被合并.
+         * @remarks 结点马上从场景管理器的剔除数据里拿掉，不再单独渲染.
+         */
+        TResult addNode(SceneNode *node);
+
+        /**
+         * @fn  TResult StaticBatch::build();
+         * @brief   用合批数据创建顶点缓冲区、索引缓冲区和 VAO
+         * @return  调用成功返回 T3D_OK.
+         * @remarks 成功后释放顶点数据，之后不能再 addNode.
+         */
+        TResult build();
+
+        /**
+         * @fn  size_t StaticBatch::getSubMeshCount() const
+         * @brief   获取合并的结点数量
+         */
+        size_t getSubMeshCount() const { return mSubMeshes.size(); }
+
+        /**
+         * @fn  const SubMesh &StaticBatch::getSubMesh(size_t index) const
+         * @brief   获取合并的结点信息
+         */
+        const SubMesh &getSubMesh(size_t index) const 
+        { 
+            return mSubMeshes[index]; 
+        }
+
+        /**
+         * @fn  size_t StaticBatch::getVisibleCount() const
+         * @brief   获取上一次剔除后可见的结点数量
+         */
+        size_t getVisibleCount() const { return mVisibleCount; }
+
+        /**
+         * @fn  const Aabb &StaticBatch::getBound() const
+         * @brief   获取所有结点的世界空间包围盒
+         */
+        const Aabb &getBound() const { return mBound; }
+
+        /**
+         * @fn  virtual MaterialPtr StaticBatch::getMaterial() const override;
+         * @brief   实现基类接口
+         */
+        virtual MaterialPtr getMaterial() const override;
+
+        /**
+         * @fn  virtual VertexArrayObjectPtr 
+         *      StaticBatch::getVertexArrayObject() const override;
+         * @brief   实现基类接口
+         */
+        virtual VertexArrayObjectPtr getVertexArrayObject() const override;
+
+        /**
+         * @fn  virtual bool StaticBatch::frustumCulling(Bound *bound) override;
+         * @brief   重写基类接口，逐个剔除合并的结点，可见性变化时重写索引
+         * @param [in]  bound   : 视锥体碰撞体.
+         * @return  没有任何结点可见时返回 false.
+         */
+        virtual bool frustumCulling(Bound *bound) override;
+
+    protected:
+        /**
+         * @fn  StaticBatch::StaticBatch(Material *material, ID uID);
+         * @brief   构造函数
+         */
+        StaticBatch(Material *material, ID uID);
+
+        /**
+         * @fn  virtual ComponentPtr StaticBatch::clone() const override;
+         * @brief   重写基类接口，克隆出来的对象共用顶点缓冲区，不持有结点
+         */
+        virtual ComponentPtr clone() const override;
+
+        /**
+         * @fn  virtual TResult StaticBatch::cloneProperties(
+         *      ComponentPtr newObj) const override;
+         * @brief   重写基类接口
+         */
+        virtual TResult cloneProperties(ComponentPtr newObj) const override;
+
+        /**
+         * @fn  virtual void 
+         *      StaticBatch::onDetachSceneNode(SceneNode *node) override;
+         * @brief   重写基类接口，让被合并的结点恢复单独渲染
+         */
+        virtual void onDetachSceneNode(SceneNode *node) override;
+
+        /**
+         * @fn  void StaticBatch::releaseNodes();
+         * @brief   让被合并的结点恢复单独渲染
+         */
+        void releaseNodes();
+
+        /**
+         * @fn  TResult StaticBatch::setupVAO();
+         * @brief   用顶点缓冲区和合并后的索引创建索引缓冲区和 VAO
+         */
+        TResult setupVAO();
+
+        /**
+         * @fn  void StaticBatch::setupCulling();
+         * @brief   把结点包围盒整理成剔除用的 SoA 数组
+         */
+        void setupCulling();
+
+        /**
+         * @fn  TResult StaticBatch::writeIndices(const uint32_t *visibility);
+         * @brief   把可见结点的索引紧凑写入索引缓冲区，并设置 VAO 的绘制
+         *          索引数量
+         * @param [in]  visibility  : 可见性位图，为 nullptr 时全部可见.
+         */
+        TResult writeIndices(const uint32_t *visibility);
+
+    protected:
+        typedef TArray<SubMesh>         SubMeshes;
+        typedef TArray<SceneNodePtr>    SceneNodes;
+        typedef TArray<uint8_t>         Bytes;
+        typedef TArray<uint32_t>        Indices;
+        typedef TArray<Real>            Reals;
+
+        MaterialPtr             mMaterial;      /**< 材质 */
+        VertexDeclarationPtr    mDecl;          /**< 顶点声明 */
+        size_t                  mVertexSize;    /**< 顶点大小 */
+        size_t                  mVertexCount;   /**< 顶点数量 */
+        Bytes                   mVertices;      /**< 构建前的世界空间顶点 */
+        Indices                 mIndices;       /**< 合并后的全部索引 */
+        Bytes                   mDrawIndices;   /**< 写入索引缓冲区的临时数据 */
+        HardwareIndexBuffer::Type   mIndexType; /**< 索引类型 */
+
+        HardwareVertexBufferPtr mVBO;           /**< 顶点缓冲区 */
+        HardwareIndexBufferPtr  mIBO;           /**< 索引缓冲区 */
+        VertexArrayObjectPtr    mVAO;           /**< VAO */
+
+        SubMeshes               mSubMeshes;     /**< 合并的结点 */
+        SceneNodes              mNodes;         /**< 持有被合并结点的引用 */
+        Aabb                    mBound;         /**< 所有结点的包围盒 */
+
+        FrustumCuller           mCuller;        /**< 批量剔除 */
+        Reals                   mCenterX;       /**< 结点包围盒中心 x */
+        Reals                   mCenterY;       /**< 结点包围盒中心 y */
+        Reals                   mCenterZ;       /**< 结点包围盒中心 z */
+        Reals                   mExtentX;       /**< 结点包围盒 x 方向半长 */
+        Reals                   mExtentY;       /**< 结点包围盒 y 方向半长 */
+        Reals                   mExtentZ;       /**< 结点包围盒 z 方向半长 */
+        Bytes                   mLastPlanes;    /**< 结点上一次被剔除的平面 */
+        Indices                 mVisibility;    /**< 本次剔除的可见性位图 */
+        Indices                 mDrawn;         /**< 索引缓冲区对应的可见性位图 */
+        size_t                  mVisibleCount;  /**< 可见结点数量 */
+    };
+}
+
+
+#endif  /*__T3D_STATIC_BATCH_H__*/
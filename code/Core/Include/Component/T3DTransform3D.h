@@ -24,6 +24,7 @@
 
 #include "Component/T3DComponent.h"
 #include "Kernel/T3DTransform.h"
+#include "Scene/T3DTransformStore.h"
 
 
 namespace Tiny3D
@@ -43,10 +44,19 @@ namespace Tiny3D
     /**
      * @class   Transform3D
      * @brief   带变换属性的场景树结点
+     * @remarks 场景管理器提供变换存储时，局部变换同时写到存储里，修改时只
+     *          标记自己为脏，世界变换由场景管理器每帧统一计算后写回。
+     *          每个变换记住父结点的变换和计算时父变换的版本号，查询世界
+     *          变换时只要父变换版本号变了就重新计算，父变换本身也按同样的
+     *          规则查询，已经算好的祖先不会重复计算.
      */
     class T3D_ENGINE_API Transform3D : public Component
     {
+        friend class SceneNode;
+        friend class DefaultSceneMgr;
+
         T3D_DECLARE_CLASS();
+        T3D_DECLARE_POOL(Transform3D);
 
     public:
         /**
@@ -328,6 +338,14 @@ namespace Tiny3D
          */
         virtual ComponentPtr clone() const override;
 
+        /**
+         * @fn  virtual ComponentPtr Transform3D::instantiate() const override;
+         * @brief   重写基类接口，只复制局部的平移、旋转和缩放
+         * @return  返回一个新的3D变换对象.
+         * @remarks 世界变换挂到结点上后再重新计算，不从预制体复制.
+         */
+        virtual ComponentPtr instantiate() const override;
+
     protected:
         /**
          * @fn  Transform3D::Transform3D(ID uID = E_CID_AUTOMATIC);
@@ -365,6 +383,47 @@ namespace Tiny3D
 
         void notifyListener() const;
 
+        /**
+         * @fn  void Transform3D::markDirty();
+         * @brief   局部变换修改后标记为脏
+         * @remarks 使用变换存储时只更新存储里的局部变换，否则递归标记所有子结点.
+         */
+        void markDirty();
+
+        /**
+         * @fn  void Transform3D::attachStore(SceneNode *node);
+         * @brief   在场景管理器的变换存储里创建对应的变换
+         * @param [in]  node    : 所在的场景结点.
+         */
+        void attachStore(SceneNode *node);
+
+        /**
+         * @fn  void Transform3D::detachStore();
+         * @brief   从变换存储里销毁对应的变换
+         */
+        void detachStore();
+
+        /**
+         * @fn  void Transform3D::updateParent(SceneNode *parent);
+         * @brief   所在结点的父结点变化后，更新父变换，同时同步变换存储
+         * @param [in]  parent  : 新的父结点，为 nullptr 表示没有父结点.
+         */
+        void updateParent(SceneNode *parent);
+
+        /**
+         * @fn  void Transform3D::updateChildren(Transform3D *parent);
+         * @brief   所在结点的所有子结点的父变换设置为 parent
+         * @param [in]  parent  : 父变换，为 nullptr 表示没有父变换.
+         */
+        void updateChildren(Transform3D *parent);
+
+        /**
+         * @fn  void Transform3D::applyWorldTransform(const Transform &world);
+         * @brief   写回变换存储计算好的世界变换，并通知监听者
+         * @param [in]  world   : 世界变换.
+         */
+        void applyWorldTransform(const Transform &world);
+
     protected:
         typedef TList<ITransformListener *>     Listeners;
         typedef Listeners::iterator             ListenersItr;
@@ -380,6 +439,13 @@ namespace Tiny3D
         mutable Transform   mWorldTransform;/**< 从局部到世界的变换对象 */
 
         mutable bool        mIsDirty;       /**< 结点数据脏标记，需要重新计算 */
+
+        Transform3D         *mParent;       /**< 父结点的变换 */
+        mutable uint32_t    mWorldVersion;  /**< 世界变换每计算一次加一 */
+        mutable uint32_t    mParentVersion; /**< 计算世界变换时父变换的版本号 */
+
+        TransformStore          *mStore;        /**< 所在的变换存储 */
+        TransformStore::Handle  mStoreHandle;   /**< 在变换存储里的句柄 */
     };
 }
 
@@ -27,7 +27,7 @@ namespace Tiny3D
         if (pos != mPosition)
         {
             mPosition = pos;
-            setDirty(true, true);
+            markDirty();
         }
     }
 
@@ -53,7 +53,7 @@ namespace Tiny3D
         if (orientation != mOrientation)
         {
             mOrientation = orientation;
-            setDirty(true, true);
+            markDirty();
         }
     }
 
@@ -88,7 +88,7 @@ namespace Tiny3D
         if (scaling != mScaling)
         {
             mScaling = scaling;
-            setDirty(true, true);
+            markDirty();
         }
     }
 
@@ -114,7 +114,7 @@ namespace Tiny3D
         if (offset != Vector3::ZERO)
         {
             mPosition += offset;
-            setDirty(true, true);
+            markDirty();
         }
     }
 
@@ -140,7 +140,7 @@ namespace Tiny3D
         if (orientation != Quaternion::IDENTITY)
         {
             mOrientation *= orientation;
-            setDirty(true, true);
+            markDirty();
         }
     }
 
@@ -211,7 +211,7 @@ namespace Tiny3D
         if (scaling != mScaling)
         {
             mScaling = scaling;
-            setDirty(true, true);
+            markDirty();
         }
     }
 
@@ -371,6 +371,15 @@ namespace Tiny3D
          */
         TResult loadConfig(const String &cfgPath);
 
+        /**
+         * @fn  TResult Agent::initJobSystem();
+         * @brief   初始化任务系统，工作线程数量由配置文件 Job/WorkerCount 
+         *          指定，负数表示按照硬件线程数量自动设置。没有配置时
+         *          不创建工作线程
+         * @return  成功返回 T3D_OK.
+         */
+        TResult initJobSystem();
+
         /**
          * @fn  TResult Agent::loadPlugins();
          * @brief   加载配置文件中指定的插件
@@ -420,6 +429,7 @@ namespace Tiny3D
         Logger                  *mLogger;           /**< 日志对象 */
         EventManager            *mEventMgr;         /**< 事件管理器对象 */
         ObjectTracer            *mObjTracer;        /**< 对象内存跟踪 */
+        JobSystem               *mJobSystem;        /**< 任务系统 */
 
         RenderWindowPtr         mDefaultWindow;     /**< 默认渲染窗口 */
 
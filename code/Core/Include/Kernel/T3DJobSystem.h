@@ -0,0 +1,129 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#ifndef __T3D_JOB_SYSTEM_H__
+#define __T3D_JOB_SYSTEM_H__
+
+
+#include "T3DPrerequisites.h"
+#include "T3DTypedef.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+
+namespace Tiny3D
+{
+    /**
+     * @class   JobSystem
+     * @brief   任务系统
+     * @remarks 启动时创建固定数量的工作线程，parallelFor 把一段索引区间切成
+     *          若干块，工作线程和调用线程一起领取执行，全部完成才返回。
+     *          每个线程有固定的线程序号，调用线程为0，工作线程从1开始，
+     *          任务可以用线程序号访问各自的数据，不用加锁。
+     *          同一时间只执行一个 parallelFor，在任务里再调用 parallelFor
+     *          或者没有工作线程时，直接在当前线程执行。
+     */
+    class T3D_ENGINE_API JobSystem : public Singleton<JobSystem>
+    {
+        T3D_DISABLE_COPY(JobSystem);
+
+    public:
+        /**
+         * @brief 任务函数
+         * @param [in] begin : 本块起始索引
+         * @param [in] end : 本块结束索引，不包含
+         * @param [in] thread : 执行本块的线程序号
+         */
+        typedef std::function<void(size_t begin, size_t end, size_t thread)>
+            RangeJob;
+
+        /**
+         * @brief 构造函数
+         * @param [in] workerCount : 工作线程数量，不包括调用线程，0表示全部
+         *      任务都在调用线程执行
+         */
+        JobSystem(size_t workerCount);
+
+        /**
+         * @brief 析构函数，等待所有工作线程退出
+         */
+        virtual ~JobSystem();
+
+        /**
+         * @brief 获取工作线程数量
+         */
+        size_t getWorkerCount() const { return mWorkers.size(); }
+
+        /**
+         * @brief 获取参与执行任务的线程数量，也就是按线程分配数据的份数
+         */
+        size_t getThreadCount() const { return mWorkers.size() + 1; }
+
+        /**
+         * @brief 获取当前线程的线程序号，不是工作线程时返回0
+         */
+        static size_t getThreadIndex();
+
+        /**
+         * @brief 并行执行一段索引区间
+         * @param [in] count : 索引数量
+         * @param [in] grain : 每块的索引数量，0 表示按照线程数量自动切分
+         * @param [in] job : 任务函数
+         */
+        void parallelFor(size_t count, size_t grain, const RangeJob &job);
+
+    protected:
+        /**
+         * @brief 工作线程主循环
+         */
+        void workingProcedure(size_t index);
+
+        /**
+         * @brief 领取并执行当前任务的块，直到领完
+         */
+        void executeChunks(size_t thread);
+
+    protected:
+        typedef TArray<std::thread>     Workers;
+
+        Workers                 mWorkers;       /**< 工作线程 */
+
+        std::mutex              mMutex;         /**< 保护下面的任务状态 */
+        std::condition_variable mWakeCond;      /**< 通知工作线程有新任务 */
+        std::condition_variable mDoneCond;      /**< 通知调用线程任务完成 */
+        uint64_t                mGeneration;    /**< 任务编号，每次 parallelFor 加一 */
+        bool                    mIsRunning;     /**< 工作线程是否继续运行 */
+
+        const RangeJob          *mJob;          /**< 当前任务 */
+        size_t                  mCount;         /**< 当前任务的索引数量 */
+        size_t                  mGrain;         /**< 当前任务每块的索引数量 */
+        size_t                  mChunkCount;    /**< 当前任务的块数量 */
+        std::atomic<size_t>     mNextChunk;     /**< 下一个要领取的块 */
+        size_t                  mActiveWorkers; /**< 还在执行当前任务的工作线程 */
+    };
+
+    #define T3D_JOB_SYSTEM      (JobSystem::getInstance())
+}
+
+
+#endif  /*__T3D_JOB_SYSTEM_H__*/
@@ -25,6 +25,7 @@
 #include "T3DPrerequisites.h"
 #include "T3DTypedef.h"
 #include "Kernel/T3DObject.h"
+#include "Kernel/T3DStringInterner.h"
 
 
 namespace Tiny3D
@@ -58,6 +59,11 @@ namespace Tiny3D
             SCENE_NODE,        /**< 场景结点 */
         };
 
+        /**
+         * @brief   子结点数量超过该值后，在添加子结点时建立子结点索引
+         */
+        static const size_t CHILD_INDEX_THRESHOLD = 16;
+
         /**
          * @fn  virtual Node::~Node();
          * @brief   析构函数
@@ -100,6 +106,14 @@ namespace Tiny3D
          */
         const String &getName() const;
 
+        /**
+         * @fn  NameID Node::getNameID() const;
+         * @brief   获取结点名称ID
+         * @return  返回结点名称ID.
+         * @sa  StringInterner
+         */
+        NameID getNameID() const;
+
         /**
          * @fn  virtual TResult Node::addChild(NodePtr node);
          * @brief   添加一个子结点
@@ -174,6 +188,32 @@ namespace Tiny3D
          */
         NodePtr getChild(const String &name) const;
 
+        /**
+         * @brief 返回指定名称的子结点
+         * @param [in] name : 子结点名称，不要求以'\0'结尾
+         * @param [in] length : 名称长度
+         * @return 返回子结点对象
+         * @note 用于从较长字符串中截取片段直接查找，不产生临时 String 对象
+         */
+        NodePtr getChild(const char *name, size_t length) const;
+
+        /**
+         * @brief 返回指定名称ID的子结点
+         * @param [in] nameID : 子结点名称ID，由 StringInterner 生成
+         * @return 返回子结点对象
+         * @note 只比较整数，频繁按同一名称查找时先缓存名称ID再调用本接口
+         */
+        NodePtr getChildByNameID(NameID nameID) const;
+
+        /**
+         * @brief 根据路径查找子孙结点
+         * @param [in] path : 以separator分隔的结点名称路径，如 "level/room12/lamp3"
+         * @param [in] separator : 路径分隔符
+         * @return 找到返回对应结点对象，否则返回 nullptr
+         * @note 路径相对于本结点，空的路径段会被忽略，整个查找过程不分配内存
+         */
+        NodePtr findChildByPath(const char *path, char separator = '/') const;
+
         /**
          * @brief 获取前一个兄弟结点
          */
@@ -237,11 +277,52 @@ namespace Tiny3D
          */
         ID makeGlobalID() const;
 
+        /**
+         * @brief 查找子结点，不增加引用计数
+         */
+        Node *lookupChild(NameID nameID) const;
+
+        /**
+         * @brief 把子结点从子结点链表中断开
+         */
+        void detachChild(Node *child);
+
+        /**
+         * @brief 建立子结点索引
+         * @remarks 只在增删子结点和改名时调用，查找接口不会修改索引
+         */
+        void buildChildIndex();
+
+        /**
+         * @brief 销毁子结点索引
+         */
+        void destroyChildIndex();
+
+        /**
+         * @brief 按子结点链表重新建立索引
+         */
+        void rebuildChildIndex();
+
+        /**
+         * @brief 把子结点加入索引，返回 false 表示已有相同ID或名称的子结点
+         */
+        bool indexChild(Node *child);
+
+        /**
+         * @brief 把子结点从索引中移除
+         * @return 移除的项遮住了重复项，需要重建索引时返回 true
+         */
+        bool unindexChild(Node *child);
+
     private:
+        struct ChildIndex;
+
         ID          mID;            /**< 结点ID */
         String      mName;          /**< 结点名称 */
-        
+        NameID      mNameID;        /**< 结点名称ID */
+
         size_t      mChildrenCount; /**< 子结点数量 */
+        ChildIndex  *mChildIndex;   /**< 子结点索引，子结点少时为空 */
         NodePtr     mParent;        /**< 父结点 */
         NodePtr     mFirstChild;    /**< 第一个子结点 */
         NodePtr     mLastChild;     /**< 最后一个子结点 */
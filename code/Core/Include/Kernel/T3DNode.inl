@@ -25,14 +25,14 @@ namespace Tiny3D
         return mID;
     }
 
-    inline void Node::setName(const String &name)
+    inline const String &Node::getName() const
     {
-        mName = name;
+        return mName;
     }
 
-    inline const String &Node::getName() const
+    inline NameID Node::getNameID() const
     {
-        return mName;
+        return mNameID;
     }
 
     inline NodePtr Node::getFirstChild() const
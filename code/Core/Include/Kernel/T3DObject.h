@@ -23,6 +23,11 @@
 
 
 #include "T3DPrerequisites.h"
+#include "Memory/T3DObjectPool.h"
+
+#if defined (T3D_ATOMIC_REFCOUNT) || defined (T3D_REFCOUNT_STATS)
+#include <atomic>
+#endif
 
 
 namespace Tiny3D
@@ -30,6 +35,8 @@ namespace Tiny3D
     /**
      * @class   Object
      * @brief   引擎所有对象基类
+     * @remarks 定义了 T3D_ATOMIC_REFCOUNT 时引用计数是原子的，对象可以在多个
+     *          线程之间传递和持有，否则只能在一个线程里使用.
      */
     class T3D_ENGINE_API Object
     {
@@ -68,11 +75,56 @@ namespace Tiny3D
          */
         uint32_t referCount() const
         {
+#if defined (T3D_ATOMIC_REFCOUNT)
+            return mReferCount.load(std::memory_order_relaxed);
+#else
             return mReferCount;
+#endif
         }
 
+#if defined (T3D_REFCOUNT_STATS)
+        /**
+         * @fn  static uint64_t Object::getAcquireCount();
+         * @brief   返回所有对象 acquire 的累计调用次数
+         * @remarks 只有定义了 T3D_REFCOUNT_STATS 才统计，用于测量引用计数开销.
+         */
+        static uint64_t getAcquireCount();
+
+        /**
+         * @fn  static uint64_t Object::getReleaseCount();
+         * @brief   返回所有对象 release 的累计调用次数
+         * @remarks 只有定义了 T3D_REFCOUNT_STATS 才统计，用于测量引用计数开销.
+         */
+        static uint64_t getReleaseCount();
+#endif
+
     private:
-        uint32_t    mReferCount;
+        friend class ObjectTracer;
+
+        /**
+         * @fn  void Object::traceClass();
+         * @brief   第一次被持有时对象已经构造完，计入实际的类
+         * @remarks 定义了 T3D_ATOMIC_REFCOUNT 时用 CAS 认领，保证每个对象
+         *          只计数一次.
+         */
+        void traceClass();
+
+        /** 对象所属类的序号掩码 */
+        static const uint32_t TRACE_CLASS_MASK = 0x7FFFFFFF;
+        /** 对象被采样的标记 */
+        static const uint32_t TRACE_SAMPLED = 0x80000000;
+
+#if defined (T3D_ATOMIC_REFCOUNT)
+        std::atomic<uint32_t>   mReferCount;
+#else
+        uint32_t                mReferCount;
+#endif
+
+#if defined (T3D_ATOMIC_REFCOUNT)
+        std::atomic<uint32_t>   mTraceInfo; /**< 所属类序号和采样标记 */
+#else
+        uint32_t                mTraceInfo; /**< 所属类序号和采样标记 */
+#endif
     };
 }
 
@@ -26,6 +26,7 @@
 #include "T3DTypedef.h"
 #include "T3DObject.h"
 #include "Kernel/T3DAgent.h"
+#include "Kernel/T3DStringInterner.h"
 #include "Kernel/T3DBlendMode.h"
 #include "Kernel/T3DCommon.h"
 #include "Resource/T3DGPUProgram.h"
@@ -77,6 +78,13 @@ namespace Tiny3D
          */
         const String &getName() const;
 
+        /**
+         * @fn  NameID Pass::getNameID() const
+         * @brief   獲取 Pass 名稱ID
+         * @returns 返回 Pass 名称ID.
+         */
+        NameID getNameID() const;
+
         /**
          * @fn  TResult Pass::setGPUProgram(GPUProgramRefPtr program);
          * @brief   设置 Pass 使用的 GPU 程序对象
@@ -1046,6 +1054,7 @@ namespace Tiny3D
 
         Technique   *mParent;   /**< 擁有該 Pass 對象的 Technique 對象 */
         String      mName;      /**< Pass 名稱 */
+        NameID      mNameID;    /**< Pass 名稱ID */
 
         //---------------------------------------
         // Command : ambient
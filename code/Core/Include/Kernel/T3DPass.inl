@@ -29,6 +29,13 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    inline NameID Pass::getNameID() const
+    {
+        return mNameID;
+    }
+
+    //--------------------------------------------------------------------------
+
     inline GPUProgramPtr Pass::getGPUProgram() const
     {
         return mGPUProgram;
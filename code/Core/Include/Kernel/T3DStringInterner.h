@@ -0,0 +1,88 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#ifndef __T3D_STRING_INTERNER_H__
+#define __T3D_STRING_INTERNER_H__
+
+
+#include "T3DPrerequisites.h"
+
+
+namespace Tiny3D
+{
+    /**
+     * @brief   名称ID，由 StringInterner 根据字符串内容生成
+     */
+    typedef uint64_t    NameID;
+
+    /**
+     * @class   StringInterner
+     * @brief   全局字符串驻留表，把名称转换成稳定的 64 位 ID
+     * @remarks 名称ID是名称内容的 64 位 FNV-1a 哈希值，同一个字符串在不同进程、
+     *          不同平台下得到的ID都相同，可以直接序列化。查找时只需比较整数。
+     *          调试版会记录每个ID对应的字符串，一旦不同字符串得到相同ID，
+     *          立即报错并断言，发布版不做记录，不加锁也不分配内存.
+     */
+    class T3D_ENGINE_API StringInterner
+    {
+    public:
+        /**
+         * @fn  static NameID StringInterner::intern(const char *str, 
+         *      size_t length);
+         * @brief   获取字符串对应的名称ID
+         * @param [in]  str     : 字符串，不要求以'\0'结尾.
+         * @param [in]  length  : 字符串长度.
+         * @return  返回名称ID.
+         */
+        static NameID intern(const char *str, size_t length);
+
+        /**
+         * @fn  static NameID StringInterner::intern(const String &str);
+         * @brief   获取字符串对应的名称ID
+         * @param [in]  str : 字符串.
+         * @return  返回名称ID.
+         */
+        static NameID intern(const String &str);
+
+        /**
+         * @fn  static NameID StringInterner::combine(NameID id, 
+         *      uint64_t value);
+         * @brief   在名称ID基础上混入一个整数，生成派生ID
+         * @param [in]  id      : 名称ID.
+         * @param [in]  value   : 要混入的整数.
+         * @return  返回派生ID.
+         * @remarks 派生ID不对应任何字符串，不会被记录，调用者自己保证唯一性.
+         */
+        static NameID combine(NameID id, uint64_t value);
+
+        /**
+         * @fn  static size_t StringInterner::getInternedCount();
+         * @brief   获取已经记录的字符串数量
+         * @return  调试版返回记录的字符串数量，发布版始终返回 0.
+         */
+        static size_t getInternedCount();
+
+    private:
+        static NameID hash(const char *str, size_t length);
+    };
+}
+
+
+#endif  /*__T3D_STRING_INTERNER_H__*/
@@ -25,6 +25,7 @@
 #include "T3DPrerequisites.h"
 #include "T3DTypedef.h"
 #include "T3DObject.h"
+#include "Kernel/T3DStringInterner.h"
 
 namespace Tiny3D
 {
@@ -71,6 +72,13 @@ namespace Tiny3D
          */
         const String &getName() const;
 
+        /**
+         * @fn  NameID Technique::getNameID() const;
+         * @brief   獲取 Technique 的名稱ID
+         * @return  The name identifier.
+         */
+        NameID getNameID() const;
+
         uint32_t getRenderQueue() const;
 
         void setRenderQueue(uint32_t queue);
@@ -149,6 +157,7 @@ namespace Tiny3D
     protected:
         Material    *mParent;   /**< The parent */
         String      mName;      /**< The name */
+        NameID      mNameID;    /**< The name identifier */
         Passes      mPasses;    /**< The passes */
 
         //---------------------------------------
@@ -29,6 +29,13 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    inline NameID Technique::getNameID() const
+    {
+        return mNameID;
+    }
+
+    //--------------------------------------------------------------------------
+
     inline uint32_t Technique::getRenderQueue() const
     {
         return mRenderQueue;
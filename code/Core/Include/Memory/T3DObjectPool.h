@@ -0,0 +1,198 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#ifndef __T3D_OBJECT_POOL_H__
+#define __T3D_OBJECT_POOL_H__
+
+
+#include "T3DPrerequisites.h"
+#include <mutex>
+
+
+namespace Tiny3D
+{
+    /**
+     * @class   ObjectPool
+     * @brief   按类分开的定长对象池
+     * @remarks 每次从系统申请一整块能放下若干个对象的内存，释放的对象挂到
+     *          空闲链表上复用，内存只增不减，进程结束才还给系统。
+     *          通过 T3D_DECLARE_POOL 和 T3D_IMPLEMENT_POOL 让某个类的 new 和
+     *          delete 走对象池。比对象池大小大的派生类直接用系统内存分配.
+     */
+    class T3D_ENGINE_API ObjectPool
+    {
+        T3D_DISABLE_COPY(ObjectPool);
+
+    public:
+        /**
+         * @struct  Stats
+         * @brief   对象池统计信息
+         */
+        struct Stats
+        {
+            const char  *name;          /**< 类名 */
+            size_t      objectSize;     /**< 池里每个对象占用的字节数 */
+            size_t      slabObjects;    /**< 每块内存能放下的对象数 */
+            size_t      slabCount;      /**< 已经申请的内存块数 */
+            size_t      reservedBytes;  /**< 已经申请的总字节数 */
+            size_t      liveCount;      /**< 当前存活的对象数 */
+            size_t      peakCount;      /**< 存活对象数的峰值 */
+            size_t      allocCount;     /**< 累计分配次数 */
+            size_t      freeCount;      /**< 累计释放次数 */
+            size_t      fallbackCount;  /**< 累计走系统内存分配的次数 */
+        };
+
+        typedef TArray<Stats>   StatsList;
+
+        static const size_t DEFAULT_SLAB_OBJECTS = 256;
+
+        /**
+         * @fn  ObjectPool::ObjectPool(const char *name, size_t objectSize, 
+         *      size_t slabObjects = DEFAULT_SLAB_OBJECTS);
+         * @brief   构造函数
+         * @param [in]  name        : 类名，用于统计.
+         * @param [in]  objectSize  : 对象大小.
+         * @param [in]  slabObjects : 每次申请的内存块能放下的对象数.
+         */
+        ObjectPool(const char *name, size_t objectSize, 
+            size_t slabObjects = DEFAULT_SLAB_OBJECTS);
+
+        /**
+         * @fn  ObjectPool::~ObjectPool();
+         * @brief   析构函数
+         */
+        ~ObjectPool();
+
+        /**
+         * @fn  void *ObjectPool::allocate(size_t size);
+         * @brief   分配一个对象的内存
+         * @param [in]  size    : 对象实际大小.
+         * @return  返回对象内存地址.
+         */
+        void *allocate(size_t size);
+
+        /**
+         * @fn  void ObjectPool::deallocate(void *ptr, size_t size);
+         * @brief   释放一个对象的内存
+         * @param [in]  ptr     : 对象内存地址.
+         * @param [in]  size    : 对象实际大小，跟分配时一致.
+         */
+        void deallocate(void *ptr, size_t size);
+
+        /**
+         * @fn  void ObjectPool::getStats(Stats &stats) const;
+         * @brief   获取对象池统计信息
+         * @param [out] stats   : 返回的统计信息.
+         */
+        void getStats(Stats &stats) const;
+
+        /**
+         * @fn  static void ObjectPool::getAllStats(StatsList &stats);
+         * @brief   获取所有对象池的统计信息
+         * @param [out] stats   : 返回的统计信息列表.
+         */
+        static void getAllStats(StatsList &stats);
+
+        /**
+         * @fn  static void ObjectPool::dumpStats();
+         * @brief   输出所有对象池的统计信息到日志
+         */
+        static void dumpStats();
+
+    protected:
+        /**
+         * @struct  FreeNode
+         * @brief   空闲对象链表结点，直接放在空闲对象的内存里
+         */
+        struct FreeNode
+        {
+            FreeNode    *next;
+        };
+
+        /**
+         * @fn  void ObjectPool::allocateSlab();
+         * @brief   申请一块新内存，切成对象挂到空闲链表上
+         */
+        void allocateSlab();
+
+        /**
+         * @fn  static std::mutex &ObjectPool::getRegistryMutex();
+         * @brief   保护对象池链表的锁
+         */
+        static std::mutex &getRegistryMutex();
+
+        typedef TArray<void*>   Slabs;
+
+        const char      *mName;         /**< 类名 */
+        size_t          mObjectSize;    /**< 对齐后的对象大小 */
+        size_t          mSlabObjects;   /**< 每块内存能放下的对象数 */
+
+        FreeNode        *mFreeList;     /**< 空闲对象链表 */
+        Slabs           mSlabs;         /**< 已申请的内存块 */
+
+        size_t          mLiveCount;     /**< 当前存活的对象数 */
+        size_t          mPeakCount;     /**< 存活对象数的峰值 */
+        size_t          mAllocCount;    /**< 累计分配次数 */
+        size_t          mFreeCount;     /**< 累计释放次数 */
+        size_t          mFallbackCount; /**< 累计走系统内存分配的次数 */
+
+        mutable std::mutex  mMutex;     /**< 对象可能在工作线程创建和释放 */
+
+        ObjectPool      *mNext;         /**< 所有对象池串成的链表 */
+
+        static ObjectPool   *msFirstPool;
+    };
+
+#if defined (T3D_DISABLE_OBJECT_POOL)
+    #define T3D_DECLARE_POOL(cls)
+    #define T3D_IMPLEMENT_POOL(cls, slabObjects)
+#else
+    /**
+     * 放在类声明里，跟 T3D_DECLARE_CLASS 一起使用，让该类的对象从对象池分配
+     */
+    #define T3D_DECLARE_POOL(cls) \
+        public: \
+            static ObjectPool &getObjectPool(); \
+            static void *operator new(size_t size) \
+            { \
+                return getObjectPool().allocate(size); \
+            } \
+            static void operator delete(void *ptr, size_t size) \
+            { \
+                getObjectPool().deallocate(ptr, size); \
+            } \
+        private:
+
+    /**
+     * 放在类实现里，跟 T3D_IMPLEMENT_CLASS_x 一起使用。
+     * 对象池故意不释放，保证全局对象析构时还能正常归还内存
+     */
+    #define T3D_IMPLEMENT_POOL(cls, slabObjects) \
+        ObjectPool &cls::getObjectPool() \
+        { \
+            static ObjectPool *pool \
+                = new ObjectPool(#cls, sizeof(cls), slabObjects); \
+            return *pool; \
+        }
+#endif
+}
+
+
+#endif  /*__T3D_OBJECT_POOL_H__*/
@@ -24,6 +24,8 @@
 
 #include "T3DPrerequisites.h"
 #include "Kernel/T3DObject.h"
+#include <mutex>
+#include <atomic>
 
 
 namespace Tiny3D
@@ -31,8 +33,11 @@ namespace Tiny3D
     /**
      * @class   ObjectTracer
      * @brief   一个跟踪内存的类，能够跟踪所有Object其派生类内存泄漏的情况
-     * @remarks  这里的跟踪当对象数量很大的时候会有一定的性能损耗， 
-     *           建议这里在定位完内存问题就关闭掉跟踪.
+     * @remarks 每个类的存活数量、峰值和字节数由 Class 上的原子计数记录，
+     *          一直打开，开销只有对象创建和销毁时各一次原子操作。
+     *          打开跟踪后，每隔若干个对象采样一次，记录创建时的调用栈，
+     *          可以对比两个时间点的快照，找出新增的对象和泄漏的位置。
+     *          采样间隔越小开销越大，间隔为 1 时每个对象都记录.
      */
     class T3D_ENGINE_API ObjectTracer : public Singleton<ObjectTracer>
     {
@@ -40,12 +45,84 @@ namespace Tiny3D
         friend class Object;
 
     public:
+        /** 默认采样间隔 */
+        static const uint32_t DEFAULT_SAMPLE_INTERVAL;
+
+        /** 采样时记录的最大调用栈深度 */
+        static const size_t MAX_BACKTRACE_DEPTH = 16;
+
+        /**
+         * @struct  ClassInfo
+         * @brief   一个类的实例统计
+         */
+        struct ClassInfo
+        {
+            const Class *cls;           /**< 类 */
+            uint32_t    liveCount;      /**< 存活的实例数量 */
+            uint32_t    peakCount;      /**< 存活实例数量的峰值 */
+            uint64_t    totalCount;     /**< 累计创建的实例数量 */
+            size_t      bytes;          /**< 存活实例占用的字节数 */
+        };
+
+        /**
+         * @struct  SampleInfo
+         * @brief   一个被采样的存活对象
+         */
+        struct SampleInfo
+        {
+            const Object    *object;    /**< 对象 */
+            const Class     *cls;       /**< 对象的类 */
+            uint64_t        serial;     /**< 创建序号 */
+            size_t          depth;      /**< 调用栈深度 */
+            void            *frames[MAX_BACKTRACE_DEPTH];   /**< 调用栈 */
+        };
+
+        typedef TArray<ClassInfo>       ClassInfos;
+        typedef TArray<SampleInfo>      SampleInfos;
+
+        /**
+         * @struct  Snapshot
+         * @brief   某个时间点的对象快照
+         */
+        struct Snapshot
+        {
+            uint64_t    serial;         /**< 快照时的创建序号 */
+            ClassInfos  classes;        /**< 有过实例的类 */
+            SampleInfos samples;        /**< 存活的采样对象 */
+        };
+
+        /**
+         * @struct  ClassDelta
+         * @brief   一个类在两个快照之间的变化
+         */
+        struct ClassDelta
+        {
+            const Class *cls;           /**< 类 */
+            int64_t     liveDelta;      /**< 存活实例数量的变化 */
+            int64_t     bytesDelta;     /**< 存活实例字节数的变化 */
+        };
+
+        typedef TArray<ClassDelta>      ClassDeltas;
+
+        /**
+         * @struct  SnapshotDiff
+         * @brief   两个快照的差异
+         */
+        struct SnapshotDiff
+        {
+            ClassDeltas classes;        /**< 存活数量有变化的类 */
+            SampleInfos samples;        /**< 第一个快照之后创建，到第二个快照还存活的采样对象 */
+        };
+
         /**
-         * @fn  ObjectTracer::ObjectTracer(bool enabled = false);
+         * @fn  ObjectTracer::ObjectTracer(bool enabled = false, 
+         *      uint32_t sampleInterval = DEFAULT_SAMPLE_INTERVAL);
          * @brief   默认构造函数
-         * @param [in]  enabled (Optional) : 是否开启内存跟踪功能，默认是关闭的.
+         * @param [in]  enabled (Optional) : 是否开启采样跟踪，默认是关闭的.
+         * @param [in]  sampleInterval (Optional) : 每多少个对象采样一个.
          */
-        ObjectTracer(bool enabled = false);
+        ObjectTracer(bool enabled = false, 
+            uint32_t sampleInterval = DEFAULT_SAMPLE_INTERVAL);
 
         /**
          * @fn  virtual ObjectTracer::~ObjectTracer();
@@ -55,11 +132,43 @@ namespace Tiny3D
 
         /**
          * @fn  bool ObjectTracer::isTracingEnabled() const
-         * @brief   获取内存跟踪是否打开
+         * @brief   获取采样跟踪是否打开
          * @return  返回内存跟踪器工作状态.
          */
         bool isTracingEnabled() const { return mIsEnabled; }
 
+        /**
+         * @fn  void ObjectTracer::setSampleInterval(uint32_t interval);
+         * @brief   设置采样间隔
+         * @param [in]  interval    : 每多少个对象采样一个，0 表示不采样.
+         */
+        void setSampleInterval(uint32_t interval);
+
+        /**
+         * @fn  uint32_t ObjectTracer::getSampleInterval() const;
+         * @brief   获取采样间隔
+         */
+        uint32_t getSampleInterval() const;
+
+        /**
+         * @fn  void ObjectTracer::takeSnapshot(Snapshot &snapshot) const;
+         * @brief   获取当前所有类的实例统计和存活的采样对象
+         * @param [out] snapshot    : 返回的快照.
+         */
+        void takeSnapshot(Snapshot &snapshot) const;
+
+        /**
+         * @fn  static void ObjectTracer::diffSnapshots(
+         *      const Snapshot &before, const Snapshot &after, 
+         *      SnapshotDiff &diff);
+         * @brief   对比两个快照
+         * @param [in]  before  : 先拍的快照.
+         * @param [in]  after   : 后拍的快照.
+         * @param [out] diff    : 返回的差异.
+         */
+        static void diffSnapshots(const Snapshot &before, 
+            const Snapshot &after, SnapshotDiff &diff);
+
         /**
          * @fn  void ObjectTracer::dumpMemoryInfo() const;
          * @brief   输出当前内存信息到对应平台Console
@@ -77,28 +186,41 @@ namespace Tiny3D
          */
         void dumpMemoryInfo(FileDataStream &fs) const;
 
+        /**
+         * @fn  void ObjectTracer::dumpSnapshotDiff(
+         *      const SnapshotDiff &diff) const;
+         * @brief   输出快照差异到对应平台Console
+         * @param [in]  diff    : 快照差异.
+         */
+        void dumpSnapshotDiff(const SnapshotDiff &diff) const;
+
     protected:
         /**
-         * @fn  void ObjectTracer::addObject(Object *object)
-         * @brief   添加一个对象到内存跟踪器里
-         * @param [in,out]  object  If non-null, the object.
+         * @fn  void ObjectTracer::sampleObject(Object *object);
+         * @brief   对象开始计入所属的类时调用，按采样间隔记录调用栈
+         * @param [in]  object  : 对象.
          */
-        void addObject(Object *object)
-        {
-            if (mIsEnabled)
-                mObjects.insert(object);
-        }
+        void sampleObject(Object *object);
 
         /**
-         * @fn  void ObjectTracer::removeObject(Object *object)
-         * @brief   从内存跟踪器里移除一个对象
-         * @param [in,out]  object  If non-null, the object.
+         * @fn  void ObjectTracer::removeSample(const Object *object);
+         * @brief   被采样的对象销毁时调用
+         * @param [in]  object  : 对象.
          */
-        void removeObject(Object *object)
-        {
-            if (mIsEnabled)
-                mObjects.erase(object);
-        }
+        void removeSample(const Object *object);
+
+        /**
+         * @fn  static size_t ObjectTracer::captureBacktrace(void **frames, 
+         *      size_t maxDepth);
+         * @brief   获取当前调用栈，不支持的平台返回 0
+         */
+        static size_t captureBacktrace(void **frames, size_t maxDepth);
+
+        /**
+         * @fn  void ObjectTracer::printSample(const SampleInfo &sample) const;
+         * @brief   输出采样对象和调用栈
+         */
+        void printSample(const SampleInfo &sample) const;
 
         /**
          * @fn  void ObjectTracer::printInfo(const String &str) const;
@@ -107,13 +229,17 @@ namespace Tiny3D
          */
         void printInfo(const String &str) const;
 
-        typedef TSet<Object*>           Objects;
-        typedef Objects::iterator       ObjectsItr;
-        typedef Objects::const_iterator ObjectsConstItr;
-        typedef Objects::value_type     ObjectsValue;
+        typedef TMap<const Object*, SampleInfo> Samples;
+        typedef Samples::iterator               SamplesItr;
+        typedef Samples::const_iterator         SamplesConstItr;
+        typedef Samples::value_type             SamplesValue;
+
+        bool                    mIsEnabled;     /**< 是否开启了采样跟踪 */
+        std::atomic<uint32_t>   mSampleInterval;/**< 采样间隔 */
+        std::atomic<uint64_t>   mSerial;        /**< 对象创建序号 */
 
-        bool                    mIsEnabled;     /**< 是否开启了内存跟踪 */
-        Objects                 mObjects;       /**< 对象集合 */
+        mutable std::mutex      mMutex;         /**< 保护采样对象 */
+        Samples                 mSamples;       /**< 存活的采样对象 */
 
         mutable FileDataStream  *mStream;       /**< 临时输出对象，用于dumpMemoryInfo的时候 */
     };
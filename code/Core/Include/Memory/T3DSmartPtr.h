@@ -51,6 +51,8 @@ namespace Tiny3D
     template <typename T>
     class SmartPtr
     {
+        template <typename T2> friend class SmartPtr;
+
     public:
         static const SmartPtr NULL_PTR; /**< The null pointer */
 
@@ -84,6 +86,35 @@ namespace Tiny3D
             }
         }
 
+        /**
+         * @fn  SmartPtr::SmartPtr(SmartPtr &&rkPointer)
+         * @brief   Move constructor，直接接管引用，不改变引用计数
+         * @param [in,out]  rkPointer   The rk pointer.
+         */
+        SmartPtr(SmartPtr &&rkPointer) noexcept
+        {
+            mReferObject = rkPointer.mReferObject;
+            rkPointer.mReferObject = nullptr;
+        }
+
+        /**
+         * @fn  template <typename T2> SmartPtr::SmartPtr(
+         *      SmartPtr<T2> &&rkOther, 
+         *      typename std::enable_if<std::is_convertible<T2 *, 
+         *      T *>::value, void>::type ** = 0)
+         * @brief   Move constructor，直接接管引用，不改变引用计数
+         * @tparam  T2  Generic type parameter.
+         * @param [in,out]  rkOther     The rk other.
+         * @param [in,out]  parameter2  (Optional) If non-null, the second parameter.
+         */
+        template <typename T2>
+        SmartPtr(SmartPtr<T2> &&rkOther,
+            typename std::enable_if<std::is_convertible<T2 *, T *>::value, void>::type ** = 0) noexcept
+        {
+            mReferObject = rkOther.mReferObject;
+            rkOther.mReferObject = nullptr;
+        }
+
         /**
          * @fn  template <typename T2> SmartPtr::SmartPtr(
          *      const SmartPtr<T2> &rkOther, 
@@ -126,10 +157,11 @@ namespace Tiny3D
         }
 
         /**
-         * @fn  virtual SmartPtr::~SmartPtr()
+         * @fn  SmartPtr::~SmartPtr()
          * @brief   Destructor
+         * @remarks 不是虚函数，智能指针只有一个对象指针大小，不要派生
          */
-        virtual ~SmartPtr()
+        ~SmartPtr()
         {
             if (mReferObject != nullptr)
             {
@@ -219,6 +251,53 @@ namespace Tiny3D
             return *this;
         }
 
+        /**
+         * @fn  SmartPtr SmartPtr::&operator=(SmartPtr &&rkPointer)
+         * @brief   Move assignment operator，直接接管引用
+         * @param [in,out]  rkPointer   The rk pointer.
+         * @return  A shallow copy of this object.
+         */
+        SmartPtr &operator =(SmartPtr &&rkPointer) noexcept
+        {
+            if (this != &rkPointer)
+            {
+                Object *obj = mReferObject;
+                mReferObject = rkPointer.mReferObject;
+                rkPointer.mReferObject = nullptr;
+
+                if (obj != nullptr)
+                {
+                    obj->release();
+                }
+            }
+
+            return *this;
+        }
+
+        /**
+         * @fn  template <typename T2> SmartPtr 
+         *      SmartPtr::&operator=(SmartPtr<T2> &&rkOther)
+         * @brief   Move assignment operator，直接接管引用
+         * @tparam  T2  Generic type parameter.
+         * @param [in,out]  rkOther The rk other.
+         * @return  The result of the operation.
+         */
+        template <typename T2>
+        typename std::enable_if<std::is_convertible<T2 *, T *>::value, SmartPtr &>::type
+            operator =(SmartPtr<T2> &&rkOther) noexcept
+        {
+            Object *obj = mReferObject;
+            mReferObject = rkOther.mReferObject;
+            rkOther.mReferObject = nullptr;
+
+            if (obj != nullptr)
+            {
+                obj->release();
+            }
+
+            return *this;
+        }
+
         /**
          * @fn  template <typename T2> SmartPtr 
          *      SmartPtr::&operator=(const SmartPtr<T2> &rkOther)
@@ -25,6 +25,8 @@
 #include "T3DPrerequisites.h"
 #include "T3DTypedef.h"
 #include "Render/T3DRenderWindow.h"
+#include "Render/T3DRenderStatistics.h"
+#include "Render/T3DRenderStateCache.h"
 #include "Kernel/T3DCommon.h"
 
 
@@ -372,6 +374,30 @@ namespace Tiny3D
          */
         ViewportPtr getViewport() const;
 
+        /**
+         * @fn  RenderStatistics &RenderContext::getStatistics();
+         * @brief   获取渲染统计数据
+         * @return  返回渲染统计对象.
+         * @remarks 渲染队列和具体渲染器在渲染时填充，应用层在一帧渲染结束后查询.
+         */
+        RenderStatistics &getStatistics();
+
+        /**
+         * @fn  const RenderStatistics &RenderContext::getStatistics() const;
+         * @brief   获取渲染统计数据
+         * @return  返回渲染统计对象.
+         */
+        const RenderStatistics &getStatistics() const;
+
+        /**
+         * @fn  RenderStateCache &RenderContext::getStateCache();
+         * @brief   获取渲染状态缓存
+         * @return  返回渲染状态缓存对象.
+         * @remarks 外部直接修改了底层图形 API 状态时，需要调用
+         *          RenderStateCache::invalidate() 让缓存失效.
+         */
+        RenderStateCache &getStateCache();
+
         /**
          * @fn  virtual TResult 
          *      Renderer::bindGPUProgram(GPUProgramPtr program) = 0;
@@ -412,6 +438,33 @@ namespace Tiny3D
          */
         virtual TResult renderObject(VertexArrayObjectPtr vao) = 0;
 
+        /**
+         * @fn  virtual bool Renderer::isInstancingSupported() const;
+         * @brief   是否支持实例化渲染
+         * @return  支持返回 true，默认不支持.
+         * @remarks 实现了 renderObjectInstanced 的渲染平台需要重写本接口.
+         */
+        virtual bool isInstancingSupported() const;
+
+        /**
+         * @fn  virtual TResult Renderer::renderObjectInstanced(
+         *      VertexArrayObjectPtr vao, HardwareVertexBufferPtr instances, 
+         *      size_t startInstance, size_t instanceCount);
+         * @brief   实例化渲染对象
+         * @param [in]  vao             VAO 对象.
+         * @param [in]  instances       实例数据缓冲区，每个实例是一个 Matrix4 
+         *                              的世界变换.
+         * @param [in]  startInstance   第一个实例在实例缓冲区中的索引.
+         * @param [in]  instanceCount   实例数量.
+         * @return  调用成功返回 T3D_OK，不支持实例化的渲染平台返回 
+         *          T3D_ERR_RENDER_NOT_SUPPORTED.
+         * @remarks 实例化渲染不使用 setWorldTransform 设置的世界变换，调用
+         *          之后当前的世界变换也不再确定.
+         */
+        virtual TResult renderObjectInstanced(VertexArrayObjectPtr vao,
+            HardwareVertexBufferPtr instances, size_t startInstance,
+            size_t instanceCount);
+
     protected:
         /**
          * @fn  virtual TResult Renderer::postInit();
@@ -518,6 +571,9 @@ namespace Tiny3D
         RenderTargetPtr         mRenderTarget;      /**< 当前渲染目标 */
 
         ViewportPtr             mViewport;          /**< 当前渲染视口对象 */
+
+        RenderStatistics        mStatistics;        /**< 渲染统计数据 */
+        RenderStateCache        mStateCache;        /**< 渲染状态缓存 */
     };
 }
 
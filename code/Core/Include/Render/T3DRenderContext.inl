@@ -56,6 +56,27 @@ namespace Tiny3D
     }
 
     //--------------------------------------------------------------------------
+
+    inline RenderStatistics &RenderContext::getStatistics()
+    {
+        return mStatistics;
+    }
+
+    //--------------------------------------------------------------------------
+
+    inline const RenderStatistics &RenderContext::getStatistics() const
+    {
+        return mStatistics;
+    }
+
+    //--------------------------------------------------------------------------
+
+    inline RenderStateCache &RenderContext::getStateCache()
+    {
+        return mStateCache;
+    }
+
+    //--------------------------------------------------------------------------
 // 
 //     inline HardwareConstantBufferPtr Renderer::getConstantBuffer(size_t slot) const
 //     {
@@ -28,73 +28,19 @@
 
 namespace Tiny3D
 {
-    /**
-     * @brief 渲染分组
-     */
-    class T3D_ENGINE_API RenderGroup : public Object
-    {
-        T3D_DECLARE_CLASS();
-
-    public:
-        /**
-         * @brief 创建渲染分组
-         */
-        static RenderGroupPtr create();
-
-        /**
-         * @brief 析构函数
-         */
-        virtual ~RenderGroup();
-
-        /**
-         * @brief 添加一个渲染对象到渲染分组
-         * @param [in] renderable : 可渲染对象
-         * @return 成功返回 T3D_OK
-         */
-        TResult addRenderable(RenderablePtr renderable);
-
-        /**
-         * @brief 清空分组里的渲染对象
-         */
-        void clear();
-
-        /**
-         * @brief 渲染分组里的所有渲染对象
-         * @param [in] groupID : 渲染分组ID
-         * @param [in] renderer : 渲染器对象
-         * @return 成功返回 T3D_OK
-         */
-        TResult render(ID groupID, RenderContextPtr renderer);
-
-    protected:
-        /**
-         * @brief 构造函数
-         */
-        RenderGroup();
-
-        /**
-         * @brief 计算渲染图元数量
-         * @param [in] vao : 要渲染的VAO对象
-         * @return 返回需要渲染的图元数量
-         */
-        size_t calcPrimitiveCount(VertexArrayObjectPtr vao) const;
-
-    protected:
-        typedef TList<RenderablePtr>              RenderableList;
-        typedef RenderableList::iterator                RenderableListItr;
-        typedef RenderableList::const_iterator          RenderableListConstItr;
-
-        typedef TMap<MaterialPtr, RenderableList>   Renderables;
-        typedef Renderables::iterator                   RenderablesItr;
-        typedef Renderables::const_iterator             RenderablesConstItr;
-        typedef std::pair<MaterialPtr, RenderableList>  RenderablesValue;
-
-        Renderables     mRenderables;   /**< 可渲染对象列表 */
-    };
-
+    class RenderStatistics;
 
     /**
      * @brief 渲染队列
+     * @remarks 每个可渲染对象的每个 Pass 生成一个渲染项，用 64 位排序键描述
+     *      渲染顺序，存放在预分配的数组里，渲染前用基数排序。清空队列只重置
+     *      计数，不释放内存，队列规模稳定以后每帧不再有内存分配。
+     *      排序键最高 8 位是分组ID，其余位的排列由分组的排序策略决定：
+     *          STATE           : Pass(4) | GPU程序(16) | 纹理(16) | VAO(20)
+     *          FRONT_TO_BACK   : Pass(4) | 深度(20) | GPU程序(16) | 纹理(16)
+     *          BACK_TO_FRONT   : 反转深度(20) | Pass(4) | GPU程序(16) | 纹理(16)
+     *      排序后相邻的、使用同一个 Pass 和同一个 VAO 的渲染项，在渲染器支持
+     *      实例化的时候合并成一次实例化渲染，世界变换打包到每帧共用的实例缓冲区。
      */
     class T3D_ENGINE_API RenderQueue : public Object
     {
@@ -120,6 +66,26 @@ namespace Tiny3D
             E_GRPID_OVERLAY = 100               /**< UI分组 */
         };
 
+        /**
+         * @brief 渲染分组内的排序策略
+         */
+        enum class SortPolicy : uint8_t
+        {
+            STATE = 0,          /**< 只按照渲染状态排序，减少状态切换 */
+            FRONT_TO_BACK,      /**< 由近到远，充分利用提前深度测试 */
+            BACK_TO_FRONT,      /**< 由远到近，半透明物体正确混合 */
+        };
+
+        /**
+         * @brief 渲染队列默认预分配的渲染项数量
+         */
+        static const size_t DEFAULT_CAPACITY;
+
+        /**
+         * @brief 默认的合并实例化渲染的最少渲染项数量
+         */
+        static const size_t DEFAULT_INSTANCING_THRESHOLD;
+
         /**
          * @brief 创建渲染队列对象
          */
@@ -130,17 +96,80 @@ namespace Tiny3D
          */
         virtual ~RenderQueue();
 
+        /**
+         * @brief 设置渲染分组的排序策略
+         * @param [in] groupID : 分组ID
+         * @param [in] policy : 排序策略
+         * @remarks 默认实体、自动和线框分组由近到远，半透明分组由远到近，
+         *      其他分组只按照渲染状态排序
+         */
+        void setSortPolicy(uint32_t groupID, SortPolicy policy);
+
+        /**
+         * @brief 获取渲染分组的排序策略
+         * @param [in] groupID : 分组ID
+         */
+        SortPolicy getSortPolicy(uint32_t groupID) const;
+
+        /**
+         * @brief 设置裁剪使用的相机，之后加入队列的对象用相机视图矩阵计算深度
+         * @param [in] camera : 相机对象
+         */
+        void setCamera(Camera *camera);
+
         /**
          * @brief 添加可渲染对象到指定渲染分组
          * @param [in] groupID : 分组ID
          * @param [in] renderable : 可渲染对象
          * @return 成功返回 T3D_OK
          * @see enum GroupID
+         * @remarks 队列不持有可渲染对象的引用，可渲染对象在渲染结束前必须有效。
+         *      分组需要按照深度排序时，在这里用相机视图矩阵计算深度
+         */
+        TResult addRenderable(uint32_t groupID, Renderable *renderable);
+
+        /**
+         * @brief 设置按线程划分的渲染项分桶数量，并清空所有分桶
+         * @param [in] count : 分桶数量，一般是任务系统的线程数量
+         * @remarks 多个线程同时裁剪时，每个线程往自己的分桶里添加，
+         *      全部完成后调用 mergeBuckets 合并到队列里，整个过程不用加锁
+         */
+        void setBucketCount(size_t count);
+
+        /**
+         * @brief 获取分桶数量
          */
-        TResult addRenderable(uint32_t groupID, RenderablePtr renderable);
+        size_t getBucketCount() const { return mBuckets.size(); }
 
         /**
-         * @brief 清空渲染队列
+         * @brief 添加可渲染对象到指定分桶
+         * @param [in] bucket : 分桶索引，同一时间一个分桶只能由一个线程使用
+         * @param [in] groupID : 分组ID
+         * @param [in] renderable : 可渲染对象
+         * @return 成功返回 T3D_OK
+         * @remarks 除了写入的分桶，只读取队列的状态，可以在多个线程同时调用
+         */
+        TResult addRenderable(size_t bucket, uint32_t groupID, 
+            Renderable *renderable);
+
+        /**
+         * @brief 把所有分桶的渲染项按照分桶顺序追加到队列，并清空分桶
+         */
+        void mergeBuckets();
+
+        /**
+         * @brief 设置合并实例化渲染的最少渲染项数量
+         * @param [in] threshold : 渲染项数量，0 表示不使用实例化渲染
+         */
+        void setInstancingThreshold(size_t threshold);
+
+        /**
+         * @brief 获取合并实例化渲染的最少渲染项数量
+         */
+        size_t getInstancingThreshold() const;
+
+        /**
+         * @brief 清空渲染队列，保留已经分配的内存
          */
         void clear();
 
@@ -149,7 +178,18 @@ namespace Tiny3D
          * @param [in] renderer : 渲染器
          * @return 成功返回 T3D_OK
          */
-        TResult render(RenderContextPtr renderer);
+        TResult render(RenderContext *renderer);
+
+        /**
+         * @brief 预分配渲染项
+         * @param [in] capacity : 渲染项数量
+         */
+        void reserve(size_t capacity);
+
+        /**
+         * @brief 获取当前队列中的渲染项数量
+         */
+        size_t getItemCount() const { return mItemCount; }
 
     protected:
         /**
@@ -157,13 +197,120 @@ namespace Tiny3D
          */
         RenderQueue();
 
+        /**
+         * @brief 渲染项
+         */
+        struct RenderItem
+        {
+            uint64_t    key;            /**< 排序键 */
+            Renderable  *renderable;    /**< 可渲染对象 */
+            Pass        *pass;          /**< 要渲染的 Pass */
+            VertexArrayObject   *vao;   /**< 要渲染的 VAO */
+            uint32_t    groupID;        /**< 渲染分组ID */
+        };
+
+        /**
+         * @brief 合并成一次实例化渲染的连续渲染项
+         */
+        struct InstanceRun
+        {
+            size_t  first;              /**< 第一个渲染项索引 */
+            size_t  count;              /**< 渲染项数量 */
+            size_t  startInstance;      /**< 在实例缓冲区中的起始索引 */
+        };
+
+        typedef TArray<RenderItem>      RenderItems;
+        typedef TArray<InstanceRun>     InstanceRuns;
+        typedef TArray<Matrix4>         InstanceData;
+
+        /**
+         * @brief 一个线程使用的渲染项分桶，跟队列一样只重置计数不释放内存
+         */
+        struct Bucket
+        {
+            RenderItems items;          /**< 渲染项数组 */
+            size_t      count;          /**< 当前渲染项数量 */
+        };
+
+        typedef TArray<Bucket>          Buckets;
+
+        enum SortKey
+        {
+            E_KEY_TEXTURE_BITS = 16,
+            E_KEY_PROGRAM_BITS = 16,
+            E_KEY_STATE_BITS = E_KEY_PROGRAM_BITS + E_KEY_TEXTURE_BITS,
+            E_KEY_DEPTH_BITS = 20,
+            E_KEY_VAO_BITS = E_KEY_DEPTH_BITS,
+            E_KEY_PASS_BITS = 4,
+            E_KEY_GROUP_BITS = 8,
+            E_KEY_GROUP_SHIFT = 64 - E_KEY_GROUP_BITS,
+            E_KEY_MAX_GROUPS = 1 << E_KEY_GROUP_BITS,
+        };
+
+        /**
+         * @brief 生成排序键
+         */
+        static uint64_t makeSortKey(uint32_t groupID, SortPolicy policy,
+            size_t pass, const void *program, const void *texture, 
+            const void *vao, uint32_t depth);
+
+        /**
+         * @brief 计算可渲染对象在相机空间的深度，并量化到排序键的深度位数
+         */
+        uint32_t calcDepth(Renderable *renderable) const;
+
+        /**
+         * @brief 把对象地址散列成指定位数的值，用于排序键里区分不同对象
+         */
+        static uint64_t hashPointer(const void *ptr, uint32_t bits);
+
+        /**
+         * @brief 为可渲染对象的每个 Pass 生成渲染项，追加到指定数组
+         * @param [in,out] items : 渲染项数组，容量不够时扩大一倍
+         * @param [in,out] count : 数组中已经使用的渲染项数量
+         */
+        void appendItems(RenderItems &items, size_t &count, uint32_t groupID,
+            Renderable *renderable) const;
+
+        /**
+         * @brief 计算渲染图元数量
+         * @param [in] vao : 要渲染的VAO对象
+         * @return 返回需要渲染的图元数量
+         */
+        static size_t calcPrimitiveCount(VertexArrayObject *vao);
+
+        /**
+         * @brief 按照排序键对渲染项做基数排序
+         */
+        void sort();
+
+        /**
+         * @brief 查找可以合并实例化渲染的连续渲染项，并把世界变换写入实例缓冲区
+         * @return 实例缓冲区创建或者写入失败时返回错误码，这时全部逐个渲染
+         */
+        TResult buildInstanceRuns();
+
+        /**
+         * @brief 逐个渲染一段渲染项
+         */
+        void renderItems(RenderContext *renderer, RenderStatistics &stats,
+            size_t first, size_t count);
+
     protected:
-        typedef TMap<uint32_t, RenderGroupPtr>  RenderableGroup;
-        typedef RenderableGroup::iterator       RenderableGroupItr;
-        typedef RenderableGroup::const_iterator RenderableGroupConstItr;
-        typedef TPair<uint32_t, RenderGroupPtr> RenderableGroupValue;
+        RenderItems     mItems;         /**< 渲染项数组 */
+        RenderItems     mScratch;       /**< 基数排序用的临时数组 */
+        size_t          mItemCount;     /**< 当前渲染项数量 */
+        Buckets         mBuckets;       /**< 按线程划分的渲染项分桶 */
+
+        SortPolicy      mSortPolicies[E_KEY_MAX_GROUPS];    /**< 各个分组排序策略 */
+
+        Real            mDepthAxis[4];  /**< 视图矩阵第三行取反，点乘得到深度 */
+        Real            mInvFar;        /**< 远平面距离的倒数 */
 
-        RenderableGroup     mGroups;        /**< 渲染分组 */
+        size_t          mInstancingThreshold;   /**< 合并实例化渲染的最少数量 */
+        InstanceRuns    mInstanceRuns;  /**< 本帧合并实例化渲染的渲染项区间 */
+        InstanceData    mInstanceData;  /**< 本帧所有实例的世界变换 */
+        HardwareVertexBufferPtr mInstanceBuffer;    /**< 每帧共用的实例缓冲区 */
     };
 }
 
@@ -67,6 +67,11 @@ namespace Tiny3D
         void setBlendOpAlpha(int32_t idx, BlendOperation op);
         BlendOperation getBlendOpAlpha(int32_t idx) const;
 
+        /**
+         * @brief 状态是否被修改过，渲染器需要根据状态重新生成底层状态对象
+         */
+        bool isDirty() const;
+
     protected:
         BlendState();
 
@@ -124,6 +129,11 @@ namespace Tiny3D
         void setStencilOp(StencilOp stencilFail, StencilOp depthFail, StencilOp pass);
         void getStencilOp(StencilOp& stencilFail, StencilOp& depthFail, StencilOp& pass) const;
 
+        /**
+         * @brief 状态是否被修改过，渲染器需要根据状态重新生成底层状态对象
+         */
+        bool isDirty() const;
+
     protected:
         DepthStencilState();
 
@@ -171,6 +181,11 @@ namespace Tiny3D
         void setMSAAEnabled(bool enabled);
         bool isMSAAEnabled() const;
 
+        /**
+         * @brief 状态是否被修改过，渲染器需要根据状态重新生成底层状态对象
+         */
+        bool isDirty() const;
+
     protected:
         RasterizerState();
 
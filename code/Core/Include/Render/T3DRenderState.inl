@@ -198,6 +198,13 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    inline bool BlendState::isDirty() const
+    {
+        return mIsDirty;
+    }
+
+    //--------------------------------------------------------------------------
+
     inline void DepthStencilState::setDepthTestEnabled(bool enabled)
     {
         if (mDepthTestEnable != enabled)
@@ -383,6 +390,13 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    inline bool DepthStencilState::isDirty() const
+    {
+        return mIsDirty;
+    }
+
+    //--------------------------------------------------------------------------
+
     inline void RasterizerState::setPolygonMode(PolygonMode mode)
     {
         if (mPolygonMode != mode)
@@ -534,6 +548,13 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    inline bool RasterizerState::isDirty() const
+    {
+        return mIsDirty;
+    }
+
+    //--------------------------------------------------------------------------
+
     inline void SamplerState::setAddressMode(const UVWAddressMode& uvw)
     {
         if (mAddressMode.u != uvw.u || mAddressMode.v != uvw.v
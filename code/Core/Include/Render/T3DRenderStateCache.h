@@ -0,0 +1,133 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#ifndef __T3D_RENDER_STATE_CACHE_H__
+#define __T3D_RENDER_STATE_CACHE_H__
+
+
+#include "T3DPrerequisites.h"
+#include "T3DTypedef.h"
+
+
+namespace Tiny3D
+{
+    class RenderStatistics;
+
+    /**
+     * @brief 渲染状态缓存
+     * @remarks 记录当前绑定到底层图形 API 的 GPU 程序、纹理、渲染状态对象和
+     *      常量缓冲区。具体渲染器在调用底层 API 之前先查询缓存，状态没有变化
+     *      就跳过这次调用，并记录到渲染统计里。
+     *      每个 set 接口在状态发生变化时更新缓存并返回 true，
+     *      状态相同时返回 false。
+     */
+    class T3D_ENGINE_API RenderStateCache
+    {
+    public:
+        enum
+        {
+            MAX_TEXTURE_SLOTS = 16,     /**< 缓存的纹理槽数量 */
+            MAX_CONSTANT_SLOTS = 16,    /**< 缓存的常量缓冲区槽数量 */
+        };
+
+        /**
+         * @brief 构造函数
+         * @param [in] statistics : 记录被跳过调用次数的渲染统计对象
+         */
+        RenderStateCache(RenderStatistics *statistics);
+
+        /**
+         * @brief 析构函数
+         */
+        ~RenderStateCache();
+
+        /**
+         * @brief 清空缓存，之后所有状态都会重新绑定
+         * @remarks 底层图形 API 的状态被外部修改或者设备重建后需要调用
+         */
+        void invalidate();
+
+        /**
+         * @brief 设置 GPU 程序
+         */
+        bool setGPUProgram(GPUProgram *program);
+
+        /**
+         * @brief 设置纹理
+         * @param [in] slot : 纹理槽，超出缓存范围的槽总是返回 true
+         * @param [in] texture : 纹理对象
+         */
+        bool setTexture(size_t slot, Texture *texture);
+
+        /**
+         * @brief 设置混合状态
+         * @remarks 同一个状态对象被修改过（isDirty）时仍然需要重新绑定
+         */
+        bool setBlendState(BlendState *state);
+
+        /**
+         * @brief 设置深度模板状态
+         */
+        bool setDepthStencilState(DepthStencilState *state);
+
+        /**
+         * @brief 设置光栅化状态
+         */
+        bool setRasterizerState(RasterizerState *state);
+
+        /**
+         * @brief 设置常量缓冲区
+         * @param [in] slot : 常量缓冲区槽，超出缓存范围的槽总是返回 true
+         * @param [in] buffer : 常量缓冲区
+         */
+        bool setConstantBuffer(size_t slot, HardwareConstantBuffer *buffer);
+
+    protected:
+        /**
+         * @brief 比较并更新缓存的对象，相同的时候记录一次被跳过的调用
+         */
+        template <typename T>
+        bool update(SmartPtr<T> &cached, T *value, bool &valid, 
+            bool force = false);
+
+    protected:
+        RenderStatistics            *mStatistics;   /**< 渲染统计 */
+
+        GPUProgramPtr               mProgram;       /**< 当前 GPU 程序 */
+        TexturePtr                  mTextures[MAX_TEXTURE_SLOTS];   /**< 当前纹理 */
+        BlendStatePtr               mBlendState;    /**< 当前混合状态 */
+        DepthStencilStatePtr        mDepthState;    /**< 当前深度模板状态 */
+        RasterizerStatePtr          mRasterState;   /**< 当前光栅化状态 */
+        HardwareConstantBufferPtr   mConstBuffers[MAX_CONSTANT_SLOTS];  /**< 当前常量缓冲区 */
+
+        /**
+         * @brief 缓存是否有效，nullptr 也是合法的绑定状态，需要单独标记
+         */
+        bool    mIsProgramValid;
+        bool    mIsTextureValid[MAX_TEXTURE_SLOTS];
+        bool    mIsBlendValid;
+        bool    mIsDepthValid;
+        bool    mIsRasterValid;
+        bool    mIsConstBufferValid[MAX_CONSTANT_SLOTS];
+    };
+}
+
+
+#endif  /*__T3D_RENDER_STATE_CACHE_H__*/
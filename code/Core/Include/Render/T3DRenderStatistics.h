@@ -0,0 +1,213 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#ifndef __T3D_RENDER_STATISTICS_H__
+#define __T3D_RENDER_STATISTICS_H__
+
+
+#include "T3DPrerequisites.h"
+#include "T3DTypedef.h"
+
+
+namespace Tiny3D
+{
+    /**
+     * @brief 渲染统计数据
+     * @remarks 每帧统计绘制调用、图元数量、状态切换、纹理绑定以及每个渲染分组
+     *      的耗时，并保留最近若干帧的帧时间用于计算百分位数。
+     *      绘制调用和图元由 RenderQueue 在渲染时统计，状态切换和纹理绑定由
+     *      具体渲染器在调用底层图形 API 时统计。
+     */
+    class T3D_ENGINE_API RenderStatistics
+    {
+    public:
+        /**
+         * @brief 默认保留的历史帧数
+         */
+        static const size_t DEFAULT_HISTORY_SIZE;
+
+        /**
+         * @brief 单个渲染分组的统计数据
+         */
+        struct GroupStats
+        {
+            GroupStats()
+                : drawCalls(0)
+                , primitives(0)
+                , time(0.0)
+            {}
+
+            uint32_t    drawCalls;      /**< 绘制调用次数 */
+            uint32_t    primitives;     /**< 图元数量 */
+            float64_t   time;           /**< 渲染耗时，单位毫秒 */
+        };
+
+        /**
+         * @brief 一帧的统计数据
+         */
+        struct FrameStats
+        {
+            FrameStats()
+                : frameIndex(0)
+                , drawCalls(0)
+                , primitives(0)
+                , stateChanges(0)
+                , textureBinds(0)
+                , avoidedCalls(0)
+                , frameTime(0.0)
+                , renderTime(0.0)
+            {}
+
+            uint64_t    frameIndex;     /**< 帧序号 */
+            uint32_t    drawCalls;      /**< 绘制调用次数 */
+            uint32_t    primitives;     /**< 图元数量 */
+            uint32_t    stateChanges;   /**< 状态切换次数 */
+            uint32_t    textureBinds;   /**< 纹理绑定次数 */
+            uint32_t    avoidedCalls;   /**< 状态缓存跳过的冗余调用次数 */
+            float64_t   frameTime;      /**< 跟上一帧开始的时间间隔，单位毫秒 */
+            float64_t   renderTime;     /**< 本帧渲染耗时，单位毫秒 */
+        };
+
+        /**
+         * @brief 构造函数
+         * @param [in] historySize : 保留的历史帧数
+         */
+        RenderStatistics(size_t historySize = DEFAULT_HISTORY_SIZE);
+
+        /**
+         * @brief 析构函数
+         */
+        ~RenderStatistics();
+
+        /**
+         * @brief 开始一帧统计，清空当前帧的计数
+         */
+        void beginFrame();
+
+        /**
+         * @brief 结束一帧统计，记录帧时间到历史里
+         */
+        void endFrame();
+
+        /**
+         * @brief 开始统计一个渲染分组，之后的绘制调用都计入这个分组
+         * @param [in] groupID : 渲染分组ID
+         */
+        void beginGroup(uint32_t groupID);
+
+        /**
+         * @brief 结束统计当前渲染分组，累计分组耗时
+         */
+        void endGroup();
+
+        /**
+         * @brief 记录一次绘制调用
+         * @param [in] primitives : 本次绘制的图元数量
+         */
+        void addDrawCall(size_t primitives);
+
+        /**
+         * @brief 记录一次渲染状态切换
+         */
+        void addStateChange();
+
+        /**
+         * @brief 记录一次纹理绑定
+         */
+        void addTextureBind();
+
+        /**
+         * @brief 记录一次被状态缓存跳过的冗余调用
+         */
+        void addAvoidedCall();
+
+        /**
+         * @brief 获取最近一帧的统计数据
+         * @remarks 在 endFrame 之后调用返回完整一帧的数据
+         */
+        const FrameStats &getFrameStats() const;
+
+        /**
+         * @brief 获取最近一帧指定渲染分组的统计数据
+         * @param [in] groupID : 渲染分组ID
+         * @return 本帧没有渲染该分组返回 nullptr
+         */
+        const GroupStats *getGroupStats(uint32_t groupID) const;
+
+        /**
+         * @brief 设置保留的历史帧数，会清空已有的历史
+         */
+        void setHistorySize(size_t historySize);
+
+        /**
+         * @brief 获取历史里已经记录的帧数
+         */
+        size_t getHistoryCount() const;
+
+        /**
+         * @brief 获取历史帧时间的平均值，单位毫秒
+         */
+        float64_t getAverageFrameTime() const;
+
+        /**
+         * @brief 获取历史帧时间的百分位数，单位毫秒
+         * @param [in] percentile : 百分位，范围 [0, 100]，如 50、95、99
+         * @return 历史为空时返回 0
+         */
+        float64_t getFrameTimePercentile(Real percentile) const;
+
+        /**
+         * @brief 清空所有统计数据和历史
+         */
+        void reset();
+
+    protected:
+        /**
+         * @brief 获取单调时钟的当前时间，单位毫秒
+         */
+        static float64_t now();
+
+        typedef TMap<uint32_t, GroupStats>      GroupStatsMap;
+        typedef GroupStatsMap::iterator         GroupStatsMapItr;
+        typedef GroupStatsMap::const_iterator   GroupStatsMapConstItr;
+        typedef GroupStatsMap::value_type       GroupStatsMapValue;
+
+        typedef TArray<float64_t>               FrameTimeHistory;
+
+        FrameStats          mFrame;             /**< 当前帧统计数据 */
+        GroupStatsMap       mGroups;            /**< 各个渲染分组统计数据 */
+        GroupStats          *mCurrentGroup;     /**< 当前正在统计的分组 */
+
+        float64_t           mFrameStart;        /**< 当前帧开始时间 */
+        float64_t           mGroupStart;        /**< 当前分组开始时间 */
+
+        FrameTimeHistory    mHistory;           /**< 帧时间环形缓冲区 */
+        size_t              mHistoryHead;       /**< 下一个写入位置 */
+        size_t              mHistoryCount;      /**< 已记录的帧数 */
+
+        mutable FrameTimeHistory    mSorted;    /**< 计算百分位数的临时缓冲 */
+    };
+}
+
+
+#include "T3DRenderStatistics.inl"
+
+
+#endif  /*__T3D_RENDER_STATISTICS_H__*/
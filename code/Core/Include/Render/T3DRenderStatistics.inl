@@ -0,0 +1,72 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    inline void RenderStatistics::addDrawCall(size_t primitives)
+    {
+        mFrame.drawCalls++;
+        mFrame.primitives += (uint32_t)primitives;
+
+        if (mCurrentGroup != nullptr)
+        {
+            mCurrentGroup->drawCalls++;
+            mCurrentGroup->primitives += (uint32_t)primitives;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    inline void RenderStatistics::addStateChange()
+    {
+        mFrame.stateChanges++;
+    }
+
+    //--------------------------------------------------------------------------
+
+    inline void RenderStatistics::addTextureBind()
+    {
+        mFrame.textureBinds++;
+    }
+
+    //--------------------------------------------------------------------------
+
+    inline void RenderStatistics::addAvoidedCall()
+    {
+        mFrame.avoidedCalls++;
+    }
+
+    //--------------------------------------------------------------------------
+
+    inline const RenderStatistics::FrameStats &
+        RenderStatistics::getFrameStats() const
+    {
+        return mFrame;
+    }
+
+    //--------------------------------------------------------------------------
+
+    inline size_t RenderStatistics::getHistoryCount() const
+    {
+        return mHistoryCount;
+    }
+}
@@ -0,0 +1,121 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#ifndef __T3D_RENDER_TEXTURE_H__
+#define __T3D_RENDER_TEXTURE_H__
+
+
+#include "Render/T3DRenderTarget.h"
+#include "ImageCodec/T3DImageCodecBase.h"
+
+
+namespace Tiny3D
+{
+    /**
+     * @brief 内存渲染目标
+     * @remarks 渲染结果写到系统内存里的 A8R8G8B8 帧缓冲，不依赖窗口系统，
+     *      用于软件渲染器的离屏渲染以及无显示环境下的回归测试和性能测试
+     */
+    class T3D_ENGINE_API RenderTexture : public RenderTarget
+    {
+        T3D_DECLARE_CLASS();
+
+    public:
+        /**
+         * @brief 创建内存渲染目标
+         * @param [in] name : 渲染目标名称
+         * @param [in] width : 宽度
+         * @param [in] height : 高度
+         * @return 调用成功返回一个渲染目标对象，失败返回 nullptr
+         */
+        static RenderTexturePtr create(const String &name, size_t width,
+            size_t height);
+
+        /**
+         * @brief 析构函数
+         */
+        virtual ~RenderTexture();
+
+        /**
+         * @brief 获取渲染目标类型
+         * @remarks 实现基类接口
+         */
+        virtual Type getType() const override;
+
+        /**
+         * @brief 用指定颜色清除帧缓冲
+         * @param [in] clrFill : 填充颜色
+         * @param [in] clearFlags : 清除标记
+         * @param [in] depth : 深度值
+         * @param [in] stencil : 模板值
+         * @remarks 内存渲染目标没有深度和模板缓冲，只清除颜色
+         */
+        virtual void clear(const ColorRGB &clrFill, uint32_t clearFlags,
+            Real depth, uint32_t stencil) override;
+
+        /**
+         * @brief 获取帧缓冲
+         * @return 返回帧缓冲地址
+         */
+        uint8_t *getFramebuffer();
+
+        /**
+         * @brief 获取帧缓冲
+         * @return 返回帧缓冲地址
+         */
+        const uint8_t *getFramebuffer() const;
+
+        /**
+         * @brief 获取帧缓冲大小
+         * @return 返回帧缓冲大小
+         */
+        size_t getFramebufferSize() const;
+
+        /**
+         * @brief 把帧缓冲内容编码保存到文件
+         * @param [in] path : 文件路径
+         * @param [in] type : 图像文件格式类型，默认PNG格式
+         * @return 调用成功返回 T3D_OK
+         */
+        TResult saveToFile(const String &path,
+            ImageCodecBase::FileType type = ImageCodecBase::FileType::PNG);
+
+    protected:
+        /**
+         * @brief 构造函数
+         */
+        RenderTexture(const String &name);
+
+        /**
+         * @brief 初始化，分配帧缓冲
+         */
+        TResult init(size_t width, size_t height);
+
+    protected:
+        uint8_t     *mFramebuffer;      /**< 帧缓冲 */
+        size_t      mFramebufferSize;   /**< 帧缓冲大小 */
+    };
+}
+
+
+#include "T3DRenderTexture.inl"
+
+
+#endif  /*__T3D_RENDER_TEXTURE_H__*/
@@ -120,6 +120,20 @@ namespace Tiny3D
          */
         virtual bool isIndicesUsed() const = 0;
 
+        /**
+         * @brief 设置实际绘制的索引数量
+         * @param [in] count : 从索引缓冲区开头算起要绘制的索引数量，为 0 时
+         *      绘制索引缓冲区里的全部索引
+         * @remarks 索引缓冲区只有前面一部分有效时使用，比如静态合批剔除以后
+         */
+        void setDrawIndexCount(size_t count);
+
+        /**
+         * @brief 获取实际绘制的索引数量
+         * @return 没有设置过时返回索引缓冲区的索引数量
+         */
+        size_t getDrawIndexCount() const;
+
         /**
          * @brief 获取图元数量
          */
@@ -144,6 +158,7 @@ namespace Tiny3D
     private:
         mutable size_t  mPrimitiveCount;    /**< 图元数量 */
         mutable bool    mIsDirty;           /**< 是否需要重新计算图元数量 */
+        size_t          mDrawIndexCount;    /**< 实际绘制的索引数量，0 表示全部 */
     };
 }
 
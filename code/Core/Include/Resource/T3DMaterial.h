@@ -41,12 +41,12 @@ namespace Tiny3D
         typedef Techniques::iterator            TechniquesItr;
         typedef Techniques::const_iterator      TechniquesConstItr;
 
-        typedef TMap<String, GPUProgramPtr>     GPUPrograms;
+        typedef THashMap<NameID, GPUProgramPtr> GPUPrograms;
         typedef GPUPrograms::iterator           GPUProgramsItr;
         typedef GPUPrograms::const_iterator     GPUProgramsConstItr;
         typedef GPUPrograms::value_type         GPUProgramsValue;
 
-        typedef TMap<String, GPUConstBufferPtr> GPUConstBuffers;
+        typedef THashMap<NameID, GPUConstBufferPtr> GPUConstBuffers;
         typedef GPUConstBuffers::iterator       GPUConstBuffersItr;
         typedef GPUConstBuffers::const_iterator GPUConstBuffersConstITr;
         typedef GPUConstBuffers::value_type     GPUConstBuffersValue;
@@ -41,6 +41,11 @@ namespace Tiny3D
         T3D_DECLARE_CLASS();
 
     public:
+        /**
+         * @brief   默認內存預算，沒有引用的模型超過該大小後按最久未使用的順序卸載
+         */
+        static const size_t DEFAULT_MEMORY_BUDGET = 64 * 1024 * 1024;
+
         /**
          * @fn  static DylibManagerPtr create();
          * @brief   創建動態庫管理器對象
@@ -25,6 +25,7 @@
 #include "T3DPrerequisites.h"
 #include "T3DTypedef.h"
 #include "Kernel/T3DObject.h"
+#include "Kernel/T3DStringInterner.h"
 
 
 namespace Tiny3D
@@ -72,21 +73,21 @@ namespace Tiny3D
         virtual Type getType() const = 0;
 
         /**
-         * @fn  ID Resource::getID() const
+         * @fn  NameID Resource::getID() const
          * @brief   獲取資源唯一ID
          * @return  The identifier.
          */
-        ID getID() const
+        NameID getID() const
         {
             return mID;
         }
         
         /**
-         * @fn  ID Resource::getCloneID() const
+         * @fn  NameID Resource::getCloneID() const
          * @brief   獲取克隆資源唯一ID，當該資源是從其他資源克隆出來試，該ID才有效
          * @return  The clone identifier.
          */
-        ID getCloneID() const
+        NameID getCloneID() const
         {
             return mCloneID;
         }
@@ -175,11 +176,15 @@ namespace Tiny3D
         virtual ResourcePtr clone() const = 0;
 
     private:
+        typedef TList<Resource*>    UnusedList;
+
         uint32_t    mResReferCount; /**< 資源自身的引用計數 */
+        bool        mIsUnused;      /**< 沒有引用但還保留在緩存裡 */
+        UnusedList::iterator    mUnusedItr; /**< 在資源管理器無引用列表裡的位置 */
 
     protected:
-        ID      mID;        /**< 資源ID */
-        ID      mCloneID;   /**< 如果資源是從其他資源克隆出來的，該ID才有效 */
+        NameID  mID;        /**< 資源ID，即資源名稱ID */
+        NameID  mCloneID;   /**< 如果資源是從其他資源克隆出來的，該ID才有效 */
         size_t  mSize;      /**< 資源大小 */
         bool    mIsLoaded;  /**< 資源是否加載標記 */
         String  mName;      /**< 資源名稱 */
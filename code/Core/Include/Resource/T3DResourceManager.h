@@ -60,6 +60,15 @@ namespace Tiny3D
          */
         virtual TResult unload(ResourcePtr res);
 
+        /**
+         * @fn  TResult ResourceManager::retain(ResourcePtr res);
+         * @brief   增加資源自身的引用計數，和 unload() 配對使用
+         * @param [in]  res : 已加載或者克隆出來的資源對象.
+         * @return  成功返回 T3D_OK.
+         * @remarks 用於多個對象共享同一份資源，例如預制體實例共享預制體的材質.
+         */
+        TResult retain(ResourcePtr res);
+
         /**
          * @fn  virtual TResult ResourceManager::unloadAllResources();
          * @brief   卸載所有資源，慎用 ！
@@ -69,11 +78,43 @@ namespace Tiny3D
 
         /**
          * @fn  virtual TResult ResourceManager::unloadUnused();
-         * @brief   把當前資源管理裡所有不適用資源從內存中卸載掉
+         * @brief   把當前資源管理裡所有不使用資源從內存中卸載掉
          * @return  A TResult.
+         * @remarks 不管內存預算，卸載所有已經沒有引用但還保留在緩存裡的資源.
          */
         virtual TResult unloadUnused();
 
+        /**
+         * @fn  TResult ResourceManager::trim();
+         * @brief   按最久未使用的順序卸載沒有引用的資源，直到內存不超過預算
+         * @return  A TResult.
+         * @remarks 還在使用的資源不會被卸載，所以內存佔用可能仍然超過預算.
+         */
+        TResult trim();
+
+        /**
+         * @fn  void ResourceManager::setMemoryBudget(size_t budget);
+         * @brief   設置內存預算
+         * @param [in]  budget  : 內存預算，單位：字節.
+         * @remarks 預算為 0 時資源沒有引用就馬上卸載，否則沒有引用的資源會
+         *          保留在緩存裡，超出預算時再按最久未使用的順序卸載.
+         */
+        void setMemoryBudget(size_t budget);
+
+        /**
+         * @fn  size_t ResourceManager::getMemoryBudget() const
+         * @brief   獲取內存預算
+         * @return  返回內存預算，單位：字節.
+         */
+        size_t getMemoryBudget() const { return mMemoryBudget; }
+
+        /**
+         * @fn  size_t ResourceManager::getMemoryUsage() const
+         * @brief   獲取緩存裡所有資源的大小總和
+         * @return  返回內存佔用，單位：字節.
+         */
+        size_t getMemoryUsage() const { return mMemoryUsage; }
+
         /**
          * @fn  ResourcePtr ResourceManager::clone(ResourcePtr src);
          * @brief   從源資源克隆 一份新資源出來
@@ -86,14 +127,14 @@ namespace Tiny3D
 
         /**
          * @fn  ResourcePtr ResourceManager::getResource( const String &name, 
-         *      ID cloneID = T3D_INVALID_ID) const;
+         *      NameID cloneID = T3D_INVALID_ID) const;
          * @brief   根據資源名稱獲取對應資源對象
          * @param [in]  name    : 資源名稱.
          * @param [in]  cloneID (Optional) : 傳入該參數直接用該ID查找，默認自動找非克隆對象.
          * @return  返回查詢的資源對象，如果返回 NULL_PTR 則表示沒有該資源。.
          */
         ResourcePtr getResource(
-            const String &name, ID cloneID = T3D_INVALID_ID) const;
+            const String &name, NameID cloneID = T3D_INVALID_ID) const;
 
     protected:
         /**
@@ -115,33 +156,32 @@ namespace Tiny3D
             const String &strName, int32_t argc, va_list args) = 0;
 
         /**
-         * @fn  uint32_t ResourceManager::hash(const char *str) const;
-         * @brief   根據名稱計算資源 hash 值，作為其ID
-         * @param   str The string.
-         * @return  An uint32_t.
+         * @fn  NameID ResourceManager::toID(const String &name) const;
+         * @brief   根據名稱生成ID
+         * @param [in]  name    : 資源名稱.
+         * @return  返回資源名稱ID.
+         * @sa  StringInterner
          */
-        uint32_t hash(const char *str) const;
+        NameID toID(const String &name) const;
 
         /**
-         * @fn  ID ResourceManager::toID(const String &name) const;
-         * @brief   根據名稱生成ID
-         * @param   name    The name.
-         * @return  Name as an ID.
+         * @fn  NameID ResourceManager::toCloneID(const String &name);
+         * @brief   根據名稱生成克隆對象 ID
+         * @param [in]  name    : 被克隆資源名稱.
+         * @return  返回緩存中沒有被佔用的克隆對象ID.
          */
-        ID toID(const String &name) const;
+        NameID toCloneID(const String &name);
 
         /**
-         * @fn  ID ResourceManager::toCloneID(const String &name, 
-         *      ID cloneID) const;
-         * @brief   根據名稱生成克隆對象 ID
-         * @param   name    The name.
-         * @param   cloneID Identifier for the clone.
-         * @return  The given data converted to an ID.
+         * @fn  void ResourceManager::evict(Resource *res);
+         * @brief   卸載資源並從緩存中清除
+         * @param [in]  res : 緩存裡的資源對象.
+         * @remarks 調用後 res 可能已經被釋放，不能再使用.
          */
-        ID toCloneID(const String &name, ID cloneID) const;
+        void evict(Resource *res);
 
     protected:
-        typedef TMap<ID, ResourcePtr>       Resources;
+        typedef THashMap<NameID, ResourcePtr>   Resources;
         typedef Resources::iterator         ResourcesItr;
         typedef Resources::const_iterator   ResourcesConstItr;
         typedef Resources::value_type       ResourcesValue;
@@ -151,8 +191,14 @@ namespace Tiny3D
         typedef ResourcesMap::const_iterator    ResourcesMapConstItr;
         typedef ResourcesMap::value_type        ResourcesMapValue;
 
+        typedef Resource::UnusedList    UnusedList;
+
         Resources   mResourcesCache;    /**< 資源對象池 */
-        ID          mCloneID;           /**< 克隆ID */
+        uint64_t    mCloneID;           /**< 克隆序號 */
+
+        mutable UnusedList  mUnusedResources;   /**< 沒有引用的資源，按最近使用排序，最久未使用的在前面 */
+        size_t      mMemoryBudget;      /**< 內存預算，0 表示不保留沒有引用的資源 */
+        size_t      mMemoryUsage;       /**< 緩存裡所有資源的大小總和 */
     };
 }
 
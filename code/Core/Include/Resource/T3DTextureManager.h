@@ -40,6 +40,11 @@ namespace Tiny3D
         T3D_DECLARE_CLASS();
 
     public:
+        /**
+         * @brief   默认内存预算，没有引用的纹理超过该大小后按最久未使用的顺序卸载
+         */
+        static const size_t DEFAULT_MEMORY_BUDGET = 256 * 1024 * 1024;
+
         /**
          * @fn  static TextureManagerPtr create();
          * @brief   创建纹理管理器对象
@@ -0,0 +1,143 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#ifndef __T3D_COMPONENT_STORE_H__
+#define __T3D_COMPONENT_STORE_H__
+
+
+#include "T3DPrerequisites.h"
+#include "T3DTypedef.h"
+
+
+namespace Tiny3D
+{
+    /**
+     * @class   ComponentStore
+     * @brief   按组件类型分组的组件存储，用于按类型批量更新组件
+     * @remarks 同一个类的组件放在同一个连续数组里，组件对象本身由各类的
+     *          对象池分配，也基本连续。更新时按组件执行顺序逐个类型扫描数组，
+     *          同一类型的组件之间互不依赖，数量多的类型交给任务系统并行更新。
+     *          组件记录自己在存储里的位置，添加和删除都是常数时间，删除时用
+     *          数组最后一个组件填补空位。
+     *          只有挂在场景根结点下的结点上的组件才放进来，结点挂到场景里或者
+     *          从场景里拿下来时整棵子树的组件一起添加或删除。结点和祖先结点
+     *          有一个不可用时（SceneNode::isActive）组件不更新。
+     *          更新过程中不能添加或删除组件，也不能增删场景里带组件的结点.
+     */
+    class T3D_ENGINE_API ComponentStore
+    {
+    public:
+        /**
+         * @brief 并行更新时每块的组件数量，一个类型的组件少于这个数量时不并行
+         */
+        static const size_t UPDATE_GRAIN;
+
+        /**
+         * @brief 构造函数
+         */
+        ComponentStore();
+
+        /**
+         * @brief 析构函数
+         */
+        ~ComponentStore();
+
+        /**
+         * @brief 添加组件
+         * @param [in] component : 组件对象，已经挂到场景里的结点上
+         * @param [in] order : 组件执行顺序，决定该类型在第几批更新
+         */
+        void add(Component *component, uint32_t order);
+
+        /**
+         * @brief 移除组件，组件不在存储里时什么都不做
+         * @param [in] component : 组件对象
+         */
+        void remove(Component *component);
+
+        /**
+         * @brief 移除所有组件
+         */
+        void clear();
+
+        /**
+         * @brief 按执行顺序逐个类型更新所有组件
+         * @param [in] jobs : 任务系统，为 nullptr 时全部在当前线程更新
+         */
+        void update(JobSystem *jobs = nullptr);
+
+        /**
+         * @brief 获取组件总数
+         */
+        size_t getCount() const { return mCount; }
+
+        /**
+         * @brief 获取组件类型数量
+         */
+        size_t getTypeCount() const { return mBuckets.size(); }
+
+        /**
+         * @brief 获取第 index 个类型的组件类
+         */
+        const Class *getTypeClass(size_t index) const;
+
+        /**
+         * @brief 获取第 index 个类型的组件数量
+         */
+        size_t getTypeSize(size_t index) const;
+
+    protected:
+        typedef TArray<Component*>  Components;
+
+        /**
+         * @brief 同一个类的组件
+         */
+        struct Bucket
+        {
+            const Class     *cls;           /**< 组件类 */
+            uint32_t        order;          /**< 组件执行顺序 */
+            Components      components;     /**< 组件数组 */
+        };
+
+        typedef TArray<Bucket>      Buckets;
+        typedef TArray<uint32_t>    Indices;
+
+        /**
+         * @brief 更新一个类型里一段连续的组件
+         */
+        static void updateRange(const Components &components, size_t begin, 
+            size_t end);
+
+        /**
+         * @brief 按执行顺序重新排列类型的更新顺序
+         */
+        void sortBuckets();
+
+    protected:
+        Buckets         mBuckets;       /**< 所有类型，只增不减，位置不变 */
+        Indices         mClassBuckets;  /**< 类序号到类型位置加一，0 表示没有 */
+        Indices         mUpdateOrder;   /**< 按执行顺序排列的类型位置 */
+        size_t          mCount;         /**< 组件总数 */
+        bool            mIsUpdating;    /**< 是否正在更新 */
+    };
+}
+
+
+#endif  /*__T3D_COMPONENT_STORE_H__*/
@@ -23,6 +23,9 @@
 
 
 #include "Scene/T3DSceneManagerBase.h"
+#include "Bound/T3DDynamicAabbTree.h"
+#include "Scene/T3DTransformStore.h"
+#include "Scene/T3DComponentStore.h"
 
 
 namespace Tiny3D
@@ -32,6 +35,15 @@ namespace Tiny3D
      * @brief   默认场景管理器
      * @remarks 当没有任何场景管理器插件设置时候，会自动使用默认场景管理器。 
      *          默认场景管理器实际上是什么场景管理都没有，只是简单的一个渲染树.
+     *          可渲染结点按照碰撞体的世界空间包围盒放在动态 AABB 树里做视锥体
+     *          剔除，没有碰撞体或者碰撞体没有有限包围盒的结点单独放在一个列表里，
+     *          每次都交给结点自己判断.
+     *          任务系统有工作线程时，更新和剔除都分给多个线程：调用线程先
+     *          更新上面几层，拆出足够多的独立子树并行更新，期间剔除树的
+     *          修改按线程记下来，全部完成后在调用线程统一处理；剔除时可见
+     *          结点分块并行生成渲染项，写入渲染队列各线程的分桶，最后合并.
+     *          所有 Transform3D 的局部变换放在变换存储里，更新场景树之前先
+     *          按层扫描一遍计算世界变换，再把变化了的写回各个 Transform3D.
      */
     class T3D_ENGINE_API DefaultSceneMgr 
         : public SceneManagerBase
@@ -40,6 +52,21 @@ namespace Tiny3D
         T3D_DECLARE_CLASS();
 
     public:
+        /**
+         * @brief 并行更新时每个线程大约分到的子树数量
+         */
+        static const size_t UPDATE_ROOTS_PER_THREAD;
+
+        /**
+         * @brief 并行更新时最多拆分的层数
+         */
+        static const size_t MAX_SPLIT_LEVEL;
+
+        /**
+         * @brief 并行剔除时每块的结点数量，可见结点少于这个数量时不并行
+         */
+        static const size_t CULLING_GRAIN;
+
         /**
          * @fn  static DefaultSceneMgrPtr create();
          * @brief   创建默认场景管理器
@@ -114,6 +141,36 @@ namespace Tiny3D
          */
         virtual TResult removeSceneNode(SceneNode *node) override;
 
+        /**
+         * @fn  virtual TResult updateSceneNode(SceneNode *node) override;
+         * @brief   实现基类接口，碰撞体移出了树里扩大的包围盒时才调整树
+         * @param [in]  node    : 场景结点.
+         * @return  调用成功返回 T3D_OK.
+         */
+        virtual TResult updateSceneNode(SceneNode *node) override;
+
+        /**
+         * @fn  virtual TransformStore *DefaultSceneMgr::getTransformStore();
+         * @brief   获取场景管理器统一计算世界变换用的变换存储
+         * @return  实现基类接口.
+         */
+        virtual TransformStore *getTransformStore() override;
+
+        /**
+         * @fn  virtual ComponentStore *DefaultSceneMgr::getComponentStore();
+         * @brief   实现基类接口
+         * @return  没有打开按类型批量更新时返回 nullptr.
+         */
+        virtual ComponentStore *getComponentStore() override;
+
+        /**
+         * @fn  virtual void DefaultSceneMgr::setComponentStoreEnabled(
+         *      bool enabled);
+         * @brief   实现基类接口，打开时把场景树上已有的组件都放进组件存储
+         * @param [in]  enabled : 是否打开.
+         */
+        virtual void setComponentStoreEnabled(bool enabled) override;
+
         virtual void setComponentOrder(const Class *cls, uint32_t order) override;
 
         virtual uint32_t getComponentOrder(const Class *cls) const override;
@@ -128,38 +185,89 @@ namespace Tiny3D
         DefaultSceneMgr();
 
         /**
-         * @fn  TResult frustumCulling(CameraPtr camera);
+         * @fn  TResult frustumCulling(Camera *camera);
          * @brief   Frustum culling
          * @param   camera  The camera.
          * @return  A TResult.
          */
-        TResult frustumCulling(CameraPtr camera);
+        TResult frustumCulling(Camera *camera);
 
-    protected:
         /**
-         * @struct  Slot
-         * @brief   A slot.
+         * @fn  void addToUnbounded(SceneNode *node);
+         * @brief   把结点加入没有包围盒的结点列表
          */
-        struct Slot
-        {
-            Slot()
-                : count(0)
-                , first(nullptr)
-                , last(nullptr)
-            {}
+        void addToUnbounded(SceneNode *node);
 
-            size_t          count;  /**< Number of  */
-            SceneNodePtr    first;  /**< The first */
-            SceneNodePtr    last;   /**< The last */
-        };
+        /**
+         * @fn  void removeFromUnbounded(SceneNode *node);
+         * @brief   把结点从没有包围盒的结点列表移除，最后一个结点填补空位
+         */
+        void removeFromUnbounded(SceneNode *node);
+
+        /**
+         * @fn  static bool getCullingAabb(SceneNode *node, Aabb &aabb);
+         * @brief   获取结点用于剔除的世界空间包围盒
+         * @return  结点没有碰撞体或者碰撞体没有有限包围盒时返回 false.
+         */
+        static bool getCullingAabb(SceneNode *node, Aabb &aabb);
+
+        /**
+         * @fn  void collectUpdateRoots(size_t target);
+         * @brief   从根结点开始逐层更新，直到拆出足够多的子树用于并行更新
+         * @param [in]  target  : 期望的子树数量.
+         */
+        void collectUpdateRoots(size_t target);
+
+        /**
+         * @fn  void updateParallel();
+         * @brief   用任务系统并行更新场景树
+         */
+        void updateParallel();
+
+        /**
+         * @fn  void addVisibleNodes(size_t begin, size_t end, size_t bucket);
+         * @brief   把一段可见结点加入渲染队列
+         * @param [in]  begin   : 起始索引.
+         * @param [in]  end     : 结束索引，不包含.
+         * @param [in]  bucket  : 渲染队列分桶，为 SIZE_MAX 时直接加入队列.
+         */
+        void addVisibleNodes(size_t begin, size_t end, size_t bucket);
+
+        /**
+         * @fn  void updateTransforms();
+         * @brief   计算变换存储里所有脏变换的世界变换，并写回 Transform3D
+         */
+        void updateTransforms();
+
+        /**
+         * @fn  void updateComponents();
+         * @brief   按类型批量更新组件存储里的所有组件
+         */
+        void updateComponents();
+
+        /**
+         * @fn  void applyDeferred();
+         * @brief   处理并行更新期间各线程延后的剔除树更新
+         */
+        void applyDeferred();
 
-        typedef TArray<Slot>                SceneNodes;
-        typedef SceneNodes::iterator        RenderablesItr;
-        typedef SceneNodes::const_iterator  RenderablesConstItr;
+    protected:
+        typedef TArray<SceneNode*>          SceneNodes;
+        typedef TArray<void*>               VisibleNodes;
+        typedef TArray<SceneNodes>          DeferredNodes;
 
         SceneNodePtr    mRoot;          /**< 根结点 */
         RenderQueuePtr  mRenderQueue;   /**< 渲染队列 */
-        SceneNodes      mSceneNodes;    /**< 可渲染结点列表，用于做视锥体剔除 */
+        DynamicAabbTree mCullingTree;   /**< 可渲染结点的包围体树，用于视锥体剔除 */
+        TransformStore  mTransforms;    /**< 所有结点的变换 */
+        ComponentStore  mComponents;    /**< 按类型存放的组件 */
+        bool            mUseComponentStore; /**< 是否按类型批量更新组件 */
+        SceneNodes      mUnbounded;     /**< 没有包围盒的可渲染结点 */
+        VisibleNodes    mVisibleNodes;  /**< 剔除结果，每帧复用 */
+        SceneNodes      mUpdateRoots;   /**< 并行更新的子树根结点 */
+        SceneNodes      mSplitNodes;    /**< 拆分子树时的临时数组 */
+        DeferredNodes   mDeferred;      /**< 并行更新时各线程延后的剔除树更新 */
+        bool            mIsUpdating;    /**< 是否正在并行更新 */
         OrderMap        mOrders;        /**< */
     };
 }
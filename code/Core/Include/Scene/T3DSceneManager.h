@@ -109,6 +109,52 @@ namespace Tiny3D
          */
         virtual TResult removeSceneNode(SceneNode *node) override;
 
+        /**
+         * @fn  TResult updateSceneNode(SceneNode *node);
+         * @brief   结点碰撞体的世界空间包围体发生变化，更新剔除用的数据
+         * @param [in]  node    : 场景结点.
+         * @return  调用成功返回 T3D_OK.
+         */
+        virtual TResult updateSceneNode(SceneNode *node) override;
+
+        /**
+         * @fn  virtual TransformStore *SceneManager::getTransformStore();
+         * @brief   获取场景管理器统一计算世界变换用的变换存储
+         * @return  实现基类接口.
+         */
+        virtual TransformStore *getTransformStore() override;
+
+        /**
+         * @fn  virtual ComponentStore *SceneManager::getComponentStore();
+         * @brief   获取按类型批量更新组件用的组件存储
+         * @return  实现基类接口.
+         */
+        virtual ComponentStore *getComponentStore() override;
+
+        /**
+         * @fn  virtual void SceneManager::setComponentStoreEnabled(
+         *      bool enabled);
+         * @brief   设置是否按组件类型批量更新组件
+         * @param [in]  enabled : 是否打开.
+         */
+        virtual void setComponentStoreEnabled(bool enabled) override;
+
+        /**
+         * @fn  virtual TResult SceneManager::buildStaticBatches(
+         *      SceneNodePtr root = nullptr);
+         * @brief   把静态结点按材质和顶点格式合批
+         * @param [in]  root    : 只合批这个结点下的子树，nullptr 表示整个场景.
+         * @return  实现基类接口.
+         */
+        virtual TResult buildStaticBatches(SceneNodePtr root = nullptr) override;
+
+        /**
+         * @fn  virtual TResult SceneManager::clearStaticBatches();
+         * @brief   删除所有静态合批
+         * @return  实现基类接口.
+         */
+        virtual TResult clearStaticBatches() override;
+
         virtual void setComponentOrder(const Class *cls, uint32_t order) override;
 
         virtual uint32_t getComponentOrder(const Class *cls) const override;
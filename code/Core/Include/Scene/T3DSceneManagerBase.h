@@ -106,6 +106,60 @@ namespace Tiny3D
          */
         virtual TResult removeSceneNode(SceneNode *node) = 0;
 
+        /**
+         * @fn  TResult updateSceneNode(SceneNode *node);
+         * @brief   结点碰撞体的世界空间包围体发生变化，更新剔除用的数据
+         * @param [in]  node    : 场景结点.
+         * @return  调用成功返回 T3D_OK.
+         */
+        virtual TResult updateSceneNode(SceneNode *node) = 0;
+
+        /**
+         * @fn  virtual TransformStore *SceneManagerBase::getTransformStore();
+         * @brief   获取场景管理器统一计算世界变换用的变换存储
+         * @return  默认返回 nullptr，表示每个 Transform3D 自己计算世界变换.
+         */
+        virtual TransformStore *getTransformStore();
+
+        /**
+         * @fn  virtual ComponentStore *SceneManagerBase::getComponentStore();
+         * @brief   获取按类型批量更新组件用的组件存储
+         * @return  默认返回 nullptr，表示按结点逐个更新组件.
+         * @sa  void setComponentStoreEnabled(bool enabled)
+         */
+        virtual ComponentStore *getComponentStore();
+
+        /**
+         * @fn  virtual void SceneManagerBase::setComponentStoreEnabled(
+         *      bool enabled);
+         * @brief   设置是否按组件类型批量更新组件
+         * @param [in]  enabled : true 表示组件按类型存放在连续数组里，每帧
+         *                        按类型批量更新，false 表示遍历场景树逐个
+         *                        结点更新.
+         * @remarks 默认不支持，什么都不做。打开后只调用组件的 update，不再
+         *          调用 SceneNode::update，也不检查祖先结点是否 enabled.
+         */
+        virtual void setComponentStoreEnabled(bool enabled);
+
+        /**
+         * @fn  virtual TResult SceneManagerBase::buildStaticBatches(
+         *      SceneNodePtr root = nullptr);
+         * @brief   把静态结点按材质和顶点格式合批
+         * @param [in]  root    : 只合批这个结点下的子树，nullptr 表示整个场景.
+         * @return  调用成功返回 T3D_OK.
+         * @remarks 一般在场景加载完成后调用一次。合批后的顶点是世界空间的，
+         *          合批结点挂在根结点下，原来的结点不再单独参与剔除和渲染.
+         * @sa  void SceneNode::setStatic(bool isStatic)
+         */
+        virtual TResult buildStaticBatches(SceneNodePtr root = nullptr);
+
+        /**
+         * @fn  virtual TResult SceneManagerBase::clearStaticBatches();
+         * @brief   删除所有静态合批，原来的结点恢复单独渲染
+         * @return  调用成功返回 T3D_OK.
+         */
+        virtual TResult clearStaticBatches();
+
         virtual void setComponentOrder(const Class *cls, uint32_t order) = 0;
 
         virtual uint32_t getComponentOrder(const Class *cls) const = 0;
@@ -118,6 +172,11 @@ namespace Tiny3D
          * @brief   构造函数
          */
         SceneManagerBase();
+
+    protected:
+        typedef TArray<SceneNodePtr>    StaticBatches;
+
+        StaticBatches   mStaticBatches; /**< 静态合批结点 */
     };
 }
 
@@ -23,6 +23,7 @@
 
 
 #include "Kernel/T3DNode.h"
+#include "Kernel/T3DCommon.h"
 
 
 namespace Tiny3D
@@ -34,9 +35,11 @@ namespace Tiny3D
     class T3D_ENGINE_API SceneNode : public Node
     {
         friend class DefaultSceneMgr;
+        friend class StaticBatch;
 
         T3D_DISABLE_COPY(SceneNode);
         T3D_DECLARE_CLASS();
+        T3D_DECLARE_POOL(SceneNode);
 
     public:
         /**
@@ -67,6 +70,17 @@ namespace Tiny3D
          */
         virtual NodePtr clone() const override;
 
+        /**
+         * @fn  SceneNodePtr SceneNode::instantiate() const;
+         * @brief   把本结点当作预制体，生成一个实例
+         * @return  返回新的实例结点，包含所有子结点的实例.
+         * @remarks 和 clone() 深拷贝所有组件不同，实例的组件通过 
+         *          Component::instantiate() 生成，和预制体共享 VAO、材质等
+         *          不可变数据，只复制实例自身的状态。实例修改共享数据时才会
+         *          复制一份，参见 Renderable::getWritableMaterial().
+         */
+        SceneNodePtr instantiate() const;
+
         /**
          * @fn  virtual void SceneNode::setVisible(bool visible);
          * @brief   设置结点是否可见
@@ -102,6 +116,15 @@ namespace Tiny3D
          */
         bool isEnabled() const;
 
+        /**
+         * @fn  bool SceneNode::isActive() const;
+         * @brief   获取结点和所有祖先结点是否都可用
+         * @return  结点和所有祖先结点都可用时返回 true.
+         * @remarks 在 setEnabled 和挂到父结点、从父结点拿下来时更新，
+         *          查询不需要遍历祖先结点.
+         */
+        bool isActive() const;
+
         /**
          * @fn  virtual void SceneNode::setCameraMask(uint32_t mask);
          * @brief   设置结点使用对应相机的掩码
@@ -120,6 +143,31 @@ namespace Tiny3D
          */
         uint32_t getCameraMask() const;
 
+        /**
+         * @fn  void SceneNode::setStatic(bool isStatic);
+         * @brief   设置结点是否静态结点
+         * @param [in]  isStatic : 静态标记.
+         * @sa  bool isStatic() const
+         * @remarks 静态结点在 SceneManager::buildStaticBatches() 时会按材质合批，
+         *          合批后结点不再单独参与剔除和渲染，也不应再修改变换.
+         */
+        void setStatic(bool isStatic);
+
+        /**
+         * @fn  bool SceneNode::isStatic() const;
+         * @brief   获取结点是否静态结点
+         * @return  返回静态标记.
+         * @sa  void setStatic(bool isStatic)
+         */
+        bool isStatic() const;
+
+        /**
+         * @fn  StaticBatch *SceneNode::getStaticBatch() const;
+         * @brief   获取结点所在的静态合批
+         * @return  没有合批返回 nullptr.
+         */
+        StaticBatch *getStaticBatch() const;
+
         /**
          * @fn  virtual void SceneNode::visit();
          * @brief   递归遍历
@@ -128,26 +176,41 @@ namespace Tiny3D
         virtual void visit();
 
         /**
-         * @fn  virtual void SceneNode::frustumCulling(BoundPtr bound, 
-         *      RenderQueuePtr queue);
+         * @fn  virtual void SceneNode::frustumCulling(Bound *bound, 
+         *      RenderQueue *queue);
          * @brief   视景体外物体剔除，递归调用所有子结点
          * @param [in]  bound   : 视锥体碰撞体.
          * @param [in]  queue   : 渲染队列.
          * @note
          *  - 如果本身不在视景体内，则所有子结点上的物体都会被剔除，不参与渲染；
          *  - 如果本身在视景体内，则会递归调用子结点判断；
-         *  - 如果不是可渲染结点，则无法加入的RenderQueue中；.
+         *  - 如果不是可渲染结点，则无法加入的RenderQueue中；
+         *  - 每帧每个结点都会调用，参数只借用，不持有引用.
          */
-        virtual void frustumCulling(BoundPtr bound, RenderQueuePtr queue);
+        virtual void frustumCulling(Bound *bound, RenderQueue *queue);
 
         /**
-         * @fn  ComponentPtr SceneNode::addComponent(const String &type);
+         * @fn  ComponentPtr SceneNode::addComponent(const Class *cls, ...);
          * @brief   Adds a component
-         * @param   type    The type.
+         * @param   cls     组件类，必须已经在 ComponentRegistry 中注册.
+         * @param   ...     传给组件创建函数的参数.
          * @return  A ComponentPtr.
          */
         ComponentPtr addComponent(const Class *cls, ...);
 
+        /**
+         * @fn  template <typename T, typename... Args> 
+         *      SmartPtr<T> SceneNode::addComponent(Args&&... args);
+         * @brief   添加组件，直接调用 T::create(args...) 创建组件对象
+         * @tparam  T       组件类型.
+         * @param   args    T::create 的参数.
+         * @return  返回新建的组件对象，失败返回 nullptr.
+         * @remarks 参数类型在编译期检查，不走变参和注册表，批量实例化结点时
+         *          优先使用本接口.
+         */
+        template <typename T, typename... Args>
+        SmartPtr<T> addComponent(Args&&... args);
+
         /**
          * @fn  ComponentPtr SceneNode::getComponent(const String &type) const;
          * @brief   Gets a component
@@ -156,6 +219,15 @@ namespace Tiny3D
          */
         ComponentPtr getComponent(const Class *cls) const;
 
+        /**
+         * @fn  template <typename T> SmartPtr<T> SceneNode::getComponent() const;
+         * @brief   获取指定类型的组件
+         * @tparam  T   组件类型.
+         * @return  没有该组件返回 nullptr.
+         */
+        template <typename T>
+        SmartPtr<T> getComponent() const;
+
         /**
          * @fn  void SceneNode::removeComponent(const String &type);
          * @brief   Removes the component described by type
@@ -214,8 +286,75 @@ namespace Tiny3D
          */
         virtual TResult cloneProperties(NodePtr node) const override;
 
+        /**
+         * @fn  TResult SceneNode::instantiateProperties(SceneNode *node) const;
+         * @brief   把本结点属性、组件实例和子结点实例复制给目标结点
+         * @param [in]  node    : 目标结点.
+         * @return  成功返回 T3D_OK.
+         */
+        TResult instantiateProperties(SceneNode *node) const;
+
         uint32_t getComponentOrder(const Class *cls) const;
 
+        /**
+         * @fn  uint32_t SceneNode::checkComponent(const Class *cls) const;
+         * @brief   检查能否添加组件
+         * @param [in]  cls : 组件类.
+         * @return  可以添加返回组件执行顺序，否则返回 ComponentOrder::INVALID.
+         */
+        uint32_t checkComponent(const Class *cls) const;
+
+        /**
+         * @fn  TResult SceneNode::attachComponent(const Class *cls, 
+         *      uint32_t order, Component *component);
+         * @brief   把新建的组件挂到结点上
+         * @param [in]  cls         : 组件类.
+         * @param [in]  order       : 组件执行顺序.
+         * @param [in]  component   : 组件对象.
+         * @return  调用成功返回 T3D_OK.
+         */
+        TResult attachComponent(const Class *cls, uint32_t order, 
+            Component *component);
+
+        /**
+         * @fn  virtual void SceneNode::onAttachParent(NodePtr parent) override;
+         * @brief   从父类继承，同步变换存储里的父变换
+         * @param [in]  parent  : 挂上去的父结点.
+         */
+        virtual void onAttachParent(NodePtr parent) override;
+
+        /**
+         * @fn  virtual void SceneNode::onDetachParent(NodePtr parent) override;
+         * @brief   从父类继承，同步变换存储里的父变换
+         * @param [in]  parent  : 拿下来的父结点.
+         */
+        virtual void onDetachParent(NodePtr parent) override;
+
+        /**
+         * @fn  void SceneNode::updateActive(bool parentActive);
+         * @brief   根据父结点的状态更新结点及其子结点的 mIsActive
+         * @param [in]  parentActive    : 父结点是否可用，没有父结点时为 true.
+         */
+        void updateActive(bool parentActive);
+
+        /**
+         * @fn  bool SceneNode::isInScene() const;
+         * @brief   结点是否在场景管理器的根结点下
+         */
+        bool isInScene() const;
+
+        /**
+         * @fn  void SceneNode::storeComponents(ComponentStore *store);
+         * @brief   把结点及其子结点上的组件都放进组件存储
+         */
+        void storeComponents(ComponentStore *store);
+
+        /**
+         * @fn  void SceneNode::unstoreComponents(ComponentStore *store);
+         * @brief   把结点及其子结点上的组件都从组件存储里移除
+         */
+        void unstoreComponents(ComponentStore *store);
+
     private:
         typedef TMap<uint32_t, Component*>      ComponentQueue;
         typedef ComponentQueue::iterator        ComponentQueueItr;
@@ -224,7 +363,9 @@ namespace Tiny3D
 
         bool        mIsVisible;     /**< 结点可见性 */
         bool        mIsEnabled;     /**< 结点可用性 */
+        bool        mIsActive;      /**< 结点和所有祖先结点都可用 */
         bool        mIsDirty;
+        bool        mIsStatic;      /**< 是否静态结点 */
         uint32_t    mCameraMask;    /**< 相机掩码 */
 
         ComponentQueue  mComponentQueue;/**< The components */
@@ -233,8 +374,9 @@ namespace Tiny3D
         Bound           *mCollider;
         Renderable      *mRenderable;   /**< The renderable */
 
-        SceneNode       *mPrev;
-        SceneNode       *mNext;
+        int32_t         mCullingProxy;  /**< 场景管理器剔除树中的代理ID */
+        int32_t         mUnboundedIdx;  /**< 在没有包围盒的结点列表中的索引 */
+        StaticBatch     *mStaticBatch;  /**< 结点所在的静态合批 */
     };
 }
 
@@ -36,8 +36,66 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    inline bool SceneNode::isActive() const
+    {
+        return mIsActive;
+    }
+
+    //--------------------------------------------------------------------------
+
     inline uint32_t SceneNode::getCameraMask() const
     {
         return mCameraMask;
     }
+
+    //--------------------------------------------------------------------------
+
+    inline void SceneNode::setStatic(bool isStatic)
+    {
+        mIsStatic = isStatic;
+    }
+
+    //--------------------------------------------------------------------------
+
+    inline bool SceneNode::isStatic() const
+    {
+        return mIsStatic;
+    }
+
+    //--------------------------------------------------------------------------
+
+    inline StaticBatch *SceneNode::getStaticBatch() const
+    {
+        return mStaticBatch;
+    }
+
+    //--------------------------------------------------------------------------
+
+    template <typename T, typename... Args>
+    inline SmartPtr<T> SceneNode::addComponent(Args&&... args)
+    {
+        SmartPtr<T> component;
+        uint32_t order = checkComponent(T3D_CLASS(T));
+
+        if (ComponentOrder::INVALID != order)
+        {
+            component = T::create(std::forward<Args>(args)...);
+
+            if (component != nullptr 
+                && T3D_FAILED(attachComponent(T3D_CLASS(T), order, component)))
+            {
+                component = nullptr;
+            }
+        }
+
+        return component;
+    }
+
+    //--------------------------------------------------------------------------
+
+    template <typename T>
+    inline SmartPtr<T> SceneNode::getComponent() const
+    {
+        return smart_pointer_cast<T>(getComponent(T3D_CLASS(T)));
+    }
 }
@@ -0,0 +1,239 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#ifndef __T3D_TRANSFORM_STORE_H__
+#define __T3D_TRANSFORM_STORE_H__
+
+
+#include "T3DPrerequisites.h"
+#include "T3DTypedef.h"
+#include "Kernel/T3DTransform.h"
+
+
+namespace Tiny3D
+{
+    /**
+     * @class   TransformStore
+     * @brief   面向数据的变换层次存储
+     * @remarks 所有变换的局部位置、朝向、缩放和世界变换各自放在连续数组里，
+     *          按照层级排序，父结点一定在子结点前面，同一层的结点连续存放。
+     *          修改局部变换只设置脏标记，不遍历子结点。每帧 update 按层顺序
+     *          扫描一遍数组：父结点脏了子结点也标记为脏，脏的结点用父结点的
+     *          世界变换重新计算自己的世界变换。同一层结点之间互不依赖，
+     *          结点多的层可以交给任务系统并行计算。
+     *          外部用句柄引用变换，句柄在销毁前一直有效；添加、删除结点和
+     *          修改父结点只做标记，下次 update 时统一重新排序。
+     */
+    class T3D_ENGINE_API TransformStore
+    {
+    public:
+        typedef uint32_t    Handle;
+
+        /**
+         * @brief 无效句柄
+         */
+        static const Handle INVALID_HANDLE;
+
+        /**
+         * @brief 并行计算时每块的结点数量，一层的结点少于这个数量时不并行
+         */
+        static const size_t SWEEP_GRAIN;
+
+        /**
+         * @brief 构造函数
+         */
+        TransformStore();
+
+        /**
+         * @brief 析构函数
+         */
+        ~TransformStore();
+
+        /**
+         * @brief 创建一个变换
+         * @param [in] parent : 父变换句柄，INVALID_HANDLE 表示没有父变换
+         * @param [in] userData : 用户数据
+         * @return 返回变换句柄
+         * @remarks 新变换的局部变换为单位变换，并且标记为脏
+         */
+        Handle create(Handle parent, void *userData);
+
+        /**
+         * @brief 销毁变换
+         * @param [in] handle : 变换句柄
+         * @remarks 子变换在下次 update 时变成没有父变换
+         */
+        void destroy(Handle handle);
+
+        /**
+         * @brief 修改父变换
+         * @param [in] handle : 变换句柄
+         * @param [in] parent : 新的父变换句柄，INVALID_HANDLE 表示没有父变换
+         */
+        void setParent(Handle handle, Handle parent);
+
+        /**
+         * @brief 获取父变换
+         * @param [in] handle : 变换句柄
+         */
+        Handle getParent(Handle handle) const;
+
+        /**
+         * @brief 设置局部变换，并且标记为脏
+         * @param [in] handle : 变换句柄
+         * @param [in] position : 父变换空间下的位置
+         * @param [in] orientation : 父变换空间下的朝向
+         * @param [in] scaling : 父变换空间下的缩放
+         */
+        void setLocal(Handle handle, const Vector3 &position, 
+            const Quaternion &orientation, const Vector3 &scaling);
+
+        /**
+         * @brief 获取上一次 update 计算的世界变换
+         * @param [in] handle : 变换句柄
+         */
+        const Transform &getWorldTransform(Handle handle) const;
+
+        /**
+         * @brief 获取用户数据
+         * @param [in] handle : 变换句柄
+         */
+        void *getUserData(Handle handle) const;
+
+        /**
+         * @brief 是否有还没有 update 的修改
+         * @remarks 返回 false 时上一次 update 的结果就是最新的世界变换
+         */
+        bool isDirty() const { return mHasDirty || mNeedRebuild; }
+
+        /**
+         * @brief 获取变换数量
+         */
+        size_t getCount() const { return mSlotCount; }
+
+        /**
+         * @brief 获取层数，只有根变换时为1
+         */
+        size_t getLevelCount() const;
+
+        /**
+         * @brief 按层扫描，重新计算所有脏变换的世界变换
+         * @param [in] jobs : 任务系统，为 nullptr 时全部在当前线程计算
+         */
+        void update(JobSystem *jobs = nullptr);
+
+        /**
+         * @brief 获取上一次 update 中世界变换发生变化的变换数量
+         */
+        size_t getChangedCount() const { return mChanged.size(); }
+
+        /**
+         * @brief 获取上一次 update 中世界变换发生变化的变换的用户数据
+         * @param [in] index : 0 到 getChangedCount() - 1
+         */
+        void *getChangedUserData(size_t index) const;
+
+        /**
+         * @brief 获取上一次 update 中世界变换发生变化的变换的世界变换
+         * @param [in] index : 0 到 getChangedCount() - 1
+         */
+        const Transform &getChangedWorldTransform(size_t index) const;
+
+        /**
+         * @brief 遍历所有有效变换的用户数据
+         * @param [in] index : 0 到 getCapacity() - 1
+         * @return 无效位置返回 nullptr
+         */
+        void *getUserDataAt(size_t index) const;
+
+        /**
+         * @brief 获取数组容量，包括已经销毁还没有回收的位置
+         */
+        size_t getCapacity() const { return mHandles.size(); }
+
+    protected:
+        /**
+         * @brief 句柄对应的信息
+         */
+        struct Slot
+        {
+            uint32_t    index;      /**< 在数组中的位置，空闲时是下一个空闲句柄 */
+            Handle      parent;     /**< 父变换句柄 */
+            int32_t     depth;      /**< 层级，重新排序时使用，空闲时为 -1 */
+        };
+
+        typedef TArray<Slot>        Slots;
+        typedef TArray<Handle>      Handles;
+        typedef TArray<int32_t>     Parents;
+        typedef TArray<Vector3>     Vectors;
+        typedef TArray<Quaternion>  Quaternions;
+        typedef TArray<Transform>   Transforms;
+        typedef TArray<uint8_t>     Flags;
+        typedef TArray<void*>       UserData;
+        typedef TArray<size_t>      Offsets;
+        typedef TArray<uint32_t>    Indices;
+
+        /**
+         * @brief 计算所有变换的层级，按层级重新排列数组
+         */
+        void rebuild();
+
+        /**
+         * @brief 计算一段连续结点的世界变换，这段结点必须在同一层
+         */
+        void sweep(size_t begin, size_t end);
+
+    protected:
+        Slots           mSlots;         /**< 句柄信息 */
+        Handle          mFreeList;      /**< 空闲句柄链表 */
+        size_t          mSlotCount;     /**< 有效变换数量 */
+
+        Handles         mHandles;       /**< 每个位置的句柄，已销毁为无效句柄 */
+        Parents         mParents;       /**< 父变换的位置，没有父变换为 -1 */
+        Vectors         mPositions;     /**< 局部位置 */
+        Quaternions     mOrientations;  /**< 局部朝向 */
+        Vectors         mScalings;      /**< 局部缩放 */
+        Transforms      mWorlds;        /**< 世界变换 */
+        Flags           mDirty;         /**< 脏标记 */
+        UserData        mUserData;      /**< 用户数据 */
+
+        Offsets         mLevels;        /**< 每层起始位置，最后一个是结束位置 */
+        Indices         mChanged;       /**< 上一次 update 中发生变化的位置 */
+
+        Handles         mChain;         /**< 重新排序时向上查找层级的临时链表 */
+        Offsets         mCursor;        /**< 重新排序时每层的写入位置 */
+
+        // 重新排序时写入的数组，排完跟上面对应的数组交换，保留容量下次再用
+        Handles         mScratchHandles;        /**< 句柄 */
+        Parents         mScratchParents;        /**< 父变换的位置 */
+        Vectors         mScratchPositions;      /**< 局部位置 */
+        Quaternions     mScratchOrientations;   /**< 局部朝向 */
+        Vectors         mScratchScalings;       /**< 局部缩放 */
+        Transforms      mScratchWorlds;         /**< 世界变换 */
+        Flags           mScratchDirty;          /**< 脏标记 */
+        UserData        mScratchUserData;       /**< 用户数据 */
+
+        bool            mNeedRebuild;   /**< 是否需要重新排序 */
+        bool            mHasDirty;      /**< 是否有脏变换 */
+    };
+}
+
+
+#endif  /*__T3D_TRANSFORM_STORE_H__*/
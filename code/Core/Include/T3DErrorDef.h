@@ -65,6 +65,7 @@ namespace Tiny3D
         T3D_ERR_RES_COMPILED            = T3D_ERR_CORE + 0x00b2, /**< 编译脚本失败 */
 
         T3D_ERR_RENDER_CREATE_WINDOW    = T3D_ERR_CORE + 0x00C0, /**< 创建渲染窗口失败 */
+        T3D_ERR_RENDER_NOT_SUPPORTED    = T3D_ERR_CORE + 0x00C1, /**< 渲染器不支持该功能 */
 
         T3D_ERR_HW_BUFFER_WRITE         = T3D_ERR_CORE + 0x00E0, /**< 写硬件缓冲失败 */
         T3D_ERR_HW_BUFFER_READ          = T3D_ERR_CORE + 0x00E1, /**< 读硬件缓冲失败 */
@@ -57,10 +57,12 @@ namespace Tiny3D
     #define LOG_TAG_COMPONENT           "Component"
 
     class Object;
+    class ObjectPool;
     class ObjectTracer;
 
     class Agent;
     class Plugin;
+    class JobSystem;
 
     class Variant;
 
@@ -134,12 +136,12 @@ namespace Tiny3D
 
     class RenderTarget;
     class RenderWindow;
+    class RenderTexture;
     
     class Viewport;
 
     class RenderContext;
     class RenderCapabilities;
-    class RenderGroup;
     class RenderQueue;
 
     class BlendState;
@@ -161,6 +163,8 @@ namespace Tiny3D
     class SceneManagerBase;
     class SceneManager;
     class DefaultSceneMgr;
+    class TransformStore;
+    class ComponentStore;
 
     class SceneNode;
 
@@ -179,6 +183,7 @@ namespace Tiny3D
     class Cube;
     class Axis;
     class Globe;
+    class StaticBatch;
 
     class SceneTransform2D;
     class SceneText2D;
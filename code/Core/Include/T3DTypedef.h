@@ -99,13 +99,13 @@ namespace Tiny3D
 
     T3D_DECLARE_SMART_PTR(RenderTarget);
     T3D_DECLARE_SMART_PTR(RenderWindow);
+    T3D_DECLARE_SMART_PTR(RenderTexture);
 
     T3D_DECLARE_SMART_PTR(Viewport);
 
     T3D_DECLARE_SMART_PTR(RenderContext);
     T3D_DECLARE_SMART_PTR(RenderCapabilities);
 
-    T3D_DECLARE_SMART_PTR(RenderGroup);
     T3D_DECLARE_SMART_PTR(RenderQueue);
 
     T3D_DECLARE_SMART_PTR(BlendState);
@@ -146,6 +146,7 @@ namespace Tiny3D
     T3D_DECLARE_SMART_PTR(Cube);
     T3D_DECLARE_SMART_PTR(Axis);
     T3D_DECLARE_SMART_PTR(Globe);
+    T3D_DECLARE_SMART_PTR(StaticBatch);
 
     T3D_DECLARE_SMART_PTR(SceneTransform2D);
     T3D_DECLARE_SMART_PTR(SceneSprite);
@@ -30,10 +30,12 @@
 // Kernel
 #include <Kernel/T3DCommon.h>
 #include <Kernel/T3DAgent.h>
+#include <Kernel/T3DJobSystem.h>
 #include <Kernel/T3DConfigFile.h>
 #include <Kernel/T3DCreator.h>
 #include <Kernel/T3DObject.h>
 #include <Kernel/T3DPlugin.h>
+#include <Kernel/T3DStringInterner.h>
 #include <Kernel/T3DNode.h>
 #include <Kernel/T3DBlendMode.h>
 #include <Kernel/T3DTechnique.h>
@@ -43,6 +45,7 @@
 
 // Memory
 #include <Memory/T3DSmartPtr.h>
+#include <Memory/T3DObjectPool.h>
 #include <Memory/T3DObjectTracer.h>
 
 // Resource
@@ -83,8 +86,11 @@
 #include <Render/T3DRenderCapabilities.h>
 #include <Render/T3DRenderState.h>
 #include <Render/T3DRenderQueue.h>
+#include <Render/T3DRenderStatistics.h>
+#include <Render/T3DRenderStateCache.h>
 #include <Render/T3DRenderTarget.h>
 #include <Render/T3DRenderWindow.h>
+#include <Render/T3DRenderTexture.h>
 #include <Render/T3DViewport.h>
 #include <Render/T3DHardwareBufferManagerBase.h>
 #include <Render/T3DHardwareBufferManager.h>
@@ -101,14 +107,19 @@
 #include <Bound/T3DAabbBound.h>
 #include <Bound/T3DObbBound.h>
 #include <Bound/T3DFrustumBound.h>
+#include <Bound/T3DFrustumCuller.h>
+#include <Bound/T3DDynamicAabbTree.h>
 
 // Scene Graph
 #include <Scene/T3DSceneNode.h>
+#include <Scene/T3DTransformStore.h>
+#include <Scene/T3DComponentStore.h>
 #include <Scene/T3DSceneManager.h>
 
 // Component
 #include <Component/T3DComponent.h>
 #include <Component/T3DComponentCreator.h>
+#include <Component/T3DComponentRegistry.h>
 #include <Component/T3DAxis.h>
 #include <Component/T3DBillboard.h>
 #include <Component/T3DCube.h>
@@ -118,6 +129,7 @@
 #include <Component/T3DQuad.h>
 #include <Component/T3DRenderable.h>
 #include <Component/T3DGlobe.h>
+#include <Component/T3DStaticBatch.h>
 #include <Component/T3DTransform3D.h>
 
 
@@ -21,6 +21,8 @@
 #include "Bound/T3DAabbBound.h"
 #include "Component/T3DCube.h"
 #include "Scene/T3DSceneNode.h"
+#include "Scene/T3DSceneManager.h"
+#include "Component/T3DComponentRegistry.h"
 
 
 namespace Tiny3D
@@ -28,6 +30,8 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     T3D_IMPLEMENT_CLASS_1(AabbBound, Bound);
+    T3D_IMPLEMENT_POOL(AabbBound, 128);
+    T3D_REGISTER_COMPONENT(AabbBound);
 
     //--------------------------------------------------------------------------
 
@@ -86,8 +90,12 @@ namespace Tiny3D
             AabbBoundPtr aabbBound = smart_pointer_cast<AabbBound>(bound);
             aabbBound->mAabb = mAabb;
             aabbBound->mOriginalAabb = mOriginalAabb;
-            aabbBound->mRenderable
-                = smart_pointer_cast<Cube>(mRenderable->clone());
+            // 调试用的渲染体只和形状有关，实例之间共享顶点数据
+            if (mRenderable != nullptr)
+            {
+                aabbBound->mRenderable = smart_pointer_cast<Cube>(
+                    mRenderable->instantiate());
+            }
         }
 
         return ret;
@@ -143,6 +151,14 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    bool AabbBound::getWorldAabb(Aabb &aabb) const
+    {
+        aabb = mAabb;
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+
     void AabbBound::update()
     {
         // 这里不用传统的变换8个顶点，然后逐个比较获取最大x,y,z来重新设置AABB
@@ -284,6 +300,9 @@ namespace Tiny3D
             mAabb.setParam(vMin, vMax);
 
             mIsDirty = false;
+
+            // 通知场景管理器更新剔除用的包围盒
+            T3D_SCENE_MGR.updateSceneNode(getSceneNode());
         }
     }
 }
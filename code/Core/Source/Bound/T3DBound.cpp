@@ -52,7 +52,7 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
-    bool Bound::test(BoundPtr bound) const
+    bool Bound::test(Bound *bound) const
     {
         bool ret = false;
 
@@ -60,26 +60,25 @@ namespace Tiny3D
         {
         case Type::SPHERE:
             {
-                SphereBoundPtr sphere = smart_pointer_cast<SphereBound>(bound);
+                SphereBound *sphere = static_cast<SphereBound *>(bound);
                 ret = testSphere(sphere->getSphere());
             }
             break;
         case Type::AABB:
             {
-                AabbBoundPtr aabb = smart_pointer_cast<AabbBound>(bound);
+                AabbBound *aabb = static_cast<AabbBound *>(bound);
                 ret = testAabb(aabb->getAlignAxisBox());
             }
             break;
         case Type::OBB:
             {
-                ObbBoundPtr obb = smart_pointer_cast<ObbBound>(bound);
+                ObbBound *obb = static_cast<ObbBound *>(bound);
                 ret = testObb(obb->getObb());
             }
             break;
         case Type::FRUSTUM:
             {
-                FrustumBoundPtr frustum
-                    = smart_pointer_cast<FrustumBound>(bound);
+                FrustumBound *frustum = static_cast<FrustumBound *>(bound);
                 ret = testFrustum(frustum->getFrustum());
             }
             break;
@@ -110,6 +109,13 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    bool Bound::getWorldAabb(Aabb &aabb) const
+    {
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+
     void Bound::updateTransform(const Transform3D *xform)
     {
         mIsDirty = true;
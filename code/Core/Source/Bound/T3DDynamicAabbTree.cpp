@@ -0,0 +1,675 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#include "Bound/T3DDynamicAabbTree.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    const int32_t DynamicAabbTree::NULL_NODE = -1;
+    const Real DynamicAabbTree::DEFAULT_FAT_RATIO = Real(0.1);
+
+    //--------------------------------------------------------------------------
+
+    DynamicAabbTree::DynamicAabbTree()
+        : mRoot(NULL_NODE)
+        , mFreeList(NULL_NODE)
+        , mProxyCount(0)
+        , mFatRatio(DEFAULT_FAT_RATIO)
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    DynamicAabbTree::~DynamicAabbTree()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    int32_t DynamicAabbTree::allocateNode()
+    {
+        if (mFreeList == NULL_NODE)
+        {
+            // 空闲链表用完了，结点数组扩大一倍，新结点串进空闲链表
+            size_t oldCount = mNodes.size();
+            size_t newCount = (oldCount == 0 ? 16 : oldCount * 2);
+            mNodes.resize(newCount);
+
+            size_t i = 0;
+            for (i = oldCount; i < newCount; ++i)
+            {
+                TreeNode &node = mNodes[i];
+                node.parent = (i + 1 < newCount ? int32_t(i + 1) : NULL_NODE);
+                node.height = -1;
+            }
+
+            mFreeList = int32_t(oldCount);
+        }
+
+        int32_t nodeID = mFreeList;
+        TreeNode &node = mNodes[nodeID];
+        mFreeList = node.parent;
+
+        node.parent = NULL_NODE;
+        node.child1 = NULL_NODE;
+        node.child2 = NULL_NODE;
+        node.height = 0;
+        node.mask = 0;
+        node.lastPlane = 0;
+        node.userData = nullptr;
+
+        return nodeID;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DynamicAabbTree::freeNode(int32_t nodeID)
+    {
+        TreeNode &node = mNodes[nodeID];
+        node.parent = mFreeList;
+        node.height = -1;
+        node.userData = nullptr;
+        mFreeList = nodeID;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DynamicAabbTree::setFatAabb(TreeNode &node, const Aabb &aabb) const
+    {
+        Real dx = (aabb.getMaxX() - aabb.getMinX()) * mFatRatio;
+        Real dy = (aabb.getMaxY() - aabb.getMinY()) * mFatRatio;
+        Real dz = (aabb.getMaxZ() - aabb.getMinZ()) * mFatRatio;
+
+        node.minimum[0] = aabb.getMinX() - dx;
+        node.minimum[1] = aabb.getMinY() - dy;
+        node.minimum[2] = aabb.getMinZ() - dz;
+        node.maximum[0] = aabb.getMaxX() + dx;
+        node.maximum[1] = aabb.getMaxY() + dy;
+        node.maximum[2] = aabb.getMaxZ() + dz;
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool DynamicAabbTree::contains(const TreeNode &node, const Aabb &aabb)
+    {
+        return node.minimum[0] <= aabb.getMinX() 
+            && node.minimum[1] <= aabb.getMinY()
+            && node.minimum[2] <= aabb.getMinZ()
+            && node.maximum[0] >= aabb.getMaxX()
+            && node.maximum[1] >= aabb.getMaxY()
+            && node.maximum[2] >= aabb.getMaxZ();
+    }
+
+    //--------------------------------------------------------------------------
+
+    Real DynamicAabbTree::perimeter(const TreeNode &node)
+    {
+        Real wx = node.maximum[0] - node.minimum[0];
+        Real wy = node.maximum[1] - node.minimum[1];
+        Real wz = node.maximum[2] - node.minimum[2];
+        return wx * wy + wy * wz + wz * wx;
+    }
+
+    //--------------------------------------------------------------------------
+
+    Real DynamicAabbTree::mergedPerimeter(const TreeNode &a, const TreeNode &b)
+    {
+        Real wx = std::max(a.maximum[0], b.maximum[0]) 
+            - std::min(a.minimum[0], b.minimum[0]);
+        Real wy = std::max(a.maximum[1], b.maximum[1])
+            - std::min(a.minimum[1], b.minimum[1]);
+        Real wz = std::max(a.maximum[2], b.maximum[2])
+            - std::min(a.minimum[2], b.minimum[2]);
+        return wx * wy + wy * wz + wz * wx;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DynamicAabbTree::combine(int32_t parent)
+    {
+        TreeNode &node = mNodes[parent];
+        const TreeNode &c1 = mNodes[node.child1];
+        const TreeNode &c2 = mNodes[node.child2];
+
+        size_t i = 0;
+        for (i = 0; i < 3; ++i)
+        {
+            node.minimum[i] = std::min(c1.minimum[i], c2.minimum[i]);
+            node.maximum[i] = std::max(c1.maximum[i], c2.maximum[i]);
+        }
+
+        node.height = 1 + std::max(c1.height, c2.height);
+        node.mask = (c1.mask | c2.mask);
+    }
+
+    //--------------------------------------------------------------------------
+
+    int32_t DynamicAabbTree::createProxy(const Aabb &aabb, uint32_t mask,
+        void *userData)
+    {
+        int32_t proxyID = allocateNode();
+        TreeNode &node = mNodes[proxyID];
+
+        setFatAabb(node, aabb);
+        node.userData = userData;
+        node.mask = mask;
+        node.height = 0;
+
+        insertLeaf(proxyID);
+        mProxyCount++;
+
+        return proxyID;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DynamicAabbTree::destroyProxy(int32_t proxyID)
+    {
+        T3D_ASSERT(proxyID >= 0 && proxyID < (int32_t)mNodes.size());
+        T3D_ASSERT(mNodes[proxyID].isLeaf());
+
+        removeLeaf(proxyID);
+        freeNode(proxyID);
+        mProxyCount--;
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool DynamicAabbTree::moveProxy(int32_t proxyID, const Aabb &aabb)
+    {
+        T3D_ASSERT(proxyID >= 0 && proxyID < (int32_t)mNodes.size());
+        T3D_ASSERT(mNodes[proxyID].isLeaf());
+
+        if (contains(mNodes[proxyID], aabb))
+        {
+            // 还在扩大的范围内，树不需要变化
+            return false;
+        }
+
+        removeLeaf(proxyID);
+        setFatAabb(mNodes[proxyID], aabb);
+        insertLeaf(proxyID);
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DynamicAabbTree::setProxyMask(int32_t proxyID, uint32_t mask)
+    {
+        T3D_ASSERT(proxyID >= 0 && proxyID < (int32_t)mNodes.size());
+        T3D_ASSERT(mNodes[proxyID].isLeaf());
+
+        mNodes[proxyID].mask = mask;
+
+        int32_t nodeID = mNodes[proxyID].parent;
+        while (nodeID != NULL_NODE)
+        {
+            TreeNode &node = mNodes[nodeID];
+            node.mask = (mNodes[node.child1].mask | mNodes[node.child2].mask);
+            nodeID = node.parent;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DynamicAabbTree::insertLeaf(int32_t leaf)
+    {
+        if (mRoot == NULL_NODE)
+        {
+            mRoot = leaf;
+            mNodes[mRoot].parent = NULL_NODE;
+            return;
+        }
+
+        // 从根结点往下找插入后总面积增量最小的兄弟结点
+        int32_t index = mRoot;
+
+        while (!mNodes[index].isLeaf())
+        {
+            const TreeNode &node = mNodes[index];
+            const TreeNode &leafNode = mNodes[leaf];
+            int32_t child1 = node.child1;
+            int32_t child2 = node.child2;
+
+            Real area = perimeter(node);
+            Real combinedArea = mergedPerimeter(node, leafNode);
+
+            // 在这里新建父结点，把叶子和当前结点作为兄弟的代价
+            Real cost = Real(2) * combinedArea;
+
+            // 继续往下走，祖先结点包围盒增大的代价
+            Real inheritanceCost = Real(2) * (combinedArea - area);
+
+            // 往 child1 方向下降的代价
+            Real cost1;
+            const TreeNode &c1 = mNodes[child1];
+            if (c1.isLeaf())
+            {
+                cost1 = mergedPerimeter(c1, leafNode) + inheritanceCost;
+            }
+            else
+            {
+                cost1 = mergedPerimeter(c1, leafNode) - perimeter(c1)
+                    + inheritanceCost;
+            }
+
+            // 往 child2 方向下降的代价
+            Real cost2;
+            const TreeNode &c2 = mNodes[child2];
+            if (c2.isLeaf())
+            {
+                cost2 = mergedPerimeter(c2, leafNode) + inheritanceCost;
+            }
+            else
+            {
+                cost2 = mergedPerimeter(c2, leafNode) - perimeter(c2)
+                    + inheritanceCost;
+            }
+
+            if (cost < cost1 && cost < cost2)
+            {
+                break;
+            }
+
+            index = (cost1 < cost2 ? child1 : child2);
+        }
+
+        int32_t sibling = index;
+
+        // 新建父结点，叶子和兄弟结点作为它的子结点
+        int32_t oldParent = mNodes[sibling].parent;
+        int32_t newParent = allocateNode();
+        mNodes[newParent].parent = oldParent;
+        mNodes[newParent].child1 = sibling;
+        mNodes[newParent].child2 = leaf;
+        combine(newParent);
+
+        if (oldParent != NULL_NODE)
+        {
+            if (mNodes[oldParent].child1 == sibling)
+            {
+                mNodes[oldParent].child1 = newParent;
+            }
+            else
+            {
+                mNodes[oldParent].child2 = newParent;
+            }
+        }
+        else
+        {
+            mRoot = newParent;
+        }
+
+        mNodes[sibling].parent = newParent;
+        mNodes[leaf].parent = newParent;
+
+        refit(oldParent);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DynamicAabbTree::removeLeaf(int32_t leaf)
+    {
+        if (leaf == mRoot)
+        {
+            mRoot = NULL_NODE;
+            return;
+        }
+
+        // 父结点删掉，兄弟结点顶替父结点的位置
+        int32_t parent = mNodes[leaf].parent;
+        int32_t grandParent = mNodes[parent].parent;
+        int32_t sibling = (mNodes[parent].child1 == leaf 
+            ? mNodes[parent].child2 : mNodes[parent].child1);
+
+        if (grandParent != NULL_NODE)
+        {
+            if (mNodes[grandParent].child1 == parent)
+            {
+                mNodes[grandParent].child1 = sibling;
+            }
+            else
+            {
+                mNodes[grandParent].child2 = sibling;
+            }
+
+            mNodes[sibling].parent = grandParent;
+            freeNode(parent);
+
+            refit(grandParent);
+        }
+        else
+        {
+            mRoot = sibling;
+            mNodes[sibling].parent = NULL_NODE;
+            freeNode(parent);
+        }
+
+        mNodes[leaf].parent = NULL_NODE;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DynamicAabbTree::refit(int32_t nodeID)
+    {
+        while (nodeID != NULL_NODE)
+        {
+            nodeID = balance(nodeID);
+            combine(nodeID);
+            nodeID = mNodes[nodeID].parent;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    int32_t DynamicAabbTree::balance(int32_t iA)
+    {
+        // A 的两个子树高度差超过1的时候，把较高的子结点旋转上来
+        /*
+                  A               C
+                /   \           /   \
+               B     C   =>    A     F
+                    / \       / \
+                   F   G     B   G
+        */
+        TreeNode *A = &mNodes[iA];
+        if (A->isLeaf() || A->height < 2)
+        {
+            return iA;
+        }
+
+        int32_t iB = A->child1;
+        int32_t iC = A->child2;
+
+        int32_t diff = mNodes[iC].height - mNodes[iB].height;
+
+        if (diff > 1)
+        {
+            // C 比较高，C 旋转上来
+            TreeNode *C = &mNodes[iC];
+            int32_t iF = C->child1;
+            int32_t iG = C->child2;
+
+            C->child1 = iA;
+            C->parent = A->parent;
+            A->parent = iC;
+
+            if (C->parent != NULL_NODE)
+            {
+                TreeNode &P = mNodes[C->parent];
+                if (P.child1 == iA)
+                {
+                    P.child1 = iC;
+                }
+                else
+                {
+                    P.child2 = iC;
+                }
+            }
+            else
+            {
+                mRoot = iC;
+            }
+
+            // F、G 里较高的留在 C 下面，较矮的挂到 A 下面
+            if (mNodes[iF].height > mNodes[iG].height)
+            {
+                C->child2 = iF;
+                A->child2 = iG;
+                mNodes[iG].parent = iA;
+            }
+            else
+            {
+                C->child2 = iG;
+                A->child2 = iF;
+                mNodes[iF].parent = iA;
+            }
+
+            combine(iA);
+            combine(iC);
+            return iC;
+        }
+
+        if (diff < -1)
+        {
+            // B 比较高，B 旋转上来
+            TreeNode *B = &mNodes[iB];
+            int32_t iD = B->child1;
+            int32_t iE = B->child2;
+
+            B->child1 = iA;
+            B->parent = A->parent;
+            A->parent = iB;
+
+            if (B->parent != NULL_NODE)
+            {
+                TreeNode &P = mNodes[B->parent];
+                if (P.child1 == iA)
+                {
+                    P.child1 = iB;
+                }
+                else
+                {
+                    P.child2 = iB;
+                }
+            }
+            else
+            {
+                mRoot = iB;
+            }
+
+            if (mNodes[iD].height > mNodes[iE].height)
+            {
+                B->child2 = iD;
+                A->child1 = iE;
+                mNodes[iE].parent = iA;
+            }
+            else
+            {
+                B->child2 = iE;
+                A->child1 = iD;
+                mNodes[iD].parent = iA;
+            }
+
+            combine(iA);
+            combine(iB);
+            return iB;
+        }
+
+        return iA;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DynamicAabbTree::PendingLeaves::clear()
+    {
+        centerX.clear();
+        centerY.clear();
+        centerZ.clear();
+        extentX.clear();
+        extentY.clear();
+        extentZ.clear();
+        lastPlanes.clear();
+        nodes.clear();
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DynamicAabbTree::PendingLeaves::add(const TreeNode &node, 
+        int32_t nodeID)
+    {
+        Real cx = (node.minimum[0] + node.maximum[0]) * Real(0.5);
+        Real cy = (node.minimum[1] + node.maximum[1]) * Real(0.5);
+        Real cz = (node.minimum[2] + node.maximum[2]) * Real(0.5);
+        centerX.push_back(cx);
+        centerY.push_back(cy);
+        centerZ.push_back(cz);
+        extentX.push_back(node.maximum[0] - cx);
+        extentY.push_back(node.maximum[1] - cy);
+        extentZ.push_back(node.maximum[2] - cz);
+        lastPlanes.push_back(node.lastPlane);
+        nodes.push_back(nodeID);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DynamicAabbTree::query(const Frustum &frustum, uint32_t mask,
+        TArray<void*> &result) const
+    {
+        if (mRoot == NULL_NODE)
+        {
+            return;
+        }
+
+        // 平面系数展开到数组里，避免每次构造法线
+        const uint32_t FACE_COUNT = Frustum::E_MAX_FACE;
+        const uint32_t ALL_FACES = (1U << FACE_COUNT) - 1;
+        Real planes[FACE_COUNT][4];
+
+        uint32_t i = 0;
+        for (i = 0; i < FACE_COUNT; ++i)
+        {
+            const Plane &plane = frustum.getFace((Frustum::Face)i);
+            planes[i][0] = plane[0];
+            planes[i][1] = plane[1];
+            planes[i][2] = plane[2];
+            planes[i][3] = plane[3];
+        }
+
+        // 栈里每个结点后面跟着还需要检测的平面位
+        mPending.clear();
+        mStack.clear();
+        mStack.push_back(mRoot);
+        mStack.push_back(int32_t(ALL_FACES));
+
+        while (!mStack.empty())
+        {
+            uint32_t faces = uint32_t(mStack.back());
+            mStack.pop_back();
+            int32_t nodeID = mStack.back();
+            mStack.pop_back();
+
+            const TreeNode &node = mNodes[nodeID];
+
+            if ((node.mask & mask) == 0)
+            {
+                // 整棵子树都不属于这个掩码
+                continue;
+            }
+
+            if (faces != 0 && node.isLeaf())
+            {
+                // 叶子留到最后批量检测
+                if (node.mask & mask)
+                {
+                    mPending.add(node, nodeID);
+                }
+                continue;
+            }
+
+            if (faces != 0)
+            {
+                Real cx = (node.minimum[0] + node.maximum[0]) * Real(0.5);
+                Real cy = (node.minimum[1] + node.maximum[1]) * Real(0.5);
+                Real cz = (node.minimum[2] + node.maximum[2]) * Real(0.5);
+                Real ex = node.maximum[0] - cx;
+                Real ey = node.maximum[1] - cy;
+                Real ez = node.maximum[2] - cz;
+
+                bool outside = false;
+
+                for (i = 0; i < FACE_COUNT; ++i)
+                {
+                    if ((faces & (1U << i)) == 0)
+                    {
+                        continue;
+                    }
+
+                    const Real *p = planes[i];
+                    Real d = p[0] * cx + p[1] * cy + p[2] * cz + p[3];
+                    Real r = std::abs(p[0]) * ex + std::abs(p[1]) * ey 
+                        + std::abs(p[2]) * ez;
+
+                    if (d + r < REAL_ZERO)
+                    {
+                        // 完全在平面外侧
+                        outside = true;
+                        break;
+                    }
+
+                    if (d - r >= REAL_ZERO)
+                    {
+                        // 完全在平面内侧，子树不用再检测这个平面
+                        faces &= ~(1U << i);
+                    }
+                }
+
+                if (outside)
+                {
+                    continue;
+                }
+            }
+
+            if (node.isLeaf())
+            {
+                if (node.mask & mask)
+                {
+                    result.push_back(node.userData);
+                }
+            }
+            else
+            {
+                mStack.push_back(node.child1);
+                mStack.push_back(int32_t(faces));
+                mStack.push_back(node.child2);
+                mStack.push_back(int32_t(faces));
+            }
+        }
+
+        size_t count = mPending.nodes.size();
+
+        if (count > 0)
+        {
+            mPending.visibility.resize(FrustumCuller::getMaskWords(count));
+            mCuller.setFrustum(frustum);
+            mCuller.cullAabbs(&mPending.centerX[0], &mPending.centerY[0],
+                &mPending.centerZ[0], &mPending.extentX[0], 
+                &mPending.extentY[0], &mPending.extentZ[0], count, 
+                &mPending.lastPlanes[0], &mPending.visibility[0]);
+
+            for (i = 0; i < count; ++i)
+            {
+                const TreeNode &leaf = mNodes[mPending.nodes[i]];
+                leaf.lastPlane = mPending.lastPlanes[i];
+
+                if (mPending.visibility[i >> 5] & (1U << (i & 31)))
+                {
+                    result.push_back(leaf.userData);
+                }
+            }
+        }
+    }
+}
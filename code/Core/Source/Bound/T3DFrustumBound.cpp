@@ -20,6 +20,7 @@
 
 #include "Bound/T3DFrustumBound.h"
 #include "Component/T3DCube.h"
+#include "Component/T3DComponentRegistry.h"
 
 
 namespace Tiny3D
@@ -27,6 +28,8 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     T3D_IMPLEMENT_CLASS_1(FrustumBound, Bound);
+    T3D_IMPLEMENT_POOL(FrustumBound, 16);
+    T3D_REGISTER_COMPONENT(FrustumBound);
 
     //--------------------------------------------------------------------------
 
@@ -85,7 +88,12 @@ namespace Tiny3D
             FrustumBoundPtr newBound = smart_pointer_cast<FrustumBound>(bound);
             newBound->mFrustum = mFrustum;
             newBound->mOriginalFrustum = mOriginalFrustum;
-            newBound->mRenderable = smart_pointer_cast<Cube>(mRenderable->clone());
+            // 调试用的渲染体只和形状有关，实例之间共享顶点数据
+            if (mRenderable != nullptr)
+            {
+                newBound->mRenderable = smart_pointer_cast<Cube>(
+                    mRenderable->instantiate());
+            }
         }
 
         return ret;
@@ -0,0 +1,379 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#include "Bound/T3DFrustumCuller.h"
+
+// 批量剔除的 SIMD 路径只在 Real 为单精度浮点数时启用
+#if (defined (__SSE2__) || defined (_M_X64) \
+    || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)) \
+    && __T3D_REAL_TYPE__ == __T3D_LOW_PRECISION_FLOAT__
+    #define T3D_CULLER_SSE2         1
+    #include <emmintrin.h>
+#endif
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    const uint32_t FrustumCuller::PLANE_COUNT = Frustum::E_MAX_FACE;
+
+    //--------------------------------------------------------------------------
+
+    FrustumCuller::FrustumCuller()
+    {
+        memset(mPlanes, 0, sizeof(mPlanes));
+        memset(mAbsNormals, 0, sizeof(mAbsNormals));
+    }
+
+    //--------------------------------------------------------------------------
+
+    FrustumCuller::FrustumCuller(const Frustum &frustum)
+    {
+        setFrustum(frustum);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void FrustumCuller::setFrustum(const Frustum &frustum)
+    {
+        uint32_t i = 0;
+        for (i = 0; i < PLANE_COUNT; ++i)
+        {
+            const Plane &plane = frustum.getFace((Frustum::Face)i);
+            mPlanes[i][0] = plane[0];
+            mPlanes[i][1] = plane[1];
+            mPlanes[i][2] = plane[2];
+            mPlanes[i][3] = plane[3];
+            mAbsNormals[i][0] = std::abs(plane[0]);
+            mAbsNormals[i][1] = std::abs(plane[1]);
+            mAbsNormals[i][2] = std::abs(plane[2]);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    size_t FrustumCuller::getMaskWords(size_t count)
+    {
+        return (count + 31) / 32;
+    }
+
+    //--------------------------------------------------------------------------
+
+    size_t FrustumCuller::cullAabbsScalar(const Real *centerX, 
+        const Real *centerY, const Real *centerZ, const Real *extentX, 
+        const Real *extentY, const Real *extentZ, size_t first, size_t count,
+        uint8_t *lastPlanes, uint32_t *visibility) const
+    {
+        size_t visible = 0;
+        size_t i = 0;
+
+        for (i = first; i < first + count; ++i)
+        {
+            Real cx = centerX[i], cy = centerY[i], cz = centerZ[i];
+            Real ex = extentX[i], ey = extentY[i], ez = extentZ[i];
+
+            // 先检测上一次剔除它的平面
+            uint32_t start = (lastPlanes != nullptr ? lastPlanes[i] : 0);
+            bool outside = false;
+
+            uint32_t k = 0;
+            for (k = 0; k < PLANE_COUNT; ++k)
+            {
+                uint32_t p = (k == 0 ? start : (k <= start ? k - 1 : k));
+                const Real *plane = mPlanes[p];
+                const Real *absN = mAbsNormals[p];
+
+                Real d = plane[0] * cx + plane[1] * cy + plane[2] * cz 
+                    + plane[3];
+                Real r = absN[0] * ex + absN[1] * ey + absN[2] * ez;
+
+                if (d + r < REAL_ZERO)
+                {
+                    if (lastPlanes != nullptr)
+                    {
+                        lastPlanes[i] = (uint8_t)p;
+                    }
+
+                    outside = true;
+                    break;
+                }
+            }
+
+            if (!outside)
+            {
+                visibility[i >> 5] |= (1U << (i & 31));
+                visible++;
+            }
+        }
+
+        return visible;
+    }
+
+    //--------------------------------------------------------------------------
+
+    size_t FrustumCuller::cullSpheresScalar(const Real *centerX, 
+        const Real *centerY, const Real *centerZ, const Real *radius, 
+        size_t first, size_t count, uint8_t *lastPlanes, 
+        uint32_t *visibility) const
+    {
+        size_t visible = 0;
+        size_t i = 0;
+
+        for (i = first; i < first + count; ++i)
+        {
+            Real cx = centerX[i], cy = centerY[i], cz = centerZ[i];
+            Real r = radius[i];
+
+            uint32_t start = (lastPlanes != nullptr ? lastPlanes[i] : 0);
+            bool outside = false;
+
+            uint32_t k = 0;
+            for (k = 0; k < PLANE_COUNT; ++k)
+            {
+                uint32_t p = (k == 0 ? start : (k <= start ? k - 1 : k));
+                const Real *plane = mPlanes[p];
+
+                Real d = plane[0] * cx + plane[1] * cy + plane[2] * cz
+                    + plane[3];
+
+                if (d + r < REAL_ZERO)
+                {
+                    if (lastPlanes != nullptr)
+                    {
+                        lastPlanes[i] = (uint8_t)p;
+                    }
+
+                    outside = true;
+                    break;
+                }
+            }
+
+            if (!outside)
+            {
+                visibility[i >> 5] |= (1U << (i & 31));
+                visible++;
+            }
+        }
+
+        return visible;
+    }
+
+    //--------------------------------------------------------------------------
+
+#if defined (T3D_CULLER_SSE2)
+    /**
+     * @brief 4个包围体按照各自上一次剔除的平面做一次检测
+     * @return 返回被剔除的通道掩码
+     */
+    static inline int testCoherentPlanes(const Real (*planes)[4], 
+        const Real (*absNormals)[3], const uint8_t *lastPlanes,
+        __m128 cx, __m128 cy, __m128 cz, __m128 ex, __m128 ey, __m128 ez)
+    {
+        // 每个通道的平面不同，先转置成 SoA
+        const Real *p0 = planes[lastPlanes[0]];
+        const Real *p1 = planes[lastPlanes[1]];
+        const Real *p2 = planes[lastPlanes[2]];
+        const Real *p3 = planes[lastPlanes[3]];
+        const Real *a0 = absNormals[lastPlanes[0]];
+        const Real *a1 = absNormals[lastPlanes[1]];
+        const Real *a2 = absNormals[lastPlanes[2]];
+        const Real *a3 = absNormals[lastPlanes[3]];
+
+        __m128 nx = _mm_setr_ps(p0[0], p1[0], p2[0], p3[0]);
+        __m128 ny = _mm_setr_ps(p0[1], p1[1], p2[1], p3[1]);
+        __m128 nz = _mm_setr_ps(p0[2], p1[2], p2[2], p3[2]);
+        __m128 nw = _mm_setr_ps(p0[3], p1[3], p2[3], p3[3]);
+        __m128 ax = _mm_setr_ps(a0[0], a1[0], a2[0], a3[0]);
+        __m128 ay = _mm_setr_ps(a0[1], a1[1], a2[1], a3[1]);
+        __m128 az = _mm_setr_ps(a0[2], a1[2], a2[2], a3[2]);
+
+        __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), 
+            _mm_mul_ps(ny, cy)), _mm_add_ps(_mm_mul_ps(nz, cz), nw));
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax, ex), 
+            _mm_mul_ps(ay, ey)), _mm_mul_ps(az, ez));
+        __m128 out = _mm_cmplt_ps(_mm_add_ps(d, r), _mm_setzero_ps());
+
+        return _mm_movemask_ps(out);
+    }
+
+    //--------------------------------------------------------------------------
+
+    /**
+     * @brief 4个包围体依次检测6个平面
+     * @return 返回被剔除的通道掩码，lastPlanes 不为空时记录剔除的平面
+     */
+    static inline int testAllPlanes(const Real (*planes)[4],
+        const Real (*absNormals)[3], uint32_t planeCount, uint8_t *lastPlanes,
+        __m128 cx, __m128 cy, __m128 cz, __m128 ex, __m128 ey, __m128 ez)
+    {
+        int outside = 0;
+
+        uint32_t p = 0;
+        for (p = 0; p < planeCount; ++p)
+        {
+            const Real *plane = planes[p];
+            const Real *absN = absNormals[p];
+
+            __m128 d = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), cx),
+                    _mm_mul_ps(_mm_set1_ps(plane[1]), cy)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[2]), cz),
+                    _mm_set1_ps(plane[3])));
+            __m128 r = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(absN[0]), ex),
+                    _mm_mul_ps(_mm_set1_ps(absN[1]), ey)),
+                _mm_mul_ps(_mm_set1_ps(absN[2]), ez));
+
+            int out = _mm_movemask_ps(
+                _mm_cmplt_ps(_mm_add_ps(d, r), _mm_setzero_ps()));
+
+            // 只记录第一次把它剔除的平面
+            int newly = (out & ~outside);
+            if (newly != 0 && lastPlanes != nullptr)
+            {
+                int lane = 0;
+                for (lane = 0; lane < 4; ++lane)
+                {
+                    if (newly & (1 << lane))
+                    {
+                        lastPlanes[lane] = (uint8_t)p;
+                    }
+                }
+            }
+
+            outside |= out;
+
+            if (outside == 0xF)
+            {
+                break;
+            }
+        }
+
+        return outside;
+    }
+#endif
+
+    //--------------------------------------------------------------------------
+
+    size_t FrustumCuller::cullAabbs(const Real *centerX, const Real *centerY,
+        const Real *centerZ, const Real *extentX, const Real *extentY,
+        const Real *extentZ, size_t count, uint8_t *lastPlanes,
+        uint32_t *visibility) const
+    {
+        memset(visibility, 0, getMaskWords(count) * sizeof(uint32_t));
+
+        size_t visible = 0;
+        size_t i = 0;
+
+#if defined (T3D_CULLER_SSE2)
+        for (i = 0; i + 4 <= count; i += 4)
+        {
+            __m128 cx = _mm_loadu_ps(centerX + i);
+            __m128 cy = _mm_loadu_ps(centerY + i);
+            __m128 cz = _mm_loadu_ps(centerZ + i);
+            __m128 ex = _mm_loadu_ps(extentX + i);
+            __m128 ey = _mm_loadu_ps(extentY + i);
+            __m128 ez = _mm_loadu_ps(extentZ + i);
+
+            uint8_t *planes = (lastPlanes != nullptr ? lastPlanes + i : nullptr);
+
+            if (planes != nullptr 
+                && testCoherentPlanes(mPlanes, mAbsNormals, planes, 
+                    cx, cy, cz, ex, ey, ez) == 0xF)
+            {
+                // 4个都还在上一次剔除它们的平面外面
+                continue;
+            }
+
+            int outside = testAllPlanes(mPlanes, mAbsNormals, PLANE_COUNT,
+                planes, cx, cy, cz, ex, ey, ez);
+            uint32_t bits = (uint32_t)(~outside & 0xF);
+
+            // 4 对齐的一组不会跨越 32 位的字
+            visibility[i >> 5] |= (bits << (i & 31));
+            visible += ((bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1) 
+                + (bits >> 3));
+        }
+#endif
+
+        visible += cullAabbsScalar(centerX, centerY, centerZ, extentX, 
+            extentY, extentZ, i, count - i, lastPlanes, visibility);
+
+        return visible;
+    }
+
+    //--------------------------------------------------------------------------
+
+    size_t FrustumCuller::cullSpheres(const Real *centerX, const Real *centerY,
+        const Real *centerZ, const Real *radius, size_t count,
+        uint8_t *lastPlanes, uint32_t *visibility) const
+    {
+        memset(visibility, 0, getMaskWords(count) * sizeof(uint32_t));
+
+        size_t visible = 0;
+        size_t i = 0;
+
+#if defined (T3D_CULLER_SSE2)
+        // 球就是法线绝对值全为 0 的包围盒检测，半径放在 x 方向的半长上
+        static const Real ones[6][3] = 
+        {
+            { REAL_ONE, REAL_ZERO, REAL_ZERO }, 
+            { REAL_ONE, REAL_ZERO, REAL_ZERO },
+            { REAL_ONE, REAL_ZERO, REAL_ZERO }, 
+            { REAL_ONE, REAL_ZERO, REAL_ZERO },
+            { REAL_ONE, REAL_ZERO, REAL_ZERO }, 
+            { REAL_ONE, REAL_ZERO, REAL_ZERO },
+        };
+
+        __m128 zero = _mm_setzero_ps();
+
+        for (i = 0; i + 4 <= count; i += 4)
+        {
+            __m128 cx = _mm_loadu_ps(centerX + i);
+            __m128 cy = _mm_loadu_ps(centerY + i);
+            __m128 cz = _mm_loadu_ps(centerZ + i);
+            __m128 r = _mm_loadu_ps(radius + i);
+
+            uint8_t *planes = (lastPlanes != nullptr ? lastPlanes + i : nullptr);
+
+            if (planes != nullptr
+                && testCoherentPlanes(mPlanes, ones, planes,
+                    cx, cy, cz, r, zero, zero) == 0xF)
+            {
+                continue;
+            }
+
+            int outside = testAllPlanes(mPlanes, ones, PLANE_COUNT,
+                planes, cx, cy, cz, r, zero, zero);
+            uint32_t bits = (uint32_t)(~outside & 0xF);
+
+            visibility[i >> 5] |= (bits << (i & 31));
+            visible += ((bits & 1) + ((bits >> 1) & 1) + ((bits >> 2) & 1)
+                + (bits >> 3));
+        }
+#endif
+
+        visible += cullSpheresScalar(centerX, centerY, centerZ, radius,
+            i, count - i, lastPlanes, visibility);
+
+        return visible;
+    }
+}
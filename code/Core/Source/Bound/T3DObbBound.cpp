@@ -21,6 +21,8 @@
 #include "Bound/T3DObbBound.h"
 #include "Component/T3DCube.h"
 #include "Scene/T3DSceneNode.h"
+#include "Scene/T3DSceneManager.h"
+#include "Component/T3DComponentRegistry.h"
 
 
 namespace Tiny3D
@@ -28,6 +30,8 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     T3D_IMPLEMENT_CLASS_1(ObbBound, Bound);
+    T3D_IMPLEMENT_POOL(ObbBound, 128);
+    T3D_REGISTER_COMPONENT(ObbBound);
 
     //--------------------------------------------------------------------------
 
@@ -86,7 +90,12 @@ namespace Tiny3D
             ObbBoundPtr newBound = smart_pointer_cast<ObbBound>(bound);
             newBound->mObb = mObb;
             newBound->mOriginalObb = mOriginalObb;
-            newBound->mRenderable = smart_pointer_cast<Cube>(mRenderable->clone());
+            // 调试用的渲染体只和形状有关，实例之间共享顶点数据
+            if (mRenderable != nullptr)
+            {
+                newBound->mRenderable = smart_pointer_cast<Cube>(
+                    mRenderable->instantiate());
+            }
         }
 
         return ret;
@@ -163,6 +172,28 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    bool ObbBound::getWorldAabb(Aabb &aabb) const
+    {
+        // 每个方向的半径是三个轴在这个方向上投影长度之和
+        const Vector3 &c = mObb.getCenter();
+        Vector3 e(REAL_ZERO, REAL_ZERO, REAL_ZERO);
+
+        int32_t i = 0;
+        for (i = 0; i < 3; ++i)
+        {
+            const Vector3 &axis = mObb.getAxis(i);
+            Real extent = mObb.getExtent(i);
+            e.x() += std::abs(axis.x()) * extent;
+            e.y() += std::abs(axis.y()) * extent;
+            e.z() += std::abs(axis.z()) * extent;
+        }
+
+        aabb.setParam(c - e, c + e);
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+
     void ObbBound::update()
     {
         if (mIsDirty)
@@ -197,6 +228,9 @@ namespace Tiny3D
             mObb.setExtent(2, extent2);
 
             mIsDirty = false;
+
+            // 通知场景管理器更新剔除用的包围盒
+            T3D_SCENE_MGR.updateSceneNode(getSceneNode());
         }
     }
 }
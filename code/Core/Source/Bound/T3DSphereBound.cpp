@@ -21,6 +21,8 @@
 #include "Bound/T3DSphereBound.h"
 #include "Component/T3DGlobe.h"
 #include "Scene/T3DSceneNode.h"
+#include "Scene/T3DSceneManager.h"
+#include "Component/T3DComponentRegistry.h"
 
 
 namespace Tiny3D
@@ -28,6 +30,8 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     T3D_IMPLEMENT_CLASS_1(SphereBound, Bound);
+    T3D_IMPLEMENT_POOL(SphereBound, 128);
+    T3D_REGISTER_COMPONENT(SphereBound);
 
     //--------------------------------------------------------------------------
 
@@ -87,8 +91,12 @@ namespace Tiny3D
             SphereBoundPtr sphereBound = smart_pointer_cast<SphereBound>(newObj);
             sphereBound->mOriginalSphere = mOriginalSphere;
             sphereBound->mSphere = mSphere;
-            sphereBound->mRenderable
-                = smart_pointer_cast<Globe>(mRenderable->clone());
+            // 调试用的渲染体只和形状有关，实例之间共享顶点数据
+            if (mRenderable != nullptr)
+            {
+                sphereBound->mRenderable = smart_pointer_cast<Globe>(
+                    mRenderable->instantiate());
+            }
         }
 
         return ret;
@@ -146,6 +154,17 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    bool SphereBound::getWorldAabb(Aabb &aabb) const
+    {
+        const Vector3 &c = mSphere.getCenter();
+        Real r = mSphere.getRadius();
+        aabb.setParam(Vector3(c.x() - r, c.y() - r, c.z() - r),
+            Vector3(c.x() + r, c.y() + r, c.z() + r));
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+
     void SphereBound::update()
     {
         if (mIsDirty)
@@ -169,6 +188,9 @@ namespace Tiny3D
             mOriginalSphere.setCenter(center);
 
             mIsDirty = false;
+
+            // 通知场景管理器更新剔除用的包围盒
+            T3D_SCENE_MGR.updateSceneNode(getSceneNode());
         }
     }
 }
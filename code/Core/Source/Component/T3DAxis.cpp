@@ -34,6 +34,7 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     T3D_IMPLEMENT_CLASS_1(Axis, Renderable);
+    T3D_IMPLEMENT_POOL(Axis, 16);
 
     //--------------------------------------------------------------------------
 
@@ -25,6 +25,7 @@
 #include "Render/T3DRenderContext.h"
 #include "Kernel/T3DAgent.h"
 #include "Bound/T3DFrustumBound.h"
+#include "Component/T3DComponentRegistry.h"
 
 
 namespace Tiny3D
@@ -32,6 +33,7 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     T3D_IMPLEMENT_CLASS_2(Camera, Component, ITransformListener);
+    T3D_REGISTER_COMPONENT(Camera);
 
     //--------------------------------------------------------------------------
 
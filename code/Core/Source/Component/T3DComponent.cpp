@@ -42,6 +42,8 @@ namespace Tiny3D
     Component::Component(ID uID /* = E_CID_AUTOMATIC */)
         : mID(E_CID_INVALID)
         , mSceneNode(nullptr)
+        , mStoreBucket(0)
+        , mStoreIndex(0)
     {
         if (uID != E_CID_AUTOMATIC)
         {
@@ -61,6 +63,13 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    ComponentPtr Component::instantiate() const
+    {
+        return clone();
+    }
+
+    //--------------------------------------------------------------------------
+
     TResult Component::cloneProperties(ComponentPtr newObj) const
     {
         newObj->mSceneNode = mSceneNode;
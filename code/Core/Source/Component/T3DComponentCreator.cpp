@@ -22,15 +22,7 @@
 #include "Memory/T3DSmartPtr.h"
 #include "Component/T3DComponentCreator.h"
 #include "T3DErrorDef.h"
-#include "Component/T3DTransform3D.h"
-#include "Component/T3DCamera.h"
-#include "Component/T3DCube.h"
-#include "Component/T3DGlobe.h"
-#include "Component/T3DMesh.h"
-#include "Bound/T3DAabbBound.h"
-#include "Bound/T3DFrustumBound.h"
-#include "Bound/T3DObbBound.h"
-#include "Bound/T3DSphereBound.h"
+#include "Component/T3DComponentRegistry.h"
 
 
 namespace Tiny3D
@@ -75,51 +67,9 @@ namespace Tiny3D
             va_list params;
             va_start(params, argc);
             const Class *cls = va_arg(params, const Class *);
-            va_list args = va_arg(params, va_list);
-
-            if (cls == T3D_CLASS(Transform3D))
-            {
-                component = Transform3D::create();
-            }
-            else if (cls == T3D_CLASS(Camera))
-            {
-                component = Camera::create();
-            }
-            else if (cls == T3D_CLASS(AabbBound))
-            {
-                component = AabbBound::create();
-            }
-            else if (cls == T3D_CLASS(FrustumBound))
-            {
-                component = FrustumBound::create();
-            }
-            else if (cls == T3D_CLASS(ObbBound))
-            {
-                component = ObbBound::create();
-            }
-            else if (cls == T3D_CLASS(SphereBound))
-            {
-                component = SphereBound::create();
-            }
-            else if (cls == T3D_CLASS(Cube))
-            {
-                Vector3 center = va_arg(args, Vector3);
-                Vector3 extent = va_arg(args, Vector3);
-                component = Cube::create(center, extent);
-            }
-            else if (cls == T3D_CLASS(Globe))
-            {
-                Vector3 center = va_arg(args, Vector3);
-                Real *radius = va_arg(args, Real*);
-                component = Globe::create(center, *radius);
-            }
-            else if (cls == T3D_CLASS(Mesh))
-            {
-                component = Mesh::create();
-            }
-
+            va_list *args = va_arg(params, va_list *);
+            component = ComponentRegistry::createComponent(cls, *args);
             va_end(params);
-
         } while (0);
 
         return component;
@@ -0,0 +1,186 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#include "Component/T3DComponentRegistry.h"
+#include "Component/T3DComponent.h"
+#include "T3DErrorDef.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    /**
+     * @brief 按 Class 序号排列的注册信息
+     * @note 都是静态初始化前就清零的简单类型，组件类静态注册时不受初始化
+     *      顺序影响
+     */
+    struct ComponentEntry
+    {
+        ComponentRegistry::Creator  creator;        /**< 创建函数 */
+        uint32_t                    order;          /**< 直接设置的执行顺序 */
+        uint32_t                    resolvedOrder;  /**< 沿继承链算好的执行顺序 */
+    };
+
+    static ComponentEntry s_Entries[Class::MAX_CLASS_COUNT + 1];
+
+    //--------------------------------------------------------------------------
+
+    TResult ComponentRegistry::registerComponent(const Class *cls, 
+        Creator creator)
+    {
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            if (cls == nullptr || creator == nullptr)
+            {
+                ret = T3D_ERR_INVALID_PARAM;
+                break;
+            }
+
+            uint32_t index = cls->getIndex();
+            if (index == 0)
+            {
+                // 类太多没有序号，无法注册
+                ret = T3D_ERR_OUT_OF_BOUND;
+                break;
+            }
+
+            s_Entries[index].creator = creator;
+            s_Entries[index].resolvedOrder = resolveOrder(cls);
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult ComponentRegistry::unregisterComponent(const Class *cls)
+    {
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            if (cls == nullptr || cls->getIndex() == 0)
+            {
+                ret = T3D_ERR_INVALID_PARAM;
+                break;
+            }
+
+            s_Entries[cls->getIndex()].creator = nullptr;
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    ComponentRegistry::Creator ComponentRegistry::getCreator(const Class *cls)
+    {
+        return s_Entries[cls->getIndex()].creator;
+    }
+
+    //--------------------------------------------------------------------------
+
+    ComponentPtr ComponentRegistry::createComponent(const Class *cls, 
+        va_list args)
+    {
+        ComponentPtr component;
+
+        Creator creator = s_Entries[cls->getIndex()].creator;
+
+        if (creator != nullptr)
+        {
+            component = creator(args);
+        }
+        else
+        {
+            T3D_LOG_ERROR(LOG_TAG_COMPONENT, 
+                "Component class %s has not been registered !", 
+                cls->getName());
+        }
+
+        return component;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void ComponentRegistry::setOrder(const Class *cls, uint32_t order)
+    {
+        uint32_t index = cls->getIndex();
+
+        if (index == 0)
+        {
+            T3D_LOG_ERROR(LOG_TAG_COMPONENT, 
+                "Class %s has no index, could not set its order !",
+                cls->getName());
+            return;
+        }
+
+        s_Entries[index].order = order;
+
+        // 设置顺序的时候所有类都已经构造完，一次算好所有类的顺序
+        uint32_t count = Class::getClassCount();
+
+        for (uint32_t i = 1; i <= count; ++i)
+        {
+            const Class *c = Class::getClass(i);
+
+            if (c != nullptr)
+            {
+                s_Entries[i].resolvedOrder = resolveOrder(c);
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    uint32_t ComponentRegistry::getOrder(const Class *cls)
+    {
+        uint32_t order = s_Entries[cls->getIndex()].resolvedOrder;
+
+        if (order == ComponentOrder::INVALID)
+        {
+            // 在最后一次设置顺序之后才加载的类，现场算一次
+            order = resolveOrder(cls);
+        }
+
+        return order;
+    }
+
+    //--------------------------------------------------------------------------
+
+    uint32_t ComponentRegistry::resolveOrder(const Class *cls)
+    {
+        uint32_t order = s_Entries[cls->getIndex()].order;
+
+        size_t i = 0;
+        size_t count = cls->getBaseClassCount();
+
+        while (order == ComponentOrder::INVALID && i < count)
+        {
+            order = resolveOrder(cls->getBaseClass(i));
+            ++i;
+        }
+
+        return order;
+    }
+}
@@ -29,6 +29,7 @@
 #include "Resource/T3DGPUProgramManager.h"
 #include "Resource/T3DMaterial.h"
 #include "Resource/T3DMaterialManager.h"
+#include "Component/T3DComponentRegistry.h"
 
 
 namespace Tiny3D
@@ -36,6 +37,18 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     T3D_IMPLEMENT_CLASS_1(Cube, Renderable);
+    T3D_IMPLEMENT_POOL(Cube, 64);
+
+    //--------------------------------------------------------------------------
+
+    static ComponentPtr createCubeComponent(va_list args)
+    {
+        Vector3 center = va_arg(args, Vector3);
+        Vector3 extent = va_arg(args, Vector3);
+        return Cube::create(center, extent);
+    }
+
+    T3D_REGISTER_COMPONENT_CREATOR(Cube, createCubeComponent);
 
     //--------------------------------------------------------------------------
 
@@ -53,6 +66,9 @@ namespace Tiny3D
         ColorRGBA   diffuse;
     };
 
+    const size_t MAX_VERTICES = 8;
+    const size_t MAX_INDICES = 36;
+
     //--------------------------------------------------------------------------
 
     CubePtr Cube::create(const Vector3 &center, const Vector3 &extent,
@@ -94,9 +110,6 @@ namespace Tiny3D
         mCenter = center;
         mExtent = extent;
 
-        const size_t MAX_VERTICES = 8;
-        const size_t MAX_INDICES = 36;
-
         BoxVertex vertices[MAX_VERTICES];
         uint16_t indices[MAX_INDICES];
         setupBox(&vertices, MAX_VERTICES, indices, MAX_INDICES);
@@ -184,7 +197,7 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     void Cube::setupBox(void *vertices, size_t vertexCount, uint16_t *indices, 
-        size_t indexCount)
+        size_t indexCount) const
     {
         // 
         // 正方体顶点定义如下：
@@ -287,6 +300,21 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    TResult Cube::readGeometry(TArray<uint8_t> &vertices, 
+        TArray<uint32_t> &indices) const
+    {
+        BoxVertex box[MAX_VERTICES];
+        uint16_t boxIndices[MAX_INDICES];
+        setupBox(box, MAX_VERTICES, boxIndices, MAX_INDICES);
+
+        vertices.resize(sizeof(box));
+        memcpy(&vertices[0], (const void *)box, sizeof(box));
+        indices.assign(boxIndices, boxIndices + MAX_INDICES);
+        return T3D_OK;
+    }
+
+    //--------------------------------------------------------------------------
+
     ComponentPtr Cube::clone() const
     {
         CubePtr box = new Cube();
@@ -302,6 +330,41 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    ComponentPtr Cube::instantiate() const
+    {
+        CubePtr box = new Cube();
+        box->release();
+
+        TResult ret = instantiateProperties(box);
+
+        if (ret == T3D_OK)
+        {
+            // 顶点数据创建后就不再修改，直接共享预制体的 VAO
+            box->mCenter = mCenter;
+            box->mExtent = mExtent;
+            box->mVAO = mVAO;
+
+            if (mMaterial != nullptr)
+            {
+                ret = T3D_MATERIAL_MGR.retain(mMaterial);
+
+                if (ret == T3D_OK)
+                {
+                    box->mMaterial = mMaterial;
+                }
+            }
+        }
+
+        if (ret != T3D_OK)
+        {
+            box = nullptr;
+        }
+
+        return box;
+    }
+
+    //--------------------------------------------------------------------------
+
     TResult Cube::cloneProperties(ComponentPtr newObj) const
     {
         TResult ret = Renderable::cloneProperties(newObj);
@@ -328,4 +391,17 @@ namespace Tiny3D
     {
         return mVAO;
     }
+
+    //--------------------------------------------------------------------------
+
+    TResult Cube::replaceMaterial(MaterialPtr material)
+    {
+        if (mMaterial != nullptr)
+        {
+            T3D_MATERIAL_MGR.unloadMaterial(mMaterial);
+        }
+
+        mMaterial = material;
+        return T3D_OK;
+    }
 }
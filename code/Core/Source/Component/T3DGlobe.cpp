@@ -29,6 +29,7 @@
 #include "Resource/T3DGPUProgramManager.h"
 #include "Resource/T3DMaterial.h"
 #include "Resource/T3DMaterialManager.h"
+#include "Component/T3DComponentRegistry.h"
 
 
 namespace Tiny3D
@@ -36,6 +37,18 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     T3D_IMPLEMENT_CLASS_1(Globe, Renderable);
+    T3D_IMPLEMENT_POOL(Globe, 64);
+
+    //--------------------------------------------------------------------------
+
+    static ComponentPtr createGlobeComponent(va_list args)
+    {
+        Vector3 center = va_arg(args, Vector3);
+        Real *radius = va_arg(args, Real*);
+        return Globe::create(center, *radius);
+    }
+
+    T3D_REGISTER_COMPONENT_CREATOR(Globe, createGlobeComponent);
 
     //--------------------------------------------------------------------------
 
@@ -58,6 +71,7 @@ namespace Tiny3D
     const size_t MAX_SLICES = 18;
     const size_t MAX_VERTICES = (MAX_STACKS + 1) * (MAX_SLICES + 1);
     const size_t MAX_TRIANGLES = MAX_STACKS * MAX_SLICES * 2;
+    const size_t MAX_INDICES = MAX_TRIANGLES * 3;
 
     //--------------------------------------------------------------------------
 
@@ -103,7 +117,6 @@ namespace Tiny3D
         mRadius = radius;
 
         SphereVertex vertices[MAX_VERTICES];
-        const size_t MAX_INDICES = MAX_TRIANGLES * 3;
         uint16_t indices[MAX_INDICES];
 
         setupSphere(vertices, MAX_VERTICES, indices, MAX_INDICES);
@@ -191,7 +204,7 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     void Globe::setupSphere(void *vertices, size_t vertexCount,
-        uint16_t *indices, size_t indexCount)
+        uint16_t *indices, size_t indexCount) const
     {
         SphereVertex *vert = (SphereVertex *)vertices;
 
@@ -269,6 +282,41 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    ComponentPtr Globe::instantiate() const
+    {
+        GlobePtr sphere = new Globe();
+        sphere->release();
+
+        TResult ret = instantiateProperties(sphere);
+
+        if (ret == T3D_OK)
+        {
+            // 顶点数据创建后就不再修改，直接共享预制体的 VAO
+            sphere->mCenter = mCenter;
+            sphere->mRadius = mRadius;
+            sphere->mVAO = mVAO;
+
+            if (mMaterial != nullptr)
+            {
+                ret = T3D_MATERIAL_MGR.retain(mMaterial);
+
+                if (ret == T3D_OK)
+                {
+                    sphere->mMaterial = mMaterial;
+                }
+            }
+        }
+
+        if (ret != T3D_OK)
+        {
+            sphere = nullptr;
+        }
+
+        return sphere;
+    }
+
+    //--------------------------------------------------------------------------
+
     TResult Globe::cloneProperties(ComponentPtr newObj) const
     {
         TResult ret = Renderable::cloneProperties(newObj);
@@ -295,4 +343,32 @@ namespace Tiny3D
     {
         return mVAO;
     }
+
+    //--------------------------------------------------------------------------
+
+    TResult Globe::replaceMaterial(MaterialPtr material)
+    {
+        if (mMaterial != nullptr)
+        {
+            T3D_MATERIAL_MGR.unloadMaterial(mMaterial);
+        }
+
+        mMaterial = material;
+        return T3D_OK;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult Globe::readGeometry(TArray<uint8_t> &vertices, 
+        TArray<uint32_t> &indices) const
+    {
+        SphereVertex sphere[MAX_VERTICES];
+        uint16_t sphereIndices[MAX_INDICES];
+        setupSphere(sphere, MAX_VERTICES, sphereIndices, MAX_INDICES);
+
+        vertices.resize(sizeof(sphere));
+        memcpy(&vertices[0], (const void *)sphere, sizeof(sphere));
+        indices.assign(sphereIndices, sphereIndices + MAX_INDICES);
+        return T3D_OK;
+    }
 }
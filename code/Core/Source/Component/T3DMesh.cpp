@@ -21,10 +21,12 @@
 #include "Component/T3DMesh.h"
 #include "Resource/T3DModel.h"
 #include "Resource/T3DModelManager.h"
+#include "Resource/T3DMaterialManager.h"
 #include "Render/T3DHardwareBufferManager.h"
 #include "Render/T3DHardwareVertexBuffer.h"
 #include "Render/T3DHardwareIndexBuffer.h"
 #include "protobuf/ModelScriptObject.pb.h"
+#include "Component/T3DComponentRegistry.h"
 
 
 namespace Tiny3D
@@ -32,6 +34,8 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     T3D_IMPLEMENT_CLASS_1(Mesh, Renderable);
+    T3D_IMPLEMENT_POOL(Mesh, 64);
+    T3D_REGISTER_COMPONENT(Mesh);
 
     //--------------------------------------------------------------------------
 
@@ -54,7 +58,15 @@ namespace Tiny3D
 
     Mesh::~Mesh()
     {
+        if (mModel != nullptr)
+        {
+            T3D_MODEL_MGR.unload(mModel);
+        }
 
+        if (mMaterial != nullptr)
+        {
+            T3D_MATERIAL_MGR.unloadMaterial(mMaterial);
+        }
     }
 
     //--------------------------------------------------------------------------
@@ -87,6 +99,53 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    ComponentPtr Mesh::instantiate() const
+    {
+        MeshPtr newObj = Mesh::create();
+        TResult ret = instantiateProperties(newObj);
+
+        do 
+        {
+            if (T3D_FAILED(ret))
+            {
+                break;
+            }
+
+            if (mModel != nullptr)
+            {
+                ret = T3D_MODEL_MGR.retain(mModel);
+                if (T3D_FAILED(ret))
+                {
+                    break;
+                }
+
+                newObj->mModel = mModel;
+            }
+
+            if (mMaterial != nullptr)
+            {
+                ret = T3D_MATERIAL_MGR.retain(mMaterial);
+                if (T3D_FAILED(ret))
+                {
+                    break;
+                }
+
+                newObj->mMaterial = mMaterial;
+            }
+
+            newObj->mVAO = mVAO;
+        } while (0);
+
+        if (T3D_FAILED(ret))
+        {
+            newObj = nullptr;
+        }
+
+        return newObj;
+    }
+
+    //--------------------------------------------------------------------------
+
     TResult Mesh::cloneProperties(ComponentPtr newObj) const
     {
         TResult ret = Renderable::cloneProperties(newObj);
@@ -115,6 +174,19 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    TResult Mesh::replaceMaterial(MaterialPtr material)
+    {
+        if (mMaterial != nullptr)
+        {
+            T3D_MATERIAL_MGR.unloadMaterial(mMaterial);
+        }
+
+        mMaterial = material;
+        return T3D_OK;
+    }
+
+    //--------------------------------------------------------------------------
+
     TResult Mesh::setupVAO()
     {
         Script::ModelSystem::MeshData *meshData 
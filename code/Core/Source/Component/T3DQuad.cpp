@@ -35,6 +35,7 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     T3D_IMPLEMENT_CLASS_1(Quad, Renderable);
+    T3D_IMPLEMENT_POOL(Quad, 64);
 
     //--------------------------------------------------------------------------
 
@@ -20,6 +20,9 @@
 
 #include "Component/T3DRenderable.h"
 #include "Scene/T3DSceneNode.h"
+#include "Resource/T3DMaterialManager.h"
+#include "Render/T3DHardwareVertexBuffer.h"
+#include "Render/T3DHardwareIndexBuffer.h"
 
 
 namespace Tiny3D
@@ -32,6 +35,7 @@ namespace Tiny3D
 
     Renderable::Renderable(ID uID /* = E_CID_AUTOMATIC */)
         : Component(uID)
+        , mIsMaterialShared(false)
     {
 
     }
@@ -45,6 +49,73 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    TResult Renderable::readGeometry(TArray<uint8_t> &vertices, 
+        TArray<uint32_t> &indices) const
+    {
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            VertexArrayObjectPtr vao = getVertexArrayObject();
+
+            if (vao == nullptr || vao->getVertexBufferCount() == 0)
+            {
+                ret = T3D_ERR_INVALID_POINTER;
+                break;
+            }
+
+            HardwareVertexBufferPtr vbo = vao->getVertexBuffer(0);
+            size_t bytes = vbo->getVertexSize() * vbo->getVertexCount();
+            vertices.resize(bytes);
+
+            if (bytes == 0 || vbo->readData(0, bytes, &vertices[0]) != bytes)
+            {
+                vertices.clear();
+                ret = T3D_ERR_HW_BUFFER_READ;
+                break;
+            }
+
+            indices.clear();
+
+            if (!vao->isIndicesUsed())
+            {
+                break;
+            }
+
+            HardwareIndexBufferPtr ibo = vao->getIndexBuffer();
+            size_t indexCount = ibo->getIndexCount();
+            bytes = ibo->getIndexSize() * indexCount;
+            TArray<uint8_t> data(bytes);
+
+            if (bytes == 0 || ibo->readData(0, bytes, &data[0]) != bytes)
+            {
+                vertices.clear();
+                ret = T3D_ERR_HW_BUFFER_READ;
+                break;
+            }
+
+            indices.resize(indexCount);
+            size_t i = 0;
+
+            if (ibo->getIndexType() == HardwareIndexBuffer::Type::E_IT_16BITS)
+            {
+                const uint16_t *src = (const uint16_t *)&data[0];
+                for (i = 0; i < indexCount; ++i)
+                {
+                    indices[i] = src[i];
+                }
+            }
+            else
+            {
+                memcpy(&indices[0], &data[0], bytes);
+            }
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
     TResult Renderable::cloneProperties(ComponentPtr newObj) const
     {
         TResult ret = Component::cloneProperties(newObj);
@@ -56,4 +127,62 @@ namespace Tiny3D
 
         return ret;
     }
+
+    //--------------------------------------------------------------------------
+
+    TResult Renderable::instantiateProperties(ComponentPtr newObj) const
+    {
+        TResult ret = Component::cloneProperties(newObj);
+
+        if (ret == T3D_OK)
+        {
+            RenderablePtr obj = smart_pointer_cast<Renderable>(newObj);
+            obj->mIsMaterialShared = true;
+
+            // 预制体和实例共享同一个材质，任何一方修改前都要先复制
+            mIsMaterialShared = true;
+        }
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    MaterialPtr Renderable::getWritableMaterial()
+    {
+        MaterialPtr material = getMaterial();
+
+        if (mIsMaterialShared && material != nullptr)
+        {
+            MaterialPtr newMaterial 
+                = smart_pointer_cast<Material>(T3D_MATERIAL_MGR.clone(material));
+
+            if (newMaterial != nullptr 
+                && replaceMaterial(newMaterial) == T3D_OK)
+            {
+                material = newMaterial;
+                mIsMaterialShared = false;
+            }
+            else if (newMaterial != nullptr)
+            {
+                T3D_MATERIAL_MGR.unloadMaterial(newMaterial);
+            }
+        }
+
+        return material;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult Renderable::replaceMaterial(MaterialPtr material)
+    {
+        return T3D_ERR_FAIL;
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool Renderable::frustumCulling(Bound *bound)
+    {
+        return true;
+    }
 }
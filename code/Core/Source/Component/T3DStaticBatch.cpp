@@ -0,0 +1,717 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#include "Component/T3DStaticBatch.h"
+#include "Component/T3DTransform3D.h"
+#include "Scene/T3DSceneNode.h"
+#include "Scene/T3DSceneManager.h"
+#include "Bound/T3DFrustumBound.h"
+#include "Render/T3DHardwareBufferManager.h"
+#include "Render/T3DHardwareVertexBuffer.h"
+#include "Render/T3DHardwareIndexBuffer.h"
+#include "Render/T3DVertexArrayObject.h"
+#include "Component/T3DComponentRegistry.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    T3D_IMPLEMENT_CLASS_1(StaticBatch, Renderable);
+
+    //--------------------------------------------------------------------------
+
+    static ComponentPtr createStaticBatchComponent(va_list args)
+    {
+        Material *material = va_arg(args, Material*);
+        return StaticBatch::create(material);
+    }
+
+    T3D_REGISTER_COMPONENT_CREATOR(StaticBatch, createStaticBatchComponent);
+
+    //--------------------------------------------------------------------------
+
+    StaticBatchPtr StaticBatch::create(Material *material, 
+        ID uID /* = E_CID_AUTOMATIC */)
+    {
+        StaticBatchPtr batch = new StaticBatch(material, uID);
+        batch->release();
+        return batch;
+    }
+
+    //--------------------------------------------------------------------------
+
+    StaticBatch::StaticBatch(Material *material, ID uID)
+        : Renderable(uID)
+        , mMaterial(material)
+        , mDecl(nullptr)
+        , mVertexSize(0)
+        , mVertexCount(0)
+        , mIndexType(HardwareIndexBuffer::Type::E_IT_16BITS)
+        , mVBO(nullptr)
+        , mIBO(nullptr)
+        , mVAO(nullptr)
+        , mVisibleCount(0)
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    StaticBatch::~StaticBatch()
+    {
+        releaseNodes();
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool StaticBatch::canBatch(SceneNode *node)
+    {
+        bool ret = false;
+
+        do 
+        {
+            if (!node->isStatic() || node->mStaticBatch != nullptr
+                || node->mRenderable == nullptr 
+                || node->mTransform3D == nullptr)
+            {
+                break;
+            }
+
+            Renderable *renderable = node->mRenderable;
+
+            if (renderable->getClass()->isKindOf(T3D_CLASS(StaticBatch))
+                || renderable->getMaterial() == nullptr)
+            {
+                break;
+            }
+
+            VertexArrayObjectPtr vao = renderable->getVertexArrayObject();
+
+            if (vao == nullptr || vao->getVertexBufferCount() != 1
+                || vao->getPrimitiveType() 
+                    != RenderContext::PrimitiveType::E_PT_TRIANGLE_LIST)
+            {
+                break;
+            }
+
+            VertexDeclarationPtr decl = vao->getVertexDeclaration();
+
+            if (decl == nullptr)
+            {
+                break;
+            }
+
+            // 只支持单个顶点流，位置必须是3个浮点数，才能在 CPU 上变换
+            bool singleStream = true;
+
+            for (const VertexAttribute &attr : decl->getAttributes())
+            {
+                if (attr.getStream() != 0)
+                {
+                    singleStream = false;
+                    break;
+                }
+            }
+
+            const VertexAttribute *pos = decl->findAttributeBySemantic(
+                VertexAttribute::Semantic::E_VAS_POSITION, 0);
+
+            ret = (singleStream && pos != nullptr
+                && pos->getType() == VertexAttribute::Type::E_VAT_FLOAT3);
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool StaticBatch::isCompatible(SceneNode *node) const
+    {
+        if (mVAO != nullptr || node->mRenderable->getMaterial() != mMaterial)
+        {
+            return false;
+        }
+
+        if (mDecl == nullptr)
+        {
+            return true;
+        }
+
+        VertexArrayObjectPtr vao = node->mRenderable->getVertexArrayObject();
+        HardwareVertexBufferPtr vbo = vao->getVertexBuffer(0);
+        VertexDeclarationPtr decl = vao->getVertexDeclaration();
+
+        if (vbo->getVertexSize() != mVertexSize
+            || decl->getAttributeCount() != mDecl->getAttributeCount()
+            || mVertexCount + vbo->getVertexCount() > 0xFFFFFFFF)
+        {
+            return false;
+        }
+
+        auto itr0 = decl->getAttributes().begin();
+        auto itr1 = mDecl->getAttributes().begin();
+
+        while (itr0 != decl->getAttributes().end())
+        {
+            if (itr0->getOffset() != itr1->getOffset()
+                || itr0->getType() != itr1->getType()
+                || itr0->getSemantic() != itr1->getSemantic()
+                || itr0->getSemanticIndex() != itr1->getSemanticIndex())
+            {
+                return false;
+            }
+
+            ++itr0;
+            ++itr1;
+        }
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult StaticBatch::addNode(SceneNode *node)
+    {
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            if (mVAO != nullptr || !isCompatible(node))
+            {
+                ret = T3D_ERR_INVALID_PARAM;
+                break;
+            }
+
+            VertexArrayObjectPtr vao 
+                = node->mRenderable->getVertexArrayObject();
+            HardwareVertexBufferPtr vbo = vao->getVertexBuffer(0);
+            VertexDeclarationPtr decl = vao->getVertexDeclaration();
+
+            size_t vertexSize = vbo->getVertexSize();
+
+            // 从可渲染对象取 CPU 端的几何数据，不依赖缓冲区能否回读
+            Bytes vertices;
+            Indices indices;
+            ret = node->mRenderable->readGeometry(vertices, indices);
+            if (T3D_FAILED(ret))
+            {
+                T3D_LOG_WARNING(LOG_TAG_SCENE, 
+                    "Read geometry of node %s for static batch failed !",
+                    node->getName().c_str());
+                break;
+            }
+
+            size_t vertexCount = vertices.size() / vertexSize;
+
+            if (vertexCount == 0 || vertexCount * vertexSize != vertices.size())
+            {
+                ret = T3D_ERR_INVALID_PARAM;
+                break;
+            }
+
+            size_t offset = mVertices.size();
+            mVertices.insert(mVertices.end(), vertices.begin(), vertices.end());
+
+            // 索引加上顶点基址
+            size_t firstIndex = mIndices.size();
+            uint32_t base = (uint32_t)mVertexCount;
+            size_t i = 0;
+
+            if (!indices.empty())
+            {
+                mIndices.reserve(firstIndex + indices.size());
+
+                for (i = 0; i < indices.size(); ++i)
+                {
+                    mIndices.push_back(base + indices[i]);
+                }
+            }
+            else
+            {
+                for (i = 0; i < vertexCount; ++i)
+                {
+                    mIndices.push_back(base + (uint32_t)i);
+                }
+            }
+
+            // 顶点变换到世界空间：位置用仿射矩阵，法线除以缩放再旋转，
+            // 切线和副法线乘以缩放再旋转
+            const Transform &xform 
+                = node->mTransform3D->getLocalToWorldTransform();
+            const Matrix4 &world = xform.getAffineMatrix();
+            const Vector3 &scaling = xform.getScaling();
+            Matrix3 rotation;
+            xform.getOrientation().toRotationMatrix(rotation);
+
+            Vector3 minPos, maxPos;
+            size_t v = 0;
+
+            for (v = 0; v < vertexCount; ++v)
+            {
+                uint8_t *vertex = &mVertices[offset + v * vertexSize];
+
+                for (const VertexAttribute &attr : decl->getAttributes())
+                {
+                    if (attr.getType() != VertexAttribute::Type::E_VAT_FLOAT3)
+                    {
+                        continue;
+                    }
+
+                    Real elements[3];
+                    uint8_t *data = vertex + attr.getOffset();
+                    memcpy(elements, data, sizeof(elements));
+                    Vector3 value(elements[0], elements[1], elements[2]);
+
+                    switch (attr.getSemantic())
+                    {
+                    case VertexAttribute::Semantic::E_VAS_POSITION:
+                        {
+                            value = world * value;
+
+                            if (v == 0)
+                            {
+                                minPos = maxPos = value;
+                            }
+                            else
+                            {
+                                minPos.x() = std::min(minPos.x(), value.x());
+                                minPos.y() = std::min(minPos.y(), value.y());
+                                minPos.z() = std::min(minPos.z(), value.z());
+                                maxPos.x() = std::max(maxPos.x(), value.x());
+                                maxPos.y() = std::max(maxPos.y(), value.y());
+                                maxPos.z() = std::max(maxPos.z(), value.z());
+                            }
+                        }
+                        break;
+                    case VertexAttribute::Semantic::E_VAS_NORMAL:
+                        {
+                            value.x() /= scaling.x();
+                            value.y() /= scaling.y();
+                            value.z() /= scaling.z();
+                            value = rotation * value;
+                            value.normalize();
+                        }
+                        break;
+                    case VertexAttribute::Semantic::E_VAS_TANGENT:
+                    case VertexAttribute::Semantic::E_VAS_BINORMAL:
+                        {
+                            value = rotation * (value * scaling);
+                            value.normalize();
+                        }
+                        break;
+                    default:
+                        continue;
+                    }
+
+                    elements[0] = value.x();
+                    elements[1] = value.y();
+                    elements[2] = value.z();
+                    memcpy(data, elements, sizeof(elements));
+                }
+            }
+
+            SubMesh subMesh;
+            subMesh.node = node;
+            subMesh.firstIndex = firstIndex;
+            subMesh.indexCount = mIndices.size() - firstIndex;
+            subMesh.bound.setParam(minPos, maxPos);
+
+            if (mSubMeshes.empty())
+            {
+                mDecl = decl;
+                mVertexSize = vertexSize;
+                mBound = subMesh.bound;
+            }
+            else
+            {
+                Vector3 boundMin(
+                    std::min(mBound.getMinX(), minPos.x()),
+                    std::min(mBound.getMinY(), minPos.y()),
+                    std::min(mBound.getMinZ(), minPos.z()));
+                Vector3 boundMax(
+                    std::max(mBound.getMaxX(), maxPos.x()),
+                    std::max(mBound.getMaxY(), maxPos.y()),
+                    std::max(mBound.getMaxZ(), maxPos.z()));
+                mBound.setParam(boundMin, boundMax);
+            }
+
+            mSubMeshes.push_back(subMesh);
+            mVertexCount += vertexCount;
+
+            // 结点不再单独参与剔除和渲染
+            mNodes.push_back(node);
+            node->mStaticBatch = this;
+            T3D_SCENE_MGR.removeSceneNode(node);
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult StaticBatch::build()
+    {
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            if (mVAO != nullptr)
+            {
+                break;
+            }
+
+            if (mSubMeshes.empty())
+            {
+                ret = T3D_ERR_INVALID_PARAM;
+                break;
+            }
+
+            mVBO = T3D_HARDWARE_BUFFER_MGR.createVertexBuffer(mVertexSize,
+                mVertexCount, &mVertices[0], HardwareBuffer::Usage::STATIC,
+                HardwareBuffer::AccessMode::CPU_NONE);
+            if (mVBO == nullptr)
+            {
+                ret = T3D_ERR_INVALID_POINTER;
+                T3D_LOG_ERROR(LOG_TAG_SCENE, 
+                    "Create vertex buffer for StaticBatch failed !");
+                break;
+            }
+
+            mIndexType = (mVertexCount <= 0x10000 
+                ? HardwareIndexBuffer::Type::E_IT_16BITS 
+                : HardwareIndexBuffer::Type::E_IT_32BITS);
+
+            ret = setupVAO();
+            if (T3D_FAILED(ret))
+            {
+                break;
+            }
+
+            // 顶点已经在显存里了
+            Bytes().swap(mVertices);
+
+            setupCulling();
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult StaticBatch::setupVAO()
+    {
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            size_t indexSize 
+                = (mIndexType == HardwareIndexBuffer::Type::E_IT_16BITS 
+                ? sizeof(uint16_t) : sizeof(uint32_t));
+            mDrawIndices.resize(mIndices.size() * indexSize);
+
+            // 可见性会变化，索引缓冲区需要 CPU 写
+            mIBO = T3D_HARDWARE_BUFFER_MGR.createIndexBuffer(mIndexType,
+                mIndices.size(), nullptr, HardwareBuffer::Usage::DYNAMIC,
+                HardwareBuffer::AccessMode::CPU_WRITE);
+            if (mIBO == nullptr)
+            {
+                ret = T3D_ERR_INVALID_POINTER;
+                T3D_LOG_ERROR(LOG_TAG_SCENE,
+                    "Create index buffer for StaticBatch failed !");
+                break;
+            }
+
+            mVAO = T3D_HARDWARE_BUFFER_MGR.createVertexArrayObject(true);
+            if (mVAO == nullptr)
+            {
+                ret = T3D_ERR_INVALID_POINTER;
+                T3D_LOG_ERROR(LOG_TAG_SCENE, 
+                    "Create VAO for StaticBatch failed !");
+                break;
+            }
+
+            ret = mVAO->beginBinding();
+            if (T3D_FAILED(ret))
+            {
+                mVAO = nullptr;
+                T3D_LOG_ERROR(LOG_TAG_SCENE, 
+                    "Binding VAO for StaticBatch failed !");
+                break;
+            }
+
+            mVAO->setVertexDeclaration(mDecl);
+            mVAO->addVertexBuffer(mVBO);
+            mVAO->setIndexBuffer(mIBO);
+            mVAO->setPrimitiveType(
+                RenderContext::PrimitiveType::E_PT_TRIANGLE_LIST);
+
+            mVAO->endBinding();
+
+            ret = writeIndices(nullptr);
+            if (T3D_FAILED(ret))
+            {
+                mVAO = nullptr;
+                break;
+            }
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void StaticBatch::setupCulling()
+    {
+        size_t count = mSubMeshes.size();
+        size_t words = FrustumCuller::getMaskWords(count);
+
+        mCenterX.resize(count);
+        mCenterY.resize(count);
+        mCenterZ.resize(count);
+        mExtentX.resize(count);
+        mExtentY.resize(count);
+        mExtentZ.resize(count);
+
+        size_t i = 0;
+        for (i = 0; i < count; ++i)
+        {
+            const Aabb &bound = mSubMeshes[i].bound;
+            const Vector3 &center = bound.getCenter();
+            mCenterX[i] = center.x();
+            mCenterY[i] = center.y();
+            mCenterZ[i] = center.z();
+            mExtentX[i] = bound.getWidth() * REAL_HALF;
+            mExtentY[i] = bound.getHeight() * REAL_HALF;
+            mExtentZ[i] = bound.getDepth() * REAL_HALF;
+        }
+
+        mLastPlanes.assign(count, 0);
+        mVisibility.assign(words, 0);
+        mDrawn.assign(words, 0);
+
+        // 刚写入的索引缓冲区是全部可见的
+        for (i = 0; i < count; ++i)
+        {
+            mDrawn[i >> 5] |= (1U << (i & 31));
+        }
+
+        mVisibleCount = count;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult StaticBatch::writeIndices(const uint32_t *visibility)
+    {
+        size_t pos = 0;
+        size_t i = 0, j = 0;
+        bool is16Bits = (mIndexType == HardwareIndexBuffer::Type::E_IT_16BITS);
+        uint16_t *dst16 = (uint16_t *)&mDrawIndices[0];
+        uint32_t *dst32 = (uint32_t *)&mDrawIndices[0];
+
+        for (i = 0; i < mSubMeshes.size(); ++i)
+        {
+            if (visibility != nullptr 
+                && (visibility[i >> 5] & (1U << (i & 31))) == 0)
+            {
+                continue;
+            }
+
+            const SubMesh &subMesh = mSubMeshes[i];
+            const uint32_t *src = &mIndices[subMesh.firstIndex];
+
+            if (is16Bits)
+            {
+                for (j = 0; j < subMesh.indexCount; ++j)
+                {
+                    dst16[pos++] = (uint16_t)src[j];
+                }
+            }
+            else
+            {
+                memcpy(dst32 + pos, src, subMesh.indexCount * sizeof(uint32_t));
+                pos += subMesh.indexCount;
+            }
+        }
+
+        // 只写入和绘制可见部分的索引
+        size_t bytes = pos * (is16Bits ? sizeof(uint16_t) : sizeof(uint32_t));
+        TResult ret = T3D_OK;
+
+        if (mIBO->writeData(0, bytes, &mDrawIndices[0], true) != bytes)
+        {
+            ret = T3D_ERR_HW_BUFFER_WRITE;
+            T3D_LOG_ERROR(LOG_TAG_SCENE, 
+                "Write index buffer for StaticBatch failed !");
+        }
+        else
+        {
+            mVAO->setDrawIndexCount(pos);
+        }
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool StaticBatch::frustumCulling(Bound *bound)
+    {
+        if (mVAO == nullptr)
+        {
+            return false;
+        }
+
+        size_t count = mSubMeshes.size();
+
+        if (bound != nullptr && bound->getType() == Bound::Type::FRUSTUM)
+        {
+            FrustumBound *frustum = static_cast<FrustumBound *>(bound);
+            mCuller.setFrustum(frustum->getFrustum());
+            mVisibleCount = mCuller.cullAabbs(&mCenterX[0], &mCenterY[0], 
+                &mCenterZ[0], &mExtentX[0], &mExtentY[0], &mExtentZ[0], 
+                count, &mLastPlanes[0], &mVisibility[0]);
+        }
+        else
+        {
+            // 不是视锥体，没法逐个剔除，全部可见
+            size_t i = 0;
+            mVisibility.assign(mVisibility.size(), 0);
+
+            for (i = 0; i < count; ++i)
+            {
+                mVisibility[i >> 5] |= (1U << (i & 31));
+            }
+
+            mVisibleCount = count;
+        }
+
+        if (mVisibleCount == 0)
+        {
+            return false;
+        }
+
+        if (mVisibility != mDrawn 
+            && writeIndices(&mVisibility[0]) == T3D_OK)
+        {
+            mDrawn = mVisibility;
+        }
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void StaticBatch::releaseNodes()
+    {
+        for (SceneNodePtr &node : mNodes)
+        {
+            node->mStaticBatch = nullptr;
+
+            if (node->getParent() != nullptr && node->mRenderable != nullptr
+                && node->getCameraMask() != 0)
+            {
+                T3D_SCENE_MGR.addSceneNode(node);
+            }
+        }
+
+        mNodes.clear();
+
+        for (SubMesh &subMesh : mSubMeshes)
+        {
+            subMesh.node = nullptr;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void StaticBatch::onDetachSceneNode(SceneNode *node)
+    {
+        releaseNodes();
+
+        Renderable::onDetachSceneNode(node);
+    }
+
+    //--------------------------------------------------------------------------
+
+    ComponentPtr StaticBatch::clone() const
+    {
+        StaticBatchPtr batch = create(mMaterial);
+
+        if (cloneProperties(batch) != T3D_OK)
+        {
+            batch = nullptr;
+        }
+
+        return batch;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult StaticBatch::cloneProperties(ComponentPtr newObj) const
+    {
+        TResult ret = Renderable::cloneProperties(newObj);
+
+        if (ret == T3D_OK)
+        {
+            StaticBatchPtr batch = smart_pointer_cast<StaticBatch>(newObj);
+            batch->mDecl = mDecl;
+            batch->mVertexSize = mVertexSize;
+            batch->mVertexCount = mVertexCount;
+            batch->mVertices = mVertices;
+            batch->mIndices = mIndices;
+            batch->mIndexType = mIndexType;
+            batch->mSubMeshes = mSubMeshes;
+            batch->mBound = mBound;
+
+            // 克隆对象不持有结点，顶点缓冲区不会变化，直接共用
+            for (SubMesh &subMesh : batch->mSubMeshes)
+            {
+                subMesh.node = nullptr;
+            }
+
+            if (mVBO != nullptr)
+            {
+                batch->mVBO = mVBO;
+                ret = batch->setupVAO();
+
+                if (ret == T3D_OK)
+                {
+                    batch->setupCulling();
+                }
+            }
+        }
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    MaterialPtr StaticBatch::getMaterial() const
+    {
+        return mMaterial;
+    }
+
+    //--------------------------------------------------------------------------
+
+    VertexArrayObjectPtr StaticBatch::getVertexArrayObject() const
+    {
+        return mVAO;
+    }
+}
@@ -20,6 +20,8 @@
 
 #include "Component/T3DTransform3D.h"
 #include "Scene/T3DSceneNode.h"
+#include "Scene/T3DSceneManager.h"
+#include "Component/T3DComponentRegistry.h"
 
 
 namespace Tiny3D
@@ -31,6 +33,8 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     T3D_IMPLEMENT_CLASS_1(Transform3D, Component);
+    T3D_IMPLEMENT_POOL(Transform3D, 256);
+    T3D_REGISTER_COMPONENT(Transform3D);
 
     //--------------------------------------------------------------------------
 
@@ -49,6 +53,11 @@ namespace Tiny3D
         , mOrientation(Quaternion::IDENTITY)
         , mScaling(Vector3::UNIT_SCALE)
         , mIsDirty(false)
+        , mParent(nullptr)
+        , mWorldVersion(0)
+        , mParentVersion(0)
+        , mStore(nullptr)
+        , mStoreHandle(TransformStore::INVALID_HANDLE)
     {
         mWorldTransform.setTranslation(mPosition);
         mWorldTransform.setOrientation(mOrientation);
@@ -59,7 +68,7 @@ namespace Tiny3D
 
     Transform3D::~Transform3D()
     {
-
+        detachStore();
     }
 
     //--------------------------------------------------------------------------
@@ -67,38 +76,50 @@ namespace Tiny3D
     void Transform3D::setLocalMatrix(const Matrix4 &m)
     {
         m.decomposition(mPosition, mScaling, mOrientation);
-        setDirty(true, true);
+        markDirty();
     }
 
     //--------------------------------------------------------------------------
 
     const Transform &Transform3D::getLocalToWorldTransform() const
     {
-        if (isDirty())
+        if (mStore == nullptr && !mIsDirty)
         {
-            SceneNodePtr node 
-                = smart_pointer_cast<SceneNode>(getSceneNode()->getParent());
+            // 不用变换存储时，祖先脏了会递归标记到这里，没脏就不用看父变换
+            return mWorldTransform;
+        }
 
-            while (node != nullptr)
-            {
-                node = node->getParent();
-            }
+        if (mStore != nullptr && !mStore->isDirty() && !mIsDirty
+            && (mParent == nullptr || mParentVersion == mParent->mWorldVersion))
+        {
+            // 变换存储已经 update 过并且写回了本结点，父结点按层先写回，
+            // 版本号一致就说明缓存的世界变换是最新的
+            return mWorldTransform;
+        }
+
+        if (mParent != nullptr)
+        {
+            // 父变换按同样的规则查询，没变化时直接返回缓存的世界变换
+            const Transform &parent = mParent->getLocalToWorldTransform();
 
-            if (node != nullptr)
+            if (mIsDirty || mParentVersion != mParent->mWorldVersion)
             {
-                Transform3DPtr xform = node->getTransform3D();
-                const Transform &transform = xform->getLocalToWorldTransform();
-                mWorldTransform.applyTransform(transform, mPosition, 
+                mWorldTransform.applyTransform(parent, mPosition,
                     mOrientation, mScaling);
-            }
-            else
-            {
-                mWorldTransform.setTranslation(mPosition);
-                mWorldTransform.setOrientation(mOrientation);
-                mWorldTransform.setScaling(mScaling);
-                mWorldTransform.update();
-            }
+                mParentVersion = mParent->mWorldVersion;
+                mWorldVersion++;
+                mIsDirty = false;
 
+                notifyListener();
+            }
+        }
+        else if (mIsDirty)
+        {
+            mWorldTransform.setTranslation(mPosition);
+            mWorldTransform.setOrientation(mOrientation);
+            mWorldTransform.setScaling(mScaling);
+            mWorldTransform.update();
+            mWorldVersion++;
             mIsDirty = false;
 
             notifyListener();
@@ -142,6 +163,118 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    void Transform3D::markDirty()
+    {
+        if (mStore != nullptr)
+        {
+            // 子结点由变换存储按层扫描时标记
+            mIsDirty = true;
+            mStore->setLocal(mStoreHandle, mPosition, mOrientation, mScaling);
+        }
+        else
+        {
+            setDirty(true, true);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void Transform3D::attachStore(SceneNode *node)
+    {
+        TransformStore *store = T3D_SCENE_MGR.getTransformStore();
+
+        if (store == nullptr || store == mStore)
+        {
+            return;
+        }
+
+        detachStore();
+
+        TransformStore::Handle parent = TransformStore::INVALID_HANDLE;
+
+        if (mParent != nullptr && mParent->mStore == store)
+        {
+            parent = mParent->mStoreHandle;
+        }
+
+        mStore = store;
+        mStoreHandle = store->create(parent, this);
+        store->setLocal(mStoreHandle, mPosition, mOrientation, mScaling);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void Transform3D::detachStore()
+    {
+        if (mStore != nullptr)
+        {
+            mStore->destroy(mStoreHandle);
+            mStore = nullptr;
+            mStoreHandle = TransformStore::INVALID_HANDLE;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void Transform3D::updateParent(SceneNode *parent)
+    {
+        mParent = (parent != nullptr ? parent->getTransform3D() : nullptr);
+
+        if (mStore != nullptr)
+        {
+            TransformStore::Handle handle = TransformStore::INVALID_HANDLE;
+
+            if (mParent != nullptr && mParent->mStore == mStore)
+            {
+                handle = mParent->mStoreHandle;
+            }
+
+            mStore->setParent(mStoreHandle, handle);
+        }
+
+        markDirty();
+    }
+
+    //--------------------------------------------------------------------------
+
+    void Transform3D::updateChildren(Transform3D *parent)
+    {
+        NodePtr child = getSceneNode()->getFirstChild();
+
+        while (child != nullptr)
+        {
+            SceneNode *node = static_cast<SceneNode *>((Node *)child);
+            Transform3D *xform = node->getTransform3D();
+
+            if (xform != nullptr)
+            {
+                xform->updateParent(
+                    parent != nullptr ? getSceneNode() : nullptr);
+            }
+
+            child = child->getNextSibling();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void Transform3D::applyWorldTransform(const Transform &world)
+    {
+        mWorldTransform = world;
+        mWorldVersion++;
+        mIsDirty = false;
+
+        // 按层写回，父变换已经写过了
+        if (mParent != nullptr)
+        {
+            mParentVersion = mParent->mWorldVersion;
+        }
+
+        notifyListener();
+    }
+
+    //--------------------------------------------------------------------------
+
     void Transform3D::setDirty(bool isDirty, bool recursive /* = false */)
     {
         if (mIsDirty != isDirty)
@@ -174,12 +307,31 @@ namespace Tiny3D
         }
         return newObj;
     }
+
+    //--------------------------------------------------------------------------
+
+    ComponentPtr Transform3D::instantiate() const
+    {
+        Transform3DPtr newObj = create();
+        newObj->mPosition = mPosition;
+        newObj->mOrientation = mOrientation;
+        newObj->mScaling = mScaling;
+        newObj->mIsDirty = true;
+        return newObj;
+    }
+
     //--------------------------------------------------------------------------
 
     void Transform3D::onAttachSceneNode(SceneNode *node)
     {
         Component::onAttachSceneNode(node);
 
+        SceneNodePtr parent = smart_pointer_cast<SceneNode>(node->getParent());
+        mParent = (parent != nullptr ? parent->getTransform3D() : nullptr);
+
+        attachStore(node);
+        updateChildren(this);
+
         setDirty(true, true);
     }
 
@@ -187,13 +339,24 @@ namespace Tiny3D
 
     void Transform3D::onDetachSceneNode(SceneNode *node)
     {
+        updateChildren(nullptr);
+
         Component::onDetachSceneNode(node);
+
+        detachStore();
+        mParent = nullptr;
     }
 
     //--------------------------------------------------------------------------
 
     void Transform3D::update()
     {
+        if (mStore != nullptr)
+        {
+            // 场景管理器已经统一计算并写回了
+            return;
+        }
+
         getLocalToWorldTransform();
     }
 
@@ -24,6 +24,7 @@
 #include "Kernel/T3DPlugin.h"
 #include "Kernel/T3DConfigFile.h"
 #include "Kernel/T3DCommon.h"
+#include "Kernel/T3DJobSystem.h"
 
 #include "ImageCodec/T3DImageCodec.h"
 
@@ -84,6 +85,7 @@ namespace Tiny3D
         : mLogger(nullptr)
         , mEventMgr(nullptr)
         , mObjTracer(nullptr)
+        , mJobSystem(nullptr)
         , mDefaultWindow(nullptr)
         , mArchiveMgr(nullptr)
         , mDylibMgr(nullptr)
@@ -120,6 +122,8 @@ namespace Tiny3D
 
         mDylibMgr->unloadAllResources();
 
+        T3D_SAFE_DELETE(mJobSystem);
+
         mShaderMgr = nullptr;
         mGPUConstBufferMgr = nullptr;
         mGPUProgramMgr = nullptr;
@@ -226,6 +230,13 @@ namespace Tiny3D
                 break;
             }
 
+            // 初始化任务系统
+            ret = initJobSystem();
+            if (T3D_FAILED(ret))
+            {
+                break;
+            }
+
             // 加载配置文件中指定的插件
             ret = loadPlugins();
             if (T3D_FAILED(ret))
@@ -939,6 +950,46 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    TResult Agent::initJobSystem()
+    {
+        // 没有配置时不创建工作线程，任务都在调用线程上执行
+        int32_t count = 0;
+
+        String s("Job");
+        Variant key(s);
+        Settings::const_iterator itr = mSettings.find(key);
+
+        if (itr != mSettings.end())
+        {
+            const Settings &settings = itr->second.mapValue();
+            key.setString("WorkerCount");
+            Settings::const_iterator i = settings.find(key);
+
+            if (i != settings.end())
+            {
+                count = i->second.int32Value();
+            }
+        }
+
+        if (count < 0)
+        {
+            // 负数表示按照硬件线程数量自动设置，留一个给调用线程
+            uint32_t cores = std::thread::hardware_concurrency();
+            count = (cores > 1 ? int32_t(cores - 1) : 0);
+        }
+
+        size_t workerCount = size_t(count);
+
+        mJobSystem = new JobSystem(workerCount);
+
+        T3D_LOG_INFO(LOG_TAG_ENGINE, "Job system started with %u workers",
+            uint32_t(workerCount));
+
+        return T3D_OK;
+    }
+
+    //--------------------------------------------------------------------------
+
     TResult Agent::loadPlugins()
     {
         TResult ret = T3D_OK;
@@ -0,0 +1,192 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#include "Kernel/T3DJobSystem.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    T3D_INIT_SINGLETON(JobSystem);
+
+    //--------------------------------------------------------------------------
+
+    // 当前线程的线程序号，工作线程启动时设置
+    static thread_local size_t sThreadIndex = 0;
+
+    // 当前线程是否正在执行任务，用来识别嵌套调用
+    static thread_local bool sInsideJob = false;
+
+    //--------------------------------------------------------------------------
+
+    JobSystem::JobSystem(size_t workerCount)
+        : mGeneration(0)
+        , mIsRunning(true)
+        , mJob(nullptr)
+        , mCount(0)
+        , mGrain(1)
+        , mChunkCount(0)
+        , mNextChunk(0)
+        , mActiveWorkers(0)
+    {
+        mWorkers.reserve(workerCount);
+
+        size_t i = 0;
+        for (i = 0; i < workerCount; ++i)
+        {
+            mWorkers.push_back(
+                std::thread(&JobSystem::workingProcedure, this, i + 1));
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    JobSystem::~JobSystem()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mIsRunning = false;
+        }
+
+        mWakeCond.notify_all();
+
+        for (std::thread &worker : mWorkers)
+        {
+            worker.join();
+        }
+
+        mWorkers.clear();
+    }
+
+    //--------------------------------------------------------------------------
+
+    size_t JobSystem::getThreadIndex()
+    {
+        return sThreadIndex;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void JobSystem::parallelFor(size_t count, size_t grain, const RangeJob &job)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (grain == 0)
+        {
+            // 每个线程大约分到4块，执行快慢不一时还能互相补上
+            size_t chunks = getThreadCount() * 4;
+            grain = (count + chunks - 1) / chunks;
+        }
+
+        if (mWorkers.empty() || sInsideJob || count <= grain)
+        {
+            // 没有必要分给工作线程
+            job(0, count, sThreadIndex);
+            return;
+        }
+
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mJob = &job;
+            mCount = count;
+            mGrain = grain;
+            mChunkCount = (count + grain - 1) / grain;
+            mNextChunk.store(0, std::memory_order_relaxed);
+            mActiveWorkers = mWorkers.size();
+            ++mGeneration;
+        }
+
+        mWakeCond.notify_all();
+
+        // 调用线程也一起领取
+        executeChunks(0);
+
+        // 等所有块执行完，并且工作线程都离开当前任务，才能让 job 失效
+        std::unique_lock<std::mutex> lock(mMutex);
+        mDoneCond.wait(lock, [this]() 
+        { 
+            return mActiveWorkers == 0; 
+        });
+        mJob = nullptr;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void JobSystem::executeChunks(size_t thread)
+    {
+        sInsideJob = true;
+
+        while (true)
+        {
+            size_t chunk = mNextChunk.fetch_add(1, std::memory_order_relaxed);
+
+            if (chunk >= mChunkCount)
+            {
+                break;
+            }
+
+            size_t begin = chunk * mGrain;
+            size_t end = std::min(begin + mGrain, mCount);
+            (*mJob)(begin, end, thread);
+        }
+
+        sInsideJob = false;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void JobSystem::workingProcedure(size_t index)
+    {
+        sThreadIndex = index;
+
+        uint64_t generation = 0;
+
+        while (true)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mWakeCond.wait(lock, [this, generation]() 
+                { 
+                    return !mIsRunning || mGeneration != generation; 
+                });
+
+                if (!mIsRunning)
+                {
+                    break;
+                }
+
+                generation = mGeneration;
+            }
+
+            executeChunks(index);
+
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                --mActiveWorkers;
+            }
+
+            mDoneCond.notify_one();
+        }
+    }
+}
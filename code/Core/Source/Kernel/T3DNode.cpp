@@ -25,6 +25,19 @@ namespace Tiny3D
 {
     //--------------------------------------------------------------------------
 
+    /**
+     * @brief 子结点索引，只有子结点较多的结点才会建立
+     * @note 同名或同ID的子结点只索引链表中最靠前的一个，与线性查找的结果一致
+     */
+    struct Node::ChildIndex
+    {
+        THashMap<ID, Node*>         ids;            /**< ID 到子结点的映射 */
+        THashMap<NameID, Node*>     names;          /**< 名称ID到子结点的映射 */
+        bool                        hasDuplicates;  /**< 是否存在未被索引的重复项 */
+    };
+
+    //--------------------------------------------------------------------------
+
     T3D_IMPLEMENT_CLASS_1(Node, Object);
 
     //--------------------------------------------------------------------------
@@ -32,7 +45,9 @@ namespace Tiny3D
     Node::Node(ID uID /* = E_NID_AUTOMATIC */)
         : mID(E_NID_INVALID)
         , mName()
+        , mNameID(StringInterner::intern("", 0))
         , mChildrenCount(0)
+        , mChildIndex(nullptr)
         , mParent(nullptr)
         , mFirstChild(nullptr)
         , mLastChild(nullptr)
@@ -56,6 +71,29 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    void Node::setName(const String &name)
+    {
+        Node *parent = mParent;
+        bool indexed = (parent != nullptr && parent->mChildIndex != nullptr);
+        bool rebuild = false;
+
+        if (indexed)
+        {
+            rebuild = parent->unindexChild(this);
+        }
+
+        mName = name;
+        mNameID = StringInterner::intern(mName);
+
+        if (indexed && (!parent->indexChild(this) || rebuild))
+        {
+            // 改名后与其他兄弟结点重名，无法判断谁在链表前面，只能重建
+            parent->rebuildChildIndex();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
     TResult Node::addChild(NodePtr node)
     {
         T3D_ASSERT(node->getParent() == nullptr);
@@ -63,6 +101,8 @@ namespace Tiny3D
         if (mFirstChild == nullptr)
         {
             // 没有子结点
+            node->mPrevSibling = nullptr;
+            node->mNextSibling = nullptr;
             mLastChild = mFirstChild = node;
         }
         else
@@ -76,6 +116,21 @@ namespace Tiny3D
 
         node->mParent = this;
         mChildrenCount++;
+
+        if (mChildIndex != nullptr)
+        {
+            if (!indexChild(node))
+            {
+                // 新结点在链表末尾，重名时保留原来的索引即可
+                mChildIndex->hasDuplicates = true;
+            }
+        }
+        else if (mChildrenCount > CHILD_INDEX_THRESHOLD)
+        {
+            // 索引只在增删子结点时维护，查找接口是只读的，可以并发调用
+            buildChildIndex();
+        }
+
         node->onAttachParent(this);
         return T3D_OK;
     }
@@ -95,33 +150,12 @@ namespace Tiny3D
                 break;
             }
 
-            Node *child = mFirstChild;
-
-            while (child != nullptr)
+            if (node->mParent != this)
             {
-                if (child == node)
-                {
-                    // 找到要删除的，先断开链表前后关系
-                    child->onDetachParent(this);
-                    child->mParent = nullptr;
-                    mChildrenCount--;
-
-                    if (child->mPrevSibling != nullptr)
-                        child->mPrevSibling->mNextSibling = child->mNextSibling;
-                    if (child->mNextSibling != nullptr)
-                        child->mNextSibling->mPrevSibling = child->mPrevSibling;
-
-                    break;
-                }
-
-                child = child->mNextSibling;
+                break;
             }
 
-            if (mChildrenCount == 0)
-            {
-                mFirstChild = nullptr;
-                mLastChild = nullptr;
-            }
+            detachChild(node);
         } while (0);
 
         return ret;
@@ -142,36 +176,51 @@ namespace Tiny3D
                 break;
             }
 
-            Node *child = mFirstChild;
+            NodePtr child = getChild(nodeID);
 
-            while (child != nullptr)
+            if (child != nullptr)
             {
-                if (child->getNodeID() == nodeID)
-                {
-                    // 找到要删除的，先断开链表前后关系
-                    child->onDetachParent(this);
-                    child->mParent = nullptr;
-                    mChildrenCount--;
+                detachChild(child);
+            }
+        } while (0);
 
-                    if (child->mPrevSibling != nullptr)
-                        child->mPrevSibling->mNextSibling = child->mNextSibling;
-                    if (child->mNextSibling != nullptr)
-                        child->mNextSibling->mPrevSibling = child->mPrevSibling;
+        return ret;
+    }
 
-                    break;
-                }
+    //--------------------------------------------------------------------------
 
-                child = child->mNextSibling;
-            }
+    void Node::detachChild(Node *child)
+    {
+        // 找到要删除的，先断开链表前后关系
+        child->onDetachParent(this);
+        child->mParent = nullptr;
+        mChildrenCount--;
+
+        if (child->mPrevSibling != nullptr)
+            child->mPrevSibling->mNextSibling = child->mNextSibling;
+        else
+            mFirstChild = child->mNextSibling;
+
+        if (child->mNextSibling != nullptr)
+            child->mNextSibling->mPrevSibling = child->mPrevSibling;
+        else
+            mLastChild = child->mPrevSibling;
 
-            if (mChildrenCount == 0)
+        child->mPrevSibling = nullptr;
+        child->mNextSibling = nullptr;
+
+        if (mChildIndex != nullptr)
+        {
+            if (mChildrenCount < CHILD_INDEX_THRESHOLD)
             {
-                mFirstChild = nullptr;
-                mLastChild = nullptr;
+                destroyChildIndex();
             }
-        } while (0);
-
-        return ret;
+            else if (unindexChild(child))
+            {
+                // 被遮住的重复项需要补上
+                rebuildChildIndex();
+            }
+        }
     }
 
     //--------------------------------------------------------------------------
@@ -180,6 +229,8 @@ namespace Tiny3D
     {
         TResult ret = T3D_OK;
 
+        destroyChildIndex();
+
         Node *child = mFirstChild;
 
         while (child != nullptr)
@@ -218,6 +269,12 @@ namespace Tiny3D
 
     NodePtr Node::getChild(ID nodeID) const
     {
+        if (mChildIndex != nullptr)
+        {
+            auto itr = mChildIndex->ids.find(nodeID);
+            return (itr != mChildIndex->ids.end() ? itr->second : nullptr);
+        }
+
         Node *child = nullptr;
         Node *temp = mFirstChild;
 
@@ -239,12 +296,69 @@ namespace Tiny3D
 
     NodePtr Node::getChild(const String &name) const
     {
+        return lookupChild(StringInterner::intern(name));
+    }
+
+    //--------------------------------------------------------------------------
+
+    NodePtr Node::getChild(const char *name, size_t length) const
+    {
+        return lookupChild(StringInterner::intern(name, length));
+    }
+
+    //--------------------------------------------------------------------------
+
+    NodePtr Node::getChildByNameID(NameID nameID) const
+    {
+        return lookupChild(nameID);
+    }
+
+    //--------------------------------------------------------------------------
+
+    NodePtr Node::findChildByPath(const char *path, char separator) const
+    {
+        const Node *node = this;
+        const char *segment = path;
+
+        while (node != nullptr && *segment != 0)
+        {
+            const char *end = segment;
+
+            while (*end != 0 && *end != separator)
+            {
+                ++end;
+            }
+
+            size_t length = end - segment;
+
+            if (length > 0)
+            {
+                node = node->lookupChild(
+                    StringInterner::intern(segment, length));
+            }
+
+            segment = (*end != 0 ? end + 1 : end);
+        }
+
+        return const_cast<Node*>(node);
+    }
+
+    //--------------------------------------------------------------------------
+
+    Node *Node::lookupChild(NameID nameID) const
+    {
+        if (mChildIndex != nullptr)
+        {
+            auto itr = mChildIndex->names.find(nameID);
+            return (itr != mChildIndex->names.end() ? itr->second : nullptr);
+        }
+
         Node *child = nullptr;
         Node *temp = mFirstChild;
 
         while (temp != nullptr)
         {
-            if (temp->getName() == name)
+            if (temp->mNameID == nameID)
             {
                 child = temp;
                 break;
@@ -254,8 +368,78 @@ namespace Tiny3D
         }
 
         return child;
+    }
 
-        return child;
+    //--------------------------------------------------------------------------
+
+    void Node::buildChildIndex()
+    {
+        T3D_ASSERT(mChildIndex == nullptr);
+
+        mChildIndex = new ChildIndex();
+        mChildIndex->ids.reserve(mChildrenCount);
+        mChildIndex->names.reserve(mChildrenCount);
+        mChildIndex->hasDuplicates = false;
+
+        Node *child = mFirstChild;
+
+        while (child != nullptr)
+        {
+            if (!indexChild(child))
+            {
+                mChildIndex->hasDuplicates = true;
+            }
+
+            child = child->mNextSibling;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void Node::destroyChildIndex()
+    {
+        T3D_SAFE_DELETE(mChildIndex);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void Node::rebuildChildIndex()
+    {
+        destroyChildIndex();
+        buildChildIndex();
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool Node::indexChild(Node *child)
+    {
+        bool ret = mChildIndex->ids.emplace(child->mID, child).second;
+        ret = mChildIndex->names.emplace(child->mNameID, child).second && ret;
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool Node::unindexChild(Node *child)
+    {
+        bool erased = false;
+
+        auto itrID = mChildIndex->ids.find(child->mID);
+        if (itrID != mChildIndex->ids.end() && itrID->second == child)
+        {
+            mChildIndex->ids.erase(itrID);
+            erased = true;
+        }
+
+        auto itrName = mChildIndex->names.find(child->mNameID);
+        if (itrName != mChildIndex->names.end() && itrName->second == child)
+        {
+            mChildIndex->names.erase(itrName);
+            erased = true;
+        }
+
+        // 有被遮住的重复项时需要调用者重建索引
+        return (erased && mChildIndex->hasDuplicates);
     }
 
     //--------------------------------------------------------------------------
@@ -274,15 +458,15 @@ namespace Tiny3D
             }
 
             // 克隆结点名称
-            node->mName = mName;
+            node->setName(mName);
 
             // 克隆子结点属性
             Node *child = mFirstChild;
 
             while (child != nullptr)
             {
+                // clone() 内部已经调用过 cloneProperties()
                 NodePtr newChild = child->clone();
-                child->cloneProperties(newChild);
                 node->addChild(newChild);
                 child = child->mNextSibling;
             }
@@ -29,24 +29,113 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+#if defined (T3D_REFCOUNT_STATS)
+    static std::atomic<uint64_t> sAcquireCount(0);
+    static std::atomic<uint64_t> sReleaseCount(0);
+
+    uint64_t Object::getAcquireCount()
+    {
+        return sAcquireCount.load(std::memory_order_relaxed);
+    }
+
+    uint64_t Object::getReleaseCount()
+    {
+        return sReleaseCount.load(std::memory_order_relaxed);
+    }
+
+    //--------------------------------------------------------------------------
+#endif
+
     Object::Object()
         : mReferCount(1)
+        , mTraceInfo(0)
     {
-        ObjectTracer::getInstance().addObject(this);
+        // 构造函数里还不知道实际的类，第一次被持有时再计数
     }
 
     //--------------------------------------------------------------------------
 
     Object::~Object()
     {
-        ObjectTracer::getInstance().removeObject(this);
+        if (mTraceInfo != 0)
+        {
+            const Class *cls = Class::getClass(mTraceInfo & TRACE_CLASS_MASK);
+
+            if (cls != nullptr)
+            {
+                cls->onInstanceDestroyed();
+            }
+
+            ObjectTracer *tracer = ObjectTracer::getInstancePtr();
+
+            if ((mTraceInfo & TRACE_SAMPLED) != 0 && tracer != nullptr)
+            {
+                tracer->removeSample(this);
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void Object::traceClass()
+    {
+        const Class *cls = getClass();
+
+        // 没有序号的类不计数，也不再尝试
+        const uint32_t info
+            = (cls->getIndex() == 0 ? TRACE_CLASS_MASK : cls->getIndex());
+
+#if defined (T3D_ATOMIC_REFCOUNT)
+        // 多个线程同时第一次持有时，只有抢到的线程计数
+        uint32_t expected = 0;
+
+        if (!mTraceInfo.compare_exchange_strong(expected, info,
+            std::memory_order_relaxed))
+        {
+            return;
+        }
+#else
+        mTraceInfo = info;
+#endif
+
+        if (info == TRACE_CLASS_MASK)
+        {
+            return;
+        }
+
+        cls->onInstanceCreated();
+
+        ObjectTracer *tracer = ObjectTracer::getInstancePtr();
+
+        if (tracer != nullptr && tracer->isTracingEnabled())
+        {
+            tracer->sampleObject(this);
+        }
     }
 
     //--------------------------------------------------------------------------
 
     Object *Object::acquire()
     {
+#if defined (T3D_ATOMIC_REFCOUNT)
+        if (mTraceInfo.load(std::memory_order_relaxed) == 0)
+#else
+        if (mTraceInfo == 0)
+#endif
+        {
+            traceClass();
+        }
+
+#if defined (T3D_REFCOUNT_STATS)
+        sAcquireCount.fetch_add(1, std::memory_order_relaxed);
+#endif
+
+#if defined (T3D_ATOMIC_REFCOUNT)
+        // 持有者本身已经有引用，增加计数不需要同步其他内存
+        mReferCount.fetch_add(1, std::memory_order_relaxed);
+#else
         ++mReferCount;
+#endif
         return this;
     }
 
@@ -54,9 +143,21 @@ namespace Tiny3D
 
     void Object::release()
     {
+#if defined (T3D_REFCOUNT_STATS)
+        sReleaseCount.fetch_add(1, std::memory_order_relaxed);
+#endif
+
+#if defined (T3D_ATOMIC_REFCOUNT)
+        // 最后一个释放的线程要看到其他线程对对象的所有修改才能删除
+        if (mReferCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete this;
+        }
+#else
         if (--mReferCount == 0)
         {
             delete this;
         }
+#endif
     }
 }
@@ -46,6 +46,7 @@ namespace Tiny3D
         : mGPUProgram(nullptr)
         , mParent(tech)
         , mName(name)
+        , mNameID(StringInterner::intern(name))
         , mAmbient(ColorRGBA::WHITE)
         , mDiffuse(ColorRGBA::WHITE)
         , mSpecular(ColorRGBA::BLACK)
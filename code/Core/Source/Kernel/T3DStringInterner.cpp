@@ -0,0 +1,118 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#include "Kernel/T3DStringInterner.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+#if defined (T3D_DEBUG)
+    struct InternTable
+    {
+        TMutex                      mutex;
+        THashMap<NameID, String>    strings;
+    };
+
+    static InternTable &getInternTable()
+    {
+        // 函数内静态对象，保证其他全局对象构造时也能安全使用
+        static InternTable table;
+        return table;
+    }
+#endif
+
+    //--------------------------------------------------------------------------
+
+    NameID StringInterner::hash(const char *str, size_t length)
+    {
+        // FNV-1a
+        NameID value = 14695981039346656037ULL;
+
+        for (size_t i = 0; i < length; ++i)
+        {
+            value ^= (uint8_t)str[i];
+            value *= 1099511628211ULL;
+        }
+
+        return value;
+    }
+
+    //--------------------------------------------------------------------------
+
+    NameID StringInterner::intern(const char *str, size_t length)
+    {
+        NameID id = hash(str, length);
+
+#if defined (T3D_DEBUG)
+        InternTable &table = getInternTable();
+        TAutoLock<TMutex> lock(table.mutex);
+
+        auto rval = table.strings.insert(
+            std::make_pair(id, String(str, length)));
+
+        if (!rval.second && (rval.first->second.length() != length
+            || memcmp(rval.first->second.c_str(), str, length) != 0))
+        {
+            T3D_LOG_ERROR(LOG_TAG_ENGINE, 
+                "Name ID collision between [%s] and [%s] !", 
+                rval.first->second.c_str(), String(str, length).c_str());
+            T3D_ASSERT(0);
+        }
+#endif
+
+        return id;
+    }
+
+    //--------------------------------------------------------------------------
+
+    NameID StringInterner::intern(const String &str)
+    {
+        return intern(str.c_str(), str.length());
+    }
+
+    //--------------------------------------------------------------------------
+
+    NameID StringInterner::combine(NameID id, uint64_t value)
+    {
+        for (size_t i = 0; i < sizeof(value); ++i)
+        {
+            id ^= (value & 0xFF);
+            id *= 1099511628211ULL;
+            value >>= 8;
+        }
+
+        return id;
+    }
+
+    //--------------------------------------------------------------------------
+
+    size_t StringInterner::getInternedCount()
+    {
+#if defined (T3D_DEBUG)
+        InternTable &table = getInternTable();
+        TAutoLock<TMutex> lock(table.mutex);
+        return table.strings.size();
+#else
+        return 0;
+#endif
+    }
+}
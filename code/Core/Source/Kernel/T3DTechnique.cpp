@@ -46,6 +46,7 @@ namespace Tiny3D
     Technique::Technique(const String &name, Material *material)
         : mParent(material)
         , mName(name)
+        , mNameID(StringInterner::intern(name))
         , mLodIndex(0)
         , mSchemeIndex(0)
         , mRenderQueue(0)
@@ -137,12 +138,13 @@ namespace Tiny3D
     TResult Technique::removePass(const String &name)
     {
         TResult ret = T3D_ERR_NOT_FOUND;
+        NameID nameID = StringInterner::intern(name);
 
         auto itr = mPasses.begin();
         while (itr != mPasses.end())
         {
             PassPtr pass = *itr;
-            if (name == pass->getName())
+            if (nameID == pass->getNameID())
             {
                 mPasses.erase(itr);
                 ret = T3D_OK;
@@ -190,12 +192,13 @@ namespace Tiny3D
     PassPtr Technique::getPass(const String &name) const
     {
         PassPtr pass;
+        NameID nameID = StringInterner::intern(name);
 
         auto itr = mPasses.begin();
         while (itr != mPasses.end())
         {
             const PassPtr &p = *itr;
-            if (name == pass->getName())
+            if (nameID == p->getNameID())
             {
                 pass = p;
                 break;
@@ -0,0 +1,228 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#include "Memory/T3DObjectPool.h"
+#include <cstddef>
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    ObjectPool *ObjectPool::msFirstPool = nullptr;
+
+    //--------------------------------------------------------------------------
+
+    std::mutex &ObjectPool::getRegistryMutex()
+    {
+        static std::mutex registryMutex;
+        return registryMutex;
+    }
+
+    //--------------------------------------------------------------------------
+
+    ObjectPool::ObjectPool(const char *name, size_t objectSize, 
+        size_t slabObjects /* = DEFAULT_SLAB_OBJECTS */)
+        : mName(name)
+        , mObjectSize(0)
+        , mSlabObjects(slabObjects > 0 ? slabObjects : 1)
+        , mFreeList(nullptr)
+        , mLiveCount(0)
+        , mPeakCount(0)
+        , mAllocCount(0)
+        , mFreeCount(0)
+        , mFallbackCount(0)
+        , mNext(nullptr)
+    {
+        // 按最大基础类型对齐，保证每个对象都满足对齐要求
+        const size_t align = alignof(std::max_align_t);
+        size_t size = std::max(objectSize, sizeof(FreeNode));
+        mObjectSize = (size + align - 1) / align * align;
+
+        std::lock_guard<std::mutex> lock(getRegistryMutex());
+        mNext = msFirstPool;
+        msFirstPool = this;
+    }
+
+    //--------------------------------------------------------------------------
+
+    ObjectPool::~ObjectPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(getRegistryMutex());
+            ObjectPool **pool = &msFirstPool;
+
+            while (*pool != nullptr)
+            {
+                if (*pool == this)
+                {
+                    *pool = mNext;
+                    break;
+                }
+
+                pool = &(*pool)->mNext;
+            }
+        }
+
+        // 还有对象存活的话不能释放内存
+        if (mLiveCount == 0)
+        {
+            for (void *slab : mSlabs)
+            {
+                ::operator delete(slab);
+            }
+
+            mSlabs.clear();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void ObjectPool::allocateSlab()
+    {
+        uint8_t *slab = (uint8_t *)::operator new(mObjectSize * mSlabObjects);
+        mSlabs.push_back(slab);
+
+        // 倒序挂到链表上，分配时按地址顺序取出
+        size_t i = mSlabObjects;
+        while (i > 0)
+        {
+            --i;
+            FreeNode *node = (FreeNode *)(slab + i * mObjectSize);
+            node->next = mFreeList;
+            mFreeList = node;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void *ObjectPool::allocate(size_t size)
+    {
+        if (size > mObjectSize)
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            ++mFallbackCount;
+            return ::operator new(size);
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        if (mFreeList == nullptr)
+        {
+            allocateSlab();
+        }
+
+        FreeNode *node = mFreeList;
+        mFreeList = node->next;
+
+        ++mAllocCount;
+        ++mLiveCount;
+
+        if (mLiveCount > mPeakCount)
+        {
+            mPeakCount = mLiveCount;
+        }
+
+        return node;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void ObjectPool::deallocate(void *ptr, size_t size)
+    {
+        if (ptr == nullptr)
+        {
+            return;
+        }
+
+        if (size > mObjectSize)
+        {
+            ::operator delete(ptr);
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        FreeNode *node = (FreeNode *)ptr;
+        node->next = mFreeList;
+        mFreeList = node;
+
+        ++mFreeCount;
+        --mLiveCount;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void ObjectPool::getStats(Stats &stats) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        stats.name = mName;
+        stats.objectSize = mObjectSize;
+        stats.slabObjects = mSlabObjects;
+        stats.slabCount = mSlabs.size();
+        stats.reservedBytes = mSlabs.size() * mSlabObjects * mObjectSize;
+        stats.liveCount = mLiveCount;
+        stats.peakCount = mPeakCount;
+        stats.allocCount = mAllocCount;
+        stats.freeCount = mFreeCount;
+        stats.fallbackCount = mFallbackCount;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void ObjectPool::getAllStats(StatsList &stats)
+    {
+        stats.clear();
+
+        std::lock_guard<std::mutex> lock(getRegistryMutex());
+        ObjectPool *pool = msFirstPool;
+
+        while (pool != nullptr)
+        {
+            Stats item;
+            pool->getStats(item);
+            stats.push_back(item);
+            pool = pool->mNext;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void ObjectPool::dumpStats()
+    {
+        StatsList stats;
+        getAllStats(stats);
+
+        T3D_LOG_INFO(LOG_TAG_ENGINE, 
+            "Dump object pools =================================>");
+
+        for (const Stats &item : stats)
+        {
+            T3D_LOG_INFO(LOG_TAG_ENGINE, "Pool %s : object size %u, "
+                "slabs %u, reserved %u bytes, live %u, peak %u, alloc %u, "
+                "free %u, fallback %u", item.name, 
+                (uint32_t)item.objectSize, (uint32_t)item.slabCount,
+                (uint32_t)item.reservedBytes, (uint32_t)item.liveCount, 
+                (uint32_t)item.peakCount, (uint32_t)item.allocCount, 
+                (uint32_t)item.freeCount, (uint32_t)item.fallbackCount);
+        }
+    }
+}
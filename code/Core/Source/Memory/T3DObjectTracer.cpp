@@ -21,13 +21,26 @@
 #include "Memory/T3DObjectTracer.h"
 #include <sstream>
 
+#if defined (T3D_OS_WINDOWS)
+#include <windows.h>
+#elif defined (T3D_OS_LINUX) || defined (T3D_OS_OSX)
+#include <execinfo.h>
+#endif
+
 
 namespace Tiny3D
 {
     T3D_INIT_SINGLETON(ObjectTracer);
 
-    ObjectTracer::ObjectTracer(bool enabled /* = false */)
+    const uint32_t ObjectTracer::DEFAULT_SAMPLE_INTERVAL = 64;
+
+    const size_t ObjectTracer::MAX_BACKTRACE_DEPTH;
+
+    ObjectTracer::ObjectTracer(bool enabled /* = false */, 
+        uint32_t sampleInterval /* = DEFAULT_SAMPLE_INTERVAL */)
         : mIsEnabled(enabled)
+        , mSampleInterval(sampleInterval)
+        , mSerial(0)
         , mStream(nullptr)
     {
 
@@ -38,27 +51,185 @@ namespace Tiny3D
 
     }
 
-    void ObjectTracer::dumpMemoryInfo() const
+    void ObjectTracer::setSampleInterval(uint32_t interval)
+    {
+        mSampleInterval.store(interval, std::memory_order_relaxed);
+    }
+
+    uint32_t ObjectTracer::getSampleInterval() const
+    {
+        return mSampleInterval.load(std::memory_order_relaxed);
+    }
+
+    void ObjectTracer::sampleObject(Object *object)
+    {
+        uint64_t serial = mSerial.fetch_add(1, std::memory_order_relaxed) + 1;
+        uint32_t interval = mSampleInterval.load(std::memory_order_relaxed);
+
+        if (interval == 0 || serial % interval != 0)
+        {
+            return;
+        }
+
+        SampleInfo sample;
+        sample.object = object;
+        sample.cls = object->getClass();
+        sample.serial = serial;
+        sample.depth = captureBacktrace(sample.frames, MAX_BACKTRACE_DEPTH);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSamples[object] = sample;
+        object->mTraceInfo |= Object::TRACE_SAMPLED;
+    }
+
+    void ObjectTracer::removeSample(const Object *object)
     {
-        if (mIsEnabled)
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSamples.erase(object);
+    }
+
+    size_t ObjectTracer::captureBacktrace(void **frames, size_t maxDepth)
+    {
+#if defined (T3D_OS_WINDOWS)
+        // 跳过自己和 sampleObject
+        return (size_t)RtlCaptureStackBackTrace(2, (DWORD)maxDepth, frames, 
+            nullptr);
+#elif defined (T3D_OS_LINUX) || defined (T3D_OS_OSX)
+        // 跳过自己和 sampleObject
+        void *buffer[MAX_BACKTRACE_DEPTH + 2];
+        size_t depth = std::min(maxDepth, MAX_BACKTRACE_DEPTH);
+        int count = backtrace(buffer, (int)depth + 2);
+
+        if (count <= 2)
         {
-            printInfo("Dump memory leak =================================>\n");
+            return 0;
+        }
+
+        memcpy(frames, buffer + 2, (count - 2) * sizeof(void *));
+        return (size_t)(count - 2);
+#else
+        return 0;
+#endif
+    }
+
+    void ObjectTracer::takeSnapshot(Snapshot &snapshot) const
+    {
+        snapshot.serial = mSerial.load(std::memory_order_relaxed);
+        snapshot.classes.clear();
+        snapshot.samples.clear();
 
-            std::stringstream ss;
+        uint32_t count = Class::getClassCount();
+        uint32_t i = 0;
 
-            for (auto itr = mObjects.begin(); itr != mObjects.end(); ++itr)
+        for (i = 1; i <= count; ++i)
+        {
+            const Class *cls = Class::getClass(i);
+
+            if (cls == nullptr || cls->getTotalCount() == 0)
             {
-                Object *obj = *itr;
+                continue;
+            }
+
+            ClassInfo info;
+            info.cls = cls;
+            info.liveCount = cls->getLiveCount();
+            info.peakCount = cls->getPeakCount();
+            info.totalCount = cls->getTotalCount();
+            info.bytes = info.liveCount * cls->getSize();
+            snapshot.classes.push_back(info);
+        }
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        snapshot.samples.reserve(mSamples.size());
+
+        for (const SamplesValue &value : mSamples)
+        {
+            snapshot.samples.push_back(value.second);
+        }
+    }
+
+    void ObjectTracer::diffSnapshots(const Snapshot &before, 
+        const Snapshot &after, SnapshotDiff &diff)
+    {
+        diff.classes.clear();
+        diff.samples.clear();
+
+        TMap<const Class*, const ClassInfo*> infos;
+
+        for (const ClassInfo &info : before.classes)
+        {
+            infos[info.cls] = &info;
+        }
+
+        for (const ClassInfo &info : after.classes)
+        {
+            ClassDelta delta;
+            delta.cls = info.cls;
+            delta.liveDelta = int64_t(info.liveCount);
+            delta.bytesDelta = int64_t(info.bytes);
 
-                ss.str("");
-                ss << "Leak Object : " << typeid(*obj).name() << " ReferCount : " << obj->referCount() << "\n";
-                printInfo(ss.str());
+            auto itr = infos.find(info.cls);
+
+            if (itr != infos.end())
+            {
+                delta.liveDelta -= int64_t(itr->second->liveCount);
+                delta.bytesDelta -= int64_t(itr->second->bytes);
+            }
+
+            if (delta.liveDelta != 0)
+            {
+                diff.classes.push_back(delta);
+            }
+        }
+
+        for (const SampleInfo &sample : after.samples)
+        {
+            if (sample.serial > before.serial)
+            {
+                diff.samples.push_back(sample);
+            }
+        }
+    }
+
+    void ObjectTracer::dumpMemoryInfo() const
+    {
+        Snapshot snapshot;
+        takeSnapshot(snapshot);
+
+        printInfo("Dump memory leak =================================>\n");
+
+        std::stringstream ss;
+        size_t totalObjects = 0;
+        size_t totalBytes = 0;
+
+        for (const ClassInfo &info : snapshot.classes)
+        {
+            if (info.liveCount == 0)
+            {
+                continue;
             }
 
             ss.str("");
+            ss << "Leak Class : " << info.cls->getName() 
+                << " Live : " << info.liveCount 
+                << " Peak : " << info.peakCount
+                << " Total : " << info.totalCount
+                << " Bytes : " << info.bytes << "\n";
+            printInfo(ss.str());
 
-            ss << "Total leak objects " << mObjects.size();
+            totalObjects += info.liveCount;
+            totalBytes += info.bytes;
         }
+
+        for (const SampleInfo &sample : snapshot.samples)
+        {
+            printSample(sample);
+        }
+
+        ss.str("");
+        ss << "Total leak objects " << totalObjects << ", " << totalBytes 
+            << " bytes\n";
+        printInfo(ss.str());
     }
 
     void ObjectTracer::dumpMemoryInfo(FileDataStream &fs) const
@@ -68,6 +239,63 @@ namespace Tiny3D
         mStream = nullptr;
     }
 
+    void ObjectTracer::dumpSnapshotDiff(const SnapshotDiff &diff) const
+    {
+        printInfo("Dump snapshot diff ===============================>\n");
+
+        std::stringstream ss;
+
+        for (const ClassDelta &delta : diff.classes)
+        {
+            ss.str("");
+            ss << "Class : " << delta.cls->getName() 
+                << " Live : " << (delta.liveDelta > 0 ? "+" : "") 
+                << delta.liveDelta
+                << " Bytes : " << (delta.bytesDelta > 0 ? "+" : "") 
+                << delta.bytesDelta << "\n";
+            printInfo(ss.str());
+        }
+
+        for (const SampleInfo &sample : diff.samples)
+        {
+            printSample(sample);
+        }
+    }
+
+    void ObjectTracer::printSample(const SampleInfo &sample) const
+    {
+        std::stringstream ss;
+        ss << "Sampled Object : " << sample.cls->getName() 
+            << " #" << sample.serial 
+            << " ReferCount : " << sample.object->referCount() << "\n";
+        printInfo(ss.str());
+
+#if defined (T3D_OS_LINUX) || defined (T3D_OS_OSX)
+        char **symbols = backtrace_symbols(sample.frames, (int)sample.depth);
+#endif
+
+        size_t i = 0;
+        for (i = 0; i < sample.depth; ++i)
+        {
+            ss.str("");
+#if defined (T3D_OS_LINUX) || defined (T3D_OS_OSX)
+            if (symbols != nullptr)
+            {
+                ss << "    " << symbols[i] << "\n";
+            }
+            else
+#endif
+            {
+                ss << "    " << sample.frames[i] << "\n";
+            }
+            printInfo(ss.str());
+        }
+
+#if defined (T3D_OS_LINUX) || defined (T3D_OS_OSX)
+        free(symbols);
+#endif
+    }
+
     void ObjectTracer::printInfo(const String &str) const
     {
         if (mStream != nullptr)
@@ -81,4 +309,3 @@ namespace Tiny3D
         }
     }
 }
-
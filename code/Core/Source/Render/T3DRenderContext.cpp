@@ -49,12 +49,13 @@ namespace Tiny3D
         : mGPUBufferUpdateObject(nullptr)
         , mGPUBufferUpdateFrame(nullptr)
         , mGPUBufferUpdateRarely(nullptr)
-        , mIsWorldMatrixDirty(false)
-        , mIsViewMatrixDirty(false)
-        , mIsProjMatrixDirty(false)
+        , mIsWorldMatrixDirty(true)
+        , mIsViewMatrixDirty(true)
+        , mIsProjMatrixDirty(true)
         , mPrimaryWindow(nullptr)
         , mRenderTarget(nullptr)
         , mViewport(nullptr)
+        , mStateCache(&mStatistics)
     {
 
     }
@@ -81,6 +82,11 @@ namespace Tiny3D
 
     TResult RenderContext::renderAllTargets()
     {
+        mStatistics.beginFrame();
+
+        // 每帧开始时底层状态可能已经被窗口、交换链等外部操作修改过
+        mStateCache.invalidate();
+
         auto itr = mRenderTargets.begin();
 
         while (itr != mRenderTargets.end())
@@ -95,6 +101,8 @@ namespace Tiny3D
             ++itr;
         }
 
+        mStatistics.endFrame();
+
         return T3D_OK;
     }
 
@@ -155,18 +163,37 @@ namespace Tiny3D
             {
             case TransformState::VIEW:
                 {
+                    if (mGPUConstUpdateFrame.mViewMatrix == mat)
+                    {
+                        mStatistics.addAvoidedCall();
+                        break;
+                    }
+
                     mGPUConstUpdateFrame.mViewMatrix = mat;
                     mIsViewMatrixDirty = true;
                 }
                 break;
             case TransformState::WORLD:
                 {
+                    if (mGPUConstUpdateObject.mWorldMatrix == mat)
+                    {
+                        // 相同的世界变换，不需要重新计算和更新常量缓冲区
+                        mStatistics.addAvoidedCall();
+                        break;
+                    }
+
                     mGPUConstUpdateObject.mWorldMatrix = mat;
                     mIsWorldMatrixDirty = true;
                 }
                 break;
             case TransformState::PROJECTION:
                 {
+                    if (mGPUConstUpdateRarely.mProjMatrix == mat)
+                    {
+                        mStatistics.addAvoidedCall();
+                        break;
+                    }
+
                     mGPUConstUpdateRarely.mProjMatrix = mat;
                     mIsProjMatrixDirty = true;
                 }
@@ -205,6 +232,22 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    bool RenderContext::isInstancingSupported() const
+    {
+        return false;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult RenderContext::renderObjectInstanced(VertexArrayObjectPtr vao,
+        HardwareVertexBufferPtr instances, size_t startInstance,
+        size_t instanceCount)
+    {
+        return T3D_ERR_RENDER_NOT_SUPPORTED;
+    }
+
+    //--------------------------------------------------------------------------
+
     TResult RenderContext::postInit()
     {
         TResult ret = T3D_OK;
@@ -22,6 +22,7 @@
 #include "Render/T3DVertexArrayObject.h"
 #include "Render/T3DHardwareVertexBuffer.h"
 #include "Render/T3DHardwareIndexBuffer.h"
+#include "Render/T3DHardwareBufferManager.h"
 #include "Component/T3DRenderable.h"
 #include "Component/T3DCamera.h"
 #include "Kernel/T3DTechnique.h"
@@ -35,263 +36,680 @@ namespace Tiny3D
 {
     //--------------------------------------------------------------------------
 
-    T3D_IMPLEMENT_CLASS_1(RenderGroup, Object);
+    T3D_IMPLEMENT_CLASS_1(RenderQueue, Object);
 
     //--------------------------------------------------------------------------
 
-    RenderGroupPtr RenderGroup::create()
+    const size_t RenderQueue::DEFAULT_CAPACITY = 1024;
+    const size_t RenderQueue::DEFAULT_INSTANCING_THRESHOLD = 4;
+
+    //--------------------------------------------------------------------------
+
+    RenderQueuePtr RenderQueue::create()
     {
-        RenderGroupPtr group = new RenderGroup();
-        group->release();
-        return group;
+        RenderQueuePtr rq = new RenderQueue();
+        rq->release();
+        return rq;
     }
 
     //--------------------------------------------------------------------------
 
-    RenderGroup::RenderGroup()
+    RenderQueue::RenderQueue()
+        : mItemCount(0)
+        , mInvFar(REAL_ZERO)
+        , mInstancingThreshold(DEFAULT_INSTANCING_THRESHOLD)
+        , mInstanceBuffer(nullptr)
     {
+        reserve(DEFAULT_CAPACITY);
 
+        size_t i = 0;
+        for (i = 0; i < E_KEY_MAX_GROUPS; ++i)
+        {
+            mSortPolicies[i] = SortPolicy::STATE;
+        }
+
+        mSortPolicies[E_GRPID_AUTOMATIC] = SortPolicy::FRONT_TO_BACK;
+        mSortPolicies[E_GRPID_SOLID] = SortPolicy::FRONT_TO_BACK;
+        mSortPolicies[E_GRPID_WIREFRAME] = SortPolicy::FRONT_TO_BACK;
+        mSortPolicies[E_GRPID_TRANSPARENT] = SortPolicy::BACK_TO_FRONT;
+        mSortPolicies[E_GRPID_TRANSPARENT_EFFECT] = SortPolicy::BACK_TO_FRONT;
+
+        for (i = 0; i < 4; ++i)
+        {
+            mDepthAxis[i] = REAL_ZERO;
+        }
     }
 
     //--------------------------------------------------------------------------
 
-    RenderGroup::~RenderGroup()
+    RenderQueue::~RenderQueue()
     {
 
     }
 
     //--------------------------------------------------------------------------
 
-    TResult RenderGroup::addRenderable(RenderablePtr renderable)
+    void RenderQueue::reserve(size_t capacity)
     {
-        TResult ret = T3D_OK;
-
-        do 
+        if (capacity > mItems.size())
         {
-            MaterialPtr material = renderable->getMaterial();
-            if (material == nullptr)
-            {
-                break;
-            }
+            mItems.resize(capacity);
+            mScratch.resize(capacity);
+        }
+    }
 
-            auto itr = mRenderables.find(material);
+    //--------------------------------------------------------------------------
 
-            if (itr != mRenderables.end())
-            {
-                // 有相同的材质，放到相同材质渲染对象列表
-                RenderableList &renderables = itr->second;
-                renderables.push_back(renderable);
-            }
-            else
-            {
-                // 没有相同材质，新增一个材质渲染对象列表
-                RenderableList renderables(1, renderable);
-                mRenderables.insert(RenderablesValue(material, renderables));
-            }
-        } while (0);
+    uint64_t RenderQueue::hashPointer(const void *ptr, uint32_t bits)
+    {
+        if (ptr == nullptr)
+        {
+            return 0;
+        }
 
-        return T3D_OK;
+        // 对象地址低位基本都是对齐的 0，混合一下再截断
+        uint64_t h = (uint64_t)(uintptr_t)ptr;
+        h ^= (h >> 33);
+        h *= 0xFF51AFD7ED558CCDULL;
+        h ^= (h >> 33);
+
+        return (h & ((1ULL << bits) - 1));
     }
 
     //--------------------------------------------------------------------------
 
-    void RenderGroup::clear()
+    uint64_t RenderQueue::makeSortKey(uint32_t groupID, SortPolicy policy,
+        size_t pass, const void *program, const void *texture, const void *vao,
+        uint32_t depth)
     {
-        mRenderables.clear();
+        const uint64_t groupMask = (1ULL << E_KEY_GROUP_BITS) - 1;
+        const uint64_t passMask = (1ULL << E_KEY_PASS_BITS) - 1;
+        const uint64_t depthMask = (1ULL << E_KEY_DEPTH_BITS) - 1;
+
+        uint64_t group = (groupID > groupMask ? groupMask : groupID);
+        uint64_t passIdx = (pass > passMask ? passMask : pass);
+        uint64_t z = (uint64_t(depth) & depthMask);
+        uint64_t state 
+            = (hashPointer(program, E_KEY_PROGRAM_BITS) << E_KEY_TEXTURE_BITS)
+            | hashPointer(texture, E_KEY_TEXTURE_BITS);
+
+        uint64_t key = (group << E_KEY_GROUP_SHIFT);
+
+        switch (policy)
+        {
+        case SortPolicy::FRONT_TO_BACK:
+            key |= (passIdx << (E_KEY_DEPTH_BITS + E_KEY_STATE_BITS))
+                | (z << E_KEY_STATE_BITS) | state;
+            break;
+        case SortPolicy::BACK_TO_FRONT:
+            // 同一个物体的多个 Pass 需要连续，深度放在 Pass 前面
+            key |= ((depthMask - z) << (E_KEY_PASS_BITS + E_KEY_STATE_BITS))
+                | (passIdx << E_KEY_STATE_BITS) | state;
+            break;
+        default:
+            // 没有深度的时候用 VAO 填充低位，相同的网格排在一起便于实例化
+            key |= (passIdx << (E_KEY_VAO_BITS + E_KEY_STATE_BITS))
+                | (state << E_KEY_VAO_BITS) | hashPointer(vao, E_KEY_VAO_BITS);
+            break;
+        }
+
+        return key;
     }
 
     //--------------------------------------------------------------------------
 
-    TResult RenderGroup::render(ID groupID, RenderContextPtr renderer)
+    void RenderQueue::setSortPolicy(uint32_t groupID, SortPolicy policy)
     {
-        PolygonMode renderMode;
-
-        ViewportPtr vp = renderer->getViewport();
-        if (vp == nullptr)
+        if (groupID >= E_KEY_MAX_GROUPS)
         {
-            return T3D_OK;
+            groupID = E_KEY_MAX_GROUPS - 1;
         }
 
-        CameraPtr camera = vp->getCamera();
+        mSortPolicies[groupID] = policy;
+    }
 
-//         if (RenderQueue::E_GRPID_INDICATOR == groupID
-//             || RenderQueue::E_GRPID_WIREFRAME == groupID)
-//         {
-//             // 指示器或者线框渲染，渲染模式需要改成线框模式
-//             renderMode = renderer->getPolygonMode();
-//             renderer->setPolygonMode(PolygonMode::WIREFRAME);
-//         }
+    //--------------------------------------------------------------------------
 
-        if (RenderQueue::E_GRPID_LIGHT != groupID)
+    RenderQueue::SortPolicy RenderQueue::getSortPolicy(uint32_t groupID) const
+    {
+        if (groupID >= E_KEY_MAX_GROUPS)
         {
-            // 不是灯光分组
-            RenderablesItr itr = mRenderables.begin();
-
-            while (itr != mRenderables.end())
-            {
-                MaterialPtr material = itr->first;
-                TechniquePtr tech = material->getBestTechnique();
+            groupID = E_KEY_MAX_GROUPS - 1;
+        }
 
-                // 渲染该 Technique 下所有 Pass
-                size_t idx = 0;
-                for (idx = 0; idx < tech->getPassCount(); ++idx)
-                {
-                    PassPtr pass = tech->getPass(idx);
+        return mSortPolicies[groupID];
+    }
 
-                    //renderer->setPolygonMode(pass->getPolygonMode());
+    //--------------------------------------------------------------------------
 
-                    GPUProgramPtr program = pass->getGPUProgram();
-                    renderer->bindGPUProgram(program);
+    void RenderQueue::setCamera(Camera *camera)
+    {
+        // 相机看向 -Z 方向，视图空间 z 取反就是深度，
+        // 只需要视图矩阵的第三行
+        const Matrix4 &m = camera->getViewMatrix();
+        mDepthAxis[0] = -m[2][0];
+        mDepthAxis[1] = -m[2][1];
+        mDepthAxis[2] = -m[2][2];
+        mDepthAxis[3] = -m[2][3];
+
+        Real farDist = camera->getFarPlaneDistance();
+        mInvFar = (farDist > REAL_ZERO ? REAL_ONE / farDist : REAL_ZERO);
+    }
 
-                    TextureUnitPtr unit = pass->getTextureUnit(0);
-                    renderer->bindTexture(unit);
+    //--------------------------------------------------------------------------
 
-                    RenderableList &renderables = itr->second;
+    uint32_t RenderQueue::calcDepth(Renderable *renderable) const
+    {
+        const Transform &xform 
+            = renderable->getSceneNode()->getTransform3D()->getLocalToWorldTransform();
+        const Vector3 &pos = xform.getTranslation();
 
-                    RenderableListItr i = renderables.begin();
+        Real depth = mDepthAxis[0] * pos.x() + mDepthAxis[1] * pos.y()
+            + mDepthAxis[2] * pos.z() + mDepthAxis[3];
+        depth *= mInvFar;
 
-                    while (i != renderables.end())
-                    {
-                        RenderablePtr renderable = *i;
+        if (depth <= REAL_ZERO)
+        {
+            return 0;
+        }
+        else if (depth >= REAL_ONE)
+        {
+            return (1U << E_KEY_DEPTH_BITS) - 1;
+        }
 
-                        // 设置渲染物体的世界变换
-                        const Transform &xform = renderable->getSceneNode()->getTransform3D()->getLocalToWorldTransform();
-                        const Matrix4 &m = xform.getAffineMatrix();
-                        renderer->setWorldTransform(m);
+        return uint32_t(depth * Real((1U << E_KEY_DEPTH_BITS) - 1));
+    }
 
-                        // 根据VAO数据渲染
-                        renderer->renderObject(renderable->getVertexArrayObject());
+    //--------------------------------------------------------------------------
 
-                        ++i;
-                    }
-                }
+    TResult RenderQueue::addRenderable(uint32_t groupID, 
+        Renderable *renderable)
+    {
+        size_t count = mItemCount;
+        appendItems(mItems, count, groupID, renderable);
 
-                ++itr;
-            }
+        if (mItems.size() > mScratch.size())
+        {
+            // 基数排序的临时数组跟着一起扩大
+            mScratch.resize(mItems.size());
         }
 
-//         if (RenderQueue::E_GRPID_INDICATOR == groupID
-//             || RenderQueue::E_GRPID_WIREFRAME == groupID)
-//         {
-//             // 恢复渲染模式
-//             renderer->setPolygonMode(renderMode);
-//         }
+        mItemCount = count;
 
         return T3D_OK;
     }
 
     //--------------------------------------------------------------------------
 
-    size_t RenderGroup::calcPrimitiveCount(VertexArrayObjectPtr vao) const
+    TResult RenderQueue::addRenderable(size_t bucket, uint32_t groupID,
+        Renderable *renderable)
     {
-        RenderContext::PrimitiveType priType = vao->getPrimitiveType();
-        bool useIndex = vao->isIndicesUsed();
-        size_t indexCount 
-            = (useIndex ? vao->getIndexBuffer()->getIndexCount() : 0);
-        size_t vertexCount = vao->getVertexBuffer(0)->getVertexCount();
+        T3D_ASSERT(bucket < mBuckets.size());
+        Bucket &b = mBuckets[bucket];
+        appendItems(b.items, b.count, groupID, renderable);
+        return T3D_OK;
+    }
 
-        size_t primCount = 0;
+    //--------------------------------------------------------------------------
 
-        switch (priType)
+    void RenderQueue::appendItems(RenderItems &items, size_t &count,
+        uint32_t groupID, Renderable *renderable) const
+    {
+        do 
         {
-        case RenderContext::PrimitiveType::E_PT_POINT_LIST:
-            primCount = (useIndex ? indexCount : vertexCount);
-            break;
+            if (E_GRPID_LIGHT == groupID)
+            {
+                // 灯光分组不直接渲染
+                break;
+            }
 
-        case RenderContext::PrimitiveType::E_PT_LINE_LIST:
-            primCount = (useIndex ? indexCount : vertexCount) / 2;
-            break;
+            MaterialPtr material = renderable->getMaterial();
+            if (material == nullptr)
+            {
+                break;
+            }
 
-        case RenderContext::PrimitiveType::E_PT_LINE_STRIP:
-            primCount = (useIndex ? indexCount : vertexCount) - 1;
-            break;
+            Technique *tech = material->getBestTechnique();
+            const Technique::Passes &passes = tech->getPasses();
 
-        case RenderContext::PrimitiveType::E_PT_TRIANGLE_LIST:
-            primCount = (useIndex ? indexCount : vertexCount) / 3;
-            break;
+            VertexArrayObject *vao = renderable->getVertexArrayObject();
+            if (vao == nullptr)
+            {
+                break;
+            }
 
-        case RenderContext::PrimitiveType::E_PT_TRIANGLE_STRIP:
-            primCount = (useIndex ? indexCount : vertexCount) - 2;
-            break;
+            SortPolicy policy = getSortPolicy(groupID);
+            uint32_t depth = 0;
 
-        case RenderContext::PrimitiveType::E_PT_TRIANGLE_FAN:
-            primCount = (useIndex ? indexCount : vertexCount) - 2;
-            break;
-        }
+            if (policy != SortPolicy::STATE)
+            {
+                depth = calcDepth(renderable);
+            }
 
-        return primCount;
+            // 每个 Pass 一个渲染项
+            size_t i = 0;
+            for (i = 0; i < passes.size(); ++i)
+            {
+                if (count == items.size())
+                {
+                    items.resize(items.empty() ? DEFAULT_CAPACITY 
+                        : items.size() * 2);
+                }
+
+                Pass *pass = passes[i];
+                TextureUnit *unit = pass->getTextureUnit(0);
+                Texture *texture = (unit != nullptr ? unit->getTexture() 
+                    : nullptr);
+                GPUProgram *program = pass->getGPUProgram();
+
+                RenderItem &item = items[count++];
+                item.key = makeSortKey(groupID, policy, i, program, texture,
+                    vao, depth);
+                item.renderable = renderable;
+                item.pass = pass;
+                item.vao = vao;
+                item.groupID = groupID;
+            }
+        } while (0);
     }
 
     //--------------------------------------------------------------------------
 
-    T3D_IMPLEMENT_CLASS_1(RenderQueue, Object);
+    void RenderQueue::setBucketCount(size_t count)
+    {
+        mBuckets.resize(count);
+
+        for (Bucket &bucket : mBuckets)
+        {
+            bucket.count = 0;
+        }
+    }
 
     //--------------------------------------------------------------------------
 
-    RenderQueuePtr RenderQueue::create()
+    void RenderQueue::mergeBuckets()
     {
-        RenderQueuePtr rq = new RenderQueue();
-        rq->release();
-        return rq;
+        for (Bucket &bucket : mBuckets)
+        {
+            if (bucket.count == 0)
+            {
+                continue;
+            }
+
+            if (mItemCount + bucket.count > mItems.size())
+            {
+                size_t capacity = mItems.size() * 2;
+                reserve(std::max(capacity, mItemCount + bucket.count));
+            }
+
+            std::copy(bucket.items.begin(), 
+                bucket.items.begin() + bucket.count,
+                mItems.begin() + mItemCount);
+            mItemCount += bucket.count;
+            bucket.count = 0;
+        }
     }
 
     //--------------------------------------------------------------------------
 
-    RenderQueue::RenderQueue()
+    void RenderQueue::setInstancingThreshold(size_t threshold)
     {
+        mInstancingThreshold = threshold;
+    }
+
+    //--------------------------------------------------------------------------
 
+    size_t RenderQueue::getInstancingThreshold() const
+    {
+        return mInstancingThreshold;
     }
 
     //--------------------------------------------------------------------------
 
-    RenderQueue::~RenderQueue()
+    void RenderQueue::clear()
     {
+        mItemCount = 0;
+        mInstanceRuns.clear();
 
+        for (Bucket &bucket : mBuckets)
+        {
+            bucket.count = 0;
+        }
     }
 
     //--------------------------------------------------------------------------
 
-    TResult RenderQueue::addRenderable(uint32_t groupID, 
-        RenderablePtr renderable)
+    void RenderQueue::sort()
     {
-        RenderableGroupItr itr = mGroups.find(groupID);
+        if (mItemCount < 2)
+        {
+            return;
+        }
+
+        // 一次遍历统计排序键每个字节的直方图
+        const size_t RADIX_PASSES = sizeof(uint64_t);
+        uint32_t histograms[RADIX_PASSES][256];
+        memset(histograms, 0, sizeof(histograms));
+
+        size_t i = 0, b = 0;
 
-        if (itr != mGroups.end())
+        for (i = 0; i < mItemCount; ++i)
         {
-            /// 已经有这组渲染对象
-            RenderGroupPtr &group = itr->second;
-            group->addRenderable(renderable);
+            uint64_t key = mItems[i].key;
+
+            for (b = 0; b < RADIX_PASSES; ++b)
+            {
+                histograms[b][(key >> (b << 3)) & 0xFF]++;
+            }
         }
-        else
+
+        // 低位到高位，每个字节做一次稳定的计数排序
+        for (b = 0; b < RADIX_PASSES; ++b)
         {
-            /// 不存在这组渲染对象
-            RenderGroupPtr group = RenderGroup::create();
-            group->addRenderable(renderable);
-            mGroups.insert(RenderableGroupValue(groupID, group));
+            uint32_t *histogram = histograms[b];
+            size_t shift = (b << 3);
+
+            uint32_t digit = (mItems[0].key >> shift) & 0xFF;
+            if (histogram[digit] == mItemCount)
+            {
+                // 所有渲染项这个字节都一样，不需要排
+                continue;
+            }
+
+            uint32_t offset = 0;
+            for (i = 0; i < 256; ++i)
+            {
+                uint32_t count = histogram[i];
+                histogram[i] = offset;
+                offset += count;
+            }
+
+            for (i = 0; i < mItemCount; ++i)
+            {
+                const RenderItem &item = mItems[i];
+                digit = (item.key >> shift) & 0xFF;
+                mScratch[histogram[digit]++] = item;
+            }
+
+            // 只交换数组内部的缓冲区，不拷贝
+            mItems.swap(mScratch);
         }
+    }
 
-        return T3D_OK;
+    //--------------------------------------------------------------------------
+
+    TResult RenderQueue::buildInstanceRuns()
+    {
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            mInstanceRuns.clear();
+
+            // 找出连续的、Pass 和 VAO 都一样的渲染项
+            size_t instanceCount = 0;
+            size_t i = 0;
+
+            while (i < mItemCount)
+            {
+                const RenderItem &item = mItems[i];
+                size_t count = 1;
+
+                while (i + count < mItemCount)
+                {
+                    const RenderItem &next = mItems[i + count];
+                    if (next.pass != item.pass || next.vao != item.vao
+                        || next.groupID != item.groupID)
+                    {
+                        break;
+                    }
+
+                    count++;
+                }
+
+                if (count >= mInstancingThreshold)
+                {
+                    InstanceRun run;
+                    run.first = i;
+                    run.count = count;
+                    run.startInstance = instanceCount;
+                    mInstanceRuns.push_back(run);
+                    instanceCount += count;
+                }
+
+                i += count;
+            }
+
+            if (instanceCount == 0)
+            {
+                break;
+            }
+
+            // 打包世界变换，整帧只写一次实例缓冲区
+            if (mInstanceData.size() < instanceCount)
+            {
+                mInstanceData.resize(instanceCount);
+            }
+
+            for (const InstanceRun &run : mInstanceRuns)
+            {
+                for (i = 0; i < run.count; ++i)
+                {
+                    Renderable *renderable = mItems[run.first + i].renderable;
+                    const Transform &xform = renderable->getSceneNode()
+                        ->getTransform3D()->getLocalToWorldTransform();
+                    mInstanceData[run.startInstance + i] 
+                        = xform.getAffineMatrix();
+                }
+            }
+
+            if (mInstanceBuffer == nullptr 
+                || mInstanceBuffer->getVertexCount() < instanceCount)
+            {
+                // 容量不够的时候按照两倍增长，避免每帧重新创建
+                size_t capacity = (mInstanceBuffer == nullptr 
+                    ? DEFAULT_CAPACITY : mInstanceBuffer->getVertexCount());
+                while (capacity < instanceCount)
+                {
+                    capacity *= 2;
+                }
+
+                mInstanceBuffer = T3D_HARDWARE_BUFFER_MGR.createVertexBuffer(
+                    sizeof(Matrix4), capacity, nullptr,
+                    HardwareBuffer::Usage::DYNAMIC,
+                    HardwareBuffer::AccessMode::CPU_WRITE);
+                if (mInstanceBuffer == nullptr)
+                {
+                    ret = T3D_ERR_INVALID_POINTER;
+                    T3D_LOG_ERROR(LOG_TAG_RENDER, 
+                        "Create instance buffer failed !");
+                    break;
+                }
+            }
+
+            size_t bytes = instanceCount * sizeof(Matrix4);
+            size_t written = mInstanceBuffer->writeData(0, bytes, 
+                &mInstanceData[0], true);
+            if (written != bytes)
+            {
+                ret = T3D_ERR_HW_BUFFER_WRITE;
+                T3D_LOG_ERROR(LOG_TAG_RENDER, 
+                    "Write instance buffer failed !");
+                break;
+            }
+        } while (0);
+
+        if (T3D_FAILED(ret))
+        {
+            mInstanceRuns.clear();
+        }
+
+        return ret;
     }
 
     //--------------------------------------------------------------------------
 
-    void RenderQueue::clear()
+    void RenderQueue::renderItems(RenderContext *renderer, 
+        RenderStatistics &stats, size_t first, size_t count)
+    {
+        size_t i = 0;
+        for (i = first; i < first + count; ++i)
+        {
+            const RenderItem &item = mItems[i];
+
+            // 设置渲染物体的世界变换
+            Renderable *renderable = item.renderable;
+            const Transform &xform = renderable->getSceneNode()
+                ->getTransform3D()->getLocalToWorldTransform();
+            const Matrix4 &m = xform.getAffineMatrix();
+            renderer->setWorldTransform(m);
+
+            // 根据VAO数据渲染
+            if (renderer->renderObject(item.vao) == T3D_OK)
+            {
+                stats.addDrawCall(calcPrimitiveCount(item.vao));
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult RenderQueue::render(RenderContext *renderer)
     {
-        mGroups.clear();
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            ViewportPtr vp = renderer->getViewport();
+            if (vp == nullptr || mItemCount == 0)
+            {
+                break;
+            }
+
+            sort();
+
+            mInstanceRuns.clear();
+
+            if (mInstancingThreshold > 0 && renderer->isInstancingSupported())
+            {
+                // 失败的时候没有实例化区间，全部逐个渲染
+                buildInstanceRuns();
+            }
+
+            RenderStatistics &stats = renderer->getStatistics();
+
+            uint32_t groupID = 0;
+            GPUProgram *program = nullptr;
+            TextureUnit *unit = nullptr;
+
+            size_t runIdx = 0;
+            size_t i = 0;
+
+            while (i < mItemCount)
+            {
+                const RenderItem &item = mItems[i];
+
+                if (i == 0 || item.groupID != groupID)
+                {
+                    // 进入新的渲染分组
+                    if (i > 0)
+                    {
+                        stats.endGroup();
+                    }
+
+                    groupID = item.groupID;
+                    stats.beginGroup(groupID);
+                }
+
+                // 同一个 GPU 程序和纹理相邻，只在变化的时候绑定
+                GPUProgram *itemProgram = item.pass->getGPUProgram();
+                if (i == 0 || itemProgram != program)
+                {
+                    renderer->bindGPUProgram(itemProgram);
+                    program = itemProgram;
+                }
+
+                TextureUnit *itemUnit = item.pass->getTextureUnit(0);
+                if (i == 0 || itemUnit != unit)
+                {
+                    renderer->bindTexture(itemUnit);
+                    unit = itemUnit;
+                }
+
+                if (runIdx < mInstanceRuns.size() 
+                    && mInstanceRuns[runIdx].first == i)
+                {
+                    // 区间内 Pass 相同，GPU 程序和纹理不需要再绑定
+                    const InstanceRun &run = mInstanceRuns[runIdx++];
+
+                    if (renderer->renderObjectInstanced(item.vao, 
+                        mInstanceBuffer, run.startInstance, run.count) 
+                        == T3D_OK)
+                    {
+                        stats.addDrawCall(
+                            calcPrimitiveCount(item.vao) * run.count);
+                    }
+                    else
+                    {
+                        // 渲染器实例化失败，退回逐个渲染
+                        renderItems(renderer, stats, run.first, run.count);
+                    }
+
+                    i += run.count;
+                }
+                else
+                {
+                    renderItems(renderer, stats, i, 1);
+                    i++;
+                }
+            }
+
+            stats.endGroup();
+        } while (0);
+
+        return ret;
     }
 
     //--------------------------------------------------------------------------
 
-    TResult RenderQueue::render(RenderContextPtr renderer)
+    size_t RenderQueue::calcPrimitiveCount(VertexArrayObject *vao)
     {
-        RenderableGroupItr itr = mGroups.begin();
+        RenderContext::PrimitiveType priType = vao->getPrimitiveType();
+        bool useIndex = vao->isIndicesUsed();
+        size_t indexCount 
+            = (useIndex ? vao->getDrawIndexCount() : 0);
+        size_t vertexCount = vao->getVertexBuffer(0)->getVertexCount();
+        size_t count = (useIndex ? indexCount : vertexCount);
 
-        while (itr != mGroups.end())
+        size_t primCount = 0;
+
+        switch (priType)
         {
-            itr->second->render(itr->first, renderer);
-            ++itr;
+        case RenderContext::PrimitiveType::E_PT_POINT_LIST:
+            primCount = count;
+            break;
+
+        case RenderContext::PrimitiveType::E_PT_LINE_LIST:
+            primCount = count / 2;
+            break;
+
+        case RenderContext::PrimitiveType::E_PT_LINE_STRIP:
+            primCount = (count > 1 ? count - 1 : 0);
+            break;
+
+        case RenderContext::PrimitiveType::E_PT_TRIANGLE_LIST:
+            primCount = count / 3;
+            break;
+
+        case RenderContext::PrimitiveType::E_PT_TRIANGLE_STRIP:
+        case RenderContext::PrimitiveType::E_PT_TRIANGLE_FAN:
+            primCount = (count > 2 ? count - 2 : 0);
+            break;
+
+        default:
+            break;
         }
 
-        return T3D_OK;
+        return primCount;
     }
 }
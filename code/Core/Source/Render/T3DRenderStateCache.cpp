@@ -0,0 +1,152 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#include "Render/T3DRenderStateCache.h"
+#include "Render/T3DRenderStatistics.h"
+#include "Render/T3DRenderState.h"
+#include "Render/T3DHardwareConstantBuffer.h"
+#include "Resource/T3DGPUProgram.h"
+#include "Resource/T3DTexture.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    RenderStateCache::RenderStateCache(RenderStatistics *statistics)
+        : mStatistics(statistics)
+    {
+        invalidate();
+    }
+
+    //--------------------------------------------------------------------------
+
+    RenderStateCache::~RenderStateCache()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    void RenderStateCache::invalidate()
+    {
+        size_t i = 0;
+
+        mProgram = nullptr;
+        mIsProgramValid = false;
+
+        for (i = 0; i < MAX_TEXTURE_SLOTS; ++i)
+        {
+            mTextures[i] = nullptr;
+            mIsTextureValid[i] = false;
+        }
+
+        mBlendState = nullptr;
+        mIsBlendValid = false;
+        mDepthState = nullptr;
+        mIsDepthValid = false;
+        mRasterState = nullptr;
+        mIsRasterValid = false;
+
+        for (i = 0; i < MAX_CONSTANT_SLOTS; ++i)
+        {
+            mConstBuffers[i] = nullptr;
+            mIsConstBufferValid[i] = false;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    template <typename T>
+    bool RenderStateCache::update(SmartPtr<T> &cached, T *value, bool &valid,
+        bool force)
+    {
+        if (valid && !force && cached == value)
+        {
+            if (mStatistics != nullptr)
+            {
+                mStatistics->addAvoidedCall();
+            }
+
+            return false;
+        }
+
+        // 只在状态变化时修改引用计数
+        cached = value;
+        valid = true;
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool RenderStateCache::setGPUProgram(GPUProgram *program)
+    {
+        return update(mProgram, program, mIsProgramValid);
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool RenderStateCache::setTexture(size_t slot, Texture *texture)
+    {
+        if (slot >= MAX_TEXTURE_SLOTS)
+        {
+            return true;
+        }
+
+        return update(mTextures[slot], texture, mIsTextureValid[slot]);
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool RenderStateCache::setBlendState(BlendState *state)
+    {
+        return update(mBlendState, state, mIsBlendValid,
+            state != nullptr && state->isDirty());
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool RenderStateCache::setDepthStencilState(DepthStencilState *state)
+    {
+        return update(mDepthState, state, mIsDepthValid,
+            state != nullptr && state->isDirty());
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool RenderStateCache::setRasterizerState(RasterizerState *state)
+    {
+        return update(mRasterState, state, mIsRasterValid,
+            state != nullptr && state->isDirty());
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool RenderStateCache::setConstantBuffer(size_t slot, 
+        HardwareConstantBuffer *buffer)
+    {
+        if (slot >= MAX_CONSTANT_SLOTS)
+        {
+            return true;
+        }
+
+        return update(mConstBuffers[slot], buffer, mIsConstBufferValid[slot]);
+    }
+}
@@ -0,0 +1,214 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#include "Render/T3DRenderStatistics.h"
+#include <chrono>
+#include <algorithm>
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    const size_t RenderStatistics::DEFAULT_HISTORY_SIZE = 300;
+
+    //--------------------------------------------------------------------------
+
+    RenderStatistics::RenderStatistics(
+        size_t historySize /* = DEFAULT_HISTORY_SIZE */)
+        : mCurrentGroup(nullptr)
+        , mFrameStart(0.0)
+        , mGroupStart(0.0)
+        , mHistoryHead(0)
+        , mHistoryCount(0)
+    {
+        setHistorySize(historySize);
+    }
+
+    //--------------------------------------------------------------------------
+
+    RenderStatistics::~RenderStatistics()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    float64_t RenderStatistics::now()
+    {
+        typedef std::chrono::steady_clock Clock;
+        typedef std::chrono::duration<float64_t, std::milli> Milliseconds;
+        return std::chrono::duration_cast<Milliseconds>(
+            Clock::now().time_since_epoch()).count();
+    }
+
+    //--------------------------------------------------------------------------
+
+    void RenderStatistics::beginFrame()
+    {
+        float64_t current = now();
+
+        uint64_t frameIndex = mFrame.frameIndex;
+        // 第一帧没有上一帧，不计算帧间隔
+        float64_t frameTime = (mFrameStart > 0.0 ? current - mFrameStart : 0.0);
+
+        mFrame = FrameStats();
+        mFrame.frameIndex = frameIndex + 1;
+        mFrame.frameTime = frameTime;
+        mFrameStart = current;
+
+        // 只清零不删除，分组稳定之后每帧不再分配内存
+        GroupStatsMapItr itr = mGroups.begin();
+        while (itr != mGroups.end())
+        {
+            itr->second = GroupStats();
+            ++itr;
+        }
+
+        mCurrentGroup = nullptr;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void RenderStatistics::endFrame()
+    {
+        if (mCurrentGroup != nullptr)
+        {
+            endGroup();
+        }
+
+        mFrame.renderTime = now() - mFrameStart;
+
+        if (mFrame.frameTime > 0.0 && !mHistory.empty())
+        {
+            mHistory[mHistoryHead] = mFrame.frameTime;
+            mHistoryHead = (mHistoryHead + 1) % mHistory.size();
+
+            if (mHistoryCount < mHistory.size())
+            {
+                mHistoryCount++;
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void RenderStatistics::beginGroup(uint32_t groupID)
+    {
+        GroupStatsMapItr itr = mGroups.find(groupID);
+
+        if (itr == mGroups.end())
+        {
+            itr = mGroups.insert(GroupStatsMapValue(groupID, GroupStats())).first;
+        }
+
+        mCurrentGroup = &itr->second;
+        mGroupStart = now();
+    }
+
+    //--------------------------------------------------------------------------
+
+    void RenderStatistics::endGroup()
+    {
+        if (mCurrentGroup != nullptr)
+        {
+            mCurrentGroup->time += now() - mGroupStart;
+            mCurrentGroup = nullptr;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    const RenderStatistics::GroupStats *RenderStatistics::getGroupStats(
+        uint32_t groupID) const
+    {
+        GroupStatsMapConstItr itr = mGroups.find(groupID);
+
+        if (itr == mGroups.end() || itr->second.drawCalls == 0)
+        {
+            return nullptr;
+        }
+
+        return &itr->second;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void RenderStatistics::setHistorySize(size_t historySize)
+    {
+        mHistory.assign(historySize, 0.0);
+        mSorted.reserve(historySize);
+        mHistoryHead = 0;
+        mHistoryCount = 0;
+    }
+
+    //--------------------------------------------------------------------------
+
+    float64_t RenderStatistics::getAverageFrameTime() const
+    {
+        if (mHistoryCount == 0)
+        {
+            return 0.0;
+        }
+
+        float64_t total = 0.0;
+        size_t i = 0;
+
+        for (i = 0; i < mHistoryCount; ++i)
+        {
+            total += mHistory[i];
+        }
+
+        return total / float64_t(mHistoryCount);
+    }
+
+    //--------------------------------------------------------------------------
+
+    float64_t RenderStatistics::getFrameTimePercentile(Real percentile) const
+    {
+        if (mHistoryCount == 0)
+        {
+            return 0.0;
+        }
+
+        // 环形缓冲区没写满之前，有效数据都在前 mHistoryCount 个
+        mSorted.assign(mHistory.begin(), mHistory.begin() + mHistoryCount);
+
+        float64_t p = std::min(std::max(float64_t(percentile), 0.0), 100.0);
+        size_t rank = size_t(p / 100.0 * float64_t(mHistoryCount - 1) + 0.5);
+
+        std::nth_element(mSorted.begin(), mSorted.begin() + rank,
+            mSorted.end());
+
+        return mSorted[rank];
+    }
+
+    //--------------------------------------------------------------------------
+
+    void RenderStatistics::reset()
+    {
+        mFrame = FrameStats();
+        mGroups.clear();
+        mCurrentGroup = nullptr;
+        mFrameStart = 0.0;
+        mGroupStart = 0.0;
+        setHistorySize(mHistory.size());
+    }
+}
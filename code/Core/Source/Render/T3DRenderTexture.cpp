@@ -0,0 +1,155 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#include "Render/T3DRenderTexture.h"
+#include "ImageCodec/T3DImage.h"
+#include "ImageCodec/T3DImageCodec.h"
+#include "Kernel/T3DCommon.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    T3D_IMPLEMENT_CLASS_1(RenderTexture, RenderTarget);
+
+    //--------------------------------------------------------------------------
+
+    RenderTexturePtr RenderTexture::create(const String &name, size_t width,
+        size_t height)
+    {
+        RenderTexturePtr texture = new RenderTexture(name);
+        texture->release();
+
+        if (texture->init(width, height) != T3D_OK)
+        {
+            texture = nullptr;
+        }
+
+        return texture;
+    }
+
+    //--------------------------------------------------------------------------
+
+    RenderTexture::RenderTexture(const String &name)
+        : RenderTarget(name)
+        , mFramebuffer(nullptr)
+        , mFramebufferSize(0)
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    RenderTexture::~RenderTexture()
+    {
+        T3D_SAFE_DELETE_ARRAY(mFramebuffer);
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult RenderTexture::init(size_t width, size_t height)
+    {
+        TResult ret = T3D_OK;
+
+        do
+        {
+            if (width == 0 || height == 0)
+            {
+                ret = T3D_ERR_INVALID_PARAM;
+                T3D_LOG_ERROR(LOG_TAG_RENDER, "Invalid render texture size \
+                    [%u x %u] !", (uint32_t)width, (uint32_t)height);
+                break;
+            }
+
+            mWidth = width;
+            mHeight = height;
+            mColorDepth = 32;
+            mPitch = Image::calcPitch(mWidth, mColorDepth);
+
+            mFramebufferSize = mPitch * mHeight;
+            mFramebuffer = new uint8_t[mFramebufferSize];
+            memset(mFramebuffer, 0, mFramebufferSize);
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    RenderTarget::Type RenderTexture::getType() const
+    {
+        return E_RT_TEXTURE;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void RenderTexture::clear(const ColorRGB &clrFill, uint32_t clearFlags,
+        Real depth, uint32_t stencil)
+    {
+        // 帧缓冲内存布局为 B、G、R、A
+        Color4 clr(clrFill);
+        uint32_t value = clr.A8R8G8B8();
+
+        size_t x = 0, y = 0;
+
+        for (y = 0; y < mHeight; ++y)
+        {
+            uint32_t *row = (uint32_t *)(mFramebuffer + mPitch * y);
+
+            for (x = 0; x < mWidth; ++x)
+            {
+                row[x] = value;
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult RenderTexture::saveToFile(const String &path,
+        ImageCodecBase::FileType type /* = ImageCodecBase::FileType::PNG */)
+    {
+        TResult ret = T3D_OK;
+
+        do
+        {
+            // 直接引用帧缓冲，不拷贝
+            Image image;
+            ret = image.load(mFramebuffer, mWidth, mHeight, mColorDepth,
+                mPitch, PixelFormat::E_PF_A8R8G8B8);
+            if (T3D_FAILED(ret))
+            {
+                T3D_LOG_ERROR(LOG_TAG_RENDER, "Load image from render \
+                    texture [%s] failed !", mName.c_str());
+                break;
+            }
+
+            ret = T3D_IMAGE_CODEC.encode(path, image, type);
+            if (T3D_FAILED(ret))
+            {
+                T3D_LOG_ERROR(LOG_TAG_RENDER, "Encode render texture [%s] \
+                    to file [%s] failed !", mName.c_str(), path.c_str());
+                break;
+            }
+        } while (0);
+
+        return ret;
+    }
+}
@@ -34,6 +34,7 @@ namespace Tiny3D
     VertexArrayObject::VertexArrayObject()
         : mPrimitiveCount(0)
         , mIsDirty(false)
+        , mDrawIndexCount(0)
     {
 
     }
@@ -60,6 +61,27 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    void VertexArrayObject::setDrawIndexCount(size_t count)
+    {
+        mDrawIndexCount = count;
+        mIsDirty = true;
+    }
+
+    //--------------------------------------------------------------------------
+
+    size_t VertexArrayObject::getDrawIndexCount() const
+    {
+        if (mDrawIndexCount != 0)
+        {
+            return mDrawIndexCount;
+        }
+
+        HardwareIndexBufferPtr ibo = getIndexBuffer();
+        return (ibo != nullptr ? ibo->getIndexCount() : 0);
+    }
+
+    //--------------------------------------------------------------------------
+
     size_t VertexArrayObject::calcPrimitiveCount() const
     {
         size_t primCount = 0;
@@ -75,32 +97,32 @@ namespace Tiny3D
         {
         case RenderContext::PrimitiveType::E_PT_POINT_LIST:
             primCount = (isIndicesUsed() 
-                ? ibo->getIndexCount() : vbo->getVertexCount());
+                ? getDrawIndexCount() : vbo->getVertexCount());
             break;
 
         case RenderContext::PrimitiveType::E_PT_LINE_LIST:
             primCount = (isIndicesUsed() 
-                ? ibo->getIndexCount() : vbo->getVertexCount()) / 2;
+                ? getDrawIndexCount() : vbo->getVertexCount()) / 2;
             break;
 
         case RenderContext::PrimitiveType::E_PT_LINE_STRIP:
             primCount = (isIndicesUsed() 
-                ? ibo->getIndexCount() : vbo->getVertexCount()) - 1;
+                ? getDrawIndexCount() : vbo->getVertexCount()) - 1;
             break;
 
         case RenderContext::PrimitiveType::E_PT_TRIANGLE_LIST:
             primCount = (isIndicesUsed() 
-                ? ibo->getIndexCount() : vbo->getVertexCount()) / 3;
+                ? getDrawIndexCount() : vbo->getVertexCount()) / 3;
             break;
 
         case RenderContext::PrimitiveType::E_PT_TRIANGLE_STRIP:
             primCount = (isIndicesUsed() 
-                ? ibo->getIndexCount() : vbo->getVertexCount()) - 2;
+                ? getDrawIndexCount() : vbo->getVertexCount()) - 2;
             break;
 
         case RenderContext::PrimitiveType::E_PT_TRIANGLE_FAN:
             primCount = (isIndicesUsed() 
-                ? ibo->getIndexCount() : vbo->getVertexCount()) - 2;
+                ? getDrawIndexCount() : vbo->getVertexCount()) - 2;
             break;
         }
 
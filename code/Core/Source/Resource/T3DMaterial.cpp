@@ -24,7 +24,7 @@
 #include "Resource/T3DGPUProgram.h"
 #include "Resource/T3DGPUProgramManager.h"
 #include "Resource/T3DGPUConstBuffer.h"
-#include "REsource/T3DGPUConstBufferManager.h"
+#include "Resource/T3DGPUConstBufferManager.h"
 #include "Kernel/T3DAgent.h"
 #include "Kernel/T3DTechnique.h"
 #include "T3DErrorDef.h"
@@ -125,6 +125,9 @@ namespace Tiny3D
                         break;
                     }
                 }
+
+                // 資源大小按材質文件大小估算
+                mSize = (size_t)stream.size();
             }
             else if (E_MT_MANUAL == mMaterialType)
             {
@@ -201,13 +204,14 @@ namespace Tiny3D
     TResult Material::removeTechnique(const String &name)
     {
         TResult ret = T3D_ERR_NOT_FOUND;
+        NameID nameID = StringInterner::intern(name);
 
         auto itr = mTechniques.begin();
 
         while (itr != mTechniques.end())
         {
             TechniquePtr &tech = *itr;
-            if (name == tech->getName())
+            if (nameID == tech->getNameID())
             {
                 mTechniques.erase(itr);
                 ret = T3D_OK;
@@ -250,12 +254,13 @@ namespace Tiny3D
     TechniquePtr Material::getTechnique(const String &name) const
     {
         TechniquePtr tech;
+        NameID nameID = StringInterner::intern(name);
         auto itr = mTechniques.begin();
 
         while (itr != mTechniques.end())
         {
             const TechniquePtr &t = *itr;
-            if (name == tech->getName())
+            if (nameID == t->getNameID())
             {
                 tech = t;
                 break;
@@ -313,7 +318,8 @@ namespace Tiny3D
                 break;
             }
 
-            mGPUPrograms.insert(GPUProgramsValue(name, program));
+            mGPUPrograms.insert(
+                GPUProgramsValue(StringInterner::intern(name), program));
         } while (0);
 
         return ret;
@@ -324,7 +330,7 @@ namespace Tiny3D
     TResult Material::removeGPUProgram(const String &name)
     {
         TResult ret = T3D_OK;
-        mGPUPrograms.erase(name);
+        mGPUPrograms.erase(StringInterner::intern(name));
         return ret;
     }
 
@@ -332,7 +338,7 @@ namespace Tiny3D
 
     GPUProgramPtr Material::getGPUProgram(const String &name) const
     {
-        return mGPUPrograms.at(name);
+        return mGPUPrograms.at(StringInterner::intern(name));
     }
 
     //--------------------------------------------------------------------------
@@ -353,7 +359,8 @@ namespace Tiny3D
                 break;
             }
 
-            mConstBuffers.insert(GPUConstBuffersValue(name, buffer));
+            mConstBuffers.insert(
+                GPUConstBuffersValue(StringInterner::intern(name), buffer));
         } while (0);
 
         return ret;
@@ -364,7 +371,7 @@ namespace Tiny3D
     TResult Material::removeGPUConstBuffer(const String &name)
     {
         TResult ret = T3D_OK;
-        mConstBuffers.erase(name);
+        mConstBuffers.erase(StringInterner::intern(name));
         return ret;
     }
 
@@ -372,7 +379,7 @@ namespace Tiny3D
 
     GPUConstBufferPtr Material::getGPUConstBuffer(const String &name) const
     {
-        return mConstBuffers.at(name);
+        return mConstBuffers.at(StringInterner::intern(name));
     }
 
     //--------------------------------------------------------------------------
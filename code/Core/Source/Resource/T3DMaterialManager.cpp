@@ -41,7 +41,7 @@ namespace Tiny3D
 
     MaterialManager::MaterialManager()
     {
-
+        setMemoryBudget(DEFAULT_MEMORY_BUDGET);
     }
 
     //--------------------------------------------------------------------------
@@ -76,8 +76,9 @@ namespace Tiny3D
 
         if (argc == 1)
         {
+            // 枚举经过 ... 传递时会被提升为 int
             Material::MaterialType matType 
-                = va_arg(args, Material::MaterialType);
+                = (Material::MaterialType)va_arg(args, int);
             material = Material::create(name, matType);
         }
 
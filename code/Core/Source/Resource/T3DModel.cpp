@@ -117,6 +117,9 @@ namespace Tiny3D
             {
                 break;
             }
+
+            // 資源大小按模型文件大小估算
+            mSize = (size_t)stream.size();
         } while (false);
 
         return T3D_OK;
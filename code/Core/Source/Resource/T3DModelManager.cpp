@@ -42,7 +42,7 @@ namespace Tiny3D
 
     ModelManager::ModelManager()
     {
-
+        setMemoryBudget(DEFAULT_MEMORY_BUDGET);
     }
 
     //--------------------------------------------------------------------------
@@ -31,6 +31,7 @@ namespace Tiny3D
 
     Resource::Resource(const String &strName)
         : mResReferCount(1)
+        , mIsUnused(false)
         , mID(T3D_INVALID_ID)
         , mCloneID(T3D_INVALID_ID)
         , mSize(0)
@@ -20,7 +20,6 @@
 
 #include "Resource/T3DResourceManager.h"
 #include "T3DErrorDef.h"
-#include <sstream>
 
 
 namespace Tiny3D
@@ -33,6 +32,8 @@ namespace Tiny3D
 
     ResourceManager::ResourceManager()
         : mCloneID(T3D_INVALID_ID)
+        , mMemoryBudget(0)
+        , mMemoryUsage(0)
     {
 
     }
@@ -46,34 +47,26 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
-    ID ResourceManager::toID(const String &name) const
+    NameID ResourceManager::toID(const String &name) const
     {
-        return hash(name.c_str());
+        return StringInterner::intern(name);
     }
 
     //--------------------------------------------------------------------------
 
-    uint32_t ResourceManager::hash(const char *str) const
+    NameID ResourceManager::toCloneID(const String &name)
     {
-        uint32_t value = 5381;
+        NameID nameID = toID(name);
+        NameID cloneID = T3D_INVALID_ID;
 
-        while (*str)
+        // 克隆ID由名稱ID和克隆序號混合得到，碰到已佔用的ID就換下一個序號
+        do 
         {
-            value += (value << 5) + (*str++);
-        }
-
-        return (value & 0x7FFFFFFF);
-    }
-
-    //--------------------------------------------------------------------------
+            cloneID = StringInterner::combine(nameID, ++mCloneID);
+        } while (cloneID == T3D_INVALID_ID 
+            || mResourcesCache.find(cloneID) != mResourcesCache.end());
 
-    ID ResourceManager::toCloneID(const String &name, ID cloneID) const
-    {
-        std::stringstream ss;
-        ss.width(4);
-        ss.fill('0');
-        ss << name << "_clone#" << cloneID;
-        return hash(ss.str().c_str());
+        return cloneID;
     }
 
     //--------------------------------------------------------------------------
@@ -82,7 +75,7 @@ namespace Tiny3D
     {
         ResourcePtr res = nullptr;
 
-        ID resID = toID(name);
+        NameID resID = toID(name);
 
         do 
         {
@@ -93,6 +86,13 @@ namespace Tiny3D
                 // cache 中存在，直接返回cache中的，並且把引用計數遞增
                 res = itr->second;
                 res->mResReferCount++;
+
+                if (res->mIsUnused)
+                {
+                    // 重新被引用，從無引用列表移除
+                    mUnusedResources.erase(res->mUnusedItr);
+                    res->mIsUnused = false;
+                }
                 break;
             }
 
@@ -132,6 +132,10 @@ namespace Tiny3D
 
             res->mID = resID;
             res->mIsLoaded = true;
+            mMemoryUsage += res->getSize();
+
+            // 新資源可能讓內存超出預算
+            trim();
         } while (0);
 
         return res;
@@ -169,7 +173,7 @@ namespace Tiny3D
             }
 
             // 卸載資源
-            ID resID = (res->isCloned() ? res->getCloneID() : res->getID());
+            NameID resID = (res->isCloned() ? res->getCloneID() : res->getID());
             auto itr = mResourcesCache.find(resID);
             if (itr == mResourcesCache.end())
             {
@@ -180,6 +184,17 @@ namespace Tiny3D
                 break;
             }
 
+            if (mMemoryBudget > 0)
+            {
+                // 有內存預算時先保留在緩存裡，放到無引用列表最後面，
+                // 超出預算才按最久未使用的順序卸載
+                res->mUnusedItr 
+                    = mUnusedResources.insert(mUnusedResources.end(), res);
+                res->mIsUnused = true;
+                ret = trim();
+                break;
+            }
+
             // 讓資源自己處理卸載事情
             ret = res->unload();
             if (T3D_FAILED(ret))
@@ -188,6 +203,7 @@ namespace Tiny3D
             }
 
             // 最後從緩存中清除掉
+            mMemoryUsage -= std::min(mMemoryUsage, res->getSize());
             mResourcesCache.erase(itr);
         } while (0);
 
@@ -196,20 +212,51 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    TResult ResourceManager::retain(ResourcePtr res)
+    {
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            if (res == nullptr || res->mResReferCount == 0)
+            {
+                ret = T3D_ERR_RES_INVALID_OBJECT;
+                T3D_LOG_ERROR(LOG_TAG_RESOURCE,
+                    "Invalid resource object !");
+                break;
+            }
+
+            res->mResReferCount++;
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
     TResult ResourceManager::unloadAllResources()
     {
         TResult ret = T3D_OK;
 
+        // 卸載過程中不再保留無引用的資源，避免淘汰時破壞遍歷
+        size_t budget = mMemoryBudget;
+        mMemoryBudget = 0;
+
         auto itr = mResourcesCache.begin();
         while (itr != mResourcesCache.end())
         {
             auto res = itr->second;
             itr++;
-            if (res->isLoaded())
+            if (res->mIsUnused)
+                evict(res);
+            else if (res->isLoaded())
                 unload(res);
         }
 
         mResourcesCache.clear();
+        mUnusedResources.clear();
+        mMemoryUsage = 0;
+        mMemoryBudget = budget;
 
         return ret;
     }
@@ -220,15 +267,76 @@ namespace Tiny3D
     {
         TResult ret = T3D_OK;
 
-        do 
+        auto itr = mUnusedResources.begin();
+        while (itr != mUnusedResources.end())
         {
-        } while (0);
+            Resource *res = *itr;
+            ++itr;
+
+            // 無引用列表裡的資源引用計數都是 0，和沒有預算時一樣直接卸載，
+            // 不管調用 unload() 的地方是否還持有對象
+            evict(res);
+        }
 
         return ret;
     }
 
     //--------------------------------------------------------------------------
 
+    TResult ResourceManager::trim()
+    {
+        TResult ret = T3D_OK;
+
+        auto itr = mUnusedResources.begin();
+        while (mMemoryUsage > mMemoryBudget && itr != mUnusedResources.end())
+        {
+            Resource *res = *itr;
+            ++itr;
+
+            // 無引用列表裡的資源引用計數都是 0，和沒有預算時一樣直接卸載，
+            // 不管調用 unload() 的地方是否還持有對象
+            evict(res);
+        }
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void ResourceManager::setMemoryBudget(size_t budget)
+    {
+        mMemoryBudget = budget;
+
+        if (mMemoryBudget == 0)
+        {
+            unloadUnused();
+        }
+        else
+        {
+            trim();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void ResourceManager::evict(Resource *res)
+    {
+        if (res->mIsUnused)
+        {
+            mUnusedResources.erase(res->mUnusedItr);
+            res->mIsUnused = false;
+        }
+
+        mMemoryUsage -= std::min(mMemoryUsage, res->getSize());
+        res->unload();
+
+        // 緩存持有最後一個引用，清除後 res 就被釋放了
+        NameID resID = (res->isCloned() ? res->getCloneID() : res->getID());
+        mResourcesCache.erase(resID);
+    }
+
+    //--------------------------------------------------------------------------
+
     ResourcePtr ResourceManager::clone(ResourcePtr src)
     {
         ResourcePtr res;
@@ -251,7 +359,7 @@ namespace Tiny3D
                 break;
             }
 
-            ID cloneID = toCloneID(res->getName(), mCloneID++);
+            NameID cloneID = toCloneID(res->getName());
             res->mCloneID = cloneID;
 
             auto rval = mResourcesCache.insert(ResourcesValue(cloneID, res));
@@ -261,7 +369,10 @@ namespace Tiny3D
                     "Add resource [%s] cloned to cache failed !",
                     res->getName().c_str());
                 res = nullptr;
+                break;
             }
+
+            mMemoryUsage += res->getSize();
         } while (0);
 
         return res;
@@ -270,13 +381,13 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     ResourcePtr ResourceManager::getResource(
-        const String &name, ID cloneID /* = T3D_INVALID_ID */) const
+        const String &name, NameID cloneID /* = T3D_INVALID_ID */) const
     {
         ResourcePtr res;
 
         do 
         {
-            ID resID = T3D_INVALID_ID;
+            NameID resID = T3D_INVALID_ID;
             if (cloneID != T3D_INVALID_ID)
             {
                 // 克隆對象
@@ -294,6 +405,13 @@ namespace Tiny3D
             }
 
             res = itr->second;
+
+            if (res->mIsUnused)
+            {
+                // 記錄最近使用，移到無引用列表最後面
+                mUnusedResources.splice(mUnusedResources.end(), 
+                    mUnusedResources, res->mUnusedItr);
+            }
         } while (0);
 
         return res;
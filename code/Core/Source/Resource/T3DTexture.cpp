@@ -157,6 +157,9 @@ namespace Tiny3D
                     break;
                 }
             }
+
+            // 資源大小按像素緩衝區大小計算
+            mSize = mPBO->getBufferSize();
         } while (0);
 
         return ret;
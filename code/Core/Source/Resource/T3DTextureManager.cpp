@@ -42,7 +42,7 @@ namespace Tiny3D
     TextureManager::TextureManager()
         : mDefaultMipMaps(1)
     {
-
+        setMemoryBudget(DEFAULT_MEMORY_BUDGET);
     }
 
     //--------------------------------------------------------------------------
@@ -98,8 +98,9 @@ namespace Tiny3D
             uint32_t access = va_arg(args, uint32_t);
             size_t numMipMaps = va_arg(args, size_t);
             PixelFormat format = va_arg(args, PixelFormat);
-            Texture::TexUsage texUsage = va_arg(args, Texture::TexUsage);
-            TextureType texType = va_arg(args, TextureType);
+            // 非 enum class 的枚举经过 ... 传递时会被提升为 int
+            Texture::TexUsage texUsage = (Texture::TexUsage)va_arg(args, int);
+            TextureType texType = (TextureType)va_arg(args, int);
             numMipMaps = (numMipMaps == -1 ? mDefaultMipMaps : numMipMaps);
             res = Texture::create(name, usage, access, numMipMaps, 
                 width, height, texUsage, texType, format);
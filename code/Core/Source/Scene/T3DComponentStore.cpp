@@ -0,0 +1,212 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#include "Scene/T3DComponentStore.h"
+#include "Scene/T3DSceneNode.h"
+#include "Component/T3DComponent.h"
+#include "Kernel/T3DJobSystem.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    const size_t ComponentStore::UPDATE_GRAIN = 256;
+
+    //--------------------------------------------------------------------------
+
+    ComponentStore::ComponentStore()
+        : mCount(0)
+        , mIsUpdating(false)
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    ComponentStore::~ComponentStore()
+    {
+        clear();
+    }
+
+    //--------------------------------------------------------------------------
+
+    void ComponentStore::add(Component *component, uint32_t order)
+    {
+        T3D_ASSERT(!mIsUpdating);
+        T3D_ASSERT(component->mStoreBucket == 0);
+
+        const Class *cls = component->getClass();
+        uint32_t index = cls->getIndex();
+
+        if (index >= mClassBuckets.size())
+        {
+            mClassBuckets.resize(index + 1, 0);
+        }
+
+        if (mClassBuckets[index] == 0)
+        {
+            // 第一次遇到这个类型
+            Bucket bucket;
+            bucket.cls = cls;
+            bucket.order = order;
+            mBuckets.push_back(bucket);
+            mClassBuckets[index] = (uint32_t)mBuckets.size();
+            sortBuckets();
+        }
+
+        uint32_t b = mClassBuckets[index];
+        Components &components = mBuckets[b - 1].components;
+
+        component->mStoreBucket = b;
+        component->mStoreIndex = (uint32_t)components.size();
+        components.push_back(component);
+        mCount++;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void ComponentStore::remove(Component *component)
+    {
+        T3D_ASSERT(!mIsUpdating);
+
+        if (component->mStoreBucket == 0)
+        {
+            return;
+        }
+
+        Components &components = mBuckets[component->mStoreBucket - 1].components;
+        uint32_t index = component->mStoreIndex;
+
+        T3D_ASSERT(components[index] == component);
+
+        // 最后一个组件填补空位
+        Component *last = components.back();
+        components[index] = last;
+        last->mStoreIndex = index;
+        components.pop_back();
+
+        component->mStoreBucket = 0;
+        component->mStoreIndex = 0;
+        mCount--;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void ComponentStore::clear()
+    {
+        T3D_ASSERT(!mIsUpdating);
+
+        for (Bucket &bucket : mBuckets)
+        {
+            for (Component *component : bucket.components)
+            {
+                component->mStoreBucket = 0;
+                component->mStoreIndex = 0;
+            }
+
+            bucket.components.clear();
+        }
+
+        mCount = 0;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void ComponentStore::update(JobSystem *jobs /* = nullptr */)
+    {
+        mIsUpdating = true;
+
+        for (uint32_t b : mUpdateOrder)
+        {
+            const Components &components = mBuckets[b].components;
+
+            if (jobs != nullptr && components.size() > UPDATE_GRAIN)
+            {
+                jobs->parallelFor(components.size(), UPDATE_GRAIN,
+                    [&components](size_t begin, size_t end, size_t thread)
+                {
+                    updateRange(components, begin, end);
+                });
+            }
+            else
+            {
+                updateRange(components, 0, components.size());
+            }
+        }
+
+        mIsUpdating = false;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void ComponentStore::updateRange(const Components &components, 
+        size_t begin, size_t end)
+    {
+        size_t i = 0;
+
+        for (i = begin; i < end; ++i)
+        {
+            Component *component = components[i];
+
+            if (component->getSceneNode()->isActive())
+            {
+                component->update();
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void ComponentStore::sortBuckets()
+    {
+        mUpdateOrder.resize(mBuckets.size());
+
+        uint32_t i = 0;
+        for (i = 0; i < mUpdateOrder.size(); ++i)
+        {
+            mUpdateOrder[i] = i;
+        }
+
+        // 执行顺序相同时按类序号排，保证每次更新顺序一致
+        const Buckets &buckets = mBuckets;
+        std::stable_sort(mUpdateOrder.begin(), mUpdateOrder.end(),
+            [&buckets](uint32_t a, uint32_t b)
+        {
+            if (buckets[a].order != buckets[b].order)
+                return buckets[a].order < buckets[b].order;
+            return buckets[a].cls->getIndex() < buckets[b].cls->getIndex();
+        });
+    }
+
+    //--------------------------------------------------------------------------
+
+    const Class *ComponentStore::getTypeClass(size_t index) const
+    {
+        return mBuckets[mUpdateOrder[index]].cls;
+    }
+
+    //--------------------------------------------------------------------------
+
+    size_t ComponentStore::getTypeSize(size_t index) const
+    {
+        return mBuckets[mUpdateOrder[index]].components.size();
+    }
+}
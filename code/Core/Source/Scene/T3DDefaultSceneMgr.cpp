@@ -30,27 +30,26 @@
 #include "Component/T3DQuad.h"
 #include "Component/T3DCube.h"
 #include "Component/T3DGlobe.h"
+#include "Bound/T3DFrustumBound.h"
+#include "Kernel/T3DTechnique.h"
+#include "Resource/T3DMaterial.h"
 #include "Kernel/T3DAgent.h"
+#include "Kernel/T3DJobSystem.h"
+#include "Component/T3DComponentRegistry.h"
 
 
 namespace Tiny3D
 {
     //--------------------------------------------------------------------------
 
-    int32_t bitcount(uint32_t x)
-    {
-        x = (x & 0x55555555UL) + ((x >> 1) & 0x55555555UL); // 0-2 in 2 bits
-        x = (x & 0x33333333UL) + ((x >> 2) & 0x33333333UL); // 0-4 in 4 bits
-        x = (x & 0x0f0f0f0fUL) + ((x >> 4) & 0x0f0f0f0fUL); // 0-8 in 8 bits
-        x = (x & 0x00ff00ffUL) + ((x >> 8) & 0x00ff00ffUL); // 0-16 in 16 bits
-        x = (x & 0x0000ffffUL) + ((x >> 16) & 0x0000ffffUL); // 0-31 in 32 bits
-        return x;
-    }
+    T3D_INIT_SINGLETON(DefaultSceneMgr);
+    T3D_IMPLEMENT_CLASS_1(DefaultSceneMgr, SceneManagerBase);
 
     //--------------------------------------------------------------------------
 
-    T3D_INIT_SINGLETON(DefaultSceneMgr);
-    T3D_IMPLEMENT_CLASS_1(DefaultSceneMgr, SceneManagerBase);
+    const size_t DefaultSceneMgr::UPDATE_ROOTS_PER_THREAD = 4;
+    const size_t DefaultSceneMgr::MAX_SPLIT_LEVEL = 4;
+    const size_t DefaultSceneMgr::CULLING_GRAIN = 256;
 
     //--------------------------------------------------------------------------
 
@@ -72,6 +71,8 @@ namespace Tiny3D
     DefaultSceneMgr::DefaultSceneMgr()
         : mRoot(nullptr)
         , mRenderQueue(nullptr)
+        , mUseComponentStore(false)
+        , mIsUpdating(false)
     {
 
     }
@@ -80,12 +81,26 @@ namespace Tiny3D
 
     DefaultSceneMgr::~DefaultSceneMgr()
     {
+        clearStaticBatches();
+
         if (mRoot != nullptr)
         {
             mRoot->removeAllChildren();
             mRoot = nullptr;
         }
 
+        // 场景树外面还有引用的结点，不再使用变换存储
+        size_t i = 0;
+        for (i = 0; i < mTransforms.getCapacity(); ++i)
+        {
+            Transform3D *xform = (Transform3D *)mTransforms.getUserDataAt(i);
+
+            if (xform != nullptr)
+            {
+                xform->mStore = nullptr;
+            }
+        }
+
         mRenderQueue = nullptr;
     }
 
@@ -103,9 +118,6 @@ namespace Tiny3D
 
         mRenderQueue = RenderQueue::create();
 
-        // 预分配32个槽给存放要剔除的可渲染对象
-        mSceneNodes.resize(32, Slot());
-
         return ret;
     }
 
@@ -117,7 +129,20 @@ namespace Tiny3D
 
         if (mRoot != nullptr)
         {
-            mRoot->visit();
+            updateTransforms();
+
+            if (mUseComponentStore)
+            {
+                updateComponents();
+            }
+            else if (T3D_JOB_SYSTEM.getWorkerCount() > 0)
+            {
+                updateParallel();
+            }
+            else
+            {
+                mRoot->visit();
+            }
         }
 
         return T3D_OK;
@@ -125,6 +150,170 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    void DefaultSceneMgr::updateTransforms()
+    {
+        JobSystem &jobs = T3D_JOB_SYSTEM;
+
+        mTransforms.update(jobs.getWorkerCount() > 0 ? &jobs : nullptr);
+
+        // 监听者可能不是线程安全的，在调用线程里通知
+        size_t i = 0;
+        for (i = 0; i < mTransforms.getChangedCount(); ++i)
+        {
+            Transform3D *xform 
+                = (Transform3D *)mTransforms.getChangedUserData(i);
+            xform->applyWorldTransform(mTransforms.getChangedWorldTransform(i));
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DefaultSceneMgr::collectUpdateRoots(size_t target)
+    {
+        mUpdateRoots.clear();
+        mUpdateRoots.push_back(mRoot);
+
+        size_t level = 0;
+
+        while (mUpdateRoots.size() < target && level < MAX_SPLIT_LEVEL)
+        {
+            // 这一层在调用线程更新，子结点作为下一层
+            mSplitNodes.clear();
+
+            for (SceneNode *node : mUpdateRoots)
+            {
+                if (!node->isEnabled())
+                {
+                    continue;
+                }
+
+                node->update();
+
+                NodePtr child = node->getFirstChild();
+
+                while (child != nullptr)
+                {
+                    mSplitNodes.push_back(
+                        static_cast<SceneNode *>((Node *)child));
+                    child = child->getNextSibling();
+                }
+            }
+
+            mUpdateRoots.swap(mSplitNodes);
+            level++;
+
+            if (mUpdateRoots.empty())
+            {
+                break;
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DefaultSceneMgr::updateParallel()
+    {
+        JobSystem &jobs = T3D_JOB_SYSTEM;
+
+        collectUpdateRoots(jobs.getThreadCount() * UPDATE_ROOTS_PER_THREAD);
+
+        mDeferred.resize(jobs.getThreadCount());
+
+        for (SceneNodes &nodes : mDeferred)
+        {
+            nodes.clear();
+        }
+
+        // 子树之间互不依赖，每个子树在一个线程里按照先父后子的顺序更新
+        mIsUpdating = true;
+
+        jobs.parallelFor(mUpdateRoots.size(), 1, 
+            [this](size_t begin, size_t end, size_t thread)
+        {
+            size_t i = 0;
+            for (i = begin; i < end; ++i)
+            {
+                mUpdateRoots[i]->visit();
+            }
+        });
+
+        mIsUpdating = false;
+
+        applyDeferred();
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DefaultSceneMgr::applyDeferred()
+    {
+        // 剔除树不是线程安全的，更新期间的修改统一在这里处理
+        for (SceneNodes &nodes : mDeferred)
+        {
+            for (SceneNode *node : nodes)
+            {
+                updateSceneNode(node);
+            }
+
+            nodes.clear();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DefaultSceneMgr::updateComponents()
+    {
+        JobSystem &jobs = T3D_JOB_SYSTEM;
+
+        if (jobs.getWorkerCount() > 0)
+        {
+            mDeferred.resize(jobs.getThreadCount());
+
+            // 同一类型的组件之间互不依赖，按类型逐批并行更新
+            mIsUpdating = true;
+            mComponents.update(&jobs);
+            mIsUpdating = false;
+
+            applyDeferred();
+        }
+        else
+        {
+            mComponents.update();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    ComponentStore *DefaultSceneMgr::getComponentStore()
+    {
+        return (mUseComponentStore ? &mComponents : nullptr);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DefaultSceneMgr::setComponentStoreEnabled(bool enabled)
+    {
+        if (enabled == mUseComponentStore)
+        {
+            return;
+        }
+
+        mUseComponentStore = enabled;
+
+        if (enabled)
+        {
+            if (mRoot != nullptr)
+            {
+                mRoot->storeComponents(&mComponents);
+            }
+        }
+        else
+        {
+            mComponents.clear();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
     TResult DefaultSceneMgr::render(ViewportPtr viewport)
     {
         TResult ret = T3D_OK;
@@ -159,36 +348,54 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
-    TResult DefaultSceneMgr::frustumCulling(CameraPtr camera)
+    TResult DefaultSceneMgr::frustumCulling(Camera *camera)
     {
         TResult ret = T3D_OK;
 
-        BoundPtr bound = camera->getBound();
+        // 相机持有碰撞体，剔除过程中只借用
+        Bound *bound = camera->getBound();
+
+        // 裁剪的同时用相机视图矩阵计算排序深度
+        mRenderQueue->setCamera(camera);
 
         uint32_t mask = camera->getObjectMask();
 
-        uint32_t count = bitcount(mask);
-        uint32_t i = 0;
-        uint32_t idx = 0;
+        // 有包围盒的结点，树上查询，掩码不匹配和视锥体外的子树整棵跳过
+        mVisibleNodes.clear();
 
-        for (i = 0; i < sizeof(mask) && idx < count; ++i)
+        if (bound->getType() == Bound::Type::FRUSTUM)
         {
-            if (mask & (1 << i))
+            FrustumBound *frustum = static_cast<FrustumBound *>(bound);
+            mCullingTree.query(frustum->getFrustum(), mask, mVisibleNodes);
+        }
+
+        JobSystem &jobs = T3D_JOB_SYSTEM;
+
+        if (jobs.getWorkerCount() > 0 && mVisibleNodes.size() > CULLING_GRAIN)
+        {
+            // 每个线程写自己的分桶，最后合并，不用加锁
+            mRenderQueue->setBucketCount(jobs.getThreadCount());
+
+            jobs.parallelFor(mVisibleNodes.size(), CULLING_GRAIN,
+                [this](size_t begin, size_t end, size_t thread)
             {
-                idx++;
+                addVisibleNodes(begin, end, thread);
+            });
 
-                Slot &slot = mSceneNodes[i];
-                
-                SceneNodePtr node = slot.first;
-                while (node != nullptr)
-                {
-                    if (node->isEnabled() && node->isVisible())
-                    {
-                        node->frustumCulling(bound, mRenderQueue);
-                    }
+            mRenderQueue->mergeBuckets();
+        }
+        else
+        {
+            addVisibleNodes(0, mVisibleNodes.size(), SIZE_MAX);
+        }
 
-                    node = node->mNext;
-                }
+        // 没有包围盒的结点，逐个交给结点自己判断
+        for (SceneNode *node : mUnbounded)
+        {
+            if ((node->getCameraMask() & mask) != 0 
+                && node->isEnabled() && node->isVisible())
+            {
+                node->frustumCulling(bound, mRenderQueue);
             }
         }
 
@@ -197,6 +404,38 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    void DefaultSceneMgr::addVisibleNodes(size_t begin, size_t end, 
+        size_t bucket)
+    {
+        size_t i = 0;
+
+        for (i = begin; i < end; ++i)
+        {
+            SceneNode *node = (SceneNode *)mVisibleNodes[i];
+
+            if (!node->isEnabled() || !node->isVisible())
+            {
+                continue;
+            }
+
+            Technique *tech 
+                = node->mRenderable->getMaterial()->getBestTechnique();
+
+            if (bucket == SIZE_MAX)
+            {
+                mRenderQueue->addRenderable(tech->getRenderQueue(), 
+                    node->mRenderable);
+            }
+            else
+            {
+                mRenderQueue->addRenderable(bucket, tech->getRenderQueue(),
+                    node->mRenderable);
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
     SceneNodePtr DefaultSceneMgr::getRoot() const
     {
         return mRoot;
@@ -204,6 +443,13 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    TransformStore *DefaultSceneMgr::getTransformStore()
+    {
+        return &mTransforms;
+    }
+
+    //--------------------------------------------------------------------------
+
     SceneNodePtr DefaultSceneMgr::createSceneNode(SceneNodePtr parent, 
         ID uID /* = Node::E_NID_AUTOMATIC */)
     {
@@ -212,7 +458,7 @@ namespace Tiny3D
             // 创建根节点
             mRoot = SceneNode::create();
             mRoot->setName("Root");
-            mRoot->addComponent(T3D_CLASS(Transform3D));
+            mRoot->addComponent<Transform3D>();
         }
 
         if (parent == nullptr)
@@ -229,7 +475,7 @@ namespace Tiny3D
                 parent->addChild(node);
             }
 
-            node->addComponent(T3D_CLASS(Transform3D));
+            node->addComponent<Transform3D>();
         }
 
         return node;
@@ -237,42 +483,63 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    bool DefaultSceneMgr::getCullingAabb(SceneNode *node, Aabb &aabb)
+    {
+        return (node->mCollider != nullptr 
+            && node->mCollider->getWorldAabb(aabb));
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DefaultSceneMgr::addToUnbounded(SceneNode *node)
+    {
+        node->mUnboundedIdx = (int32_t)mUnbounded.size();
+        mUnbounded.push_back(node);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void DefaultSceneMgr::removeFromUnbounded(SceneNode *node)
+    {
+        size_t idx = (size_t)node->mUnboundedIdx;
+        SceneNode *last = mUnbounded.back();
+        mUnbounded[idx] = last;
+        last->mUnboundedIdx = (int32_t)idx;
+        mUnbounded.pop_back();
+        node->mUnboundedIdx = -1;
+    }
+
+    //--------------------------------------------------------------------------
+
     TResult DefaultSceneMgr::addSceneNode(SceneNode *node)
     {
         TResult ret = T3D_OK;
 
         do 
         {
-            uint32_t mask = node->getCameraMask() - 1;
+            if (node->mCullingProxy != DynamicAabbTree::NULL_NODE
+                || node->mUnboundedIdx >= 0)
+            {
+                // 已经加入过了，可能只是相机掩码变化了
+                removeSceneNode(node);
+            }
 
-            if (mask >= sizeof(mask))
+            if (node->mStaticBatch != nullptr)
             {
-                // 最多支持32个，这里已经越界了
-                ret = T3D_ERR_OUT_OF_BOUND;
-                T3D_LOG_ERROR(LOG_TAG_SCENE, 
-                    "Culling renderable mask is out of bound !");
+                // 已经合批了，由合批结点负责剔除和渲染
                 break;
             }
 
-            Slot &slot = mSceneNodes[mask];
-
-            if (slot.first == nullptr)
+            Aabb aabb;
+            if (getCullingAabb(node, aabb))
             {
-                // 空链表
-                slot.first = node;
-                slot.last = node;
-                node->mPrev = node->mNext = nullptr;
+                node->mCullingProxy = mCullingTree.createProxy(aabb, 
+                    node->getCameraMask(), node);
             }
             else
             {
-                // 非空链表，插入最后
-                slot.last->mNext = node;
-                node->mPrev = slot.last;
-                node->mNext = nullptr;
-                slot.last = node;
+                addToUnbounded(node);
             }
-
-            slot.count++;
         } while (0);
 
         return ret;
@@ -286,28 +553,70 @@ namespace Tiny3D
 
         do 
         {
-            uint32_t mask = node->getCameraMask() - 1;
+            if (node->mCullingProxy != DynamicAabbTree::NULL_NODE)
+            {
+                mCullingTree.destroyProxy(node->mCullingProxy);
+                node->mCullingProxy = DynamicAabbTree::NULL_NODE;
+            }
+            else if (node->mUnboundedIdx >= 0)
+            {
+                removeFromUnbounded(node);
+            }
+            else
+            {
+                ret = T3D_ERR_NOT_FOUND;
+            }
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult DefaultSceneMgr::updateSceneNode(SceneNode *node)
+    {
+        TResult ret = T3D_OK;
 
-            if (mask >= sizeof(mask))
+        do 
+        {
+            if (mIsUpdating)
             {
-                // 最多支持32个，这里已经越界了
-                ret = T3D_ERR_OUT_OF_BOUND;
-                T3D_LOG_ERROR(LOG_TAG_SCENE, 
-                    "Culling renderable mask is out of bound !");
+                // 并行更新期间，记下来等更新完成再处理
+                mDeferred[JobSystem::getThreadIndex()].push_back(node);
                 break;
             }
 
-            if (node->mPrev != nullptr)
-                node->mPrev->mNext = node->mNext;
-            if (node->mNext != nullptr)
-                node->mNext->mPrev = node->mPrev;
-
-            Slot &slot = mSceneNodes[mask];
-            slot.count--;
+            Aabb aabb;
+            bool hasAabb = getCullingAabb(node, aabb);
 
-            if (slot.count == 0)
+            if (node->mCullingProxy != DynamicAabbTree::NULL_NODE)
             {
-                slot.first = slot.last = nullptr;
+                if (hasAabb)
+                {
+                    // 还在扩大的包围盒里面时，树不会有任何变化
+                    mCullingTree.moveProxy(node->mCullingProxy, aabb);
+                }
+                else
+                {
+                    mCullingTree.destroyProxy(node->mCullingProxy);
+                    node->mCullingProxy = DynamicAabbTree::NULL_NODE;
+                    addToUnbounded(node);
+                }
+            }
+            else if (node->mUnboundedIdx >= 0)
+            {
+                if (hasAabb)
+                {
+                    // 后来加上了碰撞体
+                    removeFromUnbounded(node);
+                    node->mCullingProxy = mCullingTree.createProxy(aabb,
+                        node->getCameraMask(), node);
+                }
+            }
+            else
+            {
+                // 没有加入剔除的结点，不用处理
+                ret = T3D_ERR_NOT_FOUND;
             }
         } while (0);
 
@@ -318,22 +627,15 @@ namespace Tiny3D
 
     void DefaultSceneMgr::setComponentOrder(const Class *cls, uint32_t order)
     {
-        mOrders.insert(OrderMapValue(cls, order));
+        mOrders[cls] = order;
+        ComponentRegistry::setOrder(cls, order);
     }
 
     //--------------------------------------------------------------------------
 
     uint32_t DefaultSceneMgr::getComponentOrder(const Class *cls) const
     {
-        uint32_t order = ComponentOrder::INVALID;
-
-        auto itr = mOrders.find(cls);
-        if (itr != mOrders.end())
-        {
-            order = itr->second;
-        }
-
-        return order;
+        return ComponentRegistry::getOrder(cls);
     }
 
     //--------------------------------------------------------------------------
@@ -132,6 +132,76 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    TResult SceneManager::updateSceneNode(SceneNode *node)
+    {
+        if (mImpl != nullptr)
+        {
+            return mImpl->updateSceneNode(node);
+        }
+
+        return T3D_ERR_SYS_NOT_INIT;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TransformStore *SceneManager::getTransformStore()
+    {
+        if (mImpl != nullptr)
+        {
+            return mImpl->getTransformStore();
+        }
+
+        return nullptr;
+    }
+
+    //--------------------------------------------------------------------------
+
+    ComponentStore *SceneManager::getComponentStore()
+    {
+        if (mImpl != nullptr)
+        {
+            return mImpl->getComponentStore();
+        }
+
+        return nullptr;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void SceneManager::setComponentStoreEnabled(bool enabled)
+    {
+        if (mImpl != nullptr)
+        {
+            mImpl->setComponentStoreEnabled(enabled);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult SceneManager::buildStaticBatches(SceneNodePtr root /* = nullptr */)
+    {
+        if (mImpl != nullptr)
+        {
+            return mImpl->buildStaticBatches(root);
+        }
+
+        return T3D_ERR_SYS_NOT_INIT;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult SceneManager::clearStaticBatches()
+    {
+        if (mImpl != nullptr)
+        {
+            return mImpl->clearStaticBatches();
+        }
+
+        return T3D_ERR_SYS_NOT_INIT;
+    }
+
+    //--------------------------------------------------------------------------
+
     void SceneManager::setComponentOrder(const Class *cls, uint32_t order)
     {
         if (mImpl != nullptr)
@@ -19,6 +19,8 @@
 
 
 #include "Scene/T3DSceneManagerBase.h"
+#include "Component/T3DStaticBatch.h"
+#include "Resource/T3DMaterial.h"
 
 
 namespace Tiny3D
@@ -40,4 +42,145 @@ namespace Tiny3D
     {
 
     }
+
+    //--------------------------------------------------------------------------
+
+    TransformStore *SceneManagerBase::getTransformStore()
+    {
+        return nullptr;
+    }
+
+    //--------------------------------------------------------------------------
+
+    ComponentStore *SceneManagerBase::getComponentStore()
+    {
+        return nullptr;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void SceneManagerBase::setComponentStoreEnabled(bool enabled)
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult SceneManagerBase::buildStaticBatches(
+        SceneNodePtr root /* = nullptr */)
+    {
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            if (root == nullptr)
+            {
+                root = getRoot();
+            }
+
+            if (root == nullptr)
+            {
+                ret = T3D_ERR_INVALID_POINTER;
+                T3D_LOG_ERROR(LOG_TAG_SCENE, "Invalid scene root !");
+                break;
+            }
+
+            struct PendingBatch
+            {
+                uint32_t        cameraMask;
+                SceneNodePtr    node;
+                StaticBatchPtr  batch;
+            };
+
+            TArray<PendingBatch> pending;
+            TArray<SceneNode *> stack;
+            stack.push_back(root);
+
+            while (!stack.empty())
+            {
+                SceneNode *node = stack.back();
+                stack.pop_back();
+
+                // 看不见的子树不参与合批
+                if (!node->isVisible() || !node->isEnabled())
+                {
+                    continue;
+                }
+
+                NodePtr child = node->getFirstChild();
+
+                while (child != nullptr)
+                {
+                    stack.push_back(static_cast<SceneNode *>((Node *)child));
+                    child = child->getNextSibling();
+                }
+
+                uint32_t mask = node->getCameraMask();
+
+                if (mask == 0 || !StaticBatch::canBatch(node))
+                {
+                    continue;
+                }
+
+                // 同一个相机掩码、材质和顶点格式的结点放到同一个合批里
+                StaticBatch *batch = nullptr;
+
+                for (PendingBatch &item : pending)
+                {
+                    if (item.cameraMask == mask 
+                        && item.batch->isCompatible(node))
+                    {
+                        batch = item.batch;
+                        break;
+                    }
+                }
+
+                if (batch == nullptr)
+                {
+                    PendingBatch item;
+                    item.cameraMask = mask;
+                    item.node = createSceneNode(getRoot());
+                    item.node->setName("StaticBatch");
+                    MaterialPtr material 
+                        = node->getRenderable()->getMaterial();
+                    item.batch = item.node->addComponent<StaticBatch>(
+                        (Material *)material);
+                    pending.push_back(item);
+                    batch = item.batch;
+                }
+
+                batch->addNode(node);
+            }
+
+            for (PendingBatch &item : pending)
+            {
+                if (item.batch->build() == T3D_OK)
+                {
+                    item.node->setCameraMask(item.cameraMask);
+                    mStaticBatches.push_back(item.node);
+                }
+                else
+                {
+                    item.node->removeFromParent();
+                }
+            }
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult SceneManagerBase::clearStaticBatches()
+    {
+        for (SceneNodePtr &node : mStaticBatches)
+        {
+            node->removeAllComponents();
+            node->removeFromParent();
+        }
+
+        mStaticBatches.clear();
+
+        return T3D_OK;
+    }
 }
@@ -26,9 +26,11 @@
 #include "Kernel/T3DCommon.h"
 #include "Kernel/T3DTechnique.h"
 #include "Component/T3DComponent.h"
-#include "Component/T3DComponentCreator.h"
+#include "Component/T3DComponentRegistry.h"
 #include "Component/T3DRenderable.h"
+#include "Component/T3DTransform3D.h"
 #include "Scene/T3DSceneManager.h"
+#include "Scene/T3DComponentStore.h"
 #include "Render/T3DRenderQueue.h"
 
 
@@ -38,6 +40,7 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     T3D_IMPLEMENT_CLASS_1(SceneNode, Node);
+    T3D_IMPLEMENT_POOL(SceneNode, 256);
 
     //--------------------------------------------------------------------------
 
@@ -54,13 +57,16 @@ namespace Tiny3D
         : Node(uID)
         , mIsVisible(true)
         , mIsEnabled(true)
+        , mIsActive(true)
         , mIsDirty(true)
+        , mIsStatic(false)
         , mCameraMask(0)
         , mTransform3D(nullptr)
         , mCollider(nullptr)
         , mRenderable(nullptr)
-        , mPrev(nullptr)
-        , mNext(nullptr)
+        , mCullingProxy(-1)
+        , mUnboundedIdx(-1)
+        , mStaticBatch(nullptr)
     {
 
     }
@@ -96,6 +102,123 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
+    void SceneNode::onAttachParent(NodePtr parent)
+    {
+        Node::onAttachParent(parent);
+
+        SceneNodePtr node = smart_pointer_cast<SceneNode>(parent);
+
+        if (mTransform3D != nullptr)
+        {
+            mTransform3D->updateParent(node);
+        }
+
+        updateActive(node->isActive());
+
+        // 只有挂到场景里的结点才放进组件存储
+        ComponentStore *store = T3D_SCENE_MGR.getComponentStore();
+        if (store != nullptr && isInScene())
+        {
+            storeComponents(store);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void SceneNode::onDetachParent(NodePtr parent)
+    {
+        Node::onDetachParent(parent);
+
+        if (mTransform3D != nullptr)
+        {
+            mTransform3D->updateParent(nullptr);
+        }
+
+        // 这时还没有断开父结点，还能判断是否在场景里
+        ComponentStore *store = T3D_SCENE_MGR.getComponentStore();
+        if (store != nullptr && isInScene())
+        {
+            unstoreComponents(store);
+        }
+
+        updateActive(true);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void SceneNode::updateActive(bool parentActive)
+    {
+        bool active = (mIsEnabled && parentActive);
+
+        if (mIsActive != active)
+        {
+            mIsActive = active;
+
+            NodePtr node = getFirstChild();
+
+            while (node != nullptr)
+            {
+                SceneNodePtr child = smart_pointer_cast<SceneNode>(node);
+                child->updateActive(active);
+                node = node->getNextSibling();
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool SceneNode::isInScene() const
+    {
+        const Node *node = this;
+
+        while (node->getParent() != nullptr)
+        {
+            node = node->getParent();
+        }
+
+        return (node == T3D_SCENE_MGR.getRoot());
+    }
+
+    //--------------------------------------------------------------------------
+
+    void SceneNode::storeComponents(ComponentStore *store)
+    {
+        for (auto &item : mComponentQueue)
+        {
+            store->add(item.second, item.first);
+        }
+
+        NodePtr node = getFirstChild();
+
+        while (node != nullptr)
+        {
+            SceneNodePtr child = smart_pointer_cast<SceneNode>(node);
+            child->storeComponents(store);
+            node = node->getNextSibling();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void SceneNode::unstoreComponents(ComponentStore *store)
+    {
+        for (auto &item : mComponentQueue)
+        {
+            store->remove(item.second);
+        }
+
+        NodePtr node = getFirstChild();
+
+        while (node != nullptr)
+        {
+            SceneNodePtr child = smart_pointer_cast<SceneNode>(node);
+            child->unstoreComponents(store);
+            node = node->getNextSibling();
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
     TResult SceneNode::cloneProperties(NodePtr node) const
     {
         TResult ret = Node::cloneProperties(node);
@@ -104,7 +227,9 @@ namespace Tiny3D
         {
             SceneNodePtr newNode = smart_pointer_cast<SceneNode>(node);
             newNode->mIsEnabled = mIsEnabled;
+            newNode->updateActive(true);
             newNode->mIsVisible = mIsVisible;
+            newNode->mIsStatic = mIsStatic;
 
             ComponentPtr component;
             auto itr = mComponentQueue.begin();
@@ -114,24 +239,11 @@ namespace Tiny3D
 
                 if (component != nullptr)
                 {
-                    newNode->mComponentQueue.insert(ComponentQueueValue(itr->first, component));
-                    newNode->mComponents.insert(ComponentsValue(component->getClass(), component));
-
-                    if (ComponentOrder::TRANSFORM == itr->first)
-                    {
-                        newNode->mTransform3D = smart_pointer_cast<Transform3D>(component);
-                    }
-                    else if (ComponentOrder::COLLIDER == itr->first)
-                    {
-                        newNode->mCollider = smart_pointer_cast<Bound>(component);
-                    }
-                    else if (ComponentOrder::RENDERABLE == itr->first)
-                    {
-                        newNode->mRenderable = smart_pointer_cast<Renderable>(component);
-                    }
-
-                    component->onAttachSceneNode(newNode);
+                    newNode->attachComponent(component->getClass(), 
+                        itr->first, component);
                 }
+
+                ++itr;
             }
 
             if (mCameraMask != 0)
@@ -144,6 +256,108 @@ namespace Tiny3D
     }
 
 
+    //--------------------------------------------------------------------------
+
+    SceneNodePtr SceneNode::instantiate() const
+    {
+        SceneNodePtr node = SceneNode::create();
+        TResult ret = instantiateProperties(node);
+
+        if (T3D_FAILED(ret))
+        {
+            node = nullptr;
+        }
+
+        return node;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult SceneNode::instantiateProperties(SceneNode *node) const
+    {
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            node->setName(getName());
+            node->mIsEnabled = mIsEnabled;
+            node->updateActive(true);
+            node->mIsVisible = mIsVisible;
+            node->mIsStatic = mIsStatic;
+
+            // 子结点同样生成实例
+            NodePtr child = getFirstChild();
+
+            while (child != nullptr)
+            {
+                NodePtr newChild;
+
+                if (child->getNodeType() == Type::SCENE_NODE)
+                {
+                    SceneNodePtr prefab = smart_pointer_cast<SceneNode>(child);
+                    newChild = prefab->instantiate();
+                }
+                else
+                {
+                    newChild = child->clone();
+                }
+
+                if (newChild == nullptr)
+                {
+                    ret = T3D_ERR_INVALID_POINTER;
+                    T3D_LOG_ERROR(LOG_TAG_SCENE, 
+                        "Instantiate child node [%s] failed !", 
+                        child->getName().c_str());
+                    break;
+                }
+
+                node->addChild(newChild);
+                child = child->getNextSibling();
+            }
+
+            if (T3D_FAILED(ret))
+            {
+                break;
+            }
+
+            auto itr = mComponentQueue.begin();
+            while (itr != mComponentQueue.end())
+            {
+                ComponentPtr component = itr->second->instantiate();
+
+                if (component == nullptr)
+                {
+                    ret = T3D_ERR_INVALID_POINTER;
+                    T3D_LOG_ERROR(LOG_TAG_SCENE, 
+                        "Instantiate component [%s] failed !", 
+                        itr->second->getClass()->getName());
+                    break;
+                }
+
+                ret = node->attachComponent(component->getClass(), 
+                    itr->first, component);
+                if (T3D_FAILED(ret))
+                {
+                    break;
+                }
+
+                ++itr;
+            }
+
+            if (T3D_FAILED(ret))
+            {
+                break;
+            }
+
+            if (mCameraMask != 0)
+            {
+                node->setCameraMask(mCameraMask);
+            }
+        } while (0);
+
+        return ret;
+    }
+
     //--------------------------------------------------------------------------
 
     void SceneNode::update()
@@ -159,19 +373,17 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
-    void SceneNode::frustumCulling(BoundPtr bound, RenderQueuePtr queue)
+    void SceneNode::frustumCulling(Bound *bound, RenderQueue *queue)
     {
-        Technique *tech = mRenderable->getMaterial()->getBestTechnique();
-
-        if (mCollider != nullptr)
+        if (mCollider != nullptr && !mCollider->test(bound))
         {
-            if (mCollider->test(bound))
-            {
-                queue->addRenderable(tech->getRenderQueue(), mRenderable);
-            }
+            return;
         }
-        else
+
+        if (mRenderable->frustumCulling(bound))
         {
+            // 被剔除的结点不用去取材质
+            Technique *tech = mRenderable->getMaterial()->getBestTechnique();
             queue->addRenderable(tech->getRenderQueue(), mRenderable);
         }
     }
@@ -212,6 +424,10 @@ namespace Tiny3D
                 child->setEnabled(enabled);
                 node = node->getNextSibling();
             }
+
+            NodePtr parent = getParent();
+            updateActive(parent == nullptr 
+                || smart_pointer_cast<SceneNode>(parent)->isActive());
         }
     }
 
@@ -278,26 +494,7 @@ namespace Tiny3D
 
     uint32_t SceneNode::getComponentOrder(const Class *cls) const
     {
-        uint32_t order = 0;
-
-        if (cls->isKindOf(T3D_CLASS(Transform3D)))
-        {
-            order = T3D_SCENE_MGR.getComponentOrder(T3D_CLASS(Transform3D));
-        }
-        else if (cls->isKindOf(T3D_CLASS(Camera)))
-        {
-            order = T3D_SCENE_MGR.getComponentOrder(T3D_CLASS(Camera));
-        }
-        else if (cls->isKindOf(T3D_CLASS(Bound)))
-        {
-            order = T3D_SCENE_MGR.getComponentOrder(T3D_CLASS(Bound));
-        }
-        else if (cls->isKindOf(T3D_CLASS(Renderable)))
-        {
-            order = T3D_SCENE_MGR.getComponentOrder(T3D_CLASS(Renderable));
-        }
-
-        return order;
+        return ComponentRegistry::getOrder(cls);
     }
 
     //--------------------------------------------------------------------------
@@ -308,9 +505,43 @@ namespace Tiny3D
 
         do 
         {
-            // 获取组件执行顺序
-            uint32_t order = getComponentOrder(cls);
+            uint32_t order = checkComponent(cls);
+            if (ComponentOrder::INVALID == order)
+            {
+                break;
+            }
 
+            // 创建组件对象
+            va_list args;
+            va_start(args, cls);
+            component = ComponentRegistry::createComponent(cls, args);
+            va_end(args);
+
+            if (component == nullptr)
+            {
+                T3D_LOG_ERROR(LOG_TAG_COMPONENT, "Create component failed !");
+                break;
+            }
+
+            if (T3D_FAILED(attachComponent(cls, order, component)))
+            {
+                component = nullptr;
+                break;
+            }
+        } while (0);
+
+        return component;
+    }
+
+    //--------------------------------------------------------------------------
+
+    uint32_t SceneNode::checkComponent(const Class *cls) const
+    {
+        // 获取组件执行顺序
+        uint32_t order = getComponentOrder(cls);
+
+        do 
+        {
             if (ComponentOrder::INVALID == order)
             {
                 T3D_LOG_ERROR(LOG_TAG_COMPONENT, "Invalid component order !");
@@ -323,37 +554,39 @@ namespace Tiny3D
             {
                 T3D_LOG_ERROR(LOG_TAG_COMPONENT,
                     "Duplicated component for class %s", cls->getName());
+                order = ComponentOrder::INVALID;
                 break;
             }
+        } while (0);
 
-            // 创建组件对象
-            ComponentCreatorPtr creator = T3D_AGENT.getComponentCreator();
-            va_list args;
-            va_start(args, cls);
-            component = creator->createObject(1, cls, args);
-            va_end(args);
+        return order;
+    }
 
-            if (component == nullptr)
-            {
-                T3D_LOG_ERROR(LOG_TAG_COMPONENT, "Create component failed !");
-                break;
-            }
+    //--------------------------------------------------------------------------
 
+    TResult SceneNode::attachComponent(const Class *cls, uint32_t order, 
+        Component *component)
+    {
+        TResult ret = T3D_OK;
+
+        do 
+        {
             // 根据顺序插入执行队列
             auto ret0 = mComponentQueue.insert(ComponentQueueValue(order, component));
             if (!ret0.second)
             {
-                component = nullptr;
+                ret = T3D_ERR_DUPLICATED_ITEM;
                 T3D_LOG_ERROR(LOG_TAG_COMPONENT, 
                     "Insert component executing queue failed !");
                 break;
             }
 
             // 缓存组件
-            auto ret = mComponents.insert(ComponentsValue(cls, component));
-            if (!ret.second)
+            auto ret1 = mComponents.insert(ComponentsValue(cls, component));
+            if (!ret1.second)
             {
-                component = nullptr;
+                mComponentQueue.erase(ret0.first);
+                ret = T3D_ERR_DUPLICATED_ITEM;
                 T3D_LOG_ERROR(LOG_TAG_COMPONENT, "Cache component failed !");
                 break;
             }
@@ -361,15 +594,15 @@ namespace Tiny3D
             // 记录下几个特殊组件，方便后续快速访问，不用每次查字典
             if (ComponentOrder::TRANSFORM == order)
             {
-                mTransform3D = smart_pointer_cast<Transform3D>(component);
+                mTransform3D = static_cast<Transform3D*>(component);
             }
             else if (ComponentOrder::COLLIDER == order)
             {
-                mCollider = smart_pointer_cast<Bound>(component);
+                mCollider = static_cast<Bound*>(component);
             }
             else if (ComponentOrder::RENDERABLE == order)
             {
-                mRenderable = smart_pointer_cast<Renderable>(component);
+                mRenderable = static_cast<Renderable*>(component);
 
                 if (mCameraMask != 0)
                 {
@@ -379,14 +612,18 @@ namespace Tiny3D
                     }
                 }
             }
-        } while (0);
 
-        if (component != nullptr)
-        {
             component->onAttachSceneNode(this);
-        }
 
-        return component;
+            // 不在场景里的结点（预制体模板、拿下来的结点）等挂到场景里再放进去
+            ComponentStore *store = T3D_SCENE_MGR.getComponentStore();
+            if (store != nullptr && isInScene())
+            {
+                store->add(component, order);
+            }
+        } while (0);
+
+        return ret;
     }
 
     //--------------------------------------------------------------------------
@@ -423,6 +660,29 @@ namespace Tiny3D
             {
                 mTransform3D = nullptr;
             }
+            else if (component == mCollider)
+            {
+                mCollider = nullptr;
+            }
+
+            ComponentStore *store = T3D_SCENE_MGR.getComponentStore();
+            if (store != nullptr)
+            {
+                store->remove(component);
+            }
+
+            // 执行队列里是裸指针，要在组件释放前移除
+            auto i = mComponentQueue.begin();
+            while (i != mComponentQueue.end())
+            {
+                if (i->second == component)
+                {
+                    mComponentQueue.erase(i);
+                    break;
+                }
+
+                ++i;
+            }
 
             component->onDetachSceneNode(this);
             mComponents.erase(itr);
@@ -433,6 +693,7 @@ namespace Tiny3D
 
     void SceneNode::removeAllComponents()
     {
+        ComponentStore *store = T3D_SCENE_MGR.getComponentStore();
         auto itr = mComponents.begin();
 
         while (itr != mComponents.end())
@@ -442,10 +703,19 @@ namespace Tiny3D
                 T3D_SCENE_MGR.removeSceneNode(this);
             }
 
+            if (store != nullptr)
+            {
+                store->remove(itr->second);
+            }
+
             itr->second->onDetachSceneNode(this);
             ++itr;
         }
 
+        mComponentQueue.clear();
         mComponents.clear();
+        mTransform3D = nullptr;
+        mCollider = nullptr;
+        mRenderable = nullptr;
     }
 }
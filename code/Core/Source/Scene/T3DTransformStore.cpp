@@ -0,0 +1,425 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#include "Scene/T3DTransformStore.h"
+#include "Kernel/T3DJobSystem.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    const TransformStore::Handle TransformStore::INVALID_HANDLE = 0xFFFFFFFF;
+    const size_t TransformStore::SWEEP_GRAIN = 1024;
+
+    //--------------------------------------------------------------------------
+
+    TransformStore::TransformStore()
+        : mFreeList(INVALID_HANDLE)
+        , mSlotCount(0)
+        , mNeedRebuild(false)
+        , mHasDirty(false)
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    TransformStore::~TransformStore()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    TransformStore::Handle TransformStore::create(Handle parent, 
+        void *userData)
+    {
+        Handle handle = mFreeList;
+
+        if (handle == INVALID_HANDLE)
+        {
+            handle = Handle(mSlots.size());
+            mSlots.push_back(Slot());
+        }
+        else
+        {
+            mFreeList = mSlots[handle].index;
+        }
+
+        // 先放到数组末尾，下次 update 时再按层级排好
+        Slot &slot = mSlots[handle];
+        slot.index = uint32_t(mHandles.size());
+        slot.parent = parent;
+        slot.depth = 0;
+
+        mHandles.push_back(handle);
+        mParents.push_back(-1);
+        mPositions.push_back(Vector3::ZERO);
+        mOrientations.push_back(Quaternion::IDENTITY);
+        mScalings.push_back(Vector3::UNIT_SCALE);
+        mWorlds.push_back(Transform());
+        mDirty.push_back(1);
+        mUserData.push_back(userData);
+
+        mSlotCount++;
+        mNeedRebuild = true;
+        mHasDirty = true;
+
+        return handle;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void TransformStore::destroy(Handle handle)
+    {
+        T3D_ASSERT(handle < mSlots.size() && mSlots[handle].depth >= 0);
+
+        Slot &slot = mSlots[handle];
+        mHandles[slot.index] = INVALID_HANDLE;
+        mUserData[slot.index] = nullptr;
+
+        slot.index = mFreeList;
+        slot.parent = INVALID_HANDLE;
+        slot.depth = -1;
+        mFreeList = handle;
+
+        mSlotCount--;
+        mNeedRebuild = true;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void TransformStore::setParent(Handle handle, Handle parent)
+    {
+        Slot &slot = mSlots[handle];
+
+        if (slot.parent != parent)
+        {
+            slot.parent = parent;
+            mDirty[slot.index] = 1;
+            mNeedRebuild = true;
+            mHasDirty = true;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    TransformStore::Handle TransformStore::getParent(Handle handle) const
+    {
+        return mSlots[handle].parent;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void TransformStore::setLocal(Handle handle, const Vector3 &position,
+        const Quaternion &orientation, const Vector3 &scaling)
+    {
+        uint32_t index = mSlots[handle].index;
+        mPositions[index] = position;
+        mOrientations[index] = orientation;
+        mScalings[index] = scaling;
+        mDirty[index] = 1;
+        mHasDirty = true;
+    }
+
+    //--------------------------------------------------------------------------
+
+    const Transform &TransformStore::getWorldTransform(Handle handle) const
+    {
+        return mWorlds[mSlots[handle].index];
+    }
+
+    //--------------------------------------------------------------------------
+
+    void *TransformStore::getUserData(Handle handle) const
+    {
+        return mUserData[mSlots[handle].index];
+    }
+
+    //--------------------------------------------------------------------------
+
+    size_t TransformStore::getLevelCount() const
+    {
+        return (mLevels.empty() ? 0 : mLevels.size() - 1);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void *TransformStore::getChangedUserData(size_t index) const
+    {
+        return mUserData[mChanged[index]];
+    }
+
+    //--------------------------------------------------------------------------
+
+    const Transform &TransformStore::getChangedWorldTransform(
+        size_t index) const
+    {
+        return mWorlds[mChanged[index]];
+    }
+
+    //--------------------------------------------------------------------------
+
+    void *TransformStore::getUserDataAt(size_t index) const
+    {
+        return mUserData[index];
+    }
+
+    //--------------------------------------------------------------------------
+
+    void TransformStore::rebuild()
+    {
+        size_t i = 0;
+        Handle h = 0;
+
+        // 计算层级，父变换已经销毁的当作根变换
+        for (h = 0; h < mSlots.size(); ++h)
+        {
+            if (mSlots[h].depth >= 0)
+            {
+                mSlots[h].depth = 0x7FFFFFFF;
+            }
+        }
+
+        Handles &chain = mChain;
+        int32_t maxDepth = -1;
+
+        for (h = 0; h < mSlots.size(); ++h)
+        {
+            if (mSlots[h].depth != 0x7FFFFFFF)
+            {
+                // 空闲或者已经计算过了
+                maxDepth = std::max(maxDepth, mSlots[h].depth);
+                continue;
+            }
+
+            // 向上找到一个层级已知的祖先，再倒过来填
+            chain.clear();
+            Handle cur = h;
+            int32_t depth = -1;
+
+            while (true)
+            {
+                Slot &slot = mSlots[cur];
+
+                if (slot.parent != INVALID_HANDLE 
+                    && (slot.parent >= mSlots.size() 
+                        || mSlots[slot.parent].depth < 0))
+                {
+                    slot.parent = INVALID_HANDLE;
+                }
+
+                chain.push_back(cur);
+
+                if (slot.parent == INVALID_HANDLE)
+                {
+                    break;
+                }
+
+                if (mSlots[slot.parent].depth != 0x7FFFFFFF)
+                {
+                    depth = mSlots[slot.parent].depth;
+                    break;
+                }
+
+                T3D_ASSERT(chain.size() <= mSlots.size());
+                cur = slot.parent;
+            }
+
+            while (!chain.empty())
+            {
+                depth++;
+                mSlots[chain.back()].depth = depth;
+                chain.pop_back();
+            }
+
+            maxDepth = std::max(maxDepth, depth);
+        }
+
+        // 按层级计数排序
+        size_t levelCount = size_t(maxDepth + 1);
+        mLevels.assign(levelCount + 1, 0);
+
+        for (h = 0; h < mSlots.size(); ++h)
+        {
+            if (mSlots[h].depth >= 0)
+            {
+                mLevels[mSlots[h].depth + 1]++;
+            }
+        }
+
+        for (i = 1; i <= levelCount; ++i)
+        {
+            mLevels[i] += mLevels[i - 1];
+        }
+
+        Offsets &cursor = mCursor;
+        cursor.assign(mLevels.begin(), mLevels.end() - 1);
+
+        // 临时数组跟正式数组交换使用，只在数量超过容量时才重新分配内存
+        Handles &handles = mScratchHandles;
+        Parents &parents = mScratchParents;
+        Vectors &positions = mScratchPositions;
+        Quaternions &orientations = mScratchOrientations;
+        Vectors &scalings = mScratchScalings;
+        Transforms &worlds = mScratchWorlds;
+        Flags &dirty = mScratchDirty;
+        UserData &userData = mScratchUserData;
+
+        handles.resize(mSlotCount);
+        parents.resize(mSlotCount);
+        positions.resize(mSlotCount);
+        orientations.resize(mSlotCount);
+        scalings.resize(mSlotCount);
+        worlds.resize(mSlotCount);
+        dirty.resize(mSlotCount);
+        userData.resize(mSlotCount);
+
+        for (i = 0; i < mHandles.size(); ++i)
+        {
+            h = mHandles[i];
+
+            if (h == INVALID_HANDLE)
+            {
+                continue;
+            }
+
+            Slot &slot = mSlots[h];
+            size_t index = cursor[slot.depth]++;
+            handles[index] = h;
+            positions[index] = mPositions[i];
+            orientations[index] = mOrientations[i];
+            scalings[index] = mScalings[i];
+            worlds[index] = mWorlds[i];
+            dirty[index] = mDirty[i];
+            userData[index] = mUserData[i];
+            slot.index = uint32_t(index);
+        }
+
+        // 位置都确定了才能填父变换的位置
+        for (i = 0; i < handles.size(); ++i)
+        {
+            Handle parent = mSlots[handles[i]].parent;
+            parents[i] = (parent != INVALID_HANDLE 
+                ? int32_t(mSlots[parent].index) : -1);
+        }
+
+        mHandles.swap(handles);
+        mParents.swap(parents);
+        mPositions.swap(positions);
+        mOrientations.swap(orientations);
+        mScalings.swap(scalings);
+        mWorlds.swap(worlds);
+        mDirty.swap(dirty);
+        mUserData.swap(userData);
+
+        mNeedRebuild = false;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void TransformStore::sweep(size_t begin, size_t end)
+    {
+        size_t i = 0;
+
+        for (i = begin; i < end; ++i)
+        {
+            int32_t parent = mParents[i];
+
+            // 父变换在上一层，已经计算完了
+            if (parent >= 0 && mDirty[parent])
+            {
+                mDirty[i] = 1;
+            }
+
+            if (!mDirty[i])
+            {
+                continue;
+            }
+
+            Transform &world = mWorlds[i];
+
+            if (parent >= 0)
+            {
+                world.applyTransform(mWorlds[parent], mPositions[i],
+                    mOrientations[i], mScalings[i]);
+            }
+            else
+            {
+                world.setTranslation(mPositions[i]);
+                world.setOrientation(mOrientations[i]);
+                world.setScaling(mScalings[i]);
+                world.update();
+            }
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void TransformStore::update(JobSystem *jobs /* = nullptr */)
+    {
+        mChanged.clear();
+
+        if (mNeedRebuild)
+        {
+            rebuild();
+        }
+
+        if (!mHasDirty)
+        {
+            return;
+        }
+
+        size_t level = 0;
+
+        for (level = 0; level + 1 < mLevels.size(); ++level)
+        {
+            size_t begin = mLevels[level];
+            size_t end = mLevels[level + 1];
+
+            if (jobs != nullptr && end - begin > SWEEP_GRAIN)
+            {
+                jobs->parallelFor(end - begin, SWEEP_GRAIN,
+                    [this, begin](size_t first, size_t last, size_t thread)
+                {
+                    sweep(begin + first, begin + last);
+                });
+            }
+            else
+            {
+                sweep(begin, end);
+            }
+        }
+
+        // 收集变化的变换，顺便清掉脏标记
+        size_t i = 0;
+        for (i = 0; i < mDirty.size(); ++i)
+        {
+            if (mDirty[i])
+            {
+                mChanged.push_back(uint32_t(i));
+                mDirty[i] = 0;
+            }
+        }
+
+        mHasDirty = false;
+    }
+}
@@ -21,12 +21,12 @@
 #include "Serializer/T3DSerializerManager.h"
 #include "Serializer/T3DBinMaterialReader.h"
 #include "Serializer/T3DBinMaterialWriter.h"
-#include "Serializer/T3DJSONMaterialReader.h"
-#include "Serializer/T3DJSONMaterialWriter.h"
+#include "Serializer/T3DJsonMaterialReader.h"
+#include "Serializer/T3DJsonMaterialWriter.h"
 #include "Serializer/T3DBinModelReader.h"
 #include "Serializer/T3DBinModelWriter.h"
-#include "Serializer/T3DJSONModelReader.h"
-#include "Serializer/T3DJSONModelWriter.h"
+#include "Serializer/T3DJsonModelReader.h"
+#include "Serializer/T3DJsonModelWriter.h"
 
 
 namespace Tiny3D
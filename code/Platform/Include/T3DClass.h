@@ -24,6 +24,7 @@
 
 #include "T3DPlatformPrerequisites.h"
 #include "T3DMacro.h"
+#include <atomic>
 
 
 namespace Tiny3D
@@ -31,6 +32,8 @@ namespace Tiny3D
     /**
      * @class   Class
      * @brief   用于运行时动态类型检查机制 
+     * @remarks 同时记录每个类的实例数量，计数都是原子的，可以一直打开。
+     *          实例什么时候算作创建和销毁由使用者决定，见 Object.
      */
     class T3D_PLATFORM_API Class
     {
@@ -39,19 +42,86 @@ namespace Tiny3D
     public:
         static const size_t MAX_BASE_CLASS_COUNT = 8;
 
+        static const uint32_t MAX_CLASS_COUNT = 4096;
+
         static const Class *getClass(const String &name);
 
-        Class(const char *name, size_t baseCount = 0, 
+        /**
+         * @brief 根据类序号获取类，序号从 1 开始
+         */
+        static const Class *getClass(uint32_t index);
+
+        /**
+         * @brief 获取已经注册的类数量
+         */
+        static uint32_t getClassCount();
+
+        Class(const char *name, size_t size, size_t baseCount = 0, 
             const Class *base1 = nullptr, const Class *base2 = nullptr, 
             const Class *base3 = nullptr, const Class *base4 = nullptr, 
             const Class *base5 = nullptr, const Class *base6 = nullptr, 
             const Class *base7 = nullptr, const Class *base8 = nullptr);
 
+        /**
+         * @brief 插件卸载时其中的类跟着析构，从注册表中移除，序号不再复用
+         */
+        ~Class();
+
         const char *getName() const
         {
             return mName;
         }
 
+        /**
+         * @brief 获取类实例的字节数
+         */
+        size_t getSize() const
+        {
+            return mSize;
+        }
+
+        /**
+         * @brief 获取类序号，从 1 开始，0 表示注册的类太多没有序号
+         */
+        uint32_t getIndex() const
+        {
+            return mIndex;
+        }
+
+        /**
+         * @brief 记录创建了一个实例
+         */
+        void onInstanceCreated() const;
+
+        /**
+         * @brief 记录销毁了一个实例
+         */
+        void onInstanceDestroyed() const;
+
+        /**
+         * @brief 获取当前存活的实例数量
+         */
+        uint32_t getLiveCount() const
+        {
+            return mLiveCount.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief 获取存活实例数量的峰值
+         */
+        uint32_t getPeakCount() const
+        {
+            return mPeakCount.load(std::memory_order_relaxed);
+        }
+
+        /**
+         * @brief 获取累计创建的实例数量
+         */
+        uint64_t getTotalCount() const
+        {
+            return mTotalCount.load(std::memory_order_relaxed);
+        }
+
         size_t getBaseClassCount() const
         {
             return mBaseClassesCount;
@@ -93,15 +163,25 @@ namespace Tiny3D
 
     private:
         const char *mName;
+        const size_t mSize;
+        uint32_t mIndex;
         const Class *mBaseClasses[MAX_BASE_CLASS_COUNT];
         const size_t mBaseClassesCount;
 
+        mutable std::atomic<uint32_t> mLiveCount;
+        mutable std::atomic<uint32_t> mPeakCount;
+        mutable std::atomic<uint64_t> mTotalCount;
+
         typedef TMap<String, const Class *> Classes;
         typedef Classes::iterator           ClassesItr;
         typedef Classes::const_iterator     ClassesConstItr;
         typedef Classes::value_type         ClassesValue;
 
         static Classes  msClasses;
+
+        /** 按序号排列的类，都是静态初始化前就清零的简单类型，不受初始化顺序影响 */
+        static const Class  *msClassTable[MAX_CLASS_COUNT];
+        static uint32_t     msClassCount;
     };
 
 
@@ -163,47 +243,47 @@ namespace Tiny3D
             static const Class msClass;
 
     #define T3D_IMPLEMENT_CLASS_0(cls) \
-        const Class cls::msClass(#cls);
+        const Class cls::msClass(#cls, sizeof(cls));
 
     #define T3D_IMPLEMENT_CLASS_1(cls, b1) \
-        const Class cls::msClass(#cls, 1, \
+        const Class cls::msClass(#cls, sizeof(cls), 1, \
             b1::getStaticClass());
 
     #define T3D_IMPLEMENT_CLASS_2(cls, b1, b2) \
-        const Class cls::msClass(#cls, 2, \
+        const Class cls::msClass(#cls, sizeof(cls), 2, \
             b1::getStaticClass(), b2::getStaticClass());
 
     #define T3D_IMPLEMENT_CLASS_3(cls, b1, b2, b3) \
-        const Class cls::msClass(#cls, 3, \
+        const Class cls::msClass(#cls, sizeof(cls), 3, \
                 b1::getStaticClass(), b2::getStaticClass(), \
                 b3::getStaticClass());
 
     #define T3D_IMPLEMENT_CLASS_4(cls, b1, b2, b3, b4) \
-        const Class cls::msClass(#cls, 4, \
+        const Class cls::msClass(#cls, sizeof(cls), 4, \
                 b1::getStaticClass(), b2::getStaticClass(), \
                 b3::getStaticClass(), b4::getStaticClass());
 
     #define T3D_IMPLEMENT_CLASS_5(cls, b1, b2, b3, b4, b5) \
-        const Class cls::msClass(#cls, 5, \
+        const Class cls::msClass(#cls, sizeof(cls), 5, \
                 b1::getStaticClass(), b2::getStaticClass(), \
                 b3::getStaticClass(), b4::getStaticClass(), \
                 b5::getStaticClass(), );
 
     #define T3D_IMPLEMENT_CLASS_6(cls, b1, b2, b3, b4, b5, b6) \
-        const Class cls::msClass(#cls, 6, \
+        const Class cls::msClass(#cls, sizeof(cls), 6, \
                 b1::getStaticClass(), b2::getStaticClass(), \
                 b3::getStaticClass(), b4::getStaticClass(), \
                 b5::getStaticClass(), b6::getStaticClass());
 
     #define T3D_IMPLEMENT_CLASS_7(cls, b0, b1, b2, b3, b4, b5, b6) \
-        const Class cls::msClass(#cls, 7, \
+        const Class cls::msClass(#cls, sizeof(cls), 7, \
                 b1::getStaticClass(), b2::getStaticClass(), \
                 b3::getStaticClass(), b4::getStaticClass(), \
                 b5::getStaticClass(), b6::getStaticClass(), \
                 b7::getStaticClass());
 
     #define T3D_IMPLEMENT_CLASS_8(cls, b0, b1, b2, b3, b4, b5, b6, b7) \
-        const Class cls::msClass(#cls, 8, \
+        const Class cls::msClass(#cls, sizeof(cls), 8, \
                 b1::getStaticClass(), b2::getStaticClass(), \
                 b3::getStaticClass(), b4::getStaticClass(), \
                 b5::getStaticClass(), b6::getStaticClass(), \
@@ -30,6 +30,7 @@
 #include <stack>
 #include <set>
 #include <map>
+#include <unordered_map>
 #include <algorithm>
 #include <thread>
 #include <mutex>
@@ -112,6 +113,9 @@ using TMap = std::map<K, V>;
 template <typename K, typename V>
 using TMultimap = std::multimap<K, V>;
 
+template <typename K, typename V>
+using THashMap = std::unordered_map<K, V>;
+
 template <typename T1, typename T2>
 using TPair = std::pair<T1, T2>;
 
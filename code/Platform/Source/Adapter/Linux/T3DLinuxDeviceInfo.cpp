@@ -21,7 +21,6 @@
 #include "Adapter/T3DFactoryInterface.h"
 
 #include <sys/types.h>
-#include <sys/sysctl.h>
 #include <sys/utsname.h>
 #include <X11/Xlib.h>
 #include <sstream>
@@ -206,6 +205,12 @@ namespace Tiny3D
         Display *display;
         char *displayName = nullptr;
         display = XOpenDisplay(displayName);
+        if (display == nullptr)
+        {
+            // 没有 X Server（例如离屏渲染的命令行环境），屏幕信息保持为 0
+            return;
+        }
+
         int w = DisplayWidth(display, 0);
         int h = DisplayHeight(display, 0);
 
@@ -304,7 +309,7 @@ namespace Tiny3D
         return mCPUCores;
     }
 
-    uint32_t LinuxDeviceInfo::getSystemRAM() const
+    uint64_t LinuxDeviceInfo::getSystemRAM() const
     {
         return mSystemRAM;
     }
@@ -27,6 +27,10 @@ namespace Tiny3D
 
     Class::Classes Class::msClasses;
 
+    const Class *Class::msClassTable[Class::MAX_CLASS_COUNT];
+
+    uint32_t Class::msClassCount = 0;
+
     const Class *Class::getClass(const String &name)
     {
         return msClasses[name];
@@ -34,13 +38,35 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
-    Class::Class(const char *name, size_t baseCount /* = 0 */, 
+    const Class *Class::getClass(uint32_t index)
+    {
+        if (index == 0 || index > msClassCount)
+            return nullptr;
+
+        return msClassTable[index - 1];
+    }
+
+    //--------------------------------------------------------------------------
+
+    uint32_t Class::getClassCount()
+    {
+        return msClassCount;
+    }
+
+    //--------------------------------------------------------------------------
+
+    Class::Class(const char *name, size_t size, size_t baseCount /* = 0 */, 
         const Class *base1 /* = nullptr */, const Class *base2 /* = nullptr */, 
         const Class *base3 /* = nullptr */, const Class *base4 /* = nullptr */, 
         const Class *base5 /* = nullptr */, const Class *base6 /* = nullptr */, 
         const Class *base7 /* = nullptr */, const Class *base8 /* = nullptr */)
         : mName(name)
+        , mSize(size)
+        , mIndex(0)
         , mBaseClassesCount(baseCount)
+        , mLiveCount(0)
+        , mPeakCount(0)
+        , mTotalCount(0)
     {
         mBaseClasses[0] = base1;
         mBaseClasses[1] = base2;
@@ -52,6 +78,53 @@ namespace Tiny3D
         mBaseClasses[7] = base8;
 
         msClasses.insert(ClassesValue(name, this));
+
+        // 类都在静态初始化和加载插件时注册，不会有多个线程同时注册
+        if (msClassCount < MAX_CLASS_COUNT)
+        {
+            msClassTable[msClassCount] = this;
+            mIndex = ++msClassCount;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    Class::~Class()
+    {
+        auto itr = msClasses.find(mName);
+
+        if (itr != msClasses.end() && itr->second == this)
+        {
+            msClasses.erase(itr);
+        }
+
+        if (mIndex != 0)
+        {
+            msClassTable[mIndex - 1] = nullptr;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void Class::onInstanceCreated() const
+    {
+        uint32_t live = mLiveCount.fetch_add(1, std::memory_order_relaxed) + 1;
+        mTotalCount.fetch_add(1, std::memory_order_relaxed);
+
+        uint32_t peak = mPeakCount.load(std::memory_order_relaxed);
+
+        while (live > peak 
+            && !mPeakCount.compare_exchange_weak(peak, live, 
+                std::memory_order_relaxed))
+        {
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void Class::onInstanceDestroyed() const
+    {
+        mLiveCount.fetch_sub(1, std::memory_order_relaxed);
     }
 
     //--------------------------------------------------------------------------
@@ -530,6 +530,12 @@ namespace Tiny3D
             return T3D_ERR_SYS_NOT_INIT;
         }
 
+        if (!mStateCache.setBlendState(state))
+        {
+            // 跟当前绑定的状态相同
+            return T3D_OK;
+        }
+
         if (state == nullptr)
         {
             float factor[] = { 1.f, 1.f, 1.f, 1.f };
@@ -543,6 +549,8 @@ namespace Tiny3D
             mD3DDeviceContext->OMSetBlendState(d3dState, factor, 0xffffffff);
         }
 
+        mStatistics.addStateChange();
+
         return T3D_OK;
     }
 
@@ -558,6 +566,12 @@ namespace Tiny3D
             return T3D_ERR_SYS_NOT_INIT;
         }
 
+        if (!mStateCache.setDepthStencilState(state))
+        {
+            // 跟当前绑定的状态相同
+            return T3D_OK;
+        }
+
         if (state == nullptr)
         {
             mD3DDeviceContext->OMSetDepthStencilState(nullptr, 0xffffffff);
@@ -570,6 +584,8 @@ namespace Tiny3D
             mD3DDeviceContext->OMSetDepthStencilState(d3dState, 0xffffffff);
         }
 
+        mStatistics.addStateChange();
+
         return T3D_OK;
     }
 
@@ -585,6 +601,12 @@ namespace Tiny3D
             return T3D_ERR_SYS_NOT_INIT;
         }
 
+        if (!mStateCache.setRasterizerState(state))
+        {
+            // 跟当前绑定的状态相同
+            return T3D_OK;
+        }
+
         if (state == nullptr)
         {
             mD3DDeviceContext->RSSetState(nullptr);
@@ -597,6 +619,8 @@ namespace Tiny3D
             mD3DDeviceContext->RSSetState(d3dState);
         }
 
+        mStatistics.addStateChange();
+
         return T3D_OK;
     }
 
@@ -673,6 +697,8 @@ namespace Tiny3D
             }
         }
 
+        mStatistics.addStateChange();
+
         return T3D_OK;
     }
 
@@ -709,6 +735,12 @@ namespace Tiny3D
 
         do 
         {
+            if (!mStateCache.setConstantBuffer(slot, buffer))
+            {
+                // 已经绑定到这个槽上
+                break;
+            }
+
             D3D11ConstantBufferPtr d3dBuffer 
                 = smart_pointer_cast<D3D11ConstantBuffer>(buffer);
             ID3D11Buffer *pBuffer = d3dBuffer->getD3DBuffer();
@@ -717,6 +749,8 @@ namespace Tiny3D
 
             mD3DDeviceContext->PSSetConstantBuffers((UINT)slot, 1,
                 (ID3D11Buffer * const *)&pBuffer);
+
+            mStatistics.addStateChange();
         } while (0);
 
         return ret;
@@ -730,6 +764,12 @@ namespace Tiny3D
 
         do 
         {
+            if (!mStateCache.setGPUProgram(program))
+            {
+                // 已经是当前的 GPU 程序
+                break;
+            }
+
             // Vertex Shader
             D3D11VertexShaderPtr vshader 
                 = smart_pointer_cast<D3D11VertexShader>(
@@ -742,6 +782,8 @@ namespace Tiny3D
             mD3DDeviceContext->PSSetShader(fshader->getD3DShader(), nullptr, 0);
 
             mBoundGPUProgram = program;
+
+            mStatistics.addStateChange();
         } while (0);
 
         return ret;
@@ -759,7 +801,7 @@ namespace Tiny3D
                 break;
 
             TexturePtr texture = unit->getTexture();
-            if (texture != nullptr)
+            if (texture != nullptr && mStateCache.setTexture(0, texture))
             {
                 D3D11PixelBufferPtr pbo
                     = smart_pointer_cast<D3D11PixelBuffer>(
@@ -768,6 +810,8 @@ namespace Tiny3D
                 ID3D11ShaderResourceView *pD3DSRView = pbo->getD3DSRView();
                 mD3DDeviceContext->PSSetShaderResources(0, 1,
                     (ID3D11ShaderResourceView *const *)&pD3DSRView);
+
+                mStatistics.addTextureBind();
             }
 
             //D3D11SamplerPtr sampler
@@ -845,7 +889,8 @@ namespace Tiny3D
                 mD3DDeviceContext->IASetIndexBuffer(d3dBuffer, idxFormat, 0);
 
                 // 绘制
-                mD3DDeviceContext->DrawIndexed((UINT)ibo->getIndexCount(), 0, 0);
+                mD3DDeviceContext->DrawIndexed(
+                    (UINT)vao->getDrawIndexCount(), 0, 0);
             }
             else
             {
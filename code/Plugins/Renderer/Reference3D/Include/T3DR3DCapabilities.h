@@ -0,0 +1,66 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+
+#ifndef __T3D_R3D_CAPABILITIES_H__
+#define __T3D_R3D_CAPABILITIES_H__
+
+
+#include "T3DR3DPrerequisites.h"
+
+
+namespace Tiny3D
+{
+    /**
+     * @class   R3DCapabilities
+     * @brief   Reference3D 渲染器渲染能力组
+     */
+    class R3DCapabilities : public RenderCapabilities
+    {
+        T3D_DECLARE_CLASS();
+
+    public:
+        /**
+         * @brief   创建一个 Reference3D 渲染器相关能力组对象
+         * @returns 调用成功返回新建 Reference3D 能力组对象
+         */
+        static R3DCapabilitiesPtr create();
+
+        /**
+         * @brief   析构函数
+         */
+        virtual ~R3DCapabilities();
+
+    protected:
+        /**
+         * @brief   构造函数
+         */
+        R3DCapabilities();
+
+        /**
+         * @brief   初始化能力值
+         * @return  调用成功返回 T3D_OK
+         */
+        virtual TResult init() override;
+    };
+}
+
+
+#endif  /*__T3D_R3D_CAPABILITIES_H__*/
@@ -37,6 +37,9 @@ namespace Tiny3D
         T3D_ERR_R3D_INVALID_COLORDEPTH,                 /**< 不支持的色深 */
         T3D_ERR_R3D_INVALID_PRIMITIVE,                  /**< 不支持的图元类型 */
         T3D_ERR_R3D_MISMATCH_VERTEX_COUNT,              /**< 不一样的顶点数量 */
+        T3D_ERR_R3D_UNSUPPORT_FORMAT_TEXTURE,           /**< 不支持的纹理像素格式 */
+        T3D_ERR_R3D_SHADER_NOT_COMPILED,                /**< 着色器还没有编译 */
+        T3D_ERR_R3D_SIMD_MISMATCH,                      /**< SIMD 与逐像素结果不一致 */
     };
 }
 
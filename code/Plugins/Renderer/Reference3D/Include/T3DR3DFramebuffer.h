@@ -136,6 +136,46 @@ namespace Tiny3D
          */
         TResult drawSolidRect(const Rect &rect, const ColorARGB &color);
 
+        /**
+         * @brief 直接写入一段连续的像素，不做混合
+         * @param [in] start : 起点屏幕坐标
+         * @param [in] colors : A8R8G8B8 格式的像素数据
+         * @param [in] count : 像素数量
+         * @return 调用成功返回 T3D_OK
+         */
+        TResult writeSpan(const Point &start, const uint32_t *colors,
+            size_t count);
+
+        /**
+         * @brief 把一段连续的像素混合到帧缓冲
+         * @param [in] start : 起点屏幕坐标
+         * @param [in] colors : 预乘透明度的 A8R8G8B8 格式像素数据
+         * @param [in] count : 像素数量
+         * @return 调用成功返回 T3D_OK
+         * @remarks 混合公式为 dst = src + dst * (1 - src.alpha)，32位色深时
+         *      每次循环用 SIMD 处理 8 个 (SSE2) 或者 16 个 (AVX2) 像素
+         */
+        TResult blendSpan(const Point &start, const uint32_t *colors,
+            size_t count);
+
+        /**
+         * @brief 把颜色转换成预乘透明度的 A8R8G8B8 格式
+         */
+        static uint32_t toPremultiplied(const ColorARGB &color);
+
+        /**
+         * @brief 用随机的像素段比较 fillSpan 、 blendSpan 的 SIMD 路径和逐像素
+         *      处理的结果
+         * @return 结果完全一致返回 T3D_OK
+         * @remarks 没有启用 SIMD 时比较的是同一条路径，总是成功
+         */
+        static TResult verifySpans();
+
+        /**
+         * @brief 获取帧缓冲对应的渲染目标
+         */
+        RenderTarget *getRenderTarget() const { return mRenderTarget; }
+
     protected:
         /**
          * @brief 构造函数
@@ -156,7 +196,35 @@ namespace Tiny3D
          */
         void fillColor(uint8_t *fb, const Color4 &color, bool alphaBlend);
 
+        /**
+         * @brief 用同一个32位颜色填充一段连续的像素，使用宽位写入
+         * @param [in] fb : 帧缓冲地址，必须是32位色深
+         * @param [in] color : A8R8G8B8 格式颜色
+         * @param [in] count : 像素数量
+         * @return void
+         */
+        static void fillSpan(uint8_t *fb, uint32_t color, size_t count);
+
+        /**
+         * @brief 把一段 32 位色深的像素混合到 dst，每次循环用 SIMD 处理一组，
+         *      剩下的交给 blendPixels
+         */
+        static void blendSpan32(uint32_t *dst, const uint32_t *colors,
+            size_t count);
+
+        /**
+         * @brief 逐个像素做预乘透明度混合，是 SIMD 路径的参考实现
+         * @param [in] fb : 帧缓冲地址
+         * @param [in] colors : 预乘透明度的 A8R8G8B8 格式像素数据
+         * @param [in] count : 像素数量
+         * @param [in] bytesPerPixel : 帧缓冲每个像素的字节数，3 或者 4
+         */
+        static void blendPixels(uint8_t *fb, const uint32_t *colors,
+            size_t count, size_t bytesPerPixel);
+
     protected:
+        RenderTarget    *mRenderTarget; /**< 渲染目标，不持有引用避免循环引用 */
+
         uint8_t     *mFramebuffer;
         size_t      mFramebufferSize;
 
@@ -0,0 +1,63 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+
+#ifndef __T3D_R3D_GPU_PROGRAM_H__
+#define __T3D_R3D_GPU_PROGRAM_H__
+
+
+#include "T3DR3DPrerequisites.h"
+
+
+namespace Tiny3D
+{
+    /**
+     * @class   R3DGPUProgram
+     * @brief   Reference3D GPU 程序，只检查各个着色器是否已经编译
+     */
+    class R3DGPUProgram : public GPUProgram
+    {
+        T3D_DECLARE_CLASS();
+
+    public:
+        static R3DGPUProgramPtr create(const String &name);
+
+        virtual ~R3DGPUProgram();
+
+        virtual TResult link(bool force = false) override;
+
+        virtual bool hasLinked() const override;
+
+    protected:
+        R3DGPUProgram(const String &name);
+
+        virtual TResult load() override;
+
+        virtual ResourcePtr clone() const override;
+
+        virtual TResult cloneProperties(GPUProgramPtr newObj) const override;
+
+    protected:
+        bool    mHasLinked;     /**< 是否已经链接 */
+    };
+}
+
+
+#endif  /*__T3D_R3D_GPU_PROGRAM_H__*/
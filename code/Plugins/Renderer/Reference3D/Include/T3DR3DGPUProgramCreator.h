@@ -0,0 +1,81 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+
+#ifndef __T3D_R3D_GPU_PROGRAM_CREATOR_H__
+#define __T3D_R3D_GPU_PROGRAM_CREATOR_H__
+
+
+#include "T3DR3DPrerequisites.h"
+
+
+namespace Tiny3D
+{
+    /**
+     * @class   R3DShaderCreator
+     * @brief   Reference3D 着色器生成器
+     */
+    class R3DShaderCreator : public ShaderCreator
+    {
+        T3D_DECLARE_CLASS();
+
+    public:
+        static const char * const SHADER_TYPE;  /**< Type of the shader */
+
+        /**
+         * @fn  virtual String R3DShaderCreator::getType() const override;
+         * @brief   重写ShaderCreator::getType() 接口
+         */
+        virtual String getType() const override;
+
+        /**
+         * @fn  virtual ShaderPtr R3DShaderCreator::createObject(
+         *      int32_t argc, ...) const override;
+         * @brief   重写ShaderCreator::createObject() 接口
+         */
+        virtual ShaderPtr createObject(int32_t argc, ...) const override;
+    };
+
+    /**
+     * @class   R3DGPUProgramCreator
+     * @brief   Reference3D GPU程序生成器
+     */
+    class R3DGPUProgramCreator : public GPUProgramCreator
+    {
+    public:
+        static const char * const GPUPROGRAM_TYPE;  /**< Type of the gpuprogram */
+
+        /**
+         * @fn  virtual String R3DGPUProgramCreator::getType() const override;
+         * @brief   重写GPUProgramCreator::getType() 接口
+         */
+        virtual String getType() const override;
+
+        /**
+         * @fn  virtual GPUProgramPtr R3DGPUProgramCreator::createObject(
+         *      int32_t argc, ...) const override;
+         * @brief   重写GPUProgramCreator::createObject() 接口
+         */
+        virtual GPUProgramPtr createObject(int32_t argc, ...) const override;
+    };
+}
+
+
+#endif  /*__T3D_R3D_GPU_PROGRAM_CREATOR_H__*/
@@ -66,7 +66,8 @@ namespace Tiny3D
          */
         virtual HardwarePixelBufferPtr createPixelBuffer(size_t width,
             size_t height, PixelFormat format, const void *pixels, 
-            HardwareBuffer::Usage usage, uint32_t mode) override;
+            HardwareBuffer::Usage usage, uint32_t mode, 
+            size_t mipmaps) override;
 
         /**
          * @brief 创建常量缓冲区
@@ -90,8 +91,7 @@ namespace Tiny3D
          * @remarks 继承自 HardwareBufferManagerBase
          * @see HardwareBufferManagerBase::createVertexDeclaration()
          */
-        virtual VertexDeclarationPtr createVertexDeclaration(
-            ShaderPtr vertexShader) override;
+        virtual VertexDeclarationPtr createVertexDeclaration() override;
 
     protected:
         /**
@@ -37,7 +37,8 @@ namespace Tiny3D
          * @brief 创建 Reference3D 渲染器相关的像素缓冲区对象
          */
         static R3DHardwarePixelBufferPtr create(size_t width, size_t height,
-            PixelFormat format, const void *pixels, Usage usage, uint32_t mode);
+            PixelFormat format, const void *pixels, Usage usage, uint32_t mode,
+            size_t mipmaps);
 
         /**
          * @brief 析构函数
@@ -56,12 +57,36 @@ namespace Tiny3D
         virtual TResult writeImage(Image &image, Rect *dstRect = nullptr,
             Rect *srcRect = nullptr) override;
 
+        /**
+         * @brief 获取像素数据，只读，供光栅化阶段直接访问，不经过锁定
+         */
+        const uint8_t *getPixels() const { return mBuffer; }
+
+        /**
+         * @brief 获取像素数据的版本号，每次以写方式锁定都会递增
+         */
+        uint32_t getVersion() const { return mVersion; }
+
+        /**
+         * @brief 获取光栅化使用的纹理采样器
+         * @return 还没有生成过采样器时返回 nullptr
+         * @remarks 采样器跟随像素缓冲区一起释放，调用者需要用 getVersion() 
+         *      判断采样器是否已经过期
+         */
+        R3DTextureSamplerPtr getTextureSampler() const;
+
+        /**
+         * @brief 设置光栅化使用的纹理采样器
+         */
+        void setTextureSampler(R3DTextureSamplerPtr sampler);
+
     protected:
         /**
          * @brief 构造函数
          */
         R3DHardwarePixelBuffer(size_t width, size_t height,
-            PixelFormat format, const void *pixels, Usage usage, uint32_t mode);
+            PixelFormat format, const void *pixels, Usage usage, uint32_t mode,
+            size_t mipmaps);
 
         /**
         * @brief 获取锁定硬件缓冲区不同渲染器实现接口。 实现基类接口
@@ -94,6 +119,9 @@ namespace Tiny3D
         uint8_t *mLockedBuffer; /**< 锁定的缓冲区 */
         Rect    mLockedRect;    /**< 锁定的区域 */
         bool    mNeedWriteBack; /**< 需要回写 */
+        uint32_t    mVersion;   /**< 像素数据版本号 */
+
+        R3DTextureSamplerPtr    mSampler;   /**< 缓存的纹理采样器 */
     };
 }
 
@@ -29,6 +29,8 @@ namespace Tiny3D
 {
     class R3DPlugin : public Plugin
     {
+        T3D_DECLARE_CLASS();
+
     public:
         /**
          * @brief 默认构造函数
@@ -66,8 +68,10 @@ namespace Tiny3D
         virtual TResult uninstall() override;
 
     protected:
-        String      mName;
-        RendererPtr mRenderer;
+        String                  mName;
+        RenderContextPtr        mRenderer;
+        R3DShaderCreator        *mShaderCreator;
+        R3DGPUProgramCreator    *mGPUCreator;
     };
 }
 
@@ -30,12 +30,26 @@
     #define T3D_R3DRENDER_API        T3D_IMPORT_API
 #endif
 
+// 光栅化内部的 SIMD 路径只在 Real 为单精度浮点数时启用
+#if (defined (__SSE2__) || defined (_M_X64) \
+    || (defined (_M_IX86_FP) && _M_IX86_FP >= 2)) \
+    && __T3D_REAL_TYPE__ == __T3D_LOW_PRECISION_FLOAT__
+    #define T3D_R3D_SSE2            1
+    #include <emmintrin.h>
+
+    #if defined (__AVX2__)
+        #define T3D_R3D_AVX2        1
+        #include <immintrin.h>
+    #endif
+#endif
+
 
 namespace Tiny3D
 {
     #define LOG_TAG_R3DRENDERER    "R3DRenderer"
 
     class R3DRenderer;
+    class R3DCapabilities;
     class R3DRenderWindow;
     class R3DHardwareBufferManager;
     class R3DHardwareVertexBuffer;
@@ -45,8 +59,18 @@ namespace Tiny3D
     class R3DVertexArrayObject;
     class R3DVertexDeclaration;
     class R3DFramebuffer;
+    class R3DTextureSampler;
+    class R3DBlendState;
+    class R3DDepthStencilState;
+    class R3DRasterizerState;
+    class R3DSamplerState;
+    class R3DShader;
+    class R3DGPUProgram;
+    class R3DShaderCreator;
+    class R3DGPUProgramCreator;
 
     T3D_DECLARE_SMART_PTR(R3DRenderer);
+    T3D_DECLARE_SMART_PTR(R3DCapabilities);
     T3D_DECLARE_SMART_PTR(R3DRenderWindow);
     T3D_DECLARE_SMART_PTR(R3DHardwareBufferManager);
     T3D_DECLARE_SMART_PTR(R3DHardwareVertexBuffer);
@@ -56,6 +80,13 @@ namespace Tiny3D
     T3D_DECLARE_SMART_PTR(R3DVertexArrayObject);
     T3D_DECLARE_SMART_PTR(R3DVertexDeclaration);
     T3D_DECLARE_SMART_PTR(R3DFramebuffer);
+    T3D_DECLARE_SMART_PTR(R3DTextureSampler);
+    T3D_DECLARE_SMART_PTR(R3DBlendState);
+    T3D_DECLARE_SMART_PTR(R3DDepthStencilState);
+    T3D_DECLARE_SMART_PTR(R3DRasterizerState);
+    T3D_DECLARE_SMART_PTR(R3DSamplerState);
+    T3D_DECLARE_SMART_PTR(R3DShader);
+    T3D_DECLARE_SMART_PTR(R3DGPUProgram);
 }
 
 
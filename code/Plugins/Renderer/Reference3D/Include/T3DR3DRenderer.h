@@ -27,8 +27,10 @@
 
 namespace Tiny3D
 {
-    class R3DRenderer : public Renderer
+    class R3DRenderer : public RenderContext
     {
+        T3D_DECLARE_CLASS();
+
     public:
         static R3DRendererPtr create();
 
@@ -63,29 +65,10 @@ namespace Tiny3D
             const RenderWindowCreateParamEx &paramEx) override;
 
         /**
-         * @brief 查询渲染器能力
-         * @param [in] cap : 能力枚举值
-         * @return 具备cap对应的能力则返回true，否则返回false
-         * @see Renderer::Capability
-         */
-        virtual bool queryCapability(Capability cap) const override;
-
-        /**
-         * @brief 设置变换矩阵
-         * @param [in] state : 变换矩阵类型
-         * @param [in] mat : 变换矩阵
-         * @return 调用成功返回 T3D_OK
-         */
-        virtual TResult setTransform(TransformState state,
-            const Matrix4 &mat) override;
-        
-        /**
-         * @brief 获取对应类型的变换矩阵
-         * @param [in] state : 变换矩阵类型
-         * @return 返回对应类型的变换矩阵
+         * @brief 创建渲染器能力对象
+         * @return 返回 Reference3D 的渲染能力对象
          */
-        virtual const Matrix4 &getTransform(
-            TransformState state) const override;
+        virtual RenderCapabilitiesPtr createRendererCapabilities() const override;
 
         /**
          * @brief 获取透视投影矩阵
@@ -140,19 +123,51 @@ namespace Tiny3D
             FrustumBoundPtr bound) override;
 
         /**
-         * @brief 设置裁剪模式
-         * @param [in] mode : 裁剪模式
-         * @return 调用成功返回 T3D_OK
+         * @brief 创建混合状态对象
+         */
+        virtual BlendStatePtr createBlendState() override;
+
+        /**
+         * @brief 创建深度缓冲和模板缓冲状态对象
          */
-        virtual TResult setCullingMode(CullingMode mode) override;
+        virtual DepthStencilStatePtr createDepthStencilState() override;
 
         /**
-         * @brief 设置渲染模式
-         * @param [in] mode : 渲染模式
-         * @return 成功返回 T3D_OK
-         * @see enum PolygonMode
+         * @brief 创建光栅化状态对象
          */
-        virtual TResult setPolygonMode(PolygonMode mode) override;
+        virtual RasterizerStatePtr createRasterizerState() override;
+
+        /**
+         * @brief 创建纹理采样状态对象
+         */
+        virtual TResult createSamplerStates(size_t numOfStates, 
+            SamplerStatePtr *states) override;
+
+        /**
+         * @brief 设置混合状态
+         * @remarks 只支持 src * a + dst * (1 - a) 这种透明混合
+         */
+        virtual TResult setBlendState(BlendStatePtr state) override;
+
+        /**
+         * @brief 设置深度缓冲和模板缓冲状态
+         * @remarks 软件光栅化没有深度缓冲，只记录状态
+         */
+        virtual TResult setDepthStencilState(
+            DepthStencilStatePtr state) override;
+
+        /**
+         * @brief 设置光栅化状态，包括消隐面剔除模式和多边形渲染模式
+         */
+        virtual TResult setRasterizerState(RasterizerStatePtr state) override;
+
+        /**
+         * @brief 设置纹理采样状态
+         * @remarks 纹理寻址和过滤方式由纹理单元的采样器决定，这里只记录状态
+         */
+        virtual TResult setSamplerStates(size_t numOfStates,
+            SamplerStatePtr *states,
+            ShaderType shader = ShaderType::PIXEL_SHADER) override;
 
         /**
          * @brief 设置渲染视口
@@ -161,43 +176,53 @@ namespace Tiny3D
         virtual TResult setViewport(ViewportPtr viewport) override;
 
         /**
-         * @brief 设置渲染材质
+         * @brief 绑定 GPU 程序
+         * @remarks 软件光栅化使用固定的变换和着色流程，这里只记录状态
+         */
+        virtual TResult bindGPUProgram(GPUProgramPtr program) override;
+
+        /**
+         * @brief 绑定 GPU 常量缓冲区
+         * @remarks 软件光栅化直接读取变换矩阵，这里只记录状态
+         */
+        virtual TResult bindGPUConstantBuffer(size_t slot,
+            HardwareConstantBufferPtr buffer) override;
+
+        /**
+         * @brief 绑定纹理
+         * @param [in] unit : 纹理单元，为空表示不使用纹理
          * @return 调用成功返回 T3D_OK
+         * @remarks 第一次绑定某个纹理或者纹理像素被改写之后会重新生成其 
+         *      mipmaps 链，并缓存在纹理的像素缓冲区上
          */
-        virtual TResult setMaterial(MaterialPtr material) override;
+        virtual TResult bindTexture(TextureUnitPtr unit) override;
 
         /**
-         * @brief 绘制顶点数组
+         * @brief 渲染顶点数组对象
          * @param [in] vao : 顶点数组对象
          * @return 调动成功返回 T3D_OK
          */
-        virtual TResult drawVertexArray(VertexArrayObjectPtr vao) override;
+        virtual TResult renderObject(VertexArrayObjectPtr vao) override;
 
         /**
-         * @brief 绘制顶点列表
-         * @param [in] priType : 图元类型
-         * @param [in] decl : 顶点声明
-         * @param [in] vbo : 顶点缓冲
-         * @param [in] startIdx : 顶点缓冲区的起始位置
-         * @param [in] priCount : 图元数量
-         * @return 调用成功返回 T3D_OK
+         * @brief 是否支持实例化渲染
+         * @return 软件光栅化逐个实例变换顶点，总是返回 true
          */
-        virtual TResult drawVertexList(PrimitiveType priType,
-            VertexDeclarationPtr decl, HardwareVertexBufferPtr vbo) override;
+        virtual bool isInstancingSupported() const override;
 
         /**
-        * @brief 绘制索引列表
-        * @param [in] priType : 图元类型
-        * @param [in] decl : 顶点声明
-        * @param [in] vbo : 顶点缓冲
-        * @param [in] ibo : 索引缓冲
-        * @param [in] startIdx : 顶点索引起始位置偏移
-        * @param [in] priCount : 图元数量
-        * @return 调用成功返回 T3D_OK
-        */
-        virtual TResult drawIndexList(PrimitiveType priType,
-            VertexDeclarationPtr decl, HardwareVertexBufferPtr vbo, 
-            HardwareIndexBufferPtr ibo) override;
+         * @brief 实例化渲染顶点数组对象
+         * @param [in] vao : 顶点数组对象
+         * @param [in] instances : 实例数据缓冲区，每个实例是一个 Matrix4
+         * @param [in] startInstance : 第一个实例在实例缓冲区中的索引
+         * @param [in] instanceCount : 实例数量
+         * @return 调用成功返回 T3D_OK
+         * @remarks 没有实例数据流，每个实例设置一次世界变换后按照 
+         *          renderObject 的流程渲染
+         */
+        virtual TResult renderObjectInstanced(VertexArrayObjectPtr vao,
+            HardwareVertexBufferPtr instances, size_t startInstance,
+            size_t instanceCount) override;
 
     protected:
         /**
@@ -213,14 +238,14 @@ namespace Tiny3D
             Vector4     pos;
             Vector4     normal;
             Vector2     uv;
-            ColorRGB    diffuse;
+            ColorARGB   diffuse;
             ColorRGB    specular;
 
             Vertex()
                 : pos(Vector4::ZERO)
                 , normal(Vector4::ZERO)
                 , uv(Vector2::ZERO)
-                , diffuse(ColorRGB::WHITE)
+                , diffuse(ColorARGB::WHITE)
                 , specular(ColorRGB::WHITE)
             {}
         };
@@ -253,16 +278,177 @@ namespace Tiny3D
         TResult rasterIndexPointList(Vertex *vertices, size_t vertexCount,
             uint8_t *indices, size_t indexCount, bool is16Bits);
 
+        /**
+         * @brief 裁剪空间下的裁剪平面标记，同时用作顶点的区域码 (outcode)
+         * @remarks 齐次裁剪空间中，顶点在视锥体内需满足：
+         *      -w <= x <= w, -w <= y <= w, 0 <= z <= w
+         *      保护带 (Guard Band) 平面则是把 x 和 y 的范围放大
+         *      GUARD_BAND_SCALE 倍
+         */
+        enum ClipPlane : uint32_t
+        {
+            E_CLIP_LEFT = (1 << 0),         /**< 左平面 */
+            E_CLIP_RIGHT = (1 << 1),        /**< 右平面 */
+            E_CLIP_BOTTOM = (1 << 2),       /**< 下平面 */
+            E_CLIP_TOP = (1 << 3),          /**< 上平面 */
+            E_CLIP_NEAR = (1 << 4),         /**< 近平面 */
+            E_CLIP_FAR = (1 << 5),          /**< 远平面 */
+            E_CLIP_GB_LEFT = (1 << 6),      /**< 保护带左平面 */
+            E_CLIP_GB_RIGHT = (1 << 7),     /**< 保护带右平面 */
+            E_CLIP_GB_BOTTOM = (1 << 8),    /**< 保护带下平面 */
+            E_CLIP_GB_TOP = (1 << 9),       /**< 保护带上平面 */
+
+            E_CLIP_FRUSTUM_MASK = 0x003F,   /**< 视锥体六个平面 */
+            E_CLIP_TRIANGLE_MASK = 0x03F0,  /**< 三角形需要裁剪的平面 */
+        };
+
+        /** 三角形依次经过近、远和四个保护带平面裁剪，每个平面最多增加一个顶点 */
+        static const size_t MAX_CLIP_VERTICES = 3 + 6;
+
+        /** 保护带相对视口的放大倍数 */
+        static const Real GUARD_BAND_SCALE;
+
+        /**
+         * @brief 裁剪用的临时顶点缓冲，每个线程一份，避免裁剪时分配内存
+         */
+        struct ClipScratch
+        {
+            Vertex  vertices[2][MAX_CLIP_VERTICES];    /**< 交替读写的两个多边形 */
+        };
+
+        /**
+         * @brief 获取当前线程的裁剪临时缓冲
+         */
+        static ClipScratch &getClipScratch();
+
+        /**
+         * @brief 根据索引类型获取第 i 个顶点索引，没有索引时直接返回 i
+         */
+        size_t fetchIndex(const uint8_t *indices, size_t i,
+            bool is16Bits) const;
+
+        /**
+         * @brief 计算顶点在齐次裁剪空间中的区域码
+         * @param [in] pos : 裁剪空间中的顶点位置
+         * @return 返回由 ClipPlane 组合而成的区域码
+         */
+        uint32_t computeClipCode(const Vector4 &pos) const;
+
+        /**
+         * @brief 计算顶点到裁剪平面的有向距离，大于等于0表示在平面内侧
+         */
+        Real clipDistance(uint32_t plane, const Vector4 &pos) const;
+
+        /**
+         * @brief 对两个顶点所有属性做线性插值
+         */
+        void interpolateVertex(const Vertex &v0, const Vertex &v1, Real t,
+            Vertex &v) const;
+
+        /**
+         * @brief 处理线段列表或者线段带
+         * @param [in] vertices : 裁剪空间的顶点数据
+         * @param [in] vertexCount : 顶点数量
+         * @param [in] indices : 索引数据，为空表示不使用索引
+         * @param [in] indexCount : 索引数量
+         * @param [in] is16Bits : 是否16位索引
+         * @param [in] isStrip : 是否线段带
+         * @return 调用成功返回 T3D_OK
+         */
+        TResult processLineList(Vertex *vertices, size_t vertexCount,
+            uint8_t *indices, size_t indexCount, bool is16Bits, bool isStrip);
+
+        /**
+         * @brief 处理三角形列表、三角形带或者三角形扇
+         * @param [in] vertices : 裁剪空间的顶点数据
+         * @param [in] vertexCount : 顶点数量
+         * @param [in] indices : 索引数据，为空表示不使用索引
+         * @param [in] indexCount : 索引数量
+         * @param [in] is16Bits : 是否16位索引
+         * @param [in] primitive : 图元类型
+         * @return 调用成功返回 T3D_OK
+         */
+        TResult processTriangleList(Vertex *vertices, size_t vertexCount,
+            uint8_t *indices, size_t indexCount, bool is16Bits,
+            PrimitiveType primitive);
+
+        /**
+         * @brief 在齐次裁剪空间中用参数化方法裁剪线段
+         * @param [in] v0 : 线段起点
+         * @param [in] v1 : 线段终点
+         * @param [out] dst0 : 裁剪后的起点
+         * @param [out] dst1 : 裁剪后的终点
+         * @return 线段完全在视锥体外返回 false
+         */
+        bool clipLine(const Vertex &v0, const Vertex &v1, Vertex &dst0,
+            Vertex &dst1) const;
+
+        /**
+         * @brief 在齐次裁剪空间中用 Sutherland-Hodgman 算法裁剪三角形
+         * @param [in] v0 : 三角形顶点
+         * @param [in] v1 : 三角形顶点
+         * @param [in] v2 : 三角形顶点
+         * @param [out] dstVerts : 裁剪后的凸多边形顶点，指向线程临时缓冲
+         * @param [out] dstVertCount : 裁剪后的顶点数量，0表示被完全裁掉
+         * @return 调用成功返回 T3D_OK
+         * @remarks 只跨越屏幕边缘但仍在保护带内的三角形不做裁剪，直接交由
+         *      光栅化阶段按视口范围剪裁，只有跨越近、远平面或者保护带的三角形
+         *      才需要真正裁剪。
+         */
+        TResult clipTriangle(const Vertex &v0, const Vertex &v1,
+            const Vertex &v2, Vertex *&dstVerts, size_t &dstVertCount) const;
+
+        /**
+         * @brief 用一个裁剪平面裁剪凸多边形
+         * @return 返回裁剪后的顶点数量
+         */
+        size_t clipPolygon(uint32_t plane, const Vertex *srcVerts,
+            size_t srcVertCount, Vertex *dstVerts) const;
+
+        /**
+         * @brief 透视除法和视口变换，变换后 pos.w 保存 1/w
+         */
+        void projectVertex(Vertex &vertex, const Matrix4 &matViewport) const;
+
+        /**
+         * @brief 光栅化已经裁剪好的线段
+         */
+        TResult rasterLine(const Vertex &v0, const Vertex &v1);
+
+        /**
+         * @brief 光栅化已经裁剪好的凸多边形
+         */
+        TResult rasterPolygon(Vertex *vertices, size_t vertexCount);
+
+        /**
+         * @brief 光栅化屏幕空间的三角形，像素范围限制在视口内
+         * @remarks 以 2x2 像素块为单位做透视校正插值和纹理采样
+         */
+        TResult rasterTriangle(const Vertex &v0, const Vertex &v1,
+            const Vertex &v2);
+
+        /**
+         * @brief 把缓存的两行像素按连续区间写入帧缓冲
+         * @param [in] left : 缓存区间左边的屏幕坐标
+         * @param [in] top : 第一行的屏幕坐标
+         * @param [in] spanWidth : 缓存区间的宽度
+         */
+        void flushSpans(int32_t left, int32_t top, size_t spanWidth);
+
     protected:
         R3DFramebufferPtr           mFramebuffer;
 
-        R3DRenderWindowPtr          mRenderWindow;          /**< 渲染窗口 */
         HardwareBufferManagerPtr    mHardwareBufferMgr;     /**< 硬件缓冲管理器 */
         R3DHardwareBufferManagerPtr mR3DHardwareBufferMgr;  /**< 渲染器相关的缓冲区管理对象 */
 
-        FrustumBoundPtr             mFrustumBound;          /**< 视锥包围对象 */
+        R3DTextureSamplerPtr        mTexture;               /**< 当前绑定的纹理 */
+        bool                        mAlphaBlend;            /**< 是否透明混合 */
+        CullingMode                 mCullingMode;           /**< 消隐面剔除模式 */
+        PolygonMode                 mPolygonMode;           /**< 多边形渲染模式 */
+
+        TArray<uint32_t>            mSpanColors;            /**< 两行像素的颜色缓存 */
+        TArray<uint8_t>             mSpanMask;              /**< 两行像素的覆盖标记 */
 
-        Matrix4 mMatrices[MAX];    /**< 各种变换矩阵 */
         Matrix4 mMV;                    /**< 模型变换和视图变换的连接结果 */
         Matrix4 mMVP;                   /**< 模型矩阵、视图变换和投影变换连接结果 */
     };
@@ -0,0 +1,102 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+
+#ifndef __T3D_R3D_SHADER_H__
+#define __T3D_R3D_SHADER_H__
+
+
+#include "T3DR3DPrerequisites.h"
+
+
+namespace Tiny3D
+{
+    /**
+     * @class   R3DShader
+     * @brief   Reference3D 着色器
+     * @remarks 软件光栅化使用固定的变换和着色流程，这里只是占位，
+     *      让材质里引用的着色器能正常加载、编译
+     */
+    class R3DShader : public Shader
+    {
+        T3D_DECLARE_CLASS();
+
+    public:
+        /**
+         * @fn  static R3DShaderPtr R3DShader::create(ShaderType shaderType,
+         *      const String &name);
+         * @brief   创建 R3DShader 对象
+         * @param [in]  shaderType  : 着色器类型.
+         * @param [in]  name        : 着色器名称.
+         * @return  返回一个新建的着色器对象.
+         */
+        static R3DShaderPtr create(ShaderType shaderType, const String &name);
+
+        /**
+         * @fn  virtual R3DShader::~R3DShader();
+         * @brief   析构函数
+         */
+        virtual ~R3DShader();
+
+        /**
+         * @fn  virtual ShaderType R3DShader::getShaderType() const override;
+         * @brief   重写 Shader::getShaderType() 接口
+         */
+        virtual ShaderType getShaderType() const override;
+
+        /**
+         * @fn  virtual TResult R3DShader::compile(bool force = false) override;
+         * @brief   重写 Shader::compile() 接口
+         */
+        virtual TResult compile(bool force = false) override;
+
+        /**
+         * @fn  virtual bool R3DShader::hasCompiled() const override;
+         * @brief   重写 Shader::hasCompiled() 接口
+         */
+        virtual bool hasCompiled() const override;
+
+    protected:
+        /**
+         * @fn  R3DShader::R3DShader(ShaderType shaderType, const String &name);
+         * @brief   构造函数
+         */
+        R3DShader(ShaderType shaderType, const String &name);
+
+        /**
+         * @fn  virtual TResult R3DShader::load() override;
+         * @brief   重写 Resource::load() 接口
+         */
+        virtual TResult load() override;
+
+        /**
+         * @fn  virtual ResourcePtr R3DShader::clone() const override;
+         * @brief   重写 Resource::clone() 接口
+         */
+        virtual ResourcePtr clone() const override;
+
+    protected:
+        ShaderType  mShaderType;    /**< 着色器类型 */
+        bool        mHasCompiled;   /**< 是否编译 */
+    };
+}
+
+
+#endif  /*__T3D_R3D_SHADER_H__*/
@@ -0,0 +1,92 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+
+#ifndef __T3D_R3D_STATE_H__
+#define __T3D_R3D_STATE_H__
+
+
+#include "T3DR3DPrerequisites.h"
+
+
+namespace Tiny3D
+{
+    /**
+     * @brief Reference3D 渲染器相关的混合状态
+     * @remarks 软件光栅化直接读取基类的状态值，不需要生成底层状态对象
+     */
+    class R3DBlendState : public BlendState
+    {
+    public:
+        static R3DBlendStatePtr create();
+
+        virtual ~R3DBlendState();
+
+    protected:
+        R3DBlendState();
+    };
+
+    /**
+     * @brief Reference3D 渲染器相关的深度缓冲和模板缓冲状态
+     * @remarks 软件光栅化直接读取基类的状态值，不需要生成底层状态对象
+     */
+    class R3DDepthStencilState : public DepthStencilState
+    {
+    public:
+        static R3DDepthStencilStatePtr create();
+
+        virtual ~R3DDepthStencilState();
+
+    protected:
+        R3DDepthStencilState();
+    };
+
+    /**
+     * @brief Reference3D 渲染器相关的光栅化状态
+     * @remarks 软件光栅化直接读取基类的状态值，不需要生成底层状态对象
+     */
+    class R3DRasterizerState : public RasterizerState
+    {
+    public:
+        static R3DRasterizerStatePtr create();
+
+        virtual ~R3DRasterizerState();
+
+    protected:
+        R3DRasterizerState();
+    };
+
+    /**
+     * @brief Reference3D 渲染器相关的纹理采样状态
+     * @remarks 软件光栅化直接读取基类的状态值，不需要生成底层状态对象
+     */
+    class R3DSamplerState : public SamplerState
+    {
+    public:
+        static R3DSamplerStatePtr create();
+
+        virtual ~R3DSamplerState();
+
+    protected:
+        R3DSamplerState();
+    };
+}
+
+#endif  /*__T3D_R3D_STATE_H__*/
@@ -0,0 +1,144 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2019  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#ifndef __T3D_R3D_TEXTURE_SAMPLER_H__
+#define __T3D_R3D_TEXTURE_SAMPLER_H__
+
+
+#include "T3DR3DPrerequisites.h"
+
+
+namespace Tiny3D
+{
+    /**
+     * @brief 软件光栅化使用的纹理采样器
+     * @remarks 从像素缓冲区生成统一的 A8R8G8B8 格式 mipmaps 链，
+     *      支持点采样、双线性和三线性过滤
+     */
+    class R3DTextureSampler : public Object
+    {
+    public:
+        /**
+         * @brief 创建纹理采样器，并生成完整的 mipmaps 链
+         * @param [in] pbo : 纹理的像素缓冲区
+         * @return 像素格式不支持时返回 nullptr
+         */
+        static R3DTextureSamplerPtr create(HardwarePixelBufferPtr pbo);
+
+        /**
+         * @brief 析构函数
+         */
+        virtual ~R3DTextureSampler();
+
+        /**
+         * @brief 从纹理单元的采样器读取过滤方式和寻址方式
+         * @param [in] sampler : 采样器对象，为空时使用默认设置
+         */
+        void setSampler(SamplerPtr sampler);
+
+        /**
+         * @brief 对 2x2 像素块采样
+         * @param [in] u : 4个像素的纹理坐标 u，依次为左上、右上、左下、右下
+         * @param [in] v : 4个像素的纹理坐标 v，顺序同 u
+         * @param [out] colors : 4个像素的采样结果
+         * @remarks mipmaps 级别由像素块内纹理坐标的屏幕空间差分计算
+         */
+        void sampleQuad(const Real *u, const Real *v, ColorARGB *colors) const;
+
+        /**
+         * @brief 按照指定的 mipmaps 级别采样
+         * @param [in] u : 纹理坐标 u
+         * @param [in] v : 纹理坐标 v
+         * @param [in] lod : mipmaps 级别，小于等于0时使用放大过滤
+         * @return 返回采样得到的颜色
+         */
+        ColorARGB sample(Real u, Real v, Real lod) const;
+
+        /**
+         * @brief 获取 mipmaps 级别数量
+         */
+        size_t getMipmapCount() const { return mMipmaps.size(); }
+
+        /**
+         * @brief 获取生成采样器时像素缓冲区的版本号
+         */
+        uint32_t getVersion() const { return mVersion; }
+
+    protected:
+        /**
+         * @brief 构造函数
+         */
+        R3DTextureSampler();
+
+        /**
+         * @brief 初始化，转换像素格式并生成 mipmaps
+         */
+        TResult init(HardwarePixelBufferPtr pbo);
+
+        /**
+         * @brief 把像素缓冲区转换成 A8R8G8B8 格式作为第0级
+         */
+        TResult loadLevel0(R3DHardwarePixelBufferPtr pbo);
+
+        /**
+         * @brief 用 2x2 盒式过滤逐级缩小到 1x1
+         */
+        void generateMipmaps();
+
+        /**
+         * @brief 一级 mipmap
+         */
+        struct MipLevel
+        {
+            size_t              width;
+            size_t              height;
+            TArray<uint32_t>    texels;
+        };
+
+        /**
+         * @brief 按照寻址方式把纹素坐标变换到纹理范围内
+         */
+        size_t address(int32_t coord, size_t size,
+            TextureAddressMode mode) const;
+
+        /**
+         * @brief 在一级 mipmap 上采样，结果按 B、G、R、A 顺序写入 bgra
+         */
+        void sampleLevel(size_t level, FilterOptions filter, Real u, Real v,
+            Real *bgra) const;
+
+    protected:
+        typedef TArray<MipLevel>    MipLevels;
+
+        MipLevels           mMipmaps;       /**< mipmaps 链，第0级为原图 */
+
+        FilterOptions       mMinFilter;     /**< 缩小过滤方式 */
+        FilterOptions       mMagFilter;     /**< 放大过滤方式 */
+        FilterOptions       mMipFilter;     /**< mipmaps 级别之间的过滤方式 */
+
+        TextureAddressMode  mAddressU;      /**< u 方向寻址方式 */
+        TextureAddressMode  mAddressV;      /**< v 方向寻址方式 */
+
+        uint32_t            mVersion;       /**< 生成时像素缓冲区的版本号 */
+    };
+}
+
+
+#endif  /*__T3D_R3D_TEXTURE_SAMPLER_H__*/
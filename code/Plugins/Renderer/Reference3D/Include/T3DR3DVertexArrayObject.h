@@ -57,12 +57,12 @@ namespace Tiny3D
          * @brief 设置绘制图元类型，实现基类接口
          */
         virtual TResult setPrimitiveType(
-            Renderer::PrimitiveType priType) override;
+            RenderContext::PrimitiveType priType) override;
 
         /**
          * @brief 获取渲染图元类型，实现基类接口
          */
-        virtual Renderer::PrimitiveType getPrimitiveType() const override;
+        virtual RenderContext::PrimitiveType getPrimitiveType() const override;
 
         /**
          * @brief 设置顶点声明，实现基类接口
@@ -115,7 +115,7 @@ namespace Tiny3D
         typedef VBOList::iterator                   VBOListItr;
         typedef VBOList::const_iterator             VBOListConstItr;
 
-        Renderer::PrimitiveType mPrimitiveType; /**< 渲染图元 */
+        RenderContext::PrimitiveType mPrimitiveType; /**< 渲染图元 */
 
         VertexDeclarationPtr    mDecl;          /**< 顶点声明对象 */
         VBOList                 mVBOList;       /**< 顶点缓冲区对象集合 */
@@ -36,7 +36,7 @@ namespace Tiny3D
         /**
          * @brief 创建 Reference3D 渲染器相关的顶点声明对象
          */
-        static R3DVertexDeclarationPtr create(ShaderPtr vertexShader);
+        static R3DVertexDeclarationPtr create();
 
         /**
          * @brief 析构函数
@@ -47,7 +47,7 @@ namespace Tiny3D
         /**
          * @brief 构造函数
          */
-        R3DVertexDeclaration(ShaderPtr vertexShader);
+        R3DVertexDeclaration();
     };
 }
 
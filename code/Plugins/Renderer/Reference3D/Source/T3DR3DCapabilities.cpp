@@ -0,0 +1,85 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+
+#include "T3DR3DCapabilities.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    T3D_IMPLEMENT_CLASS_1(R3DCapabilities, RenderCapabilities);
+
+    //--------------------------------------------------------------------------
+
+    R3DCapabilitiesPtr R3DCapabilities::create()
+    {
+        R3DCapabilitiesPtr cap = new R3DCapabilities();
+        if (cap != nullptr && cap->init() == T3D_OK)
+        {
+            cap->release();
+        }
+        else
+        {
+            cap = nullptr;
+        }
+        return cap;
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DCapabilities::R3DCapabilities()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DCapabilities::~R3DCapabilities()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DCapabilities::init()
+    {
+        TResult ret = T3D_OK;
+
+        // 软件光栅化，没有驱动
+        mDeviceName = RenderContext::REFERENCE3D;
+        mRendererName = RenderContext::REFERENCE3D;
+
+        // 固定管线，单通道单纹理
+        mNumTextureUnits = 1;
+        mNumVertexTextureUnits = 0;
+        mNumMultiRenderTargets = 1;
+        mMaxPointSize = 1.0f;
+        mNPOTLimited = false;
+
+        // 能力值
+        setCapability(Capabilities::INDEX_32BITS);
+        setCapability(Capabilities::NON_POWER_OF_2_TEXTURES);
+        setCapability(Capabilities::HWRENDER_TO_TEXTURE);
+
+        return ret;
+    }
+}
@@ -43,7 +43,8 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     R3DFramebuffer::R3DFramebuffer()
-        : mFramebuffer(nullptr)
+        : mRenderTarget(nullptr)
+        , mFramebuffer(nullptr)
         , mFramebufferSize(0)
         , mWidth(0)
         , mHeight(0)
@@ -67,6 +68,8 @@ namespace Tiny3D
     {
         TResult ret = T3D_OK;
 
+        mRenderTarget = target;
+
         switch (target->getType())
         {
         case RenderTarget::E_RT_WINDOW:
@@ -83,6 +86,17 @@ namespace Tiny3D
             }
             break;
         case RenderTarget::E_RT_TEXTURE:
+            {
+                RenderTexturePtr texture
+                    = smart_pointer_cast<RenderTexture>(target);
+                mFramebuffer = texture->getFramebuffer();
+                mFramebufferSize = texture->getFramebufferSize();
+                mWidth = texture->getWidth();
+                mHeight = texture->getHeight();
+                mColorDepth = texture->getColorDepth();
+                mPitch = texture->getPitch();
+                mBytesPerPixel = (mColorDepth >> 3);
+            }
             break;
         default:
             ret = T3D_ERR_R3D_INVALID_TARGET;
@@ -99,22 +113,39 @@ namespace Tiny3D
     {
         TResult ret = T3D_OK;
 
-        if (count == 0 && rects == nullptr)
-        {
-            uint8_t *fb = nullptr;
-            Color4 clr;
-            clr.from(color);
+        Color4 clr;
+        clr.from(color);
 
-            size_t x = 0, y = 0;
+        // 纯色填充不需要混合，alpha 通道与 fillColor 保持一致写 0xFF
+        uint32_t value = clr.A8R8G8B8() | Color4::RGB_ALPHA_MASK;
 
-            for (y = 0; y < mHeight; ++y)
+        if (count == 0 && rects == nullptr)
+        {
+            if (mBytesPerPixel == 4 && mPitch == mWidth * 4)
+            {
+                // 行之间没有空隙，整个帧缓冲当成一段连续像素
+                fillSpan(mFramebuffer, value, mWidth * mHeight);
+            }
+            else
             {
-                fb = mFramebuffer + mPitch * y;
+                uint8_t *fb = nullptr;
+                size_t x = 0, y = 0;
 
-                for (x = 0; x < mWidth; ++x)
+                for (y = 0; y < mHeight; ++y)
                 {
-                    fillColor(fb, clr, false);
-                    fb += mBytesPerPixel;
+                    fb = mFramebuffer + mPitch * y;
+
+                    if (mBytesPerPixel == 4)
+                    {
+                        fillSpan(fb, value, mWidth);
+                        continue;
+                    }
+
+                    for (x = 0; x < mWidth; ++x)
+                    {
+                        fillColor(fb, clr, false);
+                        fb += mBytesPerPixel;
+                    }
                 }
             }
         }
@@ -125,17 +156,32 @@ namespace Tiny3D
             for (i = 0; i < count; ++i)
             {
                 const Rect &rect = rects[i];
-                uint8_t *fb = nullptr;
-                Color4 clr;
-                clr.from(color);
 
+                if (rect.left >= mWidth || rect.top >= mHeight
+                    || rect.right < rect.left || rect.bottom < rect.top)
+                {
+                    continue;
+                }
+
+                // 矩形右下角是闭区间，超出帧缓冲的部分截掉
+                size_t right = std::min(rect.right, mWidth - 1);
+                size_t bottom = std::min(rect.bottom, mHeight - 1);
+                size_t width = right - rect.left + 1;
+
+                uint8_t *fb = nullptr;
                 size_t x = 0, y = 0;
 
-                for (y = rect.top; y < rect.height(); ++y)
+                for (y = rect.top; y <= bottom; ++y)
                 {
                     fb = mFramebuffer + y * mPitch + rect.left * mBytesPerPixel;
 
-                    for (x = rect.left; x < rect.width(); ++x)
+                    if (mBytesPerPixel == 4)
+                    {
+                        fillSpan(fb, value, width);
+                        continue;
+                    }
+
+                    for (x = 0; x < width; ++x)
                     {
                         fillColor(fb, clr, false);
                         fb += mBytesPerPixel;
@@ -334,15 +380,378 @@ namespace Tiny3D
         }
         else
         {
-            uint8_t srcB = *fb;
-            uint8_t srcG = *fb;
-            uint8_t srcR = *fb;
-            fb[0] = color.alpha() * color.blue() + (1 - color.alpha() * srcB);
-            fb[1] = color.alpha() * color.green() + (1 - color.alpha() * srcG);
-            fb[2] = color.alpha() * color.red() + (1 - color.alpha() * srcR);
+            // dst = src * a + dst * (1 - a)，8位定点计算，结果四舍五入
+            uint32_t a = color.alpha();
+            uint32_t invA = 255 - a;
+            uint32_t b = color.blue() * a + fb[0] * invA + 128;
+            uint32_t g = color.green() * a + fb[1] * invA + 128;
+            uint32_t r = color.red() * a + fb[2] * invA + 128;
+            fb[0] = (uint8_t)((b + (b >> 8)) >> 8);
+            fb[1] = (uint8_t)((g + (g >> 8)) >> 8);
+            fb[2] = (uint8_t)((r + (r >> 8)) >> 8);
         }
         
         if (mBytesPerPixel == 4)
             fb[3] = 0xFF;
     }
+
+    //--------------------------------------------------------------------------
+
+    void R3DFramebuffer::fillSpan(uint8_t *fb, uint32_t color, size_t count)
+    {
+        uint32_t *dst = (uint32_t *)fb;
+        size_t i = 0;
+
+#if defined (T3D_R3D_AVX2)
+        const __m256i value = _mm256_set1_epi32((int32_t)color);
+
+        for (; i + 16 <= count; i += 16)
+        {
+            _mm256_storeu_si256((__m256i *)(dst + i), value);
+            _mm256_storeu_si256((__m256i *)(dst + i + 8), value);
+        }
+#elif defined (T3D_R3D_SSE2)
+        const __m128i value = _mm_set1_epi32((int32_t)color);
+
+        for (; i + 16 <= count; i += 16)
+        {
+            _mm_storeu_si128((__m128i *)(dst + i), value);
+            _mm_storeu_si128((__m128i *)(dst + i + 4), value);
+            _mm_storeu_si128((__m128i *)(dst + i + 8), value);
+            _mm_storeu_si128((__m128i *)(dst + i + 12), value);
+        }
+#endif
+
+        for (; i < count; ++i)
+        {
+            dst[i] = color;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    uint32_t R3DFramebuffer::toPremultiplied(const ColorARGB &color)
+    {
+        Real a = std::min(std::max(color.alpha(), REAL_ZERO), REAL_ONE);
+        Real r = std::min(std::max(color.red(), REAL_ZERO), REAL_ONE) * a;
+        Real g = std::min(std::max(color.green(), REAL_ZERO), REAL_ONE) * a;
+        Real b = std::min(std::max(color.blue(), REAL_ZERO), REAL_ONE) * a;
+
+        const Real scale = Real(255.0);
+
+        return ((uint32_t)(a * scale + REAL_HALF) << 24)
+            | ((uint32_t)(r * scale + REAL_HALF) << 16)
+            | ((uint32_t)(g * scale + REAL_HALF) << 8)
+            | (uint32_t)(b * scale + REAL_HALF);
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DFramebuffer::writeSpan(const Point &start,
+        const uint32_t *colors, size_t count)
+    {
+        if (start.y >= mHeight || start.x >= mWidth)
+        {
+            return T3D_OK;
+        }
+
+        count = std::min(count, mWidth - start.x);
+        uint8_t *fb = mFramebuffer + start.y * mPitch 
+            + start.x * mBytesPerPixel;
+
+        if (mBytesPerPixel == 4)
+        {
+            memcpy(fb, colors, count * sizeof(uint32_t));
+        }
+        else
+        {
+            size_t i = 0;
+
+            for (i = 0; i < count; ++i)
+            {
+                fb[0] = (uint8_t)(colors[i] & 0xFF);
+                fb[1] = (uint8_t)((colors[i] >> 8) & 0xFF);
+                fb[2] = (uint8_t)((colors[i] >> 16) & 0xFF);
+                fb += mBytesPerPixel;
+            }
+        }
+
+        return T3D_OK;
+    }
+
+    //--------------------------------------------------------------------------
+
+#if defined (T3D_R3D_SSE2)
+    /**
+     * @brief 预乘透明度混合 4 个像素：dst = src + dst * (255 - src.a) / 255
+     */
+    static inline __m128i blendPremultiplied4(__m128i src, __m128i dst)
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i mask = _mm_set1_epi16(255);
+        const __m128i bias = _mm_set1_epi16(128);
+
+        // 展开成 16 位，每个像素的 alpha 复制到 4 个通道
+        __m128i srcLo = _mm_unpacklo_epi8(src, zero);
+        __m128i srcHi = _mm_unpackhi_epi8(src, zero);
+        __m128i invLo = _mm_sub_epi16(mask, _mm_shufflehi_epi16(
+            _mm_shufflelo_epi16(srcLo, _MM_SHUFFLE(3, 3, 3, 3)),
+            _MM_SHUFFLE(3, 3, 3, 3)));
+        __m128i invHi = _mm_sub_epi16(mask, _mm_shufflehi_epi16(
+            _mm_shufflelo_epi16(srcHi, _MM_SHUFFLE(3, 3, 3, 3)),
+            _MM_SHUFFLE(3, 3, 3, 3)));
+
+        __m128i lo = _mm_add_epi16(
+            _mm_mullo_epi16(_mm_unpacklo_epi8(dst, zero), invLo), bias);
+        __m128i hi = _mm_add_epi16(
+            _mm_mullo_epi16(_mm_unpackhi_epi8(dst, zero), invHi), bias);
+
+        // x / 255 ≈ (x + (x >> 8)) >> 8
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, _mm_srli_epi16(lo, 8)), 8);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, _mm_srli_epi16(hi, 8)), 8);
+
+        return _mm_adds_epu8(_mm_packus_epi16(lo, hi), src);
+    }
+#endif
+
+#if defined (T3D_R3D_AVX2)
+    /**
+     * @brief 预乘透明度混合 8 个像素，算法同 blendPremultiplied4
+     */
+    static inline __m256i blendPremultiplied8(__m256i src, __m256i dst)
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i mask = _mm256_set1_epi16(255);
+        const __m256i bias = _mm256_set1_epi16(128);
+
+        __m256i srcLo = _mm256_unpacklo_epi8(src, zero);
+        __m256i srcHi = _mm256_unpackhi_epi8(src, zero);
+        __m256i invLo = _mm256_sub_epi16(mask, _mm256_shufflehi_epi16(
+            _mm256_shufflelo_epi16(srcLo, _MM_SHUFFLE(3, 3, 3, 3)),
+            _MM_SHUFFLE(3, 3, 3, 3)));
+        __m256i invHi = _mm256_sub_epi16(mask, _mm256_shufflehi_epi16(
+            _mm256_shufflelo_epi16(srcHi, _MM_SHUFFLE(3, 3, 3, 3)),
+            _MM_SHUFFLE(3, 3, 3, 3)));
+
+        __m256i lo = _mm256_add_epi16(
+            _mm256_mullo_epi16(_mm256_unpacklo_epi8(dst, zero), invLo), bias);
+        __m256i hi = _mm256_add_epi16(
+            _mm256_mullo_epi16(_mm256_unpackhi_epi8(dst, zero), invHi), bias);
+
+        lo = _mm256_srli_epi16(_mm256_add_epi16(lo, _mm256_srli_epi16(lo, 8)), 8);
+        hi = _mm256_srli_epi16(_mm256_add_epi16(hi, _mm256_srli_epi16(hi, 8)), 8);
+
+        return _mm256_adds_epu8(_mm256_packus_epi16(lo, hi), src);
+    }
+#endif
+
+    TResult R3DFramebuffer::blendSpan(const Point &start,
+        const uint32_t *colors, size_t count)
+    {
+        if (start.y >= mHeight || start.x >= mWidth)
+        {
+            return T3D_OK;
+        }
+
+        count = std::min(count, mWidth - start.x);
+        uint8_t *fb = mFramebuffer + start.y * mPitch
+            + start.x * mBytesPerPixel;
+
+        if (mBytesPerPixel == 4)
+        {
+            blendSpan32((uint32_t *)fb, colors, count);
+        }
+        else
+        {
+            blendPixels(fb, colors, count, mBytesPerPixel);
+        }
+
+        return T3D_OK;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void R3DFramebuffer::blendSpan32(uint32_t *dst, const uint32_t *colors,
+        size_t count)
+    {
+        size_t i = 0;
+
+#if defined (T3D_R3D_AVX2)
+        // 每次循环 16 个像素
+        for (; i + 16 <= count; i += 16)
+        {
+            __m256i s0 = _mm256_loadu_si256((const __m256i *)(colors + i));
+            __m256i s1 
+                = _mm256_loadu_si256((const __m256i *)(colors + i + 8));
+            __m256i d0 = _mm256_loadu_si256((const __m256i *)(dst + i));
+            __m256i d1 = _mm256_loadu_si256((const __m256i *)(dst + i + 8));
+            _mm256_storeu_si256((__m256i *)(dst + i),
+                blendPremultiplied8(s0, d0));
+            _mm256_storeu_si256((__m256i *)(dst + i + 8),
+                blendPremultiplied8(s1, d1));
+        }
+#endif
+
+#if defined (T3D_R3D_SSE2)
+        // 每次循环 8 个像素
+        for (; i + 8 <= count; i += 8)
+        {
+            __m128i s0 = _mm_loadu_si128((const __m128i *)(colors + i));
+            __m128i s1 = _mm_loadu_si128((const __m128i *)(colors + i + 4));
+            __m128i d0 = _mm_loadu_si128((const __m128i *)(dst + i));
+            __m128i d1 = _mm_loadu_si128((const __m128i *)(dst + i + 4));
+            _mm_storeu_si128((__m128i *)(dst + i),
+                blendPremultiplied4(s0, d0));
+            _mm_storeu_si128((__m128i *)(dst + i + 4),
+                blendPremultiplied4(s1, d1));
+        }
+#endif
+
+        // 剩下不足一组的像素逐个处理
+        blendPixels((uint8_t *)(dst + i), colors + i, count - i, 4);
+    }
+
+    //--------------------------------------------------------------------------
+
+    void R3DFramebuffer::blendPixels(uint8_t *fb, const uint32_t *colors,
+        size_t count, size_t bytesPerPixel)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < count; ++i)
+        {
+            uint32_t src = colors[i];
+            uint32_t invA = 255 - (src >> 24);
+            uint32_t channel = 0;
+
+            for (channel = 0; channel < bytesPerPixel; ++channel)
+            {
+                uint32_t s = (src >> (channel << 3)) & 0xFF;
+                uint32_t d = fb[channel] * invA + 128;
+                d = s + ((d + (d >> 8)) >> 8);
+                fb[channel] = (uint8_t)std::min(d, uint32_t(255));
+            }
+
+            fb += bytesPerPixel;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DFramebuffer::verifySpans()
+    {
+        // 覆盖 AVX2 、 SSE2 的整组和剩下的零头，首地址也不对齐
+        const size_t MAX_SPAN = 67;
+        const size_t MAX_OFFSET = 3;
+        const size_t ITERATIONS = 256;
+        const size_t SIZE = MAX_SPAN + MAX_OFFSET + 1;
+        const uint32_t GUARD = 0xDEADBEEF;
+
+        uint32_t colors[SIZE];
+        uint32_t expected[SIZE];
+        uint32_t actual[SIZE];
+
+        // 固定种子的线性同余随机数，每次运行结果都一样
+        uint32_t seed = 0x12345678;
+        auto next = [&seed]() -> uint32_t
+        {
+            seed = seed * 1664525u + 1013904223u;
+            return seed;
+        };
+
+        TResult ret = T3D_OK;
+        size_t n = 0, i = 0;
+
+        for (n = 0; n < ITERATIONS && ret == T3D_OK; ++n)
+        {
+            size_t count = next() % (MAX_SPAN + 1);
+            size_t offset = next() % (MAX_OFFSET + 1);
+
+            for (i = 0; i < SIZE; ++i)
+            {
+                uint32_t c = next();
+
+                // 全透明和不透明的像素走的是边界值，各占一部分
+                switch (next() & 7)
+                {
+                case 0:
+                    c &= 0x00FFFFFF;
+                    break;
+                case 1:
+                    c |= 0xFF000000;
+                    break;
+                default:
+                    break;
+                }
+
+                colors[i] = c;
+                expected[i] = actual[i] = next();
+            }
+
+            expected[offset + count] = actual[offset + count] = GUARD;
+
+            blendPixels((uint8_t *)(expected + offset), colors, count, 4);
+            blendSpan32(actual + offset, colors, count);
+
+            for (i = 0; i < SIZE; ++i)
+            {
+                if (expected[i] != actual[i])
+                {
+                    ret = T3D_ERR_R3D_SIMD_MISMATCH;
+                    T3D_LOG_ERROR(LOG_TAG_R3DRENDERER, "blendSpan mismatch at "
+                        "pixel %u of %u (offset %u) : %08X != %08X !",
+                        (uint32_t)i, (uint32_t)count, (uint32_t)offset,
+                        actual[i], expected[i]);
+                    break;
+                }
+            }
+
+            if (ret != T3D_OK)
+            {
+                break;
+            }
+
+            uint32_t color = next();
+
+            for (i = 0; i < SIZE; ++i)
+            {
+                expected[i] = actual[i] = GUARD;
+            }
+
+            for (i = 0; i < count; ++i)
+            {
+                expected[offset + i] = color;
+            }
+
+            fillSpan((uint8_t *)(actual + offset), color, count);
+
+            for (i = 0; i < SIZE; ++i)
+            {
+                if (expected[i] != actual[i])
+                {
+                    ret = T3D_ERR_R3D_SIMD_MISMATCH;
+                    T3D_LOG_ERROR(LOG_TAG_R3DRENDERER, "fillSpan mismatch at "
+                        "pixel %u of %u (offset %u) : %08X != %08X !",
+                        (uint32_t)i, (uint32_t)count, (uint32_t)offset,
+                        actual[i], expected[i]);
+                    break;
+                }
+            }
+        }
+
+        if (ret == T3D_OK)
+        {
+#if defined (T3D_R3D_AVX2)
+            const char *path = "AVX2";
+#elif defined (T3D_R3D_SSE2)
+            const char *path = "SSE2";
+#else
+            const char *path = "scalar";
+#endif
+            T3D_LOG_INFO(LOG_TAG_R3DRENDERER, "%s spans match the scalar "
+                "path on %u random spans", path, (uint32_t)ITERATIONS);
+        }
+
+        return ret;
+    }
 }
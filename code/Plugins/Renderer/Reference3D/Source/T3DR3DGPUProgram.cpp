@@ -0,0 +1,147 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+
+#include "T3DR3DGPUProgram.h"
+#include "T3DR3DError.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    T3D_IMPLEMENT_CLASS_1(R3DGPUProgram, GPUProgram);
+
+    //--------------------------------------------------------------------------
+
+    R3DGPUProgramPtr R3DGPUProgram::create(const String &name)
+    {
+        R3DGPUProgramPtr program = new R3DGPUProgram(name);
+        program->release();
+        return program;
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DGPUProgram::R3DGPUProgram(const String &name)
+        : GPUProgram(name)
+        , mHasLinked(false)
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DGPUProgram::~R3DGPUProgram()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DGPUProgram::link(bool force /* = false */)
+    {
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            if (mHasLinked && !force)
+                break;
+
+            for (auto i = mShaders.begin(); i != mShaders.end(); ++i)
+            {
+                ShaderPtr shader = *i;
+                if (shader == nullptr)
+                    continue;
+
+                if (!shader->hasCompiled())
+                {
+                    T3D_LOG_ERROR(LOG_TAG_R3DRENDERER,
+                        "Shader %s has not compiled !",
+                        shader->getName().c_str());
+                    ret = T3D_ERR_R3D_SHADER_NOT_COMPILED;
+                    break;
+                }
+            }
+
+            if (T3D_FAILED(ret))
+            {
+                break;
+            }
+
+            mHasLinked = true;
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool R3DGPUProgram::hasLinked() const
+    {
+        return mHasLinked;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DGPUProgram::load()
+    {
+        return T3D_OK;
+    }
+
+    //--------------------------------------------------------------------------
+
+    ResourcePtr R3DGPUProgram::clone() const
+    {
+        R3DGPUProgramPtr program = create(getName());
+
+        TResult ret = cloneProperties(program);
+        if (T3D_FAILED(ret))
+        {
+            program = nullptr;
+        }
+
+        return program;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DGPUProgram::cloneProperties(GPUProgramPtr newObj) const
+    {
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            ret = GPUProgram::cloneProperties(newObj);
+            if (T3D_FAILED(ret))
+            {
+                T3D_LOG_ERROR(LOG_TAG_R3DRENDERER,
+                    "Clone GPU program proterties failed !");
+                break;
+            }
+
+            R3DGPUProgramPtr program 
+                = smart_pointer_cast<R3DGPUProgram>(newObj);
+            program->mHasLinked = mHasLinked;
+        } while (0);
+
+        return ret;
+    }
+}
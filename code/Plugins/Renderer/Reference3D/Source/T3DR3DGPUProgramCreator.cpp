@@ -0,0 +1,79 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+
+#include "T3DR3DGPUProgramCreator.h"
+#include "T3DR3DShader.h"
+#include "T3DR3DGPUProgram.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    T3D_IMPLEMENT_CLASS_1(R3DShaderCreator, ShaderCreator);
+
+    //--------------------------------------------------------------------------
+
+    const char * const R3DShaderCreator::SHADER_TYPE = "R3DShader";
+
+    //--------------------------------------------------------------------------
+
+    String R3DShaderCreator::getType() const
+    {
+        return SHADER_TYPE;
+    }
+
+    //--------------------------------------------------------------------------
+
+    ShaderPtr R3DShaderCreator::createObject(int32_t argc, ...) const
+    {
+        va_list params;
+        va_start(params, argc);
+        ShaderType shaderType = va_arg(params, ShaderType);
+        String name = va_arg(params, char *);
+        va_end(params);
+
+        // 软件光栅化不使用着色器源码，忽略 content 参数
+        return R3DShader::create(shaderType, name);
+    }
+
+    //--------------------------------------------------------------------------
+
+    const char * const R3DGPUProgramCreator::GPUPROGRAM_TYPE = "R3DGPUProgram";
+
+    //--------------------------------------------------------------------------
+
+    String R3DGPUProgramCreator::getType() const
+    {
+        return GPUPROGRAM_TYPE;
+    }
+
+    //--------------------------------------------------------------------------
+
+    GPUProgramPtr R3DGPUProgramCreator::createObject(int32_t argc, ...) const
+    {
+        va_list params;
+        va_start(params, argc);
+        String name = va_arg(params, char *);
+        va_end(params);
+        return R3DGPUProgram::create(name);
+    }
+}
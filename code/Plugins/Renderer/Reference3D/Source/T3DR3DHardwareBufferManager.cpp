@@ -76,10 +76,10 @@ namespace Tiny3D
 
     HardwarePixelBufferPtr R3DHardwareBufferManager::createPixelBuffer(
         size_t width, size_t height, PixelFormat format, const void *pixels,
-        HardwareBuffer::Usage usage, uint32_t mode)
+        HardwareBuffer::Usage usage, uint32_t mode, size_t mipmaps)
     {
         return R3DHardwarePixelBuffer::create(width, height, format, pixels, 
-            usage, mode);
+            usage, mode, mipmaps);
     }
 
     //--------------------------------------------------------------------------
@@ -101,9 +101,8 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
-    VertexDeclarationPtr R3DHardwareBufferManager::createVertexDeclaration(
-        ShaderPtr vertexShader)
+    VertexDeclarationPtr R3DHardwareBufferManager::createVertexDeclaration()
     {
-        return R3DVertexDeclaration::create(vertexShader);
+        return R3DVertexDeclaration::create();
     }
 }
@@ -43,7 +43,15 @@ namespace Tiny3D
         : HardwareConstantBuffer(bufSize, usage, mode)
     {
         mBuffer = new uint8_t[mBufferSize];
-        memcpy(mBuffer, buffer, mBufferSize);
+
+        if (buffer != nullptr)
+        {
+            memcpy(mBuffer, buffer, mBufferSize);
+        }
+        else
+        {
+            memset(mBuffer, 0, mBufferSize);
+        }
     }
 
     //--------------------------------------------------------------------------
@@ -107,27 +115,20 @@ namespace Tiny3D
     void *R3DHardwareConstantBuffer::lockImpl(size_t offset, size_t size,
         LockOptions options)
     {
-        char *pLockedData = nullptr;
-
-        do 
+        size_t bytesOfLocked = offset + size;
+        if (bytesOfLocked > mBufferSize)
         {
-            
-        } while (0);
+            // 超过缓冲区大小了，直接返回空
+            return nullptr;
+        }
 
-        return pLockedData;
+        return (mBuffer + offset);
     }
 
     //--------------------------------------------------------------------------
 
     TResult R3DHardwareConstantBuffer::unlockImpl()
     {
-        TResult ret = T3D_OK;
-
-        do 
-        {
-            
-        } while (0);
-
-        return ret;
+        return T3D_OK;
     }
 }
@@ -19,6 +19,7 @@
 
 
 #include "T3DR3DHardwarePixelBuffer.h"
+#include "T3DR3DTextureSampler.h"
 #include "T3DR3DError.h"
 
 
@@ -28,10 +29,10 @@ namespace Tiny3D
 
     R3DHardwarePixelBufferPtr R3DHardwarePixelBuffer::create(size_t width,
         size_t height, PixelFormat format, const void *pixels, Usage usage, 
-        uint32_t mode)
+        uint32_t mode, size_t mipmaps)
     {
         R3DHardwarePixelBufferPtr pb = new R3DHardwarePixelBuffer(width, height,
-            format, pixels, usage, mode);
+            format, pixels, usage, mode, mipmaps);
         pb->release();
         return pb;
     }
@@ -39,27 +40,53 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     R3DHardwarePixelBuffer::R3DHardwarePixelBuffer(size_t width, size_t height, 
-        PixelFormat format, const void *pixels, Usage usage, uint32_t mode)
-        : HardwarePixelBuffer(width, height, format, usage, mode)
+        PixelFormat format, const void *pixels, Usage usage, uint32_t mode,
+        size_t mipmaps)
+        : HardwarePixelBuffer(width, height, format, usage, mode, mipmaps)
         , mBuffer(nullptr)
         , mLockedBuffer(nullptr)
         , mNeedWriteBack(false)
+        , mVersion(0)
+        , mSampler(nullptr)
     {
         mBuffer = new uint8_t[mBufferSize];
         mLockedBuffer = new uint8_t[mBufferSize];
-        memcpy(mBuffer, pixels, mBufferSize);
+
+        if (pixels != nullptr)
+        {
+            memcpy(mBuffer, pixels, mBufferSize);
+        }
+        else
+        {
+            memset(mBuffer, 0, mBufferSize);
+        }
     }
 
     //--------------------------------------------------------------------------
 
     R3DHardwarePixelBuffer::~R3DHardwarePixelBuffer()
     {
+        mSampler = nullptr;
         T3D_SAFE_DELETE_ARRAY(mLockedBuffer);
         T3D_SAFE_DELETE_ARRAY(mBuffer);
     }
 
     //--------------------------------------------------------------------------
 
+    R3DTextureSamplerPtr R3DHardwarePixelBuffer::getTextureSampler() const
+    {
+        return mSampler;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void R3DHardwarePixelBuffer::setTextureSampler(R3DTextureSamplerPtr sampler)
+    {
+        mSampler = sampler;
+    }
+
+    //--------------------------------------------------------------------------
+
     TResult R3DHardwarePixelBuffer::readImage(const Image &image, 
         Rect *srcRect /* = nullptr */, Rect *dstRect /* = nullptr */)
     {
@@ -211,6 +238,9 @@ namespace Tiny3D
             }
             else
             {
+                // 以写方式锁定，之前生成的采样器过期了
+                mVersion++;
+
                 if (rect.width() == mWidth && rect.height() == mHeight)
                 {
                     // 获取整个纹理数据，则直接返回地址，不用再复制了
@@ -43,7 +43,15 @@ namespace Tiny3D
         , mBuffer(nullptr)
     {
         mBuffer = new uint8_t[mBufferSize];
-        memcpy(mBuffer, vertices, mBufferSize);
+
+        if (vertices != nullptr)
+        {
+            memcpy(mBuffer, vertices, mBufferSize);
+        }
+        else
+        {
+            memset(mBuffer, 0, mBufferSize);
+        }
     }
 
     //--------------------------------------------------------------------------
@@ -21,13 +21,18 @@
 #include "T3DR3DPlugin.h"
 #include "T3DR3DRenderer.h"
 #include "T3DR3DHardwareBufferManager.h"
+#include "T3DR3DGPUProgramCreator.h"
 
 
 namespace Tiny3D
 {
+    T3D_IMPLEMENT_CLASS_1(R3DPlugin, Plugin);
+
     R3DPlugin::R3DPlugin()
         : mName("R3DRenderer")
         , mRenderer(nullptr)
+        , mShaderCreator(nullptr)
+        , mGPUCreator(nullptr)
     {
 
     }
@@ -57,6 +62,11 @@ namespace Tiny3D
                     break;
                 }
             }
+
+            mShaderCreator = new R3DShaderCreator();
+            mGPUCreator = new R3DGPUProgramCreator();
+            T3D_SHADER_MGR.setShaderCreator(mShaderCreator);
+            T3D_GPU_PROGRAM_MGR.setGPUProgramCreator(mGPUCreator);
         } while (0);
 
         return ret;
@@ -88,6 +98,14 @@ namespace Tiny3D
                 break;
             }
 
+            T3D_SHADER_MGR.setShaderCreator(nullptr);
+            T3D_GPU_PROGRAM_MGR.setGPUProgramCreator(nullptr);
+
+            delete mShaderCreator;
+            delete mGPUCreator;
+            mShaderCreator = nullptr;
+            mGPUCreator = nullptr;
+
             mRenderer = nullptr;
         } while (0);
 
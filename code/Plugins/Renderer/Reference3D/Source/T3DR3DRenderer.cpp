@@ -21,14 +21,26 @@
 #include "T3DR3DRenderer.h"
 #include "T3DR3DRenderWindow.h"
 #include "T3DR3DHardwareBufferManager.h"
+#include "T3DR3DHardwarePixelBuffer.h"
 #include "T3DR3DError.h"
 #include "T3DR3DFramebuffer.h"
+#include "T3DR3DTextureSampler.h"
+#include "T3DR3DCapabilities.h"
+#include "T3DR3DState.h"
 
 
 namespace Tiny3D
 {
     //--------------------------------------------------------------------------
 
+    const Real R3DRenderer::GUARD_BAND_SCALE = Real(4.0);
+
+    //--------------------------------------------------------------------------
+
+    T3D_IMPLEMENT_CLASS_1(R3DRenderer, RenderContext);
+
+    //--------------------------------------------------------------------------
+
     R3DRendererPtr R3DRenderer::create()
     {
         R3DRendererPtr renderer = new R3DRenderer();
@@ -39,46 +51,81 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     R3DRenderer::R3DRenderer()
-        : Renderer()
+        : RenderContext()
         , mFramebuffer(nullptr)
-        , mRenderWindow(nullptr)
         , mHardwareBufferMgr(nullptr)
         , mR3DHardwareBufferMgr(nullptr)
-        , mFrustumBound(nullptr)
+        , mTexture(nullptr)
+        , mAlphaBlend(false)
+        , mCullingMode(CullingMode::CLOCKWISE)
+        , mPolygonMode(PolygonMode::SOLID)
     {
-        mName = Renderer::REFERENCE3D;
+        mName = RenderContext::REFERENCE3D;
     }
 
+    //--------------------------------------------------------------------------
+
     R3DRenderer::~R3DRenderer()
     {
-        mHardwareBufferMgr = nullptr;
-        mR3DHardwareBufferMgr = nullptr;
-        mRenderWindow = nullptr;
+        destroy();
     }
 
     //--------------------------------------------------------------------------
 
     TResult R3DRenderer::init()
     {
-        mR3DHardwareBufferMgr = R3DHardwareBufferManager::create();
-        mHardwareBufferMgr
-            = HardwareBufferManager::create(mR3DHardwareBufferMgr);
-
-        size_t i = 0;
+        TResult ret = T3D_OK;
 
-        for (i = 0; i < MAX; ++i)
+        do 
         {
-            mMatrices[i].makeIdentity();
-        }
+            mR3DHardwareBufferMgr = R3DHardwareBufferManager::create();
+            mHardwareBufferMgr
+                = HardwareBufferManager::create(mR3DHardwareBufferMgr);
+
+#ifdef T3D_DEBUG
+            // 调试版本检查 SIMD 的填充和混合跟逐像素处理的结果逐字节一致
+            ret = R3DFramebuffer::verifySpans();
+            if (T3D_FAILED(ret))
+            {
+                T3D_LOG_ERROR(LOG_TAG_R3DRENDERER,
+                    "SIMD spans do not match the scalar path !");
+                break;
+            }
+#endif
 
-        return T3D_OK;
+            // 没有窗口也可以渲染到纹理，所以渲染能力在这里就生成
+            mCapabilities = createRendererCapabilities();
+            if (mCapabilities == nullptr)
+            {
+                ret = T3D_ERR_SYS_NOT_INIT;
+                T3D_LOG_ERROR(LOG_TAG_R3DRENDERER,
+                    "Create renderer capabilities failed !");
+                break;
+            }
+
+            ret = postInit();
+            if (T3D_FAILED(ret))
+            {
+                T3D_LOG_ERROR(LOG_TAG_R3DRENDERER,
+                    "Post initialize failed !");
+                break;
+            }
+        } while (0);
+
+        return ret;
     }
 
+    //--------------------------------------------------------------------------
+
     TResult R3DRenderer::destroy()
     {
+        mTexture = nullptr;
+        mFramebuffer = nullptr;
+        mRenderTarget = nullptr;
+        mCapabilities = nullptr;
+        mPrimaryWindow = nullptr;
         mHardwareBufferMgr = nullptr;
         mR3DHardwareBufferMgr = nullptr;
-        mRenderWindow = nullptr;
         return T3D_OK;
     }
 
@@ -111,7 +158,10 @@ namespace Tiny3D
                 break;
             }
 
-            mRenderWindow = window;
+            if (mPrimaryWindow == nullptr)
+            {
+                mPrimaryWindow = window;
+            }
         } while (0);
 
         return window;
@@ -119,22 +169,9 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
-    bool R3DRenderer::queryCapability(Capability cap) const
-    {
-        return false;
-    }
-
-    //--------------------------------------------------------------------------
-
-    TResult R3DRenderer::setTransform(TransformState state, const Matrix4 &mat)
-    {
-        mMatrices[state] = mat;
-        return T3D_OK;
-    }
-
-    const Matrix4 &R3DRenderer::getTransform(TransformState state) const
+    RenderCapabilitiesPtr R3DRenderer::createRendererCapabilities() const
     {
-        return mMatrices[state];
+        return R3DCapabilities::create();
     }
 
     //--------------------------------------------------------------------------
@@ -400,25 +437,113 @@ namespace Tiny3D
 
         bound->setFrustumFaces(plane, Frustum::E_MAX_FACE);
 
-        if (mFrustumBound != bound)
-            mFrustumBound = bound;
+        return T3D_OK;
+    }
+
+    //--------------------------------------------------------------------------
+
+    BlendStatePtr R3DRenderer::createBlendState()
+    {
+        return R3DBlendState::create();
+    }
+
+    //--------------------------------------------------------------------------
+
+    DepthStencilStatePtr R3DRenderer::createDepthStencilState()
+    {
+        return R3DDepthStencilState::create();
+    }
+
+    //--------------------------------------------------------------------------
+
+    RasterizerStatePtr R3DRenderer::createRasterizerState()
+    {
+        return R3DRasterizerState::create();
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DRenderer::createSamplerStates(size_t numOfStates, 
+        SamplerStatePtr *states)
+    {
+        size_t i = 0;
+
+        for (i = 0; i < numOfStates; ++i)
+        {
+            states[i] = R3DSamplerState::create();
+        }
+
+        return T3D_OK;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DRenderer::setBlendState(BlendStatePtr state)
+    {
+        if (!mStateCache.setBlendState(state))
+        {
+            // 跟当前绑定的状态相同
+            return T3D_OK;
+        }
+
+        // 只支持 src * a + dst * (1 - a) 这种透明混合
+        mAlphaBlend = (state != nullptr && state->isBlendEnabled(0)
+            && state->getDstBlend(0) == BlendFactor::ONE_MINUS_SOURCE_ALPHA);
+
+        mStatistics.addStateChange();
+
+        return T3D_OK;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DRenderer::setDepthStencilState(DepthStencilStatePtr state)
+    {
+        if (!mStateCache.setDepthStencilState(state))
+        {
+            // 跟当前绑定的状态相同
+            return T3D_OK;
+        }
+
+        mStatistics.addStateChange();
 
         return T3D_OK;
     }
 
     //--------------------------------------------------------------------------
 
-    TResult R3DRenderer::setCullingMode(CullingMode mode)
+    TResult R3DRenderer::setRasterizerState(RasterizerStatePtr state)
     {
-        mCullingMode = mode;
+        if (!mStateCache.setRasterizerState(state))
+        {
+            // 跟当前绑定的状态相同
+            return T3D_OK;
+        }
+
+        if (state == nullptr)
+        {
+            // 引擎以逆时针为正面，跟 Pass 的默认值一样剔除顺时针的面
+            mCullingMode = CullingMode::CLOCKWISE;
+            mPolygonMode = PolygonMode::SOLID;
+        }
+        else
+        {
+            mCullingMode = state->getCullingMode();
+            mPolygonMode = state->getPolygonMode();
+        }
+
+        mStatistics.addStateChange();
+
         return T3D_OK;
     }
 
     //--------------------------------------------------------------------------
 
-    TResult R3DRenderer::setPolygonMode(PolygonMode mode)
+    TResult R3DRenderer::setSamplerStates(size_t numOfStates, 
+        SamplerStatePtr *states, 
+        ShaderType shader /* = ShaderType::PIXEL_SHADER */)
     {
-        mPolygonMode = mode;
+        mStatistics.addStateChange();
         return T3D_OK;
     }
 
@@ -426,23 +551,139 @@ namespace Tiny3D
 
     TResult R3DRenderer::setViewport(ViewportPtr viewport)
     {
-        mViewport = viewport;
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            mViewport = viewport;
+
+            // 视口切换到别的渲染目标时，帧缓冲跟着切换
+            RenderTargetPtr target = viewport->getRenderTarget();
+            if (mFramebuffer != nullptr
+                && mFramebuffer->getRenderTarget() == target)
+            {
+                break;
+            }
+
+            mFramebuffer = R3DFramebuffer::create(target);
+            if (mFramebuffer == nullptr)
+            {
+                ret = T3D_ERR_R3D_INVALID_TARGET;
+                T3D_LOG_ERROR(LOG_TAG_R3DRENDERER, "Create framebuffer for \
+                    render target [%s] failed !", target->getName().c_str());
+                break;
+            }
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DRenderer::bindGPUProgram(GPUProgramPtr program)
+    {
+        if (mStateCache.setGPUProgram(program))
+        {
+            mStatistics.addStateChange();
+        }
+
         return T3D_OK;
     }
 
     //--------------------------------------------------------------------------
 
-    TResult R3DRenderer::setMaterial(MaterialPtr material)
+    TResult R3DRenderer::bindGPUConstantBuffer(size_t slot,
+        HardwareConstantBufferPtr buffer)
     {
+        if (mStateCache.setConstantBuffer(slot, buffer))
+        {
+            mStatistics.addStateChange();
+        }
+
         return T3D_OK;
     }
 
     //--------------------------------------------------------------------------
 
-    TResult R3DRenderer::drawVertexArray(VertexArrayObjectPtr vao)
+    TResult R3DRenderer::bindTexture(TextureUnitPtr unit)
+    {
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            mTexture = nullptr;
+
+            if (unit == nullptr)
+            {
+                break;
+            }
+
+            TexturePtr texture = unit->getTexture();
+            if (texture == nullptr || texture->getPixelBuffer() == nullptr)
+            {
+                break;
+            }
+
+            R3DHardwarePixelBufferPtr pbo
+                = smart_pointer_cast<R3DHardwarePixelBuffer>(
+                    texture->getPixelBuffer());
+
+            // 采样器缓存在像素缓冲区上，纹理卸载时一起释放，像素改写后重新生成
+            R3DTextureSamplerPtr sampler = pbo->getTextureSampler();
+
+            if (sampler == nullptr || sampler->getVersion() != pbo->getVersion())
+            {
+                sampler = R3DTextureSampler::create(pbo);
+                if (sampler == nullptr)
+                {
+                    ret = T3D_ERR_R3D_UNSUPPORT_FORMAT_TEXTURE;
+                    T3D_LOG_ERROR(LOG_TAG_R3DRENDERER, 
+                        "Create texture sampler failed !");
+                    break;
+                }
+
+                pbo->setTextureSampler(sampler);
+            }
+
+            mTexture = sampler;
+
+            mTexture->setSampler(unit->getSampler());
+
+            if (mStateCache.setTexture(0, texture))
+            {
+                mStatistics.addTextureBind();
+            }
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DRenderer::renderObject(VertexArrayObjectPtr vao)
     {
         TResult ret = T3D_OK;
 
+        // 按需更新 GPU 常量缓冲区内容，保持跟其他渲染器一样的常量数据
+        if (mIsWorldMatrixDirty || mIsViewMatrixDirty || mIsProjMatrixDirty)
+        {
+            updateBufferPerObject();
+        }
+
+        if (mIsViewMatrixDirty || mIsProjMatrixDirty)
+        {
+            updateBufferPerFrame();
+        }
+
+        if (mIsProjMatrixDirty)
+        {
+            updateBufferRarely();
+        }
+
+        mIsWorldMatrixDirty = false;
+        mIsViewMatrixDirty = false;
+        mIsProjMatrixDirty = false;
+
         size_t indexCount = 0;
         uint8_t *indices = nullptr;
         bool is16Bits = false;
@@ -450,7 +691,7 @@ namespace Tiny3D
         if (vao->isIndicesUsed())
         {
             auto ibo = vao->getIndexBuffer();
-            indexCount = ibo->getIndexCount();
+            indexCount = vao->getDrawIndexCount();
             indices = (uint8_t*)ibo->lock(
                 HardwareBuffer::LockOptions::READ);
             is16Bits 
@@ -461,11 +702,11 @@ namespace Tiny3D
 
         do 
         {
-            mMV = mMatrices[TransformState::VIEW] 
-                * mMatrices[TransformState::WORLD];
-            mMVP = mMatrices[TransformState::PROJECTION]
-                * mMatrices[TransformState::VIEW]
-                * mMatrices[TransformState::WORLD];
+            const Matrix4 &M = getTransform(TransformState::WORLD);
+            const Matrix4 &V = getTransform(TransformState::VIEW);
+            const Matrix4 &P = getTransform(TransformState::PROJECTION);
+            mMV = V * M;
+            mMVP = P * mMV;
 
             auto vbo = vao->getVertexBuffer(0);
             size_t vertexCount = vbo->getVertexCount();
@@ -481,37 +722,34 @@ namespace Tiny3D
 
             switch (primitive)
             {
-            case Renderer::E_PT_POINT_LIST:
+            case PrimitiveType::E_PT_POINT_LIST:
                 {
                     // Point list
                     ret = processPointList(vertices, vertexCount, indices, 
                         indexCount, is16Bits);
                 }
                 break;
-            case Renderer::E_PT_LINE_LIST:
+            case PrimitiveType::E_PT_LINE_LIST:
                 {
                     // Line list
-                    
+                    ret = processLineList(vertices, vertexCount, indices,
+                        indexCount, is16Bits, false);
                 }
                 break;
-            case Renderer::E_PT_LINE_STRIP:
+            case PrimitiveType::E_PT_LINE_STRIP:
                 {
                     // Line strip
+                    ret = processLineList(vertices, vertexCount, indices,
+                        indexCount, is16Bits, true);
                 }
                 break;
-            case Renderer::E_PT_TRIANGLE_LIST:
-                {
-                    // Triangle list
-                }
-                break;
-            case Renderer::E_PT_TRIANGLE_STRIP:
-                {
-                    // Triangle strip
-                }
-                break;
-            case Renderer::E_PT_TRIANGLE_FAN:
+            case PrimitiveType::E_PT_TRIANGLE_LIST:
+            case PrimitiveType::E_PT_TRIANGLE_STRIP:
+            case PrimitiveType::E_PT_TRIANGLE_FAN:
                 {
-                    // Triangle fan
+                    // Triangle list, strip & fan
+                    ret = processTriangleList(vertices, vertexCount, indices,
+                        indexCount, is16Bits, primitive);
                 }
                 break;
             default:
@@ -536,34 +774,59 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
-    TResult R3DRenderer::drawVertexList(PrimitiveType priType, 
-        VertexDeclarationPtr decl, HardwareVertexBufferPtr vbo)
+    bool R3DRenderer::isInstancingSupported() const
     {
-        VertexArrayObjectPtr vao 
-            = T3D_HARDWARE_BUFFER_MGR.createVertexArrayObject(false);
-
-        vao->setPrimitiveType(priType);
-        vao->setVertexDeclaration(decl);
-        vao->addVertexBuffer(vbo);
-
-        return drawVertexArray(vao);
+        return true;
     }
 
     //--------------------------------------------------------------------------
 
-    TResult R3DRenderer::drawIndexList(PrimitiveType priType, 
-        VertexDeclarationPtr decl, HardwareVertexBufferPtr vbo, 
-        HardwareIndexBufferPtr ibo)
+    TResult R3DRenderer::renderObjectInstanced(VertexArrayObjectPtr vao,
+        HardwareVertexBufferPtr instances, size_t startInstance,
+        size_t instanceCount)
     {
-        VertexArrayObjectPtr vao
-            = T3D_HARDWARE_BUFFER_MGR.createVertexArrayObject(true);
+        TResult ret = T3D_OK;
+
+        do 
+        {
+            if (instances == nullptr 
+                || instances->getVertexSize() != sizeof(Matrix4)
+                || startInstance + instanceCount > instances->getVertexCount())
+            {
+                ret = T3D_ERR_INVALID_PARAM;
+                T3D_LOG_ERROR(LOG_TAG_R3DRENDERER, "Invalid instance buffer !");
+                break;
+            }
+
+            const Matrix4 *matrices = (const Matrix4 *)instances->lock(
+                startInstance * sizeof(Matrix4), 
+                instanceCount * sizeof(Matrix4),
+                HardwareBuffer::LockOptions::READ);
+            if (matrices == nullptr)
+            {
+                ret = T3D_ERR_HW_BUFFER_READ;
+                T3D_LOG_ERROR(LOG_TAG_R3DRENDERER, 
+                    "Lock instance buffer failed !");
+                break;
+            }
+
+            // 没有实例数据流，逐个实例变换顶点和光栅化
+            size_t i = 0;
+            for (i = 0; i < instanceCount; ++i)
+            {
+                setWorldTransform(matrices[i]);
+
+                ret = renderObject(vao);
+                if (T3D_FAILED(ret))
+                {
+                    break;
+                }
+            }
 
-        vao->setPrimitiveType(priType);
-        vao->setVertexDeclaration(decl);
-        vao->addVertexBuffer(vbo);
-        vao->setIndexBuffer(ibo);
+            instances->unlock();
+        } while (0);
 
-        return drawVertexArray(vao);
+        return ret;
     }
 
     //--------------------------------------------------------------------------
@@ -577,25 +840,28 @@ namespace Tiny3D
         {
             uint8_t *buffer;
             size_t  vertexSize;
-            size_t  vertexCount;
         };
 
-        TArray<BufferInfo> buffers(vao->getVertexBufferCount());
+        size_t bufferCount = vao->getVertexBufferCount();
+        TArray<BufferInfo> buffers;
+        buffers.reserve(bufferCount);
+
         size_t i = 0;
-        for (i = 0; i < vao->getVertexBufferCount(); ++i)
+        for (i = 0; i < bufferCount; ++i)
         {
-            auto vbo = vao->getVertexBuffer(0);
+            auto vbo = vao->getVertexBuffer(i);
+            if (vbo->getVertexCount() != vertexCount)
+            {
+                ret = T3D_ERR_R3D_MISMATCH_VERTEX_COUNT;
+                T3D_LOG_ERROR(LOG_TAG_R3DRENDERER, "Vertex count of stream \
+                    %d is not the same as stream 0 !", (uint32_t)i);
+                break;
+            }
 
             BufferInfo info;
             info.buffer = (uint8_t*)vbo->lock(
                 HardwareBuffer::LockOptions::READ);
             info.vertexSize = vbo->getVertexSize();
-            info.vertexCount = vbo->getVertexCount();
-            if (info.vertexCount != vertexCount)
-            {
-                ret = T3D_ERR_R3D_MISMATCH_VERTEX_COUNT;
-                break;
-            }
             buffers.push_back(info);
         }
 
@@ -609,19 +875,23 @@ namespace Tiny3D
             auto itr = attributes.begin();
             while (itr != attributes.end())
             {
-                auto attr = *itr;
+                const VertexAttribute &attr = *itr;
                 size_t idx = attr.getStream();
-                auto info = buffers[idx];
-                processVertices(info.buffer, info.vertexSize, attr, vertices,
-                    vertexCount);
+                if (idx < buffers.size())
+                {
+                    const BufferInfo &info = buffers[idx];
+                    processVertices(info.buffer, info.vertexSize, attr, 
+                        vertices, vertexCount);
+                }
 
                 ++itr;
             }
         }
 
-        for (i = 0; i < vao->getVertexBufferCount(); ++i)
+        // 只解锁上面成功锁定了的缓冲区
+        for (i = 0; i < buffers.size(); ++i)
         {
-            auto vbo = vao->getVertexBuffer(0);
+            auto vbo = vao->getVertexBuffer(i);
             vbo->unlock();
         }
 
@@ -635,62 +905,65 @@ namespace Tiny3D
     {
         TResult ret = T3D_OK;
 
-        size_t start = 0;
-        size_t srcOffset = attr.getOffset();
-        size_t size = attr.getSize();
-        size_t idx = 0;
-        size_t dstOffset = 0;
-        size_t dstVertexSize = sizeof(Vertex);
-        bool needTransform = false;
-
-        switch (attr.getSemantic())
-        {
-        case VertexAttribute::Semantic::E_VAS_POSITION:
-            dstOffset = 0;
-            needTransform = true;
-            break;
-        case VertexAttribute::Semantic::E_VAS_NORMAL:
-            dstOffset = sizeof(Vector4);
-            needTransform = true;
-            break;
-        case VertexAttribute::Semantic::E_VAS_DIFFUSE:
-            dstOffset = sizeof(Vector4) + sizeof(Vector4) + sizeof(Vector2);
-            break;
-        case VertexAttribute::Semantic::E_VAS_SPECULAR:
-            dstOffset = sizeof(Vector4) + sizeof(Vector4) + sizeof(Vector2)
-                + sizeof(ColorRGB);
-            break;
-        case VertexAttribute::Semantic::E_VAS_TEXCOORD:
-            dstOffset = sizeof(Vector4) + sizeof(Vector4);
-            break;
-        }
-
+        const uint8_t *src = buffer + attr.getOffset();
+        VertexAttribute::Semantic semantic = attr.getSemantic();
+        VertexAttribute::Type type = attr.getType();
         size_t i = 0;
 
-        for (i = 0; i < vertexCount; ++i)
+        for (i = 0; i < vertexCount; ++i, src += vertexSize)
         {
-            size_t offset = start + srcOffset;
+            Vertex &vertex = vertices[i];
+            const float32_t *values = (const float32_t *)src;
 
-            if (VertexAttribute::Semantic::E_VAS_POSITION == attr.getSemantic())
-            {
-                memcpy(&vertices[i].pos, &buffer[offset], sizeof(Real) * 3);
-                vertices[i].pos.w() = REAL_ONE;
-                vertices[i].pos = mMVP * vertices[i].pos;
-            }
-            else if (VertexAttribute::Semantic::E_VAS_NORMAL == attr.getSemantic())
-            {
-                memcpy(&vertices[i].normal, &buffer[offset], sizeof(Real) * 3);
-                vertices[i].normal.w() = REAL_ZERO;
-                vertices[i].normal = mMV * vertices[i].normal;
-                vertices[i].normal.normalize();
-            }
-            else
+            switch (semantic)
             {
-                memcpy(&vertices[dstOffset], &buffer[offset], size);
+            case VertexAttribute::Semantic::E_VAS_POSITION:
+                {
+                    vertex.pos = Vector4(values[0], values[1], values[2], 
+                        REAL_ONE);
+                    vertex.pos = mMVP * vertex.pos;
+                }
+                break;
+            case VertexAttribute::Semantic::E_VAS_NORMAL:
+                {
+                    vertex.normal = Vector4(values[0], values[1], values[2], 
+                        REAL_ZERO);
+                    vertex.normal = mMV * vertex.normal;
+                    vertex.normal.normalize();
+                }
+                break;
+            case VertexAttribute::Semantic::E_VAS_TEXCOORD:
+                {
+                    vertex.uv = Vector2(values[0], values[1]);
+                }
+                break;
+            case VertexAttribute::Semantic::E_VAS_DIFFUSE:
+            case VertexAttribute::Semantic::E_VAS_SPECULAR:
+                {
+                    // E_VAT_COLOR 跟其他渲染器一样按 RGBA 四个浮点数解释
+                    ColorARGB color(ColorARGB::WHITE);
+
+                    if (type == VertexAttribute::Type::E_VAT_COLOR
+                        || type == VertexAttribute::Type::E_VAT_FLOAT4)
+                    {
+                        color = ColorARGB(values[0], values[1], values[2],
+                            values[3]);
+                    }
+                    else if (type == VertexAttribute::Type::E_VAT_FLOAT3)
+                    {
+                        color = ColorARGB(values[0], values[1], values[2]);
+                    }
+
+                    if (semantic == VertexAttribute::Semantic::E_VAS_DIFFUSE)
+                        vertex.diffuse = color;
+                    else
+                        vertex.specular = ColorRGB(color.red(), color.green(),
+                            color.blue());
+                }
+                break;
+            default:
+                break;
             }
-
-            vertices += dstVertexSize;
-            start += size;
         }
 
         return ret;
@@ -748,16 +1021,10 @@ namespace Tiny3D
         dstVertCount = 0;
         size_t i = 0;
 
-        IntrPointFrustum intr;
-        const Frustum &frustum = mFrustumBound->getFrustum();
-        intr.setFrustum(&frustum);
-
         for (i = 0; i < srcVertCount; ++i)
         {
-            const Vector4 &pt = srcVerts[i].pos;
-            Vector3 pos(pt.x(), pt.y(), pt.z());
-            intr.setPoint(&pos);
-            if (intr.test())
+            // 顶点已经在齐次裁剪空间，直接用区域码判断是否在视锥体内
+            if ((computeClipCode(srcVerts[i].pos) & E_CLIP_FRUSTUM_MASK) == 0)
             {
                 // 在视锥体内，不用裁剪
                 dstVerts[dstVertCount] = srcVerts[i];
@@ -792,18 +1059,12 @@ namespace Tiny3D
             uint16_t *srcIdx = (uint16_t*)srcIndices;
             dstIdxCount = 0;
 
-            IntrPointFrustum intr;
-            const Frustum &frustum = mFrustumBound->getFrustum();
-            intr.setFrustum(&frustum);
-
             for (i = 0; i < srcIdxCount; ++i)
             {
                 uint16_t index = srcIdx[i];
-                const Vector4 &pt = vertices[index].pos;
-                Vector3 pos(pt.x(), pt.y(), pt.z());
-                intr.setPoint(&pos);
+                uint32_t code = computeClipCode(vertices[index].pos);
 
-                if (intr.test())
+                if ((code & E_CLIP_FRUSTUM_MASK) == 0)
                 {
                     // 在视锥体内，不用裁剪
                     indices[dstIdxCount] = index;
@@ -828,18 +1089,12 @@ namespace Tiny3D
             uint32_t *srcIdx = (uint32_t*)srcIndices;
             dstIdxCount = 0;
 
-            IntrPointFrustum intr;
-            const Frustum &frustum = mFrustumBound->getFrustum();
-            intr.setFrustum(&frustum);
-
             for (i = 0; i < srcIdxCount; ++i)
             {
                 uint32_t index = srcIdx[i];
-                const Vector4 &pt = vertices[index].pos;
-                Vector3 pos(pt.x(), pt.y(), pt.z());
-                intr.setPoint(&pos);
+                uint32_t code = computeClipCode(vertices[index].pos);
 
-                if (intr.test())
+                if ((code & E_CLIP_FRUSTUM_MASK) == 0)
                 {
                     // 在视锥体内，不用裁剪
                     indices[dstIdxCount] = index;
@@ -918,4 +1173,819 @@ namespace Tiny3D
 
         return ret;
     }
+
+    //--------------------------------------------------------------------------
+
+    R3DRenderer::ClipScratch &R3DRenderer::getClipScratch()
+    {
+        // 每个线程一份，裁剪过程不需要加锁也不需要分配内存
+        static thread_local ClipScratch scratch;
+        return scratch;
+    }
+
+    //--------------------------------------------------------------------------
+
+    size_t R3DRenderer::fetchIndex(const uint8_t *indices, size_t i,
+        bool is16Bits) const
+    {
+        if (indices == nullptr)
+        {
+            return i;
+        }
+
+        if (is16Bits)
+        {
+            return ((const uint16_t*)indices)[i];
+        }
+
+        return ((const uint32_t*)indices)[i];
+    }
+
+    //--------------------------------------------------------------------------
+
+    uint32_t R3DRenderer::computeClipCode(const Vector4 &pos) const
+    {
+        uint32_t code = 0;
+
+        Real w = pos.w();
+        Real gw = w * GUARD_BAND_SCALE;
+
+        if (pos.x() < -w)
+            code |= E_CLIP_LEFT;
+        if (pos.x() > w)
+            code |= E_CLIP_RIGHT;
+        if (pos.y() < -w)
+            code |= E_CLIP_BOTTOM;
+        if (pos.y() > w)
+            code |= E_CLIP_TOP;
+        if (pos.z() < REAL_ZERO)
+            code |= E_CLIP_NEAR;
+        if (pos.z() > w)
+            code |= E_CLIP_FAR;
+
+        if (pos.x() < -gw)
+            code |= E_CLIP_GB_LEFT;
+        if (pos.x() > gw)
+            code |= E_CLIP_GB_RIGHT;
+        if (pos.y() < -gw)
+            code |= E_CLIP_GB_BOTTOM;
+        if (pos.y() > gw)
+            code |= E_CLIP_GB_TOP;
+
+        return code;
+    }
+
+    //--------------------------------------------------------------------------
+
+    Real R3DRenderer::clipDistance(uint32_t plane, const Vector4 &pos) const
+    {
+        Real w = pos.w();
+        Real gw = w * GUARD_BAND_SCALE;
+        Real dist = REAL_ZERO;
+
+        switch (plane)
+        {
+        case E_CLIP_LEFT:
+            dist = w + pos.x();
+            break;
+        case E_CLIP_RIGHT:
+            dist = w - pos.x();
+            break;
+        case E_CLIP_BOTTOM:
+            dist = w + pos.y();
+            break;
+        case E_CLIP_TOP:
+            dist = w - pos.y();
+            break;
+        case E_CLIP_NEAR:
+            dist = pos.z();
+            break;
+        case E_CLIP_FAR:
+            dist = w - pos.z();
+            break;
+        case E_CLIP_GB_LEFT:
+            dist = gw + pos.x();
+            break;
+        case E_CLIP_GB_RIGHT:
+            dist = gw - pos.x();
+            break;
+        case E_CLIP_GB_BOTTOM:
+            dist = gw + pos.y();
+            break;
+        case E_CLIP_GB_TOP:
+            dist = gw - pos.y();
+            break;
+        }
+
+        return dist;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void R3DRenderer::interpolateVertex(const Vertex &v0, const Vertex &v1,
+        Real t, Vertex &v) const
+    {
+        v.pos = v0.pos + (v1.pos - v0.pos) * t;
+        v.normal = v0.normal + (v1.normal - v0.normal) * t;
+        v.uv = v0.uv + (v1.uv - v0.uv) * t;
+
+        v.diffuse.red() 
+            = v0.diffuse.red() + (v1.diffuse.red() - v0.diffuse.red()) * t;
+        v.diffuse.green()
+            = v0.diffuse.green() + (v1.diffuse.green() - v0.diffuse.green()) * t;
+        v.diffuse.blue()
+            = v0.diffuse.blue() + (v1.diffuse.blue() - v0.diffuse.blue()) * t;
+        v.diffuse.alpha()
+            = v0.diffuse.alpha() + (v1.diffuse.alpha() - v0.diffuse.alpha()) * t;
+
+        v.specular.red()
+            = v0.specular.red() + (v1.specular.red() - v0.specular.red()) * t;
+        v.specular.green()
+            = v0.specular.green() + (v1.specular.green() - v0.specular.green()) * t;
+        v.specular.blue()
+            = v0.specular.blue() + (v1.specular.blue() - v0.specular.blue()) * t;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DRenderer::processLineList(Vertex *vertices, size_t vertexCount,
+        uint8_t *indices, size_t indexCount, bool is16Bits, bool isStrip)
+    {
+        TResult ret = T3D_OK;
+
+        if (indexCount == 0)
+        {
+            indices = nullptr;
+        }
+
+        size_t count = (indices != nullptr ? indexCount : vertexCount);
+        size_t step = (isStrip ? 1 : 2);
+        size_t lineCount = 0;
+
+        if (isStrip)
+        {
+            lineCount = (count > 1 ? count - 1 : 0);
+        }
+        else
+        {
+            lineCount = count / 2;
+        }
+
+        Vertex v0, v1;
+        size_t i = 0;
+
+        for (i = 0; i < lineCount; ++i)
+        {
+            size_t i0 = fetchIndex(indices, i * step, is16Bits);
+            size_t i1 = fetchIndex(indices, i * step + 1, is16Bits);
+
+            if (i0 >= vertexCount || i1 >= vertexCount)
+            {
+                continue;
+            }
+
+            // 视锥体裁剪
+            if (clipLine(vertices[i0], vertices[i1], v0, v1))
+            {
+                // 光栅化
+                rasterLine(v0, v1);
+            }
+        }
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DRenderer::processTriangleList(Vertex *vertices,
+        size_t vertexCount, uint8_t *indices, size_t indexCount, bool is16Bits,
+        PrimitiveType primitive)
+    {
+        TResult ret = T3D_OK;
+
+        if (indexCount == 0)
+        {
+            indices = nullptr;
+        }
+
+        size_t count = (indices != nullptr ? indexCount : vertexCount);
+        size_t triangleCount = 0;
+
+        if (primitive == PrimitiveType::E_PT_TRIANGLE_LIST)
+        {
+            triangleCount = count / 3;
+        }
+        else
+        {
+            triangleCount = (count > 2 ? count - 2 : 0);
+        }
+
+        Vertex v0, v1;
+        size_t i = 0;
+
+        for (i = 0; i < triangleCount; ++i)
+        {
+            size_t i0 = 0, i1 = 0, i2 = 0;
+
+            switch (primitive)
+            {
+            case PrimitiveType::E_PT_TRIANGLE_LIST:
+                i0 = fetchIndex(indices, i * 3, is16Bits);
+                i1 = fetchIndex(indices, i * 3 + 1, is16Bits);
+                i2 = fetchIndex(indices, i * 3 + 2, is16Bits);
+                break;
+            case PrimitiveType::E_PT_TRIANGLE_STRIP:
+                // 奇数三角形交换前两个顶点，保持环绕顺序一致
+                i0 = fetchIndex(indices, (i & 1) ? i + 1 : i, is16Bits);
+                i1 = fetchIndex(indices, (i & 1) ? i : i + 1, is16Bits);
+                i2 = fetchIndex(indices, i + 2, is16Bits);
+                break;
+            default:
+                i0 = fetchIndex(indices, 0, is16Bits);
+                i1 = fetchIndex(indices, i + 1, is16Bits);
+                i2 = fetchIndex(indices, i + 2, is16Bits);
+                break;
+            }
+
+            if (i0 >= vertexCount || i1 >= vertexCount || i2 >= vertexCount)
+            {
+                continue;
+            }
+
+            const Vertex &p0 = vertices[i0];
+            const Vertex &p1 = vertices[i1];
+            const Vertex &p2 = vertices[i2];
+
+            if (mPolygonMode == PolygonMode::WIREFRAME)
+            {
+                // 线框模式直接按三条边裁剪、光栅化
+                if (clipLine(p0, p1, v0, v1))
+                    rasterLine(v0, v1);
+                if (clipLine(p1, p2, v0, v1))
+                    rasterLine(v0, v1);
+                if (clipLine(p2, p0, v0, v1))
+                    rasterLine(v0, v1);
+            }
+            else
+            {
+                Vertex *verts = nullptr;
+                size_t vertCount = 0;
+
+                // 视锥体裁剪
+                ret = clipTriangle(p0, p1, p2, verts, vertCount);
+                if (ret != T3D_OK)
+                {
+                    break;
+                }
+
+                // 光栅化
+                if (vertCount >= 3)
+                {
+                    rasterPolygon(verts, vertCount);
+                }
+            }
+        }
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool R3DRenderer::clipLine(const Vertex &v0, const Vertex &v1,
+        Vertex &dst0, Vertex &dst1) const
+    {
+        uint32_t code0 = computeClipCode(v0.pos) & E_CLIP_FRUSTUM_MASK;
+        uint32_t code1 = computeClipCode(v1.pos) & E_CLIP_FRUSTUM_MASK;
+
+        if ((code0 & code1) != 0)
+        {
+            // 两个端点都在同一个平面外侧，完全裁掉
+            return false;
+        }
+
+        if ((code0 | code1) == 0)
+        {
+            // 完全在视锥体内，不用裁剪
+            dst0 = v0;
+            dst1 = v1;
+            return true;
+        }
+
+        // 参数化裁剪，P(t) = v0 + (v1 - v0) * t，只处理端点跨越的平面
+        Real t0 = REAL_ZERO, t1 = REAL_ONE;
+        uint32_t planes = code0 | code1;
+        uint32_t plane = E_CLIP_LEFT;
+
+        for (plane = E_CLIP_LEFT; plane <= E_CLIP_FAR; plane <<= 1)
+        {
+            if ((planes & plane) == 0)
+            {
+                continue;
+            }
+
+            Real d0 = clipDistance(plane, v0.pos);
+            Real d1 = clipDistance(plane, v1.pos);
+
+            if (d0 < REAL_ZERO)
+            {
+                t0 = Math::max(t0, d0 / (d0 - d1));
+            }
+            else if (d1 < REAL_ZERO)
+            {
+                t1 = Math::min(t1, d0 / (d0 - d1));
+            }
+
+            if (t0 > t1)
+            {
+                return false;
+            }
+        }
+
+        interpolateVertex(v0, v1, t0, dst0);
+        interpolateVertex(v0, v1, t1, dst1);
+
+        return true;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DRenderer::clipTriangle(const Vertex &v0, const Vertex &v1,
+        const Vertex &v2, Vertex *&dstVerts, size_t &dstVertCount) const
+    {
+        TResult ret = T3D_OK;
+
+        dstVerts = nullptr;
+        dstVertCount = 0;
+
+        uint32_t code0 = computeClipCode(v0.pos);
+        uint32_t code1 = computeClipCode(v1.pos);
+        uint32_t code2 = computeClipCode(v2.pos);
+
+        if ((code0 & code1 & code2 & E_CLIP_FRUSTUM_MASK) != 0)
+        {
+            // 三个顶点都在同一个平面外侧，完全裁掉
+            return ret;
+        }
+
+        ClipScratch &scratch = getClipScratch();
+        Vertex *src = scratch.vertices[0];
+        Vertex *dst = scratch.vertices[1];
+
+        src[0] = v0;
+        src[1] = v1;
+        src[2] = v2;
+        size_t count = 3;
+
+        // 只跨越屏幕左右上下边缘的三角形，在保护带内直接交给光栅化按视口剪裁，
+        // 只有跨越近、远平面或者超出保护带才需要真正裁剪
+        uint32_t planes = (code0 | code1 | code2) & E_CLIP_TRIANGLE_MASK;
+        uint32_t plane = E_CLIP_NEAR;
+
+        for (plane = E_CLIP_NEAR; plane <= E_CLIP_GB_TOP && count >= 3; 
+            plane <<= 1)
+        {
+            if ((planes & plane) == 0)
+            {
+                continue;
+            }
+
+            count = clipPolygon(plane, src, count, dst);
+
+            Vertex *temp = src;
+            src = dst;
+            dst = temp;
+        }
+
+        if (count >= 3)
+        {
+            dstVerts = src;
+            dstVertCount = count;
+        }
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    size_t R3DRenderer::clipPolygon(uint32_t plane, const Vertex *srcVerts,
+        size_t srcVertCount, Vertex *dstVerts) const
+    {
+        size_t dstVertCount = 0;
+
+        const Vertex *prev = &srcVerts[srcVertCount - 1];
+        Real prevDist = clipDistance(plane, prev->pos);
+        size_t i = 0;
+
+        for (i = 0; i < srcVertCount; ++i)
+        {
+            const Vertex *curr = &srcVerts[i];
+            Real currDist = clipDistance(plane, curr->pos);
+
+            if (currDist >= REAL_ZERO)
+            {
+                if (prevDist < REAL_ZERO)
+                {
+                    // 从外侧进入内侧，输出交点
+                    interpolateVertex(*prev, *curr,
+                        prevDist / (prevDist - currDist),
+                        dstVerts[dstVertCount++]);
+                }
+
+                dstVerts[dstVertCount++] = *curr;
+            }
+            else if (prevDist >= REAL_ZERO)
+            {
+                // 从内侧离开到外侧，输出交点
+                interpolateVertex(*prev, *curr,
+                    prevDist / (prevDist - currDist),
+                    dstVerts[dstVertCount++]);
+            }
+
+            prev = curr;
+            prevDist = currDist;
+        }
+
+        return dstVertCount;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void R3DRenderer::projectVertex(Vertex &vertex,
+        const Matrix4 &matViewport) const
+    {
+        Vector4 &pos = vertex.pos;
+        Real invW = REAL_ONE / pos.w();
+        pos.x() *= invW;
+        pos.y() *= invW;
+        pos.z() *= invW;
+        pos.w() = REAL_ONE;
+        pos = matViewport * pos;
+        pos.w() = invW;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DRenderer::rasterLine(const Vertex &v0, const Vertex &v1)
+    {
+        const Matrix4 &matViewport = mViewport->getViewportMatrix();
+
+        Vertex p0 = v0;
+        Vertex p1 = v1;
+        projectVertex(p0, matViewport);
+        projectVertex(p1, matViewport);
+
+        // 裁剪后端点落在视口边界上，转成像素坐标时需要限制在视口内
+        Real left = Real(mViewport->getActualLeft());
+        Real top = Real(mViewport->getActualTop());
+        Real right = left + Real(mViewport->getActualWidth()) - REAL_ONE;
+        Real bottom = top + Real(mViewport->getActualHeight()) - REAL_ONE;
+
+        Point start(
+            size_t(Math::min(Math::max(p0.pos.x(), left), right)),
+            size_t(Math::min(Math::max(p0.pos.y(), top), bottom)));
+        Point end(
+            size_t(Math::min(Math::max(p1.pos.x(), left), right)),
+            size_t(Math::min(Math::max(p1.pos.y(), top), bottom)));
+
+        return mFramebuffer->drawLine(start, end, p0.diffuse);
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DRenderer::rasterPolygon(Vertex *vertices, size_t vertexCount)
+    {
+        TResult ret = T3D_OK;
+
+        const Matrix4 &matViewport = mViewport->getViewportMatrix();
+        size_t i = 0;
+
+        for (i = 0; i < vertexCount; ++i)
+        {
+            projectVertex(vertices[i], matViewport);
+        }
+
+        if (mPolygonMode == PolygonMode::POINT)
+        {
+            size_t left = mViewport->getActualLeft();
+            size_t top = mViewport->getActualTop();
+            size_t right = left + mViewport->getActualWidth();
+            size_t bottom = top + mViewport->getActualHeight();
+
+            for (i = 0; i < vertexCount; ++i)
+            {
+                // 保护带内的顶点可能在视口外
+                const Vector4 &pos = vertices[i].pos;
+                if (pos.x() < Real(left) || pos.x() >= Real(right)
+                    || pos.y() < Real(top) || pos.y() >= Real(bottom))
+                {
+                    continue;
+                }
+
+                Point pt(size_t(pos.x()), size_t(pos.y()));
+                mFramebuffer->drawPoint(pt, vertices[i].diffuse);
+            }
+        }
+        else
+        {
+            // 裁剪后是凸多边形，按扇形拆分成三角形
+            for (i = 1; i + 1 < vertexCount; ++i)
+            {
+                ret = rasterTriangle(vertices[0], vertices[i], vertices[i+1]);
+                if (ret != T3D_OK)
+                {
+                    break;
+                }
+            }
+        }
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DRenderer::rasterTriangle(const Vertex &v0, const Vertex &v1,
+        const Vertex &v2)
+    {
+        TResult ret = T3D_OK;
+
+        const Vertex *p0 = &v0;
+        const Vertex *p1 = &v1;
+        const Vertex *p2 = &v2;
+
+        // 屏幕空间 y 轴向下，面积为正表示屏幕上看是顺时针
+        Real area = (p1->pos.x() - p0->pos.x()) * (p2->pos.y() - p0->pos.y())
+            - (p1->pos.y() - p0->pos.y()) * (p2->pos.x() - p0->pos.x());
+
+        if (area == REAL_ZERO)
+        {
+            // 退化三角形
+            return ret;
+        }
+
+        if ((mCullingMode == CullingMode::CLOCKWISE && area > REAL_ZERO)
+            || (mCullingMode == CullingMode::ANTICLOCKWISE && area < REAL_ZERO))
+        {
+            // 消隐面剔除
+            return ret;
+        }
+
+        if (area < REAL_ZERO)
+        {
+            // 统一成顺时针，后面边函数都按正面积判断
+            const Vertex *temp = p1;
+            p1 = p2;
+            p2 = temp;
+            area = -area;
+        }
+
+        const Real x0 = p0->pos.x(), y0 = p0->pos.y();
+        const Real x1 = p1->pos.x(), y1 = p1->pos.y();
+        const Real x2 = p2->pos.x(), y2 = p2->pos.y();
+
+        // 包围盒限制在视口内，保护带内跨越屏幕边缘的三角形在这里被剪裁
+        int32_t vpLeft = (int32_t)mViewport->getActualLeft();
+        int32_t vpTop = (int32_t)mViewport->getActualTop();
+        int32_t vpRight = vpLeft + (int32_t)mViewport->getActualWidth();
+        int32_t vpBottom = vpTop + (int32_t)mViewport->getActualHeight();
+
+        Real minX = Math::min(Math::min(x0, x1), x2);
+        Real maxX = Math::max(Math::max(x0, x1), x2);
+        Real minY = Math::min(Math::min(y0, y1), y2);
+        Real maxY = Math::max(Math::max(y0, y1), y2);
+
+        int32_t left = std::max((int32_t)(minX - REAL_HALF), vpLeft);
+        int32_t right = std::min((int32_t)(maxX + REAL_HALF) + 1, vpRight);
+        int32_t top = std::max((int32_t)(minY - REAL_HALF), vpTop);
+        int32_t bottom = std::min((int32_t)(maxY + REAL_HALF) + 1, vpBottom);
+
+        if (left >= right || top >= bottom)
+        {
+            return ret;
+        }
+
+        // 边函数 E(x, y) 对 x 和 y 的增量
+        const Real dx12 = y1 - y2, dy12 = x2 - x1;
+        const Real dx20 = y2 - y0, dy20 = x0 - x2;
+        const Real dx01 = y0 - y1, dy01 = x1 - x0;
+
+        // 左上填充规则，正好落在边上的像素只属于上边或者左边
+        const bool topLeft0 = (dx12 > REAL_ZERO
+            || (dx12 == REAL_ZERO && dy12 > REAL_ZERO));
+        const bool topLeft1 = (dx20 > REAL_ZERO
+            || (dx20 == REAL_ZERO && dy20 > REAL_ZERO));
+        const bool topLeft2 = (dx01 > REAL_ZERO
+            || (dx01 == REAL_ZERO && dy01 > REAL_ZERO));
+
+        const Real invArea = REAL_ONE / area;
+
+        // 透视校正插值：屏幕空间里 1/w 和 attr/w 是线性的
+        const Real invW0 = p0->pos.w() * invArea;
+        const Real invW1 = p1->pos.w() * invArea;
+        const Real invW2 = p2->pos.w() * invArea;
+
+        // 以 2x2 像素块为单位光栅化，块对齐到偶数坐标，块内没被覆盖的像素作为
+        // 辅助像素参与插值，用于计算纹理坐标的屏幕空间差分
+        left &= ~1;
+        top &= ~1;
+
+        const int32_t quadX[4] = { 0, 1, 0, 1 };
+        const int32_t quadY[4] = { 0, 0, 1, 1 };
+
+        Real e0[4], e1[4], e2[4];
+        Real u[4], v[4];
+        ColorARGB diffuse[4];
+        ColorARGB texels[4];
+
+        // 两行像素的着色结果先缓存起来，整行按连续区间一次写入或者混合
+        size_t spanWidth = (size_t)(right - left + 1);
+        if (mSpanColors.size() < spanWidth * 2)
+        {
+            mSpanColors.resize(spanWidth * 2);
+            mSpanMask.resize(spanWidth * 2);
+        }
+
+        int32_t x = 0, y = 0;
+        size_t i = 0;
+
+        for (y = top; y < bottom; y += 2)
+        {
+            memset(&mSpanMask[0], 0, spanWidth * 2);
+
+            for (x = left; x < right; x += 2)
+            {
+                // 4个像素中心处的边函数值
+#if defined (T3D_R3D_SSE2)
+                const __m128 px = _mm_add_ps(_mm_set1_ps(Real(x)),
+                    _mm_setr_ps(0.5f, 1.5f, 0.5f, 1.5f));
+                const __m128 py = _mm_add_ps(_mm_set1_ps(Real(y)),
+                    _mm_setr_ps(0.5f, 0.5f, 1.5f, 1.5f));
+
+                _mm_storeu_ps(e0, _mm_add_ps(
+                    _mm_mul_ps(_mm_sub_ps(px, _mm_set1_ps(x1)),
+                        _mm_set1_ps(dx12)),
+                    _mm_mul_ps(_mm_sub_ps(py, _mm_set1_ps(y1)),
+                        _mm_set1_ps(dy12))));
+                _mm_storeu_ps(e1, _mm_add_ps(
+                    _mm_mul_ps(_mm_sub_ps(px, _mm_set1_ps(x2)),
+                        _mm_set1_ps(dx20)),
+                    _mm_mul_ps(_mm_sub_ps(py, _mm_set1_ps(y2)),
+                        _mm_set1_ps(dy20))));
+                _mm_storeu_ps(e2, _mm_add_ps(
+                    _mm_mul_ps(_mm_sub_ps(px, _mm_set1_ps(x0)),
+                        _mm_set1_ps(dx01)),
+                    _mm_mul_ps(_mm_sub_ps(py, _mm_set1_ps(y0)),
+                        _mm_set1_ps(dy01))));
+#else
+                for (i = 0; i < 4; ++i)
+                {
+                    Real px = Real(x + quadX[i]) + REAL_HALF;
+                    Real py = Real(y + quadY[i]) + REAL_HALF;
+                    e0[i] = (px - x1) * dx12 + (py - y1) * dy12;
+                    e1[i] = (px - x2) * dx20 + (py - y2) * dy20;
+                    e2[i] = (px - x0) * dx01 + (py - y0) * dy01;
+                }
+#endif
+
+                uint32_t mask = 0;
+
+                for (i = 0; i < 4; ++i)
+                {
+                    int32_t sx = x + quadX[i];
+                    int32_t sy = y + quadY[i];
+
+                    bool inside = (sx >= vpLeft && sx < right
+                        && sy >= vpTop && sy < bottom)
+                        && (e0[i] > REAL_ZERO 
+                            || (e0[i] == REAL_ZERO && topLeft0))
+                        && (e1[i] > REAL_ZERO 
+                            || (e1[i] == REAL_ZERO && topLeft1))
+                        && (e2[i] > REAL_ZERO 
+                            || (e2[i] == REAL_ZERO && topLeft2));
+
+                    if (inside)
+                    {
+                        mask |= (1 << i);
+                    }
+                }
+
+                if (mask == 0)
+                {
+                    continue;
+                }
+
+                for (i = 0; i < 4; ++i)
+                {
+                    Real w0 = e0[i] * invW0;
+                    Real w1 = e1[i] * invW1;
+                    Real w2 = e2[i] * invW2;
+                    Real sum = w0 + w1 + w2;
+
+                    if (sum > REAL_ZERO)
+                    {
+                        Real invSum = REAL_ONE / sum;
+                        w0 *= invSum;
+                        w1 *= invSum;
+                        w2 *= invSum;
+                    }
+                    else
+                    {
+                        // 远离三角形的辅助像素，退化成仿射插值
+                        w0 = e0[i] * invArea;
+                        w1 = e1[i] * invArea;
+                        w2 = e2[i] * invArea;
+                    }
+
+                    u[i] = w0 * p0->uv.x() + w1 * p1->uv.x() + w2 * p2->uv.x();
+                    v[i] = w0 * p0->uv.y() + w1 * p1->uv.y() + w2 * p2->uv.y();
+
+                    diffuse[i] = ColorARGB(
+                        w0 * p0->diffuse.red() + w1 * p1->diffuse.red()
+                            + w2 * p2->diffuse.red(),
+                        w0 * p0->diffuse.green() + w1 * p1->diffuse.green()
+                            + w2 * p2->diffuse.green(),
+                        w0 * p0->diffuse.blue() + w1 * p1->diffuse.blue()
+                            + w2 * p2->diffuse.blue(),
+                        w0 * p0->diffuse.alpha() + w1 * p1->diffuse.alpha()
+                            + w2 * p2->diffuse.alpha());
+                }
+
+                if (mTexture != nullptr)
+                {
+                    // 纹理颜色和顶点漫反射颜色调制
+                    mTexture->sampleQuad(u, v, texels);
+
+                    for (i = 0; i < 4; ++i)
+                    {
+                        diffuse[i].red() *= texels[i].red();
+                        diffuse[i].green() *= texels[i].green();
+                        diffuse[i].blue() *= texels[i].blue();
+                        diffuse[i].alpha() *= texels[i].alpha();
+                    }
+                }
+
+                for (i = 0; i < 4; ++i)
+                {
+                    if (mask & (1 << i))
+                    {
+                        if (!mAlphaBlend)
+                        {
+                            diffuse[i].alpha() = REAL_ONE;
+                        }
+
+                        size_t idx = quadY[i] * spanWidth + (x - left) 
+                            + quadX[i];
+                        mSpanColors[idx]
+                            = R3DFramebuffer::toPremultiplied(diffuse[i]);
+                        mSpanMask[idx] = 1;
+                    }
+                }
+            }
+
+            flushSpans(left, y, spanWidth);
+        }
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void R3DRenderer::flushSpans(int32_t left, int32_t top, size_t spanWidth)
+    {
+        size_t row = 0;
+
+        for (row = 0; row < 2; ++row)
+        {
+            const uint32_t *colors = &mSpanColors[row * spanWidth];
+            const uint8_t *mask = &mSpanMask[row * spanWidth];
+            size_t start = 0;
+
+            while (start < spanWidth)
+            {
+                if (mask[start] == 0)
+                {
+                    ++start;
+                    continue;
+                }
+
+                size_t end = start + 1;
+                while (end < spanWidth && mask[end] != 0)
+                {
+                    ++end;
+                }
+
+                Point pt(left + start, top + row);
+
+                if (mAlphaBlend)
+                {
+                    mFramebuffer->blendSpan(pt, colors + start, end - start);
+                }
+                else
+                {
+                    mFramebuffer->writeSpan(pt, colors + start, end - start);
+                }
+
+                start = end;
+            }
+        }
+    }
 }
@@ -0,0 +1,94 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+
+#include "T3DR3DShader.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    T3D_IMPLEMENT_CLASS_1(R3DShader, Shader);
+
+    //--------------------------------------------------------------------------
+
+    R3DShaderPtr R3DShader::create(ShaderType shaderType, const String &name)
+    {
+        R3DShaderPtr shader = new R3DShader(shaderType, name);
+        shader->release();
+        return shader;
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DShader::R3DShader(ShaderType shaderType, const String &name)
+        : Shader(name)
+        , mShaderType(shaderType)
+        , mHasCompiled(false)
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DShader::~R3DShader()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    ShaderType R3DShader::getShaderType() const
+    {
+        return mShaderType;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DShader::compile(bool force /* = false */)
+    {
+        mHasCompiled = true;
+        return T3D_OK;
+    }
+
+    //--------------------------------------------------------------------------
+
+    bool R3DShader::hasCompiled() const
+    {
+        return mHasCompiled;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DShader::load()
+    {
+        return T3D_OK;
+    }
+
+    //--------------------------------------------------------------------------
+
+    ResourcePtr R3DShader::clone() const
+    {
+        R3DShaderPtr shader = create(mShaderType, getName());
+        shader->mHasCompiled = mHasCompiled;
+        return shader;
+    }
+}
@@ -0,0 +1,118 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+
+#include "T3DR3DState.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    R3DBlendStatePtr R3DBlendState::create()
+    {
+        R3DBlendStatePtr state = new R3DBlendState();
+        state->release();
+        return state;
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DBlendState::R3DBlendState()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DBlendState::~R3DBlendState()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DDepthStencilStatePtr R3DDepthStencilState::create()
+    {
+        R3DDepthStencilStatePtr state = new R3DDepthStencilState();
+        state->release();
+        return state;
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DDepthStencilState::R3DDepthStencilState()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DDepthStencilState::~R3DDepthStencilState()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DRasterizerStatePtr R3DRasterizerState::create()
+    {
+        R3DRasterizerStatePtr state = new R3DRasterizerState();
+        state->release();
+        return state;
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DRasterizerState::R3DRasterizerState()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DRasterizerState::~R3DRasterizerState()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DSamplerStatePtr R3DSamplerState::create()
+    {
+        R3DSamplerStatePtr state = new R3DSamplerState();
+        state->release();
+        return state;
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DSamplerState::R3DSamplerState()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DSamplerState::~R3DSamplerState()
+    {
+
+    }
+}
@@ -0,0 +1,461 @@
+﻿/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2019  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+
+#include "T3DR3DTextureSampler.h"
+#include "T3DR3DHardwarePixelBuffer.h"
+#include "T3DR3DError.h"
+
+
+namespace Tiny3D
+{
+    //--------------------------------------------------------------------------
+
+    R3DTextureSamplerPtr R3DTextureSampler::create(HardwarePixelBufferPtr pbo)
+    {
+        R3DTextureSamplerPtr sampler = new R3DTextureSampler();
+        sampler->release();
+
+        if (sampler->init(pbo) != T3D_OK)
+        {
+            sampler = nullptr;
+        }
+
+        return sampler;
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DTextureSampler::R3DTextureSampler()
+        : mMinFilter(FilterOptions::LINEAR)
+        , mMagFilter(FilterOptions::LINEAR)
+        , mMipFilter(FilterOptions::POINT)
+        , mAddressU(TextureAddressMode::WRAP)
+        , mAddressV(TextureAddressMode::WRAP)
+        , mVersion(0)
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    R3DTextureSampler::~R3DTextureSampler()
+    {
+
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DTextureSampler::init(HardwarePixelBufferPtr pbo)
+    {
+        TResult ret = T3D_OK;
+
+        do
+        {
+            R3DHardwarePixelBufferPtr buffer
+                = smart_pointer_cast<R3DHardwarePixelBuffer>(pbo);
+            if (buffer == nullptr)
+            {
+                ret = T3D_ERR_INVALID_PARAM;
+                T3D_LOG_ERROR(LOG_TAG_R3DRENDERER, "Invalid pixel buffer !");
+                break;
+            }
+
+            ret = loadLevel0(buffer);
+            if (ret != T3D_OK)
+            {
+                break;
+            }
+
+            generateMipmaps();
+
+            mVersion = buffer->getVersion();
+        } while (0);
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    TResult R3DTextureSampler::loadLevel0(R3DHardwarePixelBufferPtr pbo)
+    {
+        TResult ret = T3D_OK;
+
+        MipLevel level;
+        level.width = pbo->getWidth();
+        level.height = pbo->getHeight();
+        level.texels.resize(level.width * level.height);
+
+        const uint8_t *pixels = pbo->getPixels();
+        size_t pitch = pbo->getPitch();
+        size_t x = 0, y = 0;
+
+        for (y = 0; y < level.height && ret == T3D_OK; ++y)
+        {
+            const uint8_t *src = pixels + y * pitch;
+            uint32_t *dst = &level.texels[y * level.width];
+
+            for (x = 0; x < level.width; ++x)
+            {
+                uint32_t a = 0xFF, r = 0, g = 0, b = 0;
+
+                switch (pbo->getFormat())
+                {
+                case PixelFormat::E_PF_A8R8G8B8:
+                    b = src[0], g = src[1], r = src[2], a = src[3];
+                    src += 4;
+                    break;
+                case PixelFormat::E_PF_X8R8G8B8:
+                    b = src[0], g = src[1], r = src[2];
+                    src += 4;
+                    break;
+                case PixelFormat::E_PF_B8G8R8A8:
+                    a = src[0], r = src[1], g = src[2], b = src[3];
+                    src += 4;
+                    break;
+                case PixelFormat::E_PF_B8G8R8X8:
+                    r = src[1], g = src[2], b = src[3];
+                    src += 4;
+                    break;
+                case PixelFormat::E_PF_R8G8B8:
+                    b = src[0], g = src[1], r = src[2];
+                    src += 3;
+                    break;
+                case PixelFormat::E_PF_B8G8R8:
+                    r = src[0], g = src[1], b = src[2];
+                    src += 3;
+                    break;
+                case PixelFormat::E_PF_R5G6B5:
+                    {
+                        uint16_t c = *(const uint16_t *)src;
+                        r = ((c >> 11) & 0x1F) * 255 / 31;
+                        g = ((c >> 5) & 0x3F) * 255 / 63;
+                        b = (c & 0x1F) * 255 / 31;
+                        src += 2;
+                    }
+                    break;
+                case PixelFormat::E_PF_A1R5G5B5:
+                    {
+                        uint16_t c = *(const uint16_t *)src;
+                        a = (c & 0x8000) ? 0xFF : 0;
+                        r = ((c >> 10) & 0x1F) * 255 / 31;
+                        g = ((c >> 5) & 0x1F) * 255 / 31;
+                        b = (c & 0x1F) * 255 / 31;
+                        src += 2;
+                    }
+                    break;
+                case PixelFormat::E_PF_A4R4G4B4:
+                    {
+                        uint16_t c = *(const uint16_t *)src;
+                        a = ((c >> 12) & 0xF) * 17;
+                        r = ((c >> 8) & 0xF) * 17;
+                        g = ((c >> 4) & 0xF) * 17;
+                        b = (c & 0xF) * 17;
+                        src += 2;
+                    }
+                    break;
+                default:
+                    ret = T3D_ERR_R3D_UNSUPPORT_FORMAT_TEXTURE;
+                    break;
+                }
+
+                if (ret != T3D_OK)
+                {
+                    T3D_LOG_ERROR(LOG_TAG_R3DRENDERER,
+                        "Unsupported texture pixel format [%u] !",
+                        (uint32_t)pbo->getFormat());
+                    break;
+                }
+
+                dst[x] = (a << 24) | (r << 16) | (g << 8) | b;
+            }
+        }
+
+        if (ret == T3D_OK)
+        {
+            mMipmaps.clear();
+            mMipmaps.push_back(level);
+        }
+
+        return ret;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void R3DTextureSampler::generateMipmaps()
+    {
+        while (mMipmaps.back().width > 1 || mMipmaps.back().height > 1)
+        {
+            const MipLevel &src = mMipmaps.back();
+
+            MipLevel dst;
+            dst.width = std::max(src.width >> 1, size_t(1));
+            dst.height = std::max(src.height >> 1, size_t(1));
+            dst.texels.resize(dst.width * dst.height);
+
+            size_t x = 0, y = 0;
+
+            for (y = 0; y < dst.height; ++y)
+            {
+                // 奇数尺寸时最后一行、一列重复使用边上的纹素
+                size_t y0 = std::min(y * 2, src.height - 1);
+                size_t y1 = std::min(y * 2 + 1, src.height - 1);
+
+                for (x = 0; x < dst.width; ++x)
+                {
+                    size_t x0 = std::min(x * 2, src.width - 1);
+                    size_t x1 = std::min(x * 2 + 1, src.width - 1);
+
+                    uint32_t c00 = src.texels[y0 * src.width + x0];
+                    uint32_t c01 = src.texels[y0 * src.width + x1];
+                    uint32_t c10 = src.texels[y1 * src.width + x0];
+                    uint32_t c11 = src.texels[y1 * src.width + x1];
+
+                    uint32_t texel = 0;
+                    uint32_t shift = 0;
+
+                    for (shift = 0; shift < 32; shift += 8)
+                    {
+                        uint32_t sum = ((c00 >> shift) & 0xFF)
+                            + ((c01 >> shift) & 0xFF)
+                            + ((c10 >> shift) & 0xFF)
+                            + ((c11 >> shift) & 0xFF);
+                        texel |= ((sum + 2) >> 2) << shift;
+                    }
+
+                    dst.texels[y * dst.width + x] = texel;
+                }
+            }
+
+            mMipmaps.push_back(dst);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void R3DTextureSampler::setSampler(SamplerPtr sampler)
+    {
+        if (sampler != nullptr)
+        {
+            mMinFilter = sampler->getFilter(FilterType::MIN);
+            mMagFilter = sampler->getFilter(FilterType::MAG);
+            mMipFilter = sampler->getFilter(FilterType::MIP);
+
+            const UVWAddressMode &uvw = sampler->getAddressMode();
+            mAddressU = uvw.u;
+            mAddressV = uvw.v;
+        }
+        else
+        {
+            mMinFilter = FilterOptions::LINEAR;
+            mMagFilter = FilterOptions::LINEAR;
+            mMipFilter = FilterOptions::POINT;
+            mAddressU = TextureAddressMode::WRAP;
+            mAddressV = TextureAddressMode::WRAP;
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    void R3DTextureSampler::sampleQuad(const Real *u, const Real *v,
+        ColorARGB *colors) const
+    {
+        // 像素块内横向、纵向相邻像素的纹理坐标差分，换算到第0级纹素单位
+        Real w = Real(mMipmaps[0].width);
+        Real h = Real(mMipmaps[0].height);
+        Real dudx = (u[1] - u[0]) * w, dvdx = (v[1] - v[0]) * h;
+        Real dudy = (u[2] - u[0]) * w, dvdy = (v[2] - v[0]) * h;
+
+        Real rho2 = std::max(dudx * dudx + dvdx * dvdx,
+            dudy * dudy + dvdy * dvdy);
+        Real lod = (rho2 > REAL_ZERO)
+            ? REAL_HALF * std::log2(rho2) : -REAL_ONE;
+
+        size_t i = 0;
+
+        for (i = 0; i < 4; ++i)
+        {
+            colors[i] = sample(u[i], v[i], lod);
+        }
+    }
+
+    //--------------------------------------------------------------------------
+
+    ColorARGB R3DTextureSampler::sample(Real u, Real v, Real lod) const
+    {
+        Real bgra[4];
+        size_t maxLevel = mMipmaps.size() - 1;
+
+        if (lod <= REAL_ZERO)
+        {
+            // 放大
+            sampleLevel(0, mMagFilter, u, v, bgra);
+        }
+        else if (mMipFilter == FilterOptions::NONE || maxLevel == 0)
+        {
+            // 缩小，不使用 mipmaps
+            sampleLevel(0, mMinFilter, u, v, bgra);
+        }
+        else if (mMipFilter == FilterOptions::POINT)
+        {
+            // 缩小，取最接近的一级 mipmap
+            size_t level = std::min(size_t(lod + REAL_HALF), maxLevel);
+            sampleLevel(level, mMinFilter, u, v, bgra);
+        }
+        else
+        {
+            // 三线性，相邻两级 mipmaps 之间再做一次线性插值
+            size_t level0 = std::min(size_t(lod), maxLevel);
+            size_t level1 = std::min(level0 + 1, maxLevel);
+            Real t = std::min(lod - Real(level0), REAL_ONE);
+
+            Real bgra1[4];
+            sampleLevel(level0, mMinFilter, u, v, bgra);
+            sampleLevel(level1, mMinFilter, u, v, bgra1);
+
+            size_t i = 0;
+            for (i = 0; i < 4; ++i)
+            {
+                bgra[i] += (bgra1[i] - bgra[i]) * t;
+            }
+        }
+
+        return ColorARGB(bgra[2], bgra[1], bgra[0], bgra[3]);
+    }
+
+    //--------------------------------------------------------------------------
+
+    size_t R3DTextureSampler::address(int32_t coord, size_t size,
+        TextureAddressMode mode) const
+    {
+        int32_t s = (int32_t)size;
+
+        switch (mode)
+        {
+        case TextureAddressMode::WRAP:
+            coord %= s;
+            if (coord < 0)
+                coord += s;
+            break;
+        case TextureAddressMode::MIRROR:
+            {
+                int32_t period = s << 1;
+                coord %= period;
+                if (coord < 0)
+                    coord += period;
+                if (coord >= s)
+                    coord = period - 1 - coord;
+            }
+            break;
+        default:
+            // CLAMP，BORDER 暂时按照 CLAMP 处理
+            coord = std::min(std::max(coord, 0), s - 1);
+            break;
+        }
+
+        return (size_t)coord;
+    }
+
+    //--------------------------------------------------------------------------
+
+    void R3DTextureSampler::sampleLevel(size_t level, FilterOptions filter,
+        Real u, Real v, Real *bgra) const
+    {
+        const MipLevel &mip = mMipmaps[level];
+        const uint32_t *texels = &mip.texels[0];
+
+        const Real factor = REAL_ONE / Real(255.0);
+
+        if (filter == FilterOptions::NONE || filter == FilterOptions::POINT)
+        {
+            int32_t x = (int32_t)std::floor(u * Real(mip.width));
+            int32_t y = (int32_t)std::floor(v * Real(mip.height));
+            uint32_t c = texels[address(y, mip.height, mAddressV) * mip.width
+                + address(x, mip.width, mAddressU)];
+
+            bgra[0] = Real(c & 0xFF) * factor;
+            bgra[1] = Real((c >> 8) & 0xFF) * factor;
+            bgra[2] = Real((c >> 16) & 0xFF) * factor;
+            bgra[3] = Real((c >> 24) & 0xFF) * factor;
+            return;
+        }
+
+        // 双线性，纹素中心在 (i + 0.5)
+        Real fx = u * Real(mip.width) - REAL_HALF;
+        Real fy = v * Real(mip.height) - REAL_HALF;
+        Real x0f = std::floor(fx);
+        Real y0f = std::floor(fy);
+        Real tx = fx - x0f;
+        Real ty = fy - y0f;
+
+        int32_t x0 = (int32_t)x0f;
+        int32_t y0 = (int32_t)y0f;
+
+        size_t col0 = address(x0, mip.width, mAddressU);
+        size_t col1 = address(x0 + 1, mip.width, mAddressU);
+        size_t row0 = address(y0, mip.height, mAddressV) * mip.width;
+        size_t row1 = address(y0 + 1, mip.height, mAddressV) * mip.width;
+
+        uint32_t c00 = texels[row0 + col0];
+        uint32_t c01 = texels[row0 + col1];
+        uint32_t c10 = texels[row1 + col0];
+        uint32_t c11 = texels[row1 + col1];
+
+        Real w00 = (REAL_ONE - tx) * (REAL_ONE - ty);
+        Real w01 = tx * (REAL_ONE - ty);
+        Real w10 = (REAL_ONE - tx) * ty;
+        Real w11 = tx * ty;
+
+#if defined (T3D_R3D_SSE2)
+        // 4个纹素各自展开成 4 x float (B, G, R, A)，一次完成四个通道的加权
+        const __m128i zero = _mm_setzero_si128();
+        __m128i t0 = _mm_unpacklo_epi8(
+            _mm_cvtsi32_si128((int32_t)c00), zero);
+        __m128i t1 = _mm_unpacklo_epi8(
+            _mm_cvtsi32_si128((int32_t)c01), zero);
+        __m128i t2 = _mm_unpacklo_epi8(
+            _mm_cvtsi32_si128((int32_t)c10), zero);
+        __m128i t3 = _mm_unpacklo_epi8(
+            _mm_cvtsi32_si128((int32_t)c11), zero);
+
+        __m128 sum = _mm_mul_ps(
+            _mm_cvtepi32_ps(_mm_unpacklo_epi16(t0, zero)), _mm_set1_ps(w00));
+        sum = _mm_add_ps(sum, _mm_mul_ps(
+            _mm_cvtepi32_ps(_mm_unpacklo_epi16(t1, zero)), _mm_set1_ps(w01)));
+        sum = _mm_add_ps(sum, _mm_mul_ps(
+            _mm_cvtepi32_ps(_mm_unpacklo_epi16(t2, zero)), _mm_set1_ps(w10)));
+        sum = _mm_add_ps(sum, _mm_mul_ps(
+            _mm_cvtepi32_ps(_mm_unpacklo_epi16(t3, zero)), _mm_set1_ps(w11)));
+        sum = _mm_mul_ps(sum, _mm_set1_ps(factor));
+
+        _mm_storeu_ps(bgra, sum);
+#else
+        uint32_t shift = 0;
+        size_t i = 0;
+
+        for (i = 0, shift = 0; i < 4; ++i, shift += 8)
+        {
+            bgra[i] = (Real((c00 >> shift) & 0xFF) * w00
+                + Real((c01 >> shift) & 0xFF) * w01
+                + Real((c10 >> shift) & 0xFF) * w10
+                + Real((c11 >> shift) & 0xFF) * w11) * factor;
+        }
+#endif
+    }
+}
@@ -35,7 +35,7 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     R3DVertexArrayObject::R3DVertexArrayObject(bool useIndices)
-        : mPrimitiveType(Renderer::E_PT_TRIANGLE_LIST)
+        : mPrimitiveType(RenderContext::PrimitiveType::E_PT_TRIANGLE_LIST)
         , mDecl(nullptr)
         , mIBO(nullptr)
         , mUseIndices(useIndices)
@@ -67,7 +67,7 @@ namespace Tiny3D
     //--------------------------------------------------------------------------
 
     TResult R3DVertexArrayObject::setPrimitiveType(
-        Renderer::PrimitiveType priType)
+        RenderContext::PrimitiveType priType)
     {
         mPrimitiveType = priType;
         return T3D_OK;
@@ -75,7 +75,7 @@ namespace Tiny3D
 
     //--------------------------------------------------------------------------
 
-    Renderer::PrimitiveType R3DVertexArrayObject::getPrimitiveType() const
+    RenderContext::PrimitiveType R3DVertexArrayObject::getPrimitiveType() const
     {
         return mPrimitiveType;
     }
@@ -0,0 +1,284 @@
+/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "OffscreenApp.h"
+#include <stdio.h>
+
+
+using namespace Tiny3D;
+
+
+#define OBJ_MASK_SCENE         1
+
+
+OffscreenApp theApp;
+
+
+OffscreenApp::OffscreenApp()
+    : SampleApp()
+    , mWidth(640)
+    , mHeight(480)
+    , mFrameCount(1)
+    , mRenderTexture(nullptr)
+    , mCubeNode(nullptr)
+{
+}
+
+OffscreenApp::~OffscreenApp()
+{
+}
+
+bool OffscreenApp::parseOptions(int argc, char *argv[])
+{
+    int i = 1;
+
+    while (i < argc)
+    {
+        String opt = argv[i];
+
+        if (i + 1 >= argc)
+        {
+            printf("Missing value for option %s !\n", opt.c_str());
+            return false;
+        }
+
+        const char *value = argv[i + 1];
+
+        if (opt == "-r")
+        {
+            mRendererName = value;
+        }
+        else if (opt == "-w")
+        {
+            mWidth = (size_t)atoi(value);
+        }
+        else if (opt == "-h")
+        {
+            mHeight = (size_t)atoi(value);
+        }
+        else if (opt == "-n")
+        {
+            mFrameCount = (size_t)atoi(value);
+        }
+        else if (opt == "-o")
+        {
+            mOutputPath = value;
+        }
+        else if (opt == "-m")
+        {
+            mFloorMaterial = value;
+        }
+        else
+        {
+            printf("Unknown option %s !\n", opt.c_str());
+            return false;
+        }
+
+        i += 2;
+    }
+
+    if (mWidth == 0 || mHeight == 0)
+    {
+        printf("Invalid size %u x %u !\n", (uint32_t)mWidth,
+            (uint32_t)mHeight);
+        return false;
+    }
+
+    return true;
+}
+
+int OffscreenApp::main(int argc, char *argv[])
+{
+    if (!parseOptions(argc, argv))
+    {
+        printf("Usage : OffscreenApp [-r renderer] [-w width] [-h height] "
+            "[-n frames] [-o output directory] [-m floor material]\n");
+        return -1;
+    }
+
+    TResult ret = T3D_OK;
+
+    Agent *theEngine = new Agent();
+
+    do 
+    {
+        // No window at all, everything goes to the render texture.
+        ret = theEngine->init(argv[0], false);
+        if (T3D_FAILED(ret))
+        {
+            break;
+        }
+
+        if (!mRendererName.empty())
+        {
+            RenderContextPtr renderer = theEngine->getRenderer(mRendererName);
+            if (renderer == nullptr)
+            {
+                printf("Renderer %s did not load !\n", mRendererName.c_str());
+                ret = T3D_ERR_PLG_NOT_LOADED;
+                break;
+            }
+
+            ret = theEngine->setActiveRenderer(renderer);
+            if (T3D_FAILED(ret))
+            {
+                break;
+            }
+        }
+
+        RenderContextPtr renderer = theEngine->getActiveRenderer();
+
+        mRenderTexture = RenderTexture::create("Offscreen", mWidth, mHeight);
+        if (mRenderTexture == nullptr)
+        {
+            ret = T3D_ERR_INVALID_POINTER;
+            break;
+        }
+
+        ret = renderer->attachRenderTarget(mRenderTexture);
+        if (T3D_FAILED(ret))
+        {
+            break;
+        }
+
+        applicationDidFinishLaunching();
+
+        int64_t start = DateTime::currentMSecsSinceEpoch();
+        size_t i = 0;
+
+        for (i = 0; i < mFrameCount; ++i)
+        {
+            // Spin the cube a little every frame so that frames differ.
+            Radian angle(Math::PI * Real(i) / Real(90));
+            Quaternion orientation;
+            orientation.fromAngleAxis(angle, Vector3::UNIT_Y);
+            mCubeNode->getTransform3D()->setOrientation(orientation);
+
+            T3D_SCENE_MGR.update();
+            theEngine->renderOneFrame();
+
+            if (!mOutputPath.empty())
+            {
+                char filename[32];
+                snprintf(filename, sizeof(filename), "frame_%04u.png",
+                    (uint32_t)i);
+                String path = mOutputPath + Dir::getNativeSeparator()
+                    + filename;
+
+                ret = mRenderTexture->saveToFile(path);
+                if (T3D_FAILED(ret))
+                {
+                    printf("Save frame %s failed !\n", path.c_str());
+                    break;
+                }
+            }
+        }
+
+        int64_t elapsed = DateTime::currentMSecsSinceEpoch() - start;
+        double fps = (elapsed > 0 ? double(i) * 1000.0 / double(elapsed) : 0.0);
+        printf("Rendered %u frames (%u x %u) with %s in %d ms, %.2f fps\n",
+            (uint32_t)i, (uint32_t)mWidth, (uint32_t)mHeight,
+            renderer->getName().c_str(), (int32_t)elapsed, fps);
+
+        const RenderStatistics &stats = renderer->getStatistics();
+        const RenderStatistics::FrameStats &frame = stats.getFrameStats();
+        printf("Last frame : %u draw calls, %u primitives, %u state changes, "
+            "%u texture binds, %u redundant calls avoided\n", frame.drawCalls,
+            frame.primitives, frame.stateChanges, frame.textureBinds,
+            frame.avoidedCalls);
+        printf("Frame time : avg %.3f ms, p50 %.3f ms, p95 %.3f ms, "
+            "p99 %.3f ms\n", stats.getAverageFrameTime(),
+            stats.getFrameTimePercentile(50), stats.getFrameTimePercentile(95),
+            stats.getFrameTimePercentile(99));
+
+        renderer->detachRenderTarget(mRenderTexture->getName());
+    } while (0);
+
+    mCubeNode = nullptr;
+    mRenderTexture = nullptr;
+
+    delete theEngine;
+
+    return (T3D_FAILED(ret) ? -1 : 0);
+}
+
+bool OffscreenApp::applicationDidFinishLaunching()
+{
+    buildScene();
+    return true;
+}
+
+void OffscreenApp::buildScene()
+{
+    SceneNodePtr root = T3D_SCENE_MGR.getRoot();
+
+    // Camera
+    SceneNodePtr node = T3D_SCENE_MGR.createSceneNode(root);
+
+    CameraPtr camera = smart_pointer_cast<Camera>(node->addComponent(T3D_CLASS(Camera)));
+    camera->lookAt(Vector3(0.0f, 4.0f, 8.0f), Vector3::ZERO, Vector3::UNIT_Y);
+    camera->setProjectionType(Camera::Type::PERSPECTIVE);
+    Real aspect = Real(mWidth) / Real(mHeight);
+    Radian fovY(Math::PI * REAL_HALF);
+    camera->setPerspectiveParams(fovY, aspect, 0.5f, 1000.0f);
+    camera->setObjectMask(OBJ_MASK_SCENE);
+
+    // Viewport
+    ViewportPtr viewport = mRenderTexture->addViewport(camera, 1,
+        REAL_ZERO, REAL_ZERO, REAL_ONE, REAL_ONE);
+    viewport->setBkgndColor(ColorRGB::BLACK);
+
+    // Cube
+    node = T3D_SCENE_MGR.createSceneNode(root);
+    Vector3 extent(1.0f, 1.0f, 1.0f);
+    node->addComponent(T3D_CLASS(Cube), Vector3::ZERO, extent);
+    node->getTransform3D()->setPosition(Vector3(-2.0f, 0.0f, 0.0f));
+    node->setCameraMask(OBJ_MASK_SCENE);
+    mCubeNode = node;
+
+    // Sphere
+    node = T3D_SCENE_MGR.createSceneNode(root);
+    Real radius(1.0f);
+    node->addComponent(T3D_CLASS(Globe), Vector3::ZERO, &radius);
+    node->getTransform3D()->setPosition(Vector3(2.0f, 0.0f, 0.0f));
+    node->setCameraMask(OBJ_MASK_SCENE);
+
+    // Floor, in front of the objects because Reference3D has no depth buffer
+    // and draws the quad last.
+    if (!mFloorMaterial.empty())
+    {
+        const Real half(2.0f);
+        const Real y(-1.0f);
+        const Real zNear(5.5f);
+        const Real zFar(1.5f);
+        Quad::QuadData quad;
+        quad.vertices[Quad::VI_TOP_LEFT].position = Vector3(-half, y, zFar);
+        quad.vertices[Quad::VI_TOP_LEFT].uv = Vector2(0.0f, 0.0f);
+        quad.vertices[Quad::VI_TOP_RIGHT].position = Vector3(half, y, zFar);
+        quad.vertices[Quad::VI_TOP_RIGHT].uv = Vector2(1.0f, 0.0f);
+        quad.vertices[Quad::VI_BOTTOM_LEFT].position = Vector3(-half, y, zNear);
+        quad.vertices[Quad::VI_BOTTOM_LEFT].uv = Vector2(0.0f, 1.0f);
+        quad.vertices[Quad::VI_BOTTOM_RIGHT].position = Vector3(half, y, zNear);
+        quad.vertices[Quad::VI_BOTTOM_RIGHT].uv = Vector2(1.0f, 1.0f);
+
+        node = T3D_SCENE_MGR.createSceneNode(root);
+        node->addComponent<Quad>(quad, mFloorMaterial);
+        node->setCameraMask(OBJ_MASK_SCENE);
+    }
+}
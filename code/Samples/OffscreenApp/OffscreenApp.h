@@ -0,0 +1,68 @@
+/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef __OFFSCREEN_APP_H__
+#define __OFFSCREEN_APP_H__
+
+
+#include "../Common/SampleApp.h"
+
+
+/**
+ * @brief Headless sample : renders N frames into a RenderTexture without any
+ *      window and optionally dumps every frame through the image codec.
+ *
+ * Usage : OffscreenApp [-r renderer] [-w width] [-h height] [-n frames]
+ *                      [-o output directory] [-m floor material]
+ *
+ * Without -o nothing is written and only the throughput is reported, which
+ * makes it usable as a benchmark; with -o the PNGs can be compared against
+ * reference images for render regression tests. -m lays a quad with the given
+ * material on the ground in front of the objects, e.g. -m materials/Blocks.t3d
+ * for a textured floor.
+ */
+class OffscreenApp : public SampleApp
+{
+public:
+    OffscreenApp();
+    virtual ~OffscreenApp();
+
+    int main(int argc, char *argv[]);
+
+protected:
+    virtual bool applicationDidFinishLaunching() override;
+
+    bool parseOptions(int argc, char *argv[]);
+
+    void buildScene();
+
+protected:
+    String                      mRendererName;
+    String                      mOutputPath;
+    String                      mFloorMaterial;
+    size_t                      mWidth;
+    size_t                      mHeight;
+    size_t                      mFrameCount;
+
+    Tiny3D::RenderTexturePtr    mRenderTexture;
+    Tiny3D::SceneNodePtr        mCubeNode;
+};
+
+
+#endif  /*__OFFSCREEN_APP_H__*/
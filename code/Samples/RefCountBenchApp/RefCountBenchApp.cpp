@@ -0,0 +1,440 @@
+/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "RefCountBenchApp.h"
+#include <stdio.h>
+
+
+using namespace Tiny3D;
+
+
+RefCountBenchApp theApp;
+
+
+namespace
+{
+    // Pass through function pointers so that the compiler cannot inline the
+    // calls and drop the copies of the arguments.
+    typedef bool (*TestByValue)(Bound *collider, BoundPtr bound);
+    typedef bool (*CullByValue)(Bound *collider, BoundPtr bound, 
+        RenderQueuePtr queue);
+
+    bool testByValue(Bound *collider, BoundPtr bound)
+    {
+        // Bound::test() used to cast its argument to the concrete type.
+        BoundPtr target = smart_pointer_cast<Bound>(bound);
+        return collider->test(target);
+    }
+
+    volatile TestByValue gTestByValue = testByValue;
+
+    bool cullByValue(Bound *collider, BoundPtr bound, RenderQueuePtr queue)
+    {
+        return gTestByValue(collider, bound);
+    }
+
+    volatile CullByValue gCullByValue = cullByValue;
+
+    // Acquire and release calls of all objects so far, counted by Object
+    // only when the engine is built with TINY3D_REFCOUNT_STATS.
+    struct RefCalls
+    {
+        uint64_t    acquires;
+        uint64_t    releases;
+    };
+
+    RefCalls currentRefCalls()
+    {
+        RefCalls calls;
+#if defined (T3D_REFCOUNT_STATS)
+        calls.acquires = Object::getAcquireCount();
+        calls.releases = Object::getReleaseCount();
+#else
+        calls.acquires = 0;
+        calls.releases = 0;
+#endif
+        return calls;
+    }
+
+#if defined (T3D_REFCOUNT_STATS)
+    void printRefCalls(const char *name, const RefCalls &start, 
+        const RefCalls &end, size_t frames)
+    {
+        printf("%-26s: %10.1f acquire, %10.1f release per frame\n", name,
+            double(end.acquires - start.acquires) / double(frames),
+            double(end.releases - start.releases) / double(frames));
+    }
+#endif
+}
+
+
+RefCountBenchApp::RefCountBenchApp()
+    : SampleApp()
+    , mObjectCount(100000)
+    , mFrames(100)
+    , mPassCount(0)
+    , mViewRefs(0)
+    , mNodeRefs(0)
+    , mBoundRefs(0)
+{
+}
+
+RefCountBenchApp::~RefCountBenchApp()
+{
+}
+
+bool RefCountBenchApp::parseOptions(int argc, char *argv[])
+{
+    int i = 1;
+
+    while (i < argc)
+    {
+        String opt = argv[i];
+
+        if (i + 1 >= argc)
+        {
+            printf("Missing value for option %s !\n", opt.c_str());
+            return false;
+        }
+
+        const char *value = argv[i + 1];
+
+        if (opt == "-c")
+        {
+            mObjectCount = (size_t)atoi(value);
+        }
+        else if (opt == "-n")
+        {
+            mFrames = (size_t)atoi(value);
+        }
+        else
+        {
+            printf("Unknown option %s !\n", opt.c_str());
+            return false;
+        }
+
+        i += 2;
+    }
+
+    if (mObjectCount == 0 || mFrames == 0)
+    {
+        printf("Object count and frames must not be 0 !\n");
+        return false;
+    }
+
+    return true;
+}
+
+int RefCountBenchApp::main(int argc, char *argv[])
+{
+    if (!parseOptions(argc, argv))
+    {
+        printf("Usage : RefCountBenchApp [-c object count] [-n frames]\n");
+        return -1;
+    }
+
+    TResult ret = T3D_OK;
+    bool passed = false;
+
+    Agent *theEngine = new Agent();
+
+    do 
+    {
+        // Nothing is rendered, the renderer only backs the cube prefab.
+        ret = theEngine->init(argv[0], false);
+        if (T3D_FAILED(ret))
+        {
+            break;
+        }
+
+#if defined (T3D_ATOMIC_REFCOUNT)
+        const char *mode = "atomic";
+#else
+        const char *mode = "plain";
+#endif
+
+        printf("%u objects, %u frames, %s reference counts\n", 
+            (uint32_t)mObjectCount, (uint32_t)mFrames, mode);
+
+        if (!createObjects())
+        {
+            ret = T3D_ERR_INVALID_POINTER;
+            break;
+        }
+
+        size_t i = 0;
+        size_t visibleByValue = 0, visibleNodes = 0;
+
+        RefCalls calls[5];
+        calls[0] = currentRefCalls();
+        int64_t start = DateTime::currentMSecsSinceEpoch();
+
+        for (i = 0; i < mFrames; ++i)
+        {
+            visibleByValue += cullByValue();
+        }
+
+        int64_t byValueTime = DateTime::currentMSecsSinceEpoch() - start;
+        calls[1] = currentRefCalls();
+        start = DateTime::currentMSecsSinceEpoch();
+
+        for (i = 0; i < mFrames; ++i)
+        {
+            visibleNodes += cullSceneNodes();
+        }
+
+        int64_t nodesTime = DateTime::currentMSecsSinceEpoch() - start;
+        calls[2] = currentRefCalls();
+        start = DateTime::currentMSecsSinceEpoch();
+
+        for (i = 0; i < mFrames; ++i)
+        {
+            handOverByCopy();
+        }
+
+        int64_t copyTime = DateTime::currentMSecsSinceEpoch() - start;
+        calls[3] = currentRefCalls();
+        start = DateTime::currentMSecsSinceEpoch();
+
+        for (i = 0; i < mFrames; ++i)
+        {
+            handOverByMove();
+        }
+
+        int64_t moveTime = DateTime::currentMSecsSinceEpoch() - start;
+        calls[4] = currentRefCalls();
+
+        double frames = double(mFrames);
+
+        printf("culling  : by value %8.3f ms, scene nodes %8.3f ms per frame\n",
+            double(byValueTime) / frames, double(nodesTime) / frames);
+        printf("handover : by copy  %8.3f ms, by move     %8.3f ms per frame\n",
+            double(copyTime) / frames, double(moveTime) / frames);
+
+#if defined (T3D_REFCOUNT_STATS)
+        printRefCalls("culling by value", calls[0], calls[1], mFrames);
+        printRefCalls("SceneNode::frustumCulling", calls[1], calls[2], mFrames);
+        printRefCalls("handover by copy", calls[2], calls[3], mFrames);
+        printRefCalls("handover by move", calls[3], calls[4], mFrames);
+#else
+        printf("Build with TINY3D_REFCOUNT_STATS to count acquire/release "
+            "calls\n");
+#endif
+
+        passed = (visibleByValue == visibleNodes && checkReferCounts());
+
+        printf("%s, %u visible by value, %u visible scene nodes\n", 
+            (passed ? "PASS" : "FAIL"), (uint32_t)visibleByValue, 
+            (uint32_t)visibleNodes);
+
+        destroyObjects();
+    } while (0);
+
+    delete theEngine;
+
+    if (T3D_FAILED(ret) || !passed)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+bool RefCountBenchApp::createObjects()
+{
+    SceneNodePtr root = T3D_SCENE_MGR.getRoot();
+
+    // The view is a bound on its own node so that its world AABB is updated
+    // like any other collider.
+    SceneNodePtr node = T3D_SCENE_MGR.createSceneNode(root);
+    AabbBoundPtr view = node->addComponent<AabbBound>();
+    Real half = Real(mObjectCount / 2);
+    view->setParams(-half, half, -half, half, -half, half);
+    mView = view;
+
+    mQueue = RenderQueue::create();
+
+    // All nodes are instances of one prefab, they share its VAO and material.
+    SceneNodePtr prefab = SceneNode::create();
+    prefab->addComponent<Transform3D>();
+    CubePtr cube = smart_pointer_cast<Cube>(prefab->addComponent(
+        T3D_CLASS(Cube), Vector3(REAL_HALF, REAL_HALF, REAL_HALF), 
+        Vector3(REAL_HALF, REAL_HALF, REAL_HALF)));
+    AabbBoundPtr bound = prefab->addComponent<AabbBound>();
+
+    if (cube == nullptr || bound == nullptr)
+    {
+        printf("Create cube prefab failed !\n");
+        return false;
+    }
+
+    bound->setParams(REAL_ZERO, REAL_ONE, REAL_ZERO, REAL_ONE, 
+        REAL_ZERO, REAL_ONE);
+    mPassCount = prefab->getRenderable()->getMaterial()->getBestTechnique()
+        ->getPasses().size();
+
+    if (mPassCount == 0)
+    {
+        printf("Cube material has no pass !\n");
+        return false;
+    }
+
+    mParent = T3D_SCENE_MGR.createSceneNode(root);
+    mNodes.reserve(mObjectCount);
+    mBounds.reserve(mObjectCount);
+    mHandOver.reserve(mObjectCount);
+
+    size_t i = 0;
+
+    // Half of the objects overlap the view.
+    for (i = 0; i < mObjectCount; ++i)
+    {
+        node = prefab->instantiate();
+        mParent->addChild(node);
+        node->getTransform3D()->setPosition(
+            Vector3(Real(i), REAL_ZERO, REAL_ZERO));
+
+        mNodes.push_back(node);
+        mBounds.push_back(
+            smart_pointer_cast<Bound>(node->getComponent(T3D_CLASS(AabbBound))));
+    }
+
+    // Update once to bring the world bounds up to date.
+    T3D_SCENE_MGR.update();
+
+    mViewRefs = mView->referCount();
+    mNodeRefs = mNodes[0]->referCount();
+    mBoundRefs = mBounds[0]->referCount();
+    return true;
+}
+
+void RefCountBenchApp::destroyObjects()
+{
+    mHandOver.clear();
+    mBounds.clear();
+    mNodes.clear();
+
+    if (mParent != nullptr)
+    {
+        mParent->removeFromParent();
+        mParent = nullptr;
+    }
+
+    mQueue = nullptr;
+
+    if (mView != nullptr)
+    {
+        mView->getSceneNode()->removeFromParent();
+        mView = nullptr;
+    }
+}
+
+size_t RefCountBenchApp::cullByValue()
+{
+    size_t visible = 0;
+
+    for (const BoundPtr &bound : mBounds)
+    {
+        if (gCullByValue(bound, mView, mQueue))
+        {
+            visible++;
+        }
+    }
+
+    return visible;
+}
+
+size_t RefCountBenchApp::cullSceneNodes()
+{
+    mQueue->clear();
+
+    for (const SceneNodePtr &node : mNodes)
+    {
+        node->frustumCulling(mView, mQueue);
+    }
+
+    // One render item per pass of every visible node.
+    return mQueue->getItemCount() / mPassCount;
+}
+
+void RefCountBenchApp::handOverByCopy()
+{
+    // Copy everything over and back, the source keeps its references.
+    mHandOver.clear();
+
+    for (const BoundPtr &bound : mBounds)
+    {
+        mHandOver.push_back(bound);
+    }
+
+    mBounds.clear();
+
+    for (const BoundPtr &bound : mHandOver)
+    {
+        mBounds.push_back(bound);
+    }
+
+    mHandOver.clear();
+}
+
+void RefCountBenchApp::handOverByMove()
+{
+    mHandOver.clear();
+
+    for (BoundPtr &bound : mBounds)
+    {
+        mHandOver.push_back(std::move(bound));
+    }
+
+    mBounds.clear();
+
+    for (BoundPtr &bound : mHandOver)
+    {
+        mBounds.push_back(std::move(bound));
+    }
+
+    mHandOver.clear();
+}
+
+bool RefCountBenchApp::checkReferCounts() const
+{
+    // Every path must leave the reference counts as they were after setup.
+    if (mView->referCount() != mViewRefs || mQueue->referCount() != 1)
+    {
+        return false;
+    }
+
+    for (const SceneNodePtr &node : mNodes)
+    {
+        if (node->referCount() != mNodeRefs)
+        {
+            return false;
+        }
+    }
+
+    for (const BoundPtr &bound : mBounds)
+    {
+        if (bound->referCount() != mBoundRefs)
+        {
+            return false;
+        }
+    }
+
+    return mBounds.size() == mObjectCount;
+}
@@ -0,0 +1,88 @@
+/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef __REF_COUNT_BENCH_APP_H__
+#define __REF_COUNT_BENCH_APP_H__
+
+
+#include "../Common/SampleApp.h"
+
+
+/**
+ * @brief Headless benchmark for reference counting on the per-object paths.
+ *
+ * Usage : RefCountBenchApp [-c object count] [-n frames]
+ *
+ * The objects are scene nodes instantiated from one cube prefab, each with an
+ * AABB collider. Every frame culls all of them twice against a view bound:
+ * once through wrappers that take smart pointers by value and cast them like
+ * the old SceneNode::frustumCulling() and Bound::test() did, and once through
+ * the real SceneNode::frustumCulling() into a render queue. It also hands all
+ * colliders over to a second array, by copy and by move.
+ *
+ * When the engine is built with TINY3D_REFCOUNT_STATS, the acquire and release
+ * calls of every pass are counted by Object and printed per frame. The
+ * reference counts of all objects are checked to be unchanged afterwards.
+ */
+class RefCountBenchApp : public SampleApp
+{
+public:
+    RefCountBenchApp();
+    virtual ~RefCountBenchApp();
+
+    int main(int argc, char *argv[]);
+
+protected:
+    bool parseOptions(int argc, char *argv[]);
+
+    bool createObjects();
+
+    void destroyObjects();
+
+    size_t cullByValue();
+
+    size_t cullSceneNodes();
+
+    void handOverByCopy();
+
+    void handOverByMove();
+
+    bool checkReferCounts() const;
+
+protected:
+    typedef TArray<Tiny3D::BoundPtr>        Bounds;
+    typedef TArray<Tiny3D::SceneNodePtr>    SceneNodes;
+
+    size_t      mObjectCount;
+    size_t      mFrames;
+
+    Tiny3D::SceneNodePtr    mParent;
+    Tiny3D::BoundPtr        mView;
+    Tiny3D::RenderQueuePtr  mQueue;
+    SceneNodes              mNodes;
+    Bounds                  mBounds;
+    Bounds                  mHandOver;
+    size_t                  mPassCount;
+    uint32_t                mViewRefs;
+    uint32_t                mNodeRefs;
+    uint32_t                mBoundRefs;
+};
+
+
+#endif  /*__REF_COUNT_BENCH_APP_H__*/
@@ -0,0 +1,299 @@
+/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#include "TransformBenchApp.h"
+#include <stdio.h>
+
+
+using namespace Tiny3D;
+
+
+TransformBenchApp theApp;
+
+
+TransformBenchApp::TransformBenchApp()
+    : SampleApp()
+    , mNodeCount(100000)
+    , mMaxDepth(64)
+    , mIterations(10)
+    , mErrors(0)
+{
+}
+
+TransformBenchApp::~TransformBenchApp()
+{
+}
+
+bool TransformBenchApp::parseOptions(int argc, char *argv[])
+{
+    int i = 1;
+
+    while (i < argc)
+    {
+        String opt = argv[i];
+
+        if (i + 1 >= argc)
+        {
+            printf("Missing value for option %s !\n", opt.c_str());
+            return false;
+        }
+
+        const char *value = argv[i + 1];
+
+        if (opt == "-c")
+        {
+            mNodeCount = (size_t)atoi(value);
+        }
+        else if (opt == "-d")
+        {
+            mMaxDepth = (size_t)atoi(value);
+        }
+        else if (opt == "-n")
+        {
+            mIterations = (size_t)atoi(value);
+        }
+        else
+        {
+            printf("Unknown option %s !\n", opt.c_str());
+            return false;
+        }
+
+        i += 2;
+    }
+
+    if (mNodeCount == 0 || mMaxDepth == 0 || mIterations == 0)
+    {
+        printf("Node count, depth and iterations must not be 0 !\n");
+        return false;
+    }
+
+    return true;
+}
+
+int TransformBenchApp::main(int argc, char *argv[])
+{
+    if (!parseOptions(argc, argv))
+    {
+        printf("Usage : TransformBenchApp [-c node count] [-d max depth] "
+            "[-n iterations]\n");
+        return -1;
+    }
+
+    TResult ret = T3D_OK;
+
+    Agent *theEngine = new Agent();
+
+    do 
+    {
+        // Nothing is rendered, the scene manager is all we need.
+        ret = theEngine->init(argv[0], false);
+        if (T3D_FAILED(ret))
+        {
+            break;
+        }
+
+        printf("%u nodes, %u iterations, %s\n", (uint32_t)mNodeCount,
+            (uint32_t)mIterations,
+            (T3D_SCENE_MGR.getTransformStore() != nullptr 
+                ? "transform store" : "per node transforms"));
+
+        size_t depth = 1;
+
+        while (depth <= mMaxDepth)
+        {
+            runDepth(depth);
+            depth *= 2;
+        }
+
+        printf("%s, %u mismatched leaves\n", (mErrors == 0 ? "PASS" : "FAIL"),
+            (uint32_t)mErrors);
+    } while (0);
+
+    delete theEngine;
+
+    if (T3D_FAILED(ret) || mErrors != 0)
+    {
+        return -1;
+    }
+
+    return 0;
+}
+
+void TransformBenchApp::buildChains(size_t depth)
+{
+    SceneNodePtr root = T3D_SCENE_MGR.getRoot();
+    size_t chainCount = mNodeCount / depth;
+    size_t i = 0, j = 0;
+
+    if (chainCount == 0)
+    {
+        chainCount = 1;
+    }
+
+    mChainRoots.reserve(chainCount);
+    mLeaves.reserve(chainCount);
+
+    // Small rotation and uniform scaling on every level, so that a parent
+    // that is skipped or applied twice shows up in the leaves.
+    Quaternion orientation;
+    orientation.fromAngleAxis(Radian(Real(0.05)), Vector3::UNIT_Y);
+    Vector3 scaling(Real(1.01), Real(1.01), Real(1.01));
+
+    for (i = 0; i < chainCount; ++i)
+    {
+        SceneNodePtr parent = root;
+        SceneNodePtr node;
+
+        for (j = 0; j < depth; ++j)
+        {
+            node = T3D_SCENE_MGR.createSceneNode(parent);
+            Transform3D *xform = node->getTransform3D();
+            xform->setPosition(Vector3(REAL_ONE, Real(j), Real(i % 16)));
+            xform->setOrientation(orientation);
+            xform->setScaling(scaling);
+
+            if (j == 0)
+            {
+                mChainRoots.push_back(node);
+            }
+
+            parent = node;
+        }
+
+        mLeaves.push_back(node);
+    }
+}
+
+void TransformBenchApp::destroyChains()
+{
+    SceneNodePtr root = T3D_SCENE_MGR.getRoot();
+
+    for (SceneNodePtr &node : mChainRoots)
+    {
+        root->removeChild(node);
+    }
+
+    mChainRoots.clear();
+    mLeaves.clear();
+
+    // Let the scene manager drop whatever it still keeps for the old nodes.
+    T3D_SCENE_MGR.update();
+}
+
+void TransformBenchApp::moveChains(size_t iteration)
+{
+    Real offset = Real(iteration % 8);
+
+    for (SceneNodePtr &node : mChainRoots)
+    {
+        Transform3D *xform = node->getTransform3D();
+        Vector3 pos = xform->getPosition();
+        pos.y() = offset;
+        xform->setPosition(pos);
+    }
+}
+
+size_t TransformBenchApp::checkLeaves() const
+{
+    size_t errors = 0;
+    size_t i = 0;
+
+    for (i = 0; i < mLeaves.size(); ++i)
+    {
+        // Collect the chain from the leaf up to the scene root.
+        TArray<Transform3D*> chain;
+        NodePtr node = mLeaves[i];
+
+        while (node != nullptr)
+        {
+            SceneNode *sceneNode = static_cast<SceneNode *>((Node *)node);
+            chain.push_back(sceneNode->getTransform3D());
+            node = node->getParent();
+        }
+
+        Matrix4 world = Matrix4::IDENTITY;
+
+        auto itr = chain.rbegin();
+        while (itr != chain.rend())
+        {
+            Transform3D *xform = *itr;
+            Matrix4 local;
+            local.makeTransform(xform->getPosition(), xform->getScaling(),
+                xform->getOrientation());
+            world = world * local;
+            ++itr;
+        }
+
+        Vector3 expected = world * Vector3::ZERO;
+        Vector3 actual 
+            = chain.front()->getLocalToWorldTransform().getTranslation();
+        Real tolerance = Real(1e-3) * std::max(REAL_ONE, expected.length());
+
+        if ((expected - actual).length() > tolerance)
+        {
+            errors++;
+        }
+    }
+
+    return errors;
+}
+
+void TransformBenchApp::runDepth(size_t depth)
+{
+    buildChains(depth);
+
+    // Direct queries, every leaf resolves its own world transform.
+    size_t i = 0;
+    int64_t start = DateTime::currentMSecsSinceEpoch();
+
+    for (i = 0; i < mIterations; ++i)
+    {
+        moveChains(i);
+
+        for (SceneNodePtr &node : mLeaves)
+        {
+            node->getTransform3D()->getLocalToWorldTransform();
+        }
+    }
+
+    int64_t queryTime = DateTime::currentMSecsSinceEpoch() - start;
+    size_t queryErrors = checkLeaves();
+
+    // Frame updates through the scene manager.
+    start = DateTime::currentMSecsSinceEpoch();
+
+    for (i = 0; i < mIterations; ++i)
+    {
+        moveChains(i + 1);
+        T3D_SCENE_MGR.update();
+    }
+
+    int64_t updateTime = DateTime::currentMSecsSinceEpoch() - start;
+    size_t updateErrors = checkLeaves();
+
+    printf("depth %2u : %6u chains, query %8.3f ms, update %8.3f ms, "
+        "errors %u / %u\n", (uint32_t)depth, (uint32_t)mChainRoots.size(),
+        double(queryTime) / double(mIterations),
+        double(updateTime) / double(mIterations),
+        (uint32_t)queryErrors, (uint32_t)updateErrors);
+
+    mErrors += queryErrors + updateErrors;
+
+    destroyChains();
+}
@@ -0,0 +1,72 @@
+/*******************************************************************************
+ * This file is part of Tiny3D (Tiny 3D Graphic Rendering Engine)
+ * Copyright (C) 2015-2020  Answer Wong
+ * For latest info, see https://github.com/answerear/Tiny3D
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ ******************************************************************************/
+
+#ifndef __TRANSFORM_BENCH_APP_H__
+#define __TRANSFORM_BENCH_APP_H__
+
+
+#include "../Common/SampleApp.h"
+
+
+/**
+ * @brief Headless benchmark for the transform hierarchy.
+ *
+ * Usage : TransformBenchApp [-c node count] [-d max depth] [-n iterations]
+ *
+ * For every depth 1, 2, 4 ... max depth the same number of nodes is arranged
+ * as chains of that depth. Every iteration moves all chain roots and then
+ * either queries the world transform of every leaf directly or runs one scene
+ * manager update. The leaves are checked against the product of the local
+ * matrices along each chain.
+ */
+class TransformBenchApp : public SampleApp
+{
+public:
+    TransformBenchApp();
+    virtual ~TransformBenchApp();
+
+    int main(int argc, char *argv[]);
+
+protected:
+    bool parseOptions(int argc, char *argv[]);
+
+    void buildChains(size_t depth);
+
+    void destroyChains();
+
+    void moveChains(size_t iteration);
+
+    size_t checkLeaves() const;
+
+    void runDepth(size_t depth);
+
+protected:
+    typedef TArray<Tiny3D::SceneNodePtr>    SceneNodes;
+
+    size_t      mNodeCount;
+    size_t      mMaxDepth;
+    size_t      mIterations;
+
+    SceneNodes  mChainRoots;
+    SceneNodes  mLeaves;
+    size_t      mErrors;
+};
+
+
+#endif  /*__TRANSFORM_BENCH_APP_H__*/